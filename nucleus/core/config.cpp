@@ -6,6 +6,7 @@
 #include "config.h"
 #include "nucleus/filesystem/filesystem.h"
 
+#include <cstdlib>
 #include <cstring>
 
 // Global configuration object
@@ -19,6 +20,7 @@ Config::Config() {
     language = LANGUAGE_DEFAULT;
     ppuTranslator = CPU_TRANSLATOR_FUNCTION;
     spuTranslator = CPU_TRANSLATOR_INSTRUCTION;
+    ppuTierUpThreshold = 1000;
     graphicsBackend = GRAPHICS_BACKEND_OPENGL;
 }
 
@@ -31,6 +33,16 @@ void Config::parseArguments(int argc, char** argv) {
         if (!strcmp(argv[i], "--debugger")) {
             debugger = true;
         }
+        if (!strcmp(argv[i], "--ppu-aot")) {
+            ppuTranslator = CPU_TRANSLATOR_MODULE;
+        }
+        if (!strcmp(argv[i], "--ppu-block")) {
+            ppuTranslator = CPU_TRANSLATOR_BLOCK;
+        }
+        if (!strncmp(argv[i], "--ppu-tier-up=", 14)) {
+            ppuTranslator = ConfigCpuTranslator(CPU_TRANSLATOR_INSTRUCTION | CPU_TRANSLATOR_FUNCTION);
+            ppuTierUpThreshold = std::strtoul(argv[i] + 14, nullptr, 10);
+        }
     }
 
     // Check if booting an executable was requested
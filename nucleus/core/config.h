@@ -51,6 +51,7 @@ public:
     ConfigLanguage language;
     ConfigCpuTranslator ppuTranslator;
     ConfigCpuTranslator spuTranslator;
+    unsigned int ppuTierUpThreshold;  // Interpreted calls before a PPU function is handed to the JIT
     ConfigGraphicsBackend graphicsBackend;
 
     // Constructor
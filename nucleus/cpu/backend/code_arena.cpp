@@ -0,0 +1,233 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "code_arena.h"
+#include "nucleus/logger/logger.h"
+
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
+#include <Windows.h>
+#elif defined(NUCLEUS_PLATFORM_LINUX)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(NUCLEUS_PLATFORM_OSX)
+#include <sys/mman.h>
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#include <cstring>
+
+// Granularity of the memory committed to the arena
+#define CODE_ARENA_COMMIT_SIZE  0x10000
+
+namespace cpu {
+namespace backend {
+
+static U64 alignUp(U64 value, U64 alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+CodeArena::CodeArena(U64 size) {
+    size = alignUp(size, CODE_ARENA_COMMIT_SIZE);
+
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
+    // Pagefile-backed section with its pages committed on demand, falling back to a single RWX region
+    mapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_EXECUTE_READWRITE | SEC_RESERVE,
+        DWORD(size >> 32), DWORD(size), nullptr);
+    if (mapping) {
+        rwBase = static_cast<U8*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size));
+        rxBase = static_cast<U8*>(MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_EXECUTE, 0, 0, size));
+        if (!rwBase || !rxBase) {
+            if (rwBase) {
+                UnmapViewOfFile(rwBase);
+            }
+            if (rxBase) {
+                UnmapViewOfFile(rxBase);
+            }
+            CloseHandle(mapping);
+            mapping = nullptr;
+        }
+    }
+    if (!mapping) {
+        logger.warning(LOG_CPU, "Could not map the code arena twice, using RWX memory");
+        rwBase = rxBase = static_cast<U8*>(VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_EXECUTE_READWRITE));
+    }
+#elif defined(NUCLEUS_PLATFORM_LINUX)
+    // Anonymous file mapped twice, falling back to a single RWX mapping
+    fd = syscall(SYS_memfd_create, "nucleus-code", 0);
+    if (fd >= 0 && ftruncate(fd, size) == 0) {
+        void* rw = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        void* rx = mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+        if (rw != MAP_FAILED && rx != MAP_FAILED) {
+            rwBase = static_cast<U8*>(rw);
+            rxBase = static_cast<U8*>(rx);
+        } else {
+            if (rw != MAP_FAILED) {
+                munmap(rw, size);
+            }
+            if (rx != MAP_FAILED) {
+                munmap(rx, size);
+            }
+        }
+    }
+    if (!rwBase) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+        logger.warning(LOG_CPU, "Could not map the code arena twice, using RWX memory");
+        void* rwx = mmap(nullptr, size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        rwBase = rxBase = (rwx != MAP_FAILED) ? static_cast<U8*>(rwx) : nullptr;
+    }
+#elif defined(NUCLEUS_PLATFORM_OSX)
+    void* rwx = mmap(nullptr, size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    rwBase = rxBase = (rwx != MAP_FAILED) ? static_cast<U8*>(rwx) : nullptr;
+#endif
+
+    // Check errors (no partial mapping is left behind at this point)
+    if (!rwBase || !rxBase) {
+        logger.error(LOG_CPU, "Could not reserve %llu bytes for the code arena", size);
+        rwBase = rxBase = nullptr;
+        return;
+    }
+    capacity = size;
+    freeBlocks.resize(CODE_ARENA_COMMIT_SIZE / CODE_ARENA_ALIGNMENT + 1);
+}
+
+CodeArena::~CodeArena() {
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
+    if (mapping) {
+        UnmapViewOfFile(rxBase);
+        UnmapViewOfFile(rwBase);
+        CloseHandle(mapping);
+    } else if (rwBase) {
+        VirtualFree(rwBase, 0, MEM_RELEASE);
+    }
+#elif defined(NUCLEUS_PLATFORM_LINUX) || defined(NUCLEUS_PLATFORM_OSX)
+    if (rxBase && rxBase != rwBase) {
+        munmap(rxBase, capacity);
+    }
+    if (rwBase) {
+        munmap(rwBase, capacity);
+    }
+#endif
+#if defined(NUCLEUS_PLATFORM_LINUX)
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+}
+
+bool CodeArena::commit(U64 size) {
+    if (size <= committed) {
+        return true;
+    }
+    size = alignUp(size, CODE_ARENA_COMMIT_SIZE);
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
+    const DWORD protection = mapping ? PAGE_READWRITE : PAGE_EXECUTE_READWRITE;
+    if (!VirtualAlloc(rwBase + committed, size - committed, MEM_COMMIT, protection)) {
+        return false;
+    }
+#endif
+    // Other platforms get their pages on first touch
+    committed = size;
+    return true;
+}
+
+void* CodeArena::alloc(U64 size) {
+    size = alignUp(size ? size : 1, CODE_ARENA_ALIGNMENT);
+    const U64 sizeClass = size / CODE_ARENA_ALIGNMENT;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Reuse a freed block of the same size class
+    U64 offset;
+    if (sizeClass < freeBlocks.size() && !freeBlocks[sizeClass].empty()) {
+        offset = freeBlocks[sizeClass].back();
+        freeBlocks[sizeClass].pop_back();
+        freed -= size;
+    } else {
+        if (size > capacity - used || !commit(used + size)) {
+            logger.error(LOG_CPU, "Code arena is full (%llu bytes requested)", size);
+            return nullptr;
+        }
+        offset = used;
+        used += size;
+    }
+
+    allocations[offset] = size;
+    allocated += size;
+    return rxBase + offset;
+}
+
+void CodeArena::free(void* addr) {
+    if (!addr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const U64 offset = static_cast<U8*>(addr) - rxBase;
+    const auto it = allocations.find(offset);
+    if (it == allocations.end()) {
+        logger.error(LOG_CPU, "Code arena block at %p was not allocated", addr);
+        return;
+    }
+
+    // Blocks of a size above the largest class are only reclaimed by reset
+    const U64 size = it->second;
+    const U64 sizeClass = size / CODE_ARENA_ALIGNMENT;
+    if (sizeClass < freeBlocks.size()) {
+        freeBlocks[sizeClass].push_back(offset);
+        freed += size;
+    }
+    allocated -= size;
+    allocations.erase(it);
+}
+
+void CodeArena::write(void* addr, const void* code, U64 size) {
+    memcpy(getWritable(addr), code, size);
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
+    FlushInstructionCache(GetCurrentProcess(), addr, size);
+#elif !defined(NUCLEUS_ARCH_X86)
+    __builtin___clear_cache(static_cast<char*>(addr), static_cast<char*>(addr) + size);
+#endif
+}
+
+void* CodeArena::getWritable(void* addr) const {
+    return rwBase + (static_cast<U8*>(addr) - rxBase);
+}
+
+bool CodeArena::contains(const void* addr) const {
+    const U8* ptr = static_cast<const U8*>(addr);
+    return rxBase <= ptr && ptr < rxBase + capacity;
+}
+
+void CodeArena::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    allocations.clear();
+    for (auto& blocks : freeBlocks) {
+        blocks.clear();
+    }
+    used = 0;
+    allocated = 0;
+    freed = 0;
+}
+
+CodeArenaStats CodeArena::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    CodeArenaStats stats;
+    stats.capacity = capacity;
+    stats.committed = committed;
+    stats.used = used;
+    stats.allocated = allocated;
+    stats.freed = freed;
+    stats.allocations = allocations.size();
+    return stats;
+}
+
+}  // namespace backend
+}  // namespace cpu
@@ -0,0 +1,120 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cpu {
+namespace backend {
+
+// Alignment of the blocks allocated in a code arena (and granularity of its size classes)
+constexpr U64 CODE_ARENA_ALIGNMENT = 16;
+
+struct CodeArenaStats {
+    U64 capacity;      // Bytes reserved for the arena
+    U64 committed;     // Bytes of the arena backed by memory
+    U64 used;          // Bytes below the allocation pointer (including freed blocks)
+    U64 allocated;     // Bytes of live allocations
+    U64 freed;         // Bytes of freed blocks available for reuse
+    U64 allocations;   // Number of live allocations
+};
+
+/**
+ * Code Arena
+ * ==========
+ * Reserves a large region for the code emitted by a backend, so that compiled functions
+ * are packed together instead of being scattered across the heap.
+ *
+ * The region is mapped twice: once as read-write and once as read-execute, so that no page
+ * is ever both writable and executable. Code is allocated through its executable address
+ * and copied through the writable view with CodeArena::write. If the region cannot be
+ * mapped twice, both views are the same RWX mapping.
+ *
+ * Allocations are aligned to CODE_ARENA_ALIGNMENT and taken from the end of the used space,
+ * while freed blocks are kept in size classes of CODE_ARENA_ALIGNMENT bytes for reuse.
+ */
+class CodeArena {
+    // Views of the arena
+    U8* rwBase = nullptr;
+    U8* rxBase = nullptr;
+
+    // Arena state
+    U64 capacity = 0;
+    U64 committed = 0;
+    U64 used = 0;
+    U64 allocated = 0;
+    U64 freed = 0;
+
+    // Size of each allocation, indexed by offset
+    std::unordered_map<U64, U64> allocations;
+
+    // Offsets of freed blocks, indexed by size class
+    std::vector<std::vector<U64>> freeBlocks;
+
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
+    void* mapping = nullptr;
+#elif defined(NUCLEUS_PLATFORM_LINUX)
+    int fd = -1;
+#endif
+
+    std::mutex mutex;
+
+    // Make sure the first bytes of the arena are backed by memory
+    bool commit(U64 size);
+
+public:
+    // Constructor
+    CodeArena(U64 capacity = 256 * 1024 * 1024);
+    ~CodeArena();
+
+    /**
+     * Allocate executable memory
+     * @param[in]  size  Number of bytes
+     * @return           Executable address of the block, or nullptr if the arena is full
+     */
+    void* alloc(U64 size);
+
+    /**
+     * Release executable memory
+     * @param[in]  addr  Executable address returned by CodeArena::alloc
+     */
+    void free(void* addr);
+
+    /**
+     * Copy code into an allocated block
+     * @param[in]  addr  Executable address of the destination
+     * @param[in]  code  Source buffer
+     * @param[in]  size  Number of bytes
+     */
+    void write(void* addr, const void* code, U64 size);
+
+    /**
+     * Get the writable address that corresponds to an executable address of the arena
+     * @param[in]  addr  Executable address
+     * @return           Writable address
+     */
+    void* getWritable(void* addr) const;
+
+    /**
+     * Check whether an address belongs to the executable view of the arena
+     * @param[in]  addr  Address
+     * @return           True if it is inside the arena
+     */
+    bool contains(const void* addr) const;
+
+    // Release all allocations at once
+    void reset();
+
+    // Get occupancy statistics
+    CodeArenaStats getStats();
+};
+
+}  // namespace backend
+}  // namespace cpu
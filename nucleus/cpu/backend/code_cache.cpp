@@ -0,0 +1,169 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "code_cache.h"
+#include "nucleus/logger/logger.h"
+
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
+#include <io.h>
+#elif defined(NUCLEUS_PLATFORM_LINUX) || defined(NUCLEUS_PLATFORM_OSX)
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+// Magic of the cache files: "NCC\0"
+#define CODE_CACHE_MAGIC  0x0043434E
+
+// Upper bound of the sizes stored in an entry, larger values are considered corrupt
+#define CODE_CACHE_MAX_ITEMS  0x1000000
+
+namespace cpu {
+namespace backend {
+
+struct CodeCacheHeader {
+    U32 magic;
+    U32 version;
+    U64 target;
+    U8 module[20];
+    U32 reserved;
+};
+
+template <typename T>
+static bool readItems(FILE* file, std::vector<T>& items) {
+    U32 count;
+    if (fread(&count, sizeof(count), 1, file) != 1 || count > CODE_CACHE_MAX_ITEMS) {
+        return false;
+    }
+    items.resize(count);
+    return count == 0 || fread(items.data(), sizeof(T), count, file) == count;
+}
+
+template <typename T>
+static bool writeItems(FILE* file, const std::vector<T>& items) {
+    const U32 count = items.size();
+    return fwrite(&count, sizeof(count), 1, file) == 1 &&
+        (count == 0 || fwrite(items.data(), sizeof(T), count, file) == count);
+}
+
+CodeCache::~CodeCache() {
+    close();
+}
+
+bool CodeCache::readEntry(CodeCacheEntry& entry) {
+    return fread(&entry.address, sizeof(entry.address), 1, file) == 1 &&
+        fread(&entry.hash, sizeof(entry.hash), 1, file) == 1 &&
+        fread(&entry.typeOut, sizeof(entry.typeOut), 1, file) == 1 &&
+        readItems(file, entry.ranges) &&
+        readItems(file, entry.typeIn) &&
+        readItems(file, entry.code) &&
+        readItems(file, entry.relocations) &&
+        readItems(file, entry.callSites);
+}
+
+bool CodeCache::writeEntry(const CodeCacheEntry& entry) {
+    return fwrite(&entry.address, sizeof(entry.address), 1, file) == 1 &&
+        fwrite(&entry.hash, sizeof(entry.hash), 1, file) == 1 &&
+        fwrite(&entry.typeOut, sizeof(entry.typeOut), 1, file) == 1 &&
+        writeItems(file, entry.ranges) &&
+        writeItems(file, entry.typeIn) &&
+        writeItems(file, entry.code) &&
+        writeItems(file, entry.relocations) &&
+        writeItems(file, entry.callSites);
+}
+
+bool CodeCache::open(const std::string& path, const U8 module[20], U64 target) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file) {
+        fclose(file);
+    }
+    entries.clear();
+
+    // Load existing entries
+    CodeCacheHeader header = {};
+    file = fopen(path.c_str(), "r+b");
+    if (file) {
+        const bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+            header.magic == CODE_CACHE_MAGIC &&
+            header.version == CODE_CACHE_VERSION &&
+            header.target == target &&
+            memcmp(header.module, module, sizeof(header.module)) == 0;
+        if (valid) {
+            long offset = ftell(file);
+            CodeCacheEntry entry;
+            while (readEntry(entry)) {
+                entries[entry.address] = std::move(entry);
+                offset = ftell(file);
+            }
+            // Drop any truncated entry and append new entries after the last valid one
+            fflush(file);
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
+            _chsize_s(_fileno(file), offset);
+#elif defined(NUCLEUS_PLATFORM_LINUX) || defined(NUCLEUS_PLATFORM_OSX)
+            ftruncate(fileno(file), offset);
+#endif
+            fseek(file, offset, SEEK_SET);
+            return true;
+        }
+        logger.notice(LOG_CPU, "Discarding outdated code cache: %s", path.c_str());
+        fclose(file);
+    }
+
+    // Create a new cache file
+    file = fopen(path.c_str(), "w+b");
+    if (!file) {
+        logger.warning(LOG_CPU, "Could not create code cache: %s", path.c_str());
+        return false;
+    }
+    header.magic = CODE_CACHE_MAGIC;
+    header.version = CODE_CACHE_VERSION;
+    header.target = target;
+    memcpy(header.module, module, sizeof(header.module));
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        file = nullptr;
+        return false;
+    }
+    fflush(file);
+    return true;
+}
+
+void CodeCache::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+    entries.clear();
+}
+
+bool CodeCache::find(U64 address, CodeCacheEntry& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = entries.find(address);
+    if (it == entries.end()) {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+bool CodeCache::insert(const CodeCacheEntry& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) {
+        return false;
+    }
+    entries[entry.address] = entry;
+    if (!writeEntry(entry)) {
+        logger.warning(LOG_CPU, "Could not write code cache entry");
+        fclose(file);
+        file = nullptr;
+        return false;
+    }
+    fflush(file);
+    return true;
+}
+
+}  // namespace backend
+}  // namespace cpu
@@ -0,0 +1,117 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cpu {
+namespace backend {
+
+// Version of the cache format and the generated code, increase it whenever either changes
+constexpr U32 CODE_CACHE_VERSION = 3;
+
+enum CodeCacheRelocationType : U32 {
+    RELOCATION_MEMORY_BASE = 0,  // Host address of the guest memory
+    RELOCATION_HELPER,           // Host function called by the generated code (key is the helper index)
+    RELOCATION_FUNCTION,         // HIR function object (key is the guest address of the function)
+    RELOCATION_RESERVATIONS,     // Slots of the PPU reservation table (key is the offset from the first slot)
+};
+
+// Absolute 64-bit host address embedded in the generated code
+struct CodeCacheRelocation {
+    U32 offset;  // Offset of the address from the start of the code
+    U32 type;    // Relocation type
+    U64 key;     // Identifier of the target, depending on the type
+};
+
+// Linkable call to another function, stored unlinked (see hir::NativeCallSite)
+struct CodeCacheCallSite {
+    U32 offset;  // Offset of the call instruction from the start of the code
+    U32 stub;    // Offset of the stub of the call
+    U64 target;  // Guest address of the called function
+};
+
+// Range of guest code covered by a compiled function
+struct CodeCacheRange {
+    U64 address;
+    U64 size;
+};
+
+struct CodeCacheEntry {
+    U64 address;                                   // Guest address of the function
+    U8 hash[20];                                   // SHA-1 of the guest code ranges
+    std::vector<CodeCacheRange> ranges;            // Guest code ranges
+    U32 typeOut;                                   // Type signature of the HIR function
+    std::vector<U32> typeIn;
+    std::vector<U8> code;                          // Relocatable native code
+    std::vector<CodeCacheRelocation> relocations;  // Addresses to be patched when loading the code
+    std::vector<CodeCacheCallSite> callSites;      // Calls to be linked when loading the code
+};
+
+/**
+ * Code Cache
+ * ==========
+ * Stores the native code of compiled functions on disk, so that later runs can skip
+ * the translation and compilation of functions whose guest code did not change.
+ *
+ * Each file holds the functions of a single guest module. Its header contains a key
+ * identifying the guest module and the target the code was compiled for; files with
+ * a different key, version or a corrupt header are discarded. Entries are appended as
+ * functions get compiled, and a truncated last entry is ignored and overwritten.
+ */
+class CodeCache {
+    FILE* file = nullptr;
+
+    // Entries, indexed by guest address
+    std::unordered_map<U64, CodeCacheEntry> entries;
+
+    std::mutex mutex;
+
+    // Read a single entry from the current file position
+    bool readEntry(CodeCacheEntry& entry);
+
+    // Write a single entry at the current file position
+    bool writeEntry(const CodeCacheEntry& entry);
+
+public:
+    ~CodeCache();
+
+    /**
+     * Open a cache file, creating it if missing or outdated
+     * @param[in]  path    Path to the cache file
+     * @param[in]  module  SHA-1 of the guest module
+     * @param[in]  target  Identifier of the target and features used by the compiler
+     * @return             True on success
+     */
+    bool open(const std::string& path, const U8 module[20], U64 target);
+
+    // Close the cache file
+    void close();
+
+    /**
+     * Find the entry of a function
+     * @param[in]  address  Guest address of the function
+     * @param[out] entry    Copy of the entry
+     * @return              True if the function is cached
+     */
+    bool find(U64 address, CodeCacheEntry& entry);
+
+    /**
+     * Add the entry of a function and append it to the cache file
+     * @param[in]  entry  Entry to be added
+     * @return            True on success
+     */
+    bool insert(const CodeCacheEntry& entry);
+};
+
+}  // namespace backend
+}  // namespace cpu
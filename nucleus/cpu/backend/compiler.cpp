@@ -6,17 +6,6 @@
 #include "compiler.h"
 #include "nucleus/logger/logger.h"
 
-#ifdef NUCLEUS_PLATFORM_WINDOWS
-#include <Windows.h>
-#endif
-#ifdef NUCLEUS_PLATFORM_LINUX
-#include <sys/mman.h>
-#endif
-#ifdef NUCLEUS_PLATFORM_OSX
-#include <sys/mman.h>
-#define MAP_ANONYMOUS MAP_ANON
-#endif
-
 namespace cpu {
 namespace backend {
 
@@ -32,8 +21,19 @@ Compiler::Compiler() {
 Compiler::Compiler(const Settings& settings) : settings(settings) {
 }
 
+std::vector<std::unique_ptr<Pass>>& Compiler::getThreadPasses() {
+    std::lock_guard<std::mutex> lock(passesMutex);
+
+    // Passes keep state of the function being processed, so each thread gets its own copy
+    auto& current = threadPasses[std::this_thread::get_id()];
+    for (size_t index = current.size(); index < passes.size(); index++) {
+        current.push_back(passes[index]->clone());
+    }
+    return current;
+}
+
 bool Compiler::optimize(Function* function) {
-    for (auto& pass : passes) {
+    for (auto& pass : getThreadPasses()) {
         if (!pass->run(function)) {
             logger.error(LOG_CPU, "Could not run pass: %s", pass->name());
             return false;
@@ -43,34 +43,87 @@ bool Compiler::optimize(Function* function) {
 }
 
 void Compiler::addPass(std::unique_ptr<Pass> pass) {
+    std::lock_guard<std::mutex> lock(passesMutex);
     passes.push_back(std::move(pass));
 }
 
-void* Compiler::allocRWXMemory(size_t size) {
-    void* addr = malloc(size);
+U64 Compiler::getTargetId() const {
+    return 0;
+}
+
+void Compiler::linkCallSite(const Function* caller, const NativeCallSite& site, const void* target) {
+    U8* address = static_cast<U8*>(caller->nativeAddress) + site.offset;
+    if (!patchCall(codeArena.getWritable(address), address, target)) {
+        patchCall(codeArena.getWritable(address), address, static_cast<U8*>(caller->nativeAddress) + site.stub);
+    }
+}
 
-    // Enable execution permissions
-#ifdef NUCLEUS_PLATFORM_WINDOWS
-    DWORD oldProtect;
-    if (!VirtualProtect(addr, size, PAGE_EXECUTE_READWRITE, &oldProtect)) {
-        logger.error(LOG_CPU, "Could not allocate %d bytes of RWX memory", size);
-        return nullptr;
+bool Compiler::install(Function* function, const void* code, U64 size, const std::vector<NativeCallSite>& callSites) {
+    void* codeAddr = codeArena.alloc(size);
+    if (!codeAddr) {
+        logger.error(LOG_CPU, "Cannot allocate memory for the compiled function");
+        return false;
     }
-#endif
-#ifdef NUCLEUS_PLATFORM_LINUX
-    size_t pageSize = sysconf(_SC_PAGESIZE);
-    size_t iaddr = reinterpret_cast<size_t>(addr);
-    size_t roundedAddr = iaddr & ~(pageSize - 1);
-    if (!mprotect(reinterpret_cast<void*>(roundAddr), size + (iaddr - roundAddr), PROT_READ | PROT_WRITE | PROT_EXEC)) {
-        logger.error(LOG_CPU, "Could not allocate %d bytes of RWX memory", size);
-        return nullptr;
+    codeArena.write(codeAddr, code, size);
+
+    std::lock_guard<std::mutex> lock(linkMutex);
+
+    // Forget the calls of the previous native code
+    for (const auto& site : function->nativeCallSites) {
+        callers[site.target].erase(function);
+    }
+    function->nativeSize = size;
+    function->nativeAddress = codeAddr;
+    function->nativeImmediates.clear();
+    function->nativeCallSites = callSites;
+    function->flags |= FUNCTION_IS_COMPILED;
+
+    // Link the calls of the function to the compiled callees
+    for (const auto& site : callSites) {
+        callers[site.target].insert(function);
+        if (site.target->nativeAddress) {
+            linkCallSite(function, site, site.target->nativeAddress);
+        }
     }
-#endif
-    return addr;
+    // Link the calls of other functions to the new code
+    for (const auto* caller : callers[function]) {
+        for (const auto& site : caller->nativeCallSites) {
+            if (site.target == function) {
+                linkCallSite(caller, site, codeAddr);
+            }
+        }
+    }
+    return true;
+}
+
+bool Compiler::install(Function* function, const std::vector<U8>& code, const std::vector<NativeCallSite>& callSites) {
+    return install(function, code.data(), code.size(), callSites);
+}
+
+void Compiler::unlink(Function* function) {
+    std::lock_guard<std::mutex> lock(linkMutex);
+
+    // Calls to the function go back to their stubs
+    for (const auto* caller : callers[function]) {
+        for (const auto& site : caller->nativeCallSites) {
+            if (site.target == function) {
+                linkCallSite(caller, site, static_cast<U8*>(caller->nativeAddress) + site.stub);
+            }
+        }
+    }
+    // Calls from the function are no longer patched
+    for (const auto& site : function->nativeCallSites) {
+        callers[site.target].erase(function);
+    }
+    function->nativeCallSites.clear();
+}
+
+bool Compiler::compileInlineCache(InlineCache& cache) {
+    return false;
 }
 
-void Compiler::freeRWXMemory(void* addr) {
-    free(addr);
+bool Compiler::patchCall(void* writable, const void* address, const void* target) {
+    return false;
 }
 
 }  // namespace backend
@@ -6,6 +6,8 @@
 #pragma once
 
 #include "nucleus/common.h"
+#include "nucleus/cpu/backend/code_arena.h"
+#include "nucleus/cpu/backend/inline_cache.h"
 #include "nucleus/cpu/backend/settings.h"
 #include "nucleus/cpu/backend/target.h"
 #include "nucleus/cpu/hir/block.h"
@@ -15,6 +17,10 @@
 #include "nucleus/cpu/hir/value.h"
 
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace cpu {
@@ -24,6 +30,20 @@ class Compiler {
     // Compiler passes
     std::vector<std::unique_ptr<hir::Pass>> passes;
 
+    // Copies of the compiler passes for each thread running Compiler::optimize
+    std::unordered_map<std::thread::id, std::vector<std::unique_ptr<hir::Pass>>> threadPasses;
+    std::mutex passesMutex;
+
+    // Get the passes to be used by the current thread
+    std::vector<std::unique_ptr<hir::Pass>>& getThreadPasses();
+
+    // Functions whose native code contains linkable calls to each function
+    std::unordered_map<const hir::Function*, std::unordered_set<const hir::Function*>> callers;
+    std::mutex linkMutex;
+
+    // Point a linkable call of a compiled function to an executable address, or to its stub if unreachable
+    void linkCallSite(const hir::Function* caller, const hir::NativeCallSite& site, const void* target);
+
 protected:
     // Optimize HIR
     virtual bool optimize(hir::Function* function);
@@ -35,6 +55,9 @@ public:
     // Generic target information
     TargetInfo targetInfo;
 
+    // Executable memory for the compiled functions
+    CodeArena codeArena;
+
     // Constructor
     Compiler();
     Compiler(const Settings& settings);
@@ -47,17 +70,56 @@ public:
     virtual bool compile(hir::Function* function) = 0;
     virtual bool compile(hir::Module* module) = 0;
 
+    /**
+     * Generate the stub of an inline cache for its current targets and install it as the native code of InlineCache::function
+     * @param[in]  cache  Inline cache, whose mutex is held by the caller
+     * @return            True on success, false if inline caches are not supported
+     */
+    virtual bool compileInlineCache(InlineCache& cache);
+
     /**
      * Runs a compiled function
      * @param[in]  function   Function to be called
      * @param[in]  state      Pointer to the guest thread state
      * @param[in]  arguments  Arguments as an array of constant values
+     * @param[out] result     Return value, if not nullptr (integers in the lower 64 bits, floats in the lower lanes)
+     * @return                True on success, false if the function cannot be called
      */
-    virtual bool call(hir::Function* function, void* state, const std::vector<hir::Value*>& args = {}) = 0;
+    virtual bool call(hir::Function* function, void* state, const std::vector<hir::Value*>& args = {}, V128* result = nullptr) = 0;
 
-    // Manage RWX memory
-    void* allocRWXMemory(size_t size);
-    void freeRWXMemory(void* addr);
+    /**
+     * Get an identifier of the target architecture, features and settings the generated code depends on
+     * @return  Identifier, or 0 if the generated code cannot be cached
+     */
+    virtual U64 getTargetId() const;
+
+    /**
+     * Install native code for a function, linking its calls and the calls of other functions to it
+     * @param[in]  function   Function whose native code will be replaced
+     * @param[in]  code       Native code, already relocated
+     * @param[in]  size       Size of the native code
+     * @param[in]  callSites  Linkable calls in the native code
+     * @return                True on success
+     */
+    bool install(hir::Function* function, const void* code, U64 size, const std::vector<hir::NativeCallSite>& callSites = {});
+    bool install(hir::Function* function, const std::vector<U8>& code, const std::vector<hir::NativeCallSite>& callSites = {});
+
+    /**
+     * Restore the linkable calls to a function, so that they go through Function::nativeAddress
+     * again, and forget the calls made by its native code. This is required before discarding
+     * the native code of a function.
+     * @param[in]  function  Function being invalidated
+     */
+    void unlink(hir::Function* function);
+
+    /**
+     * Point a linkable call to another executable address
+     * @param[out] writable  Writable address of the call instruction
+     * @param[in]  address   Executable address of the call instruction
+     * @param[in]  target    Executable address to be called
+     * @return               True on success, false if the target is out of reach or calls cannot be linked
+     */
+    virtual bool patchCall(void* writable, const void* address, const void* target);
 };
 
 }  // namespace backend
@@ -0,0 +1,48 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/hir/function.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace cpu {
+namespace backend {
+
+// Maximum number of targets remembered by an inline cache
+constexpr U32 INLINE_CACHE_SIZE = 4;
+
+/**
+ * Inline Cache
+ * ============
+ * Polymorphic cache of an indirect call site. Guest code calls InlineCache::function, whose
+ * native code is a stub emitted by Compiler::compileInlineCache: it compares the target address,
+ * held in a register of the guest context, against the targets observed so far and jumps to the
+ * native code of the matching function. Other targets jump to InlineCache::missAddress, the
+ * generic path, which is expected to add them to the cache and recompile the stub until it is full.
+ */
+struct InlineCache {
+    hir::Function* function = nullptr;  // Function called by the site, running the stub
+    U32 contextOffset = 0;              // Offset of the guest register holding the target (lower 32 bits)
+    void* missAddress = nullptr;        // Native code handling the targets missing in the cache
+
+    // Observed targets
+    U32 count = 0;
+    U32 targets[INLINE_CACHE_SIZE] = {};                // Guest addresses
+    hir::Function* functions[INLINE_CACHE_SIZE] = {};  // Functions at those addresses
+
+    // Statistics
+    U64 hits[INLINE_CACHE_SIZE] = {};  // Updated by the stub without synchronization
+    std::atomic<U64> misses{0};
+
+    // Guards the targets and the recompilation of the stub
+    std::mutex mutex;
+};
+
+}  // namespace backend
+}  // namespace cpu
@@ -27,6 +27,9 @@ union InstrKey {
 
     Value value;
 
+    InstrKey(Value value) : value(value) {
+    }
+
     InstrKey(const hir::Instruction* instr) : value(0) {
         const auto& opInfo = hir::opcodeInfo[instr->opcode];
         // Fill opcode field
@@ -7,6 +7,7 @@
 
 #include "nucleus/common.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace cpu {
@@ -23,11 +24,41 @@ struct RegisterSet {
 
     std::vector<int> valueIndex;
     std::vector<int> argIndex;
+    std::vector<int> calleeSavedIndex;
+    std::vector<int> scratchIndex;  // Registers overwritten by instructions with OPCODE_FLAG_CLOBBER
     int retIndex;
+
+    /**
+     * Check whether a register must be preserved by the callee
+     * @param[in]  index  Hardware register index
+     * @return            True if the register is callee-saved
+     */
+    bool isCalleeSaved(int index) const {
+        return std::find(calleeSavedIndex.begin(), calleeSavedIndex.end(), index) != calleeSavedIndex.end();
+    }
+
+    /**
+     * Check whether a register is overwritten by instructions with OPCODE_FLAG_CLOBBER
+     * @param[in]  index  Hardware register index
+     * @return            True if the register is a scratch register
+     */
+    bool isScratch(int index) const {
+        return std::find(scratchIndex.begin(), scratchIndex.end(), index) != scratchIndex.end();
+    }
+};
+
+struct StackInfo {
+    U32 alignment;    // Alignment of the stack pointer required at call sites
+    U32 shadowSpace;  // Space reserved by the caller for the register arguments of the callee
+    U32 redZone;      // Space below the stack pointer that leaf functions can use freely
 };
 
 struct TargetInfo {
     std::vector<RegisterSet> regSets;
+    StackInfo stack;
+
+    // Argument positions are shared by all register sets (Win64) rather than counted per set (SysV)
+    bool sharedArgSlots;
 };
 
 }  // namespace backend
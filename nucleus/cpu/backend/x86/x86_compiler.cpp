@@ -6,10 +6,14 @@
 #include "x86_compiler.h"
 #include "nucleus/emulator.h"
 #include "nucleus/logger/logger.h"
+#include "nucleus/cpu/backend/x86/x86_emitter.h"
 #include "nucleus/cpu/backend/x86/x86_sequences.h"
+#include "nucleus/cpu/hir/instruction.h"
+#include "nucleus/cpu/hir/opcodes.h"
 
 #include "externals/xbyak/xbyak_util.h"
 
+#include <algorithm>
 #include <queue>
 
 namespace cpu {
@@ -45,28 +49,207 @@ void X86Compiler::init() {
     targetInfo.regSets[0].types = RegisterSet::TYPE_INT;
     targetInfo.regSets[0].valueIndex = {10, 11, 12, 13, 14, 15}; // {r10, r11, r12, r13, r14, r15}
     targetInfo.regSets[0].argIndex = {1, 2, 8, 9}; // {rcx, rdx, r8, r9}
+    targetInfo.regSets[0].calleeSavedIndex = {3, 5, 6, 7, 12, 13, 14, 15}; // {rbx, rbp, rsi, rdi, r12, ..., r15}
+    targetInfo.regSets[0].scratchIndex = {0, 1, 2}; // {rax, rcx, rdx}
     targetInfo.regSets[0].retIndex = 0; // rax
     targetInfo.regSets[1].types = RegisterSet::TYPE_FLOAT | RegisterSet::TYPE_VECTOR;
     targetInfo.regSets[1].valueIndex = {6, 7, 8, 9, 10, 11, 12, 13, 14, 15}; // {xmm6, ...,  xmm15}
     targetInfo.regSets[1].argIndex = {0, 1, 2, 3}; // {xmm0, ..., xmm3}
+    targetInfo.regSets[1].calleeSavedIndex = {6, 7, 8, 9, 10, 11, 12, 13, 14, 15}; // {xmm6, ..., xmm15}
     targetInfo.regSets[1].retIndex = 0; // xmm0
-#elif defined(NUCLEUS_PLATFORM_LINUX)
-#elif defined(NUCLEUS_PLATFORM_OSX)
+    targetInfo.stack.alignment = 16;
+    targetInfo.stack.shadowSpace = 32;
+    targetInfo.stack.redZone = 0;
+    targetInfo.sharedArgSlots = true;
+#elif defined(NUCLEUS_PLATFORM_LINUX) || defined(NUCLEUS_PLATFORM_OSX)
+    // System V AMD64 ABI
+    targetInfo.regSets.resize(2);
+    targetInfo.regSets[0].types = RegisterSet::TYPE_INT;
+    targetInfo.regSets[0].valueIndex = {12, 13, 14, 15, 10, 11}; // {r12, r13, r14, r15, r10, r11}
+    targetInfo.regSets[0].argIndex = {7, 6, 2, 1, 8, 9}; // {rdi, rsi, rdx, rcx, r8, r9}
+    targetInfo.regSets[0].calleeSavedIndex = {3, 5, 12, 13, 14, 15}; // {rbx, rbp, r12, ..., r15}
+    targetInfo.regSets[0].scratchIndex = {0, 1, 2}; // {rax, rcx, rdx}
+    targetInfo.regSets[0].retIndex = 0; // rax
+    targetInfo.regSets[1].types = RegisterSet::TYPE_FLOAT | RegisterSet::TYPE_VECTOR;
+    targetInfo.regSets[1].valueIndex = {8, 9, 10, 11, 12, 13, 14, 15}; // {xmm8, ..., xmm15}
+    targetInfo.regSets[1].argIndex = {0, 1, 2, 3, 4, 5, 6, 7}; // {xmm0, ..., xmm7}
+    targetInfo.regSets[1].calleeSavedIndex = {}; // All XMM registers are volatile
+    targetInfo.regSets[1].retIndex = 0; // xmm0
+    targetInfo.stack.alignment = 16;
+    targetInfo.stack.shadowSpace = 0;
+    targetInfo.stack.redZone = 128;
+    targetInfo.sharedArgSlots = false;
 #endif
+
+    // Generate the call trampolines once, so that calls from the host do not emit any code
+    X86Emitter e(this);
+    U64 offsets[TRAMPOLINE_ARGS_COUNT][TRAMPOLINE_RET_COUNT];
+    for (int argsKind = 0; argsKind < TRAMPOLINE_ARGS_COUNT; argsKind++) {
+        for (int retKind = 0; retKind < TRAMPOLINE_RET_COUNT; retKind++) {
+            e.align(16);
+            offsets[argsKind][retKind] = e.getSize();
+            emitTrampoline(e, TrampolineArgs(argsKind), TrampolineRet(retKind));
+        }
+    }
+    auto* code = static_cast<U8*>(codeArena.alloc(e.getSize()));
+    codeArena.write(code, e.getCode(), e.getSize());
+    for (int argsKind = 0; argsKind < TRAMPOLINE_ARGS_COUNT; argsKind++) {
+        for (int retKind = 0; retKind < TRAMPOLINE_RET_COUNT; retKind++) {
+            trampolines[argsKind][retKind] = reinterpret_cast<Trampoline>(code + offsets[argsKind][retKind]);
+        }
+    }
+}
+
+void X86Compiler::emitTrampoline(X86Emitter& e, TrampolineArgs argsKind, TrampolineRet retKind) const {
+    const auto& intArgs = targetInfo.regSets[0].argIndex;
+    const auto& xmmArgs = targetInfo.regSets[1].argIndex;
+
+    // RBX holds the guest state and R12 the trampoline data during the call (both are callee-saved).
+    // After pushing them, RSP is misaligned by 8 bytes, which are reserved along with the shadow space.
+    e.push(e.rbx);
+    e.push(e.r12);
+    e.sub(e.rsp, targetInfo.stack.shadowSpace + 8);
+    e.mov(e.rbx, Xbyak::Reg64(intArgs[0]));
+    e.mov(e.rax, Xbyak::Reg64(intArgs[1]));
+    e.mov(e.r12, Xbyak::Reg64(intArgs[2]));
+
+    // Load the arguments (the trampoline parameters are overwritten at this point)
+    if (argsKind == TRAMPOLINE_ARGS_ANY) {
+        for (size_t i = 0; i < xmmArgs.size() && i < X86_TRAMPOLINE_MAX_ARGS; i++) {
+            e.vmovups(Xbyak::Xmm(xmmArgs[i]), e.ptr[e.r12 + offsetof(X86TrampolineData, xmmArgs) + 16 * i]);
+        }
+    }
+    if (argsKind != TRAMPOLINE_ARGS_NONE) {
+        for (size_t i = 0; i < intArgs.size() && i < X86_TRAMPOLINE_MAX_ARGS; i++) {
+            e.mov(Xbyak::Reg64(intArgs[i]), e.qword[e.r12 + offsetof(X86TrampolineData, intArgs) + 8 * i]);
+        }
+    }
+    e.call(e.rax);
+
+    // Store the return value
+    if (retKind == TRAMPOLINE_RET_INT) {
+        e.mov(e.qword[e.r12 + offsetof(X86TrampolineData, result)], Xbyak::Reg64(targetInfo.regSets[0].retIndex));
+    }
+    if (retKind == TRAMPOLINE_RET_XMM) {
+        e.vmovups(e.ptr[e.r12 + offsetof(X86TrampolineData, result)], Xbyak::Xmm(targetInfo.regSets[1].retIndex));
+    }
+    e.add(e.rsp, targetInfo.stack.shadowSpace + 8);
+    e.pop(e.r12);
+    e.pop(e.rbx);
+    e.ret();
+}
+
+void X86Compiler::computeFrame(const Function* function, X86Frame& frame) const {
+    const auto& stack = targetInfo.stack;
+
+    frame.savedRegs.clear();
+    frame.savedXmms.clear();
+    frame.isLeaf = true;
+    frame.localsSize = function->localsSize;
+
+    // Find callee-saved registers clobbered by the function
+    for (const auto& block : function->blocks) {
+        for (const auto& instr : block->instructions) {
+            if (instr->opcode == OPCODE_CALL || instr->opcode == OPCODE_CALLCOND) {
+                frame.isLeaf = false;
+            }
+            if (opcodeInfo[instr->opcode].getSignatureDest() != OPCODE_SIG_TYPE_V) {
+                continue;
+            }
+            const Value* value = instr->dest;
+            for (const auto& regSet : targetInfo.regSets) {
+                if (regSet.types & RegisterSet::TYPE_INT && value->isTypeInteger()) {
+                    if (regSet.isCalleeSaved(value->reg) &&
+                        std::find(frame.savedRegs.begin(), frame.savedRegs.end(), value->reg) == frame.savedRegs.end()) {
+                        frame.savedRegs.push_back(value->reg);
+                    }
+                    break;
+                }
+                if (regSet.types & RegisterSet::TYPE_FLOAT && value->isTypeFloat() ||
+                    regSet.types & RegisterSet::TYPE_VECTOR && value->isTypeVector()) {
+                    if (regSet.isCalleeSaved(value->reg) &&
+                        std::find(frame.savedXmms.begin(), frame.savedXmms.end(), value->reg) == frame.savedXmms.end()) {
+                        frame.savedXmms.push_back(value->reg);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // Leaf functions can keep their locals in the red zone without touching RSP
+    const U32 xmmSize = 16 * frame.savedXmms.size();
+    if (frame.isLeaf && xmmSize == 0 && frame.localsSize <= stack.redZone) {
+        frame.size = 0;
+        frame.xmmOffset = 0;
+        frame.localsOffset = -S32(frame.localsSize);
+        return;
+    }
+
+    // Layout: [shadow space] [saved XMM registers] [locals] [padding] [saved registers] [return address]
+    const U32 shadowSpace = frame.isLeaf ? 0 : stack.shadowSpace;
+    frame.xmmOffset = shadowSpace;
+    frame.localsOffset = shadowSpace + xmmSize;
+    frame.size = shadowSpace + xmmSize + frame.localsSize;
+
+    // Keep RSP aligned after the return address and the pushed registers
+    const U32 pushSize = 8 * (frame.savedRegs.size() + 1);
+    const U32 misalignment = (pushSize + frame.size) % stack.alignment;
+    if (misalignment) {
+        frame.size += stack.alignment - misalignment;
+    }
+}
+
+void X86Compiler::emitProlog(X86Emitter& e, const X86Frame& frame) const {
+    for (const auto& index : frame.savedRegs) {
+        e.push(Xbyak::Reg64(index));
+    }
+    if (frame.size) {
+        e.sub(e.rsp, frame.size);
+    }
+    for (size_t i = 0; i < frame.savedXmms.size(); i++) {
+        e.vmovaps(e.ptr[e.rsp + frame.xmmOffset + 16 * i], Xbyak::Xmm(frame.savedXmms[i]));
+    }
+}
+
+void X86Compiler::emitEpilog(X86Emitter& e, const X86Frame& frame) const {
+    for (size_t i = 0; i < frame.savedXmms.size(); i++) {
+        e.vmovaps(Xbyak::Xmm(frame.savedXmms[i]), e.ptr[e.rsp + frame.xmmOffset + 16 * i]);
+    }
+    if (frame.size) {
+        e.add(e.rsp, frame.size);
+    }
+    for (auto it = frame.savedRegs.rbegin(); it != frame.savedRegs.rend(); it++) {
+        e.pop(Xbyak::Reg64(*it));
+    }
+    e.ret();
 }
 
 bool X86Compiler::compile(Block* block) {
-    // TODO
-    logger.warning(LOG_CPU, "Unimplemented compiler method");
-    return false;
+    // Blocks are compiled along with the function holding them, which provides their stack frame.
+    // Frontends translating single blocks wrap them in a function whose other blocks are its exits.
+    if (!(block->flags & BLOCK_IS_ENTRY)) {
+        logger.error(LOG_CPU, "Only entry blocks can be compiled");
+        return false;
+    }
+    return compile(block->parent);
 }
 
 bool X86Compiler::compile(Function* function) {
+    if (function->blocks.empty()) {
+        logger.error(LOG_CPU, "Cannot compile function without definition");
+        return false;
+    }
+
     // Set flags
     function->flags |= FUNCTION_IS_COMPILING;
 
-    // Run compiler passes
-    optimize(function);
+    // Run compiler passes, any of which can reject the function (e.g. if registers cannot be allocated)
+    if (!optimize(function)) {
+        logger.error(LOG_CPU, "Cannot compile function");
+        function->flags &= ~FUNCTION_IS_COMPILING;
+        return false;
+    }
 
     // Initialize emitter
     X86Emitter e(this);
@@ -78,9 +261,12 @@ bool X86Compiler::compile(Function* function) {
     logger.error(LOG_CPU, "Unsupported variant of the x86 architecture");
 #endif
 
+    // Compute stack frame
+    computeFrame(function, e.frame);
+
     // Prolog block
     e.L(e.labelProlog);
-    e.sub(e.rsp, 0x28);
+    emitProlog(e, e.frame);
     if (!(function->blocks[0]->flags & BLOCK_IS_ENTRY)) {
         e.jmp(e.labelEntry, e.T_NEAR);
     }
@@ -91,7 +277,8 @@ bool X86Compiler::compile(Function* function) {
     }
 
     // Iterate over blocks
-    for (const auto& block : function->blocks) {
+    for (size_t index = 0; index < function->blocks.size(); index++) {
+        const Block* block = function->blocks[index];
         e.L(e.labels[block]);
         if (block->flags & BLOCK_IS_ENTRY) {
             e.L(e.labelEntry);
@@ -102,20 +289,26 @@ bool X86Compiler::compile(Function* function) {
                 return false;
             }
         }
+        // Phi copies of the edge falling through into the next block
+        if (index + 1 < function->blocks.size()) {
+            const Instruction* last = block->instructions.empty() ? nullptr : block->instructions.back();
+            if (!last || (last->opcode != OPCODE_BR && last->opcode != OPCODE_RET)) {
+                e.emitPhiCopies(block, function->blocks[index + 1]);
+            }
+        }
     }
 
     // Epilog block
     e.L(e.labelEpilog);
-    e.add(e.rsp, 0x28);
-    e.ret();
+    emitEpilog(e, e.frame);
+    e.emitEdgeStubs();
+    e.emitCallStubs();
 
     // Copy emitted code
-    const auto codeSize = e.getSize();
-    function->nativeSize = codeSize;
-    function->nativeAddress = allocRWXMemory(codeSize);
-    memcpy(function->nativeAddress, e.getCode(), codeSize);
-
-    function->flags |= FUNCTION_IS_COMPILED;
+    if (!install(function, e.getCode(), e.getSize(), e.callSites)) {
+        return false;
+    }
+    function->nativeImmediates = e.immediates;
     return true;
 }
 
@@ -129,36 +322,95 @@ bool X86Compiler::compile(Module* module) {
     return true;
 }
 
-bool X86Compiler::call(hir::Function* function, void* state, const std::vector<hir::Value*>& args) {
+bool X86Compiler::compileInlineCache(InlineCache& cache) {
+    // The stub runs in place of a function, so it can only clobber RAX and the flags before jumping to the target
+    X86Emitter e(this);
+    e.mov(e.eax, e.dword[e.rbx + cache.contextOffset]);
+    for (U32 index = 0; index < cache.count; index++) {
+        Xbyak::Label labelNext;
+        e.cmp(e.eax, cache.targets[index]);
+        e.jne(labelNext);
+        e.mov(e.rax, reinterpret_cast<size_t>(&cache.hits[index]));
+        e.inc(e.qword[e.rax]);
+        e.mov(e.rax, reinterpret_cast<size_t>(cache.functions[index]));
+        e.jmp(e.qword[e.rax + offsetof(hir::Function, nativeAddress)]);
+        e.L(labelNext);
+    }
+    e.mov(e.rax, reinterpret_cast<size_t>(cache.missAddress));
+    e.jmp(e.rax);
+
+    return install(cache.function, e.getCode(), e.getSize());
+}
+
+U64 X86Compiler::getTargetId() const {
+    // Generated code only runs on hosts providing the same extensions
+    U64 id = 0;
+#if defined(NUCLEUS_ARCH_X86_32BITS)
+    id |= 1ULL << 32;
+#elif defined(NUCLEUS_ARCH_X86_64BITS)
+    id |= 2ULL << 32;
+#endif
+    id |= settings.isJIT ? (1ULL << 40) : 0;
+    id |= extensions;
+    return id;
+}
+
+bool X86Compiler::patchCall(void* writable, const void* address, const void* target) {
+    // Rewrite the displacement of the near call (E8 rel32)
+    const S64 disp = static_cast<const U8*>(target) - (static_cast<const U8*>(address) + 5);
+    if (disp != S32(disp)) {
+        return false;
+    }
+    *reinterpret_cast<volatile U32*>(static_cast<U8*>(writable) + 1) = U32(S32(disp));
+    return true;
+}
+
+bool X86Compiler::call(hir::Function* function, void* state, const std::vector<hir::Value*>& args, V128* result) {
     if (!(function->flags & FUNCTION_IS_COMPILED)) {
         logger.error(LOG_CPU, "Function is not ready");
         return false;
     }
 
-    // Generate code for caller
-    X86Emitter e(this);
-    e.push(e.rbx);
-    e.push(e.r10);
-    e.push(e.r11);
-    e.push(e.r12);
-    e.push(e.r13);
-    e.push(e.r14);
-    e.push(e.r15);
-    e.mov(e.rbx, reinterpret_cast<size_t>(state));
-    e.mov(e.rax, reinterpret_cast<size_t>(function->nativeAddress));
-    e.call(e.rax);
-    e.pop(e.r15);
-    e.pop(e.r14);
-    e.pop(e.r13);
-    e.pop(e.r12);
-    e.pop(e.r11);
-    e.pop(e.r10);
-    e.pop(e.rbx);
-    e.ret();
+    // Place the arguments in the registers assigned by the ABI, as createFunctionCall does
+    X86TrampolineData data = {};
+    TrampolineArgs argsKind = args.empty() ? TRAMPOLINE_ARGS_NONE : TRAMPOLINE_ARGS_INT;
+    U32 intCount = 0;
+    U32 xmmCount = 0;
+    for (size_t i = 0; i < args.size(); i++) {
+        const Value* arg = args[i];
+        const bool isInt = arg->isTypeInteger();
+        const U32 slot = targetInfo.sharedArgSlots ? U32(i) : (isInt ? intCount++ : xmmCount++);
+        const auto& argIndex = targetInfo.regSets[isInt ? 0 : 1].argIndex;
+        if (slot >= argIndex.size() || slot >= X86_TRAMPOLINE_MAX_ARGS) {
+            logger.error(LOG_CPU, "Too many arguments for a call");
+            return false;
+        }
+        if (isInt) {
+            switch (arg->type) {
+            case TYPE_I8:  data.intArgs[slot] = arg->constant.i8;  break;
+            case TYPE_I16: data.intArgs[slot] = arg->constant.i16; break;
+            case TYPE_I32: data.intArgs[slot] = arg->constant.i32; break;
+            default:       data.intArgs[slot] = arg->constant.i64; break;
+            }
+        } else {
+            data.xmmArgs[slot] = arg->constant.v128;
+            argsKind = TRAMPOLINE_ARGS_ANY;
+        }
+    }
 
-    // Execute caller
-    auto callerFunc = reinterpret_cast<void(*)()>(e.getCode());
-    callerFunc();
+    // Return values are only stored if the caller asked for them
+    TrampolineRet retKind = TRAMPOLINE_RET_VOID;
+    if (result && (function->typeOut == TYPE_I8 || function->typeOut == TYPE_I16 ||
+        function->typeOut == TYPE_I32 || function->typeOut == TYPE_I64)) {
+        retKind = TRAMPOLINE_RET_INT;
+    } else if (result && function->typeOut != TYPE_VOID) {
+        retKind = TRAMPOLINE_RET_XMM;
+    }
+
+    trampolines[argsKind][retKind](state, function->nativeAddress, &data);
+    if (result) {
+        *result = data.result;
+    }
     return true;
 }
 
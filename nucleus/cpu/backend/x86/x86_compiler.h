@@ -14,6 +14,10 @@ namespace cpu {
 namespace backend {
 namespace x86 {
 
+// Forward declarations
+class X86Emitter;
+struct X86Frame;
+
 enum X86Extension {
     AVX   = (1 << 0),  // Advanced Vector Extensions
     AVX2  = (1 << 1),  // Advanced Vector Extensions 2
@@ -22,11 +26,75 @@ enum X86Extension {
     MOVBE = (1 << 4),  // Move Data After Swapping Bytes
 };
 
+// Maximum number of register arguments of each class passed by the call trampolines
+constexpr U32 X86_TRAMPOLINE_MAX_ARGS = 8;
+
+/**
+ * Arguments and return value exchanged with the guest code through a call trampoline.
+ * Arguments are stored at the index of the argument register assigned to them by the ABI.
+ */
+struct X86TrampolineData {
+    U64 intArgs[X86_TRAMPOLINE_MAX_ARGS];   // General-purpose register arguments
+    V128 xmmArgs[X86_TRAMPOLINE_MAX_ARGS];  // XMM register arguments (floats in the lower lanes)
+    V128 result;                            // RAX or XMM0 after the call, depending on the trampoline
+};
+
 class X86Compiler : public Compiler {
 private:
+    // Classes of arguments loaded by a call trampoline
+    enum TrampolineArgs {
+        TRAMPOLINE_ARGS_NONE,  // No arguments
+        TRAMPOLINE_ARGS_INT,   // General-purpose registers only
+        TRAMPOLINE_ARGS_ANY,   // General-purpose and XMM registers
+        TRAMPOLINE_ARGS_COUNT,
+    };
+
+    // Classes of return values stored by a call trampoline
+    enum TrampolineRet {
+        TRAMPOLINE_RET_VOID,  // Nothing
+        TRAMPOLINE_RET_INT,   // RAX
+        TRAMPOLINE_RET_XMM,   // XMM0
+        TRAMPOLINE_RET_COUNT,
+    };
+
+    // Host-to-guest call trampoline: sets the guest state, loads the arguments and calls the native code
+    using Trampoline = void(*)(void* state, const void* code, X86TrampolineData* data);
+
+    // Trampolines generated at initialization, specialized by argument and return class
+    Trampoline trampolines[TRAMPOLINE_ARGS_COUNT][TRAMPOLINE_RET_COUNT];
+
     // Initialize compiler
     void init();
 
+    /**
+     * Emit a host-to-guest call trampoline
+     * @param[in]  e         Emitter
+     * @param[in]  argsKind  Registers to be loaded from X86TrampolineData before the call
+     * @param[in]  retKind   Register to be stored into X86TrampolineData after the call
+     */
+    void emitTrampoline(X86Emitter& e, TrampolineArgs argsKind, TrampolineRet retKind) const;
+
+    /**
+     * Compute the stack frame layout of a function according to the target ABI
+     * @param[in]  function  Function whose registers have already been allocated
+     * @param[out] frame     Frame layout to be used by the prolog and epilog
+     */
+    void computeFrame(const hir::Function* function, X86Frame& frame) const;
+
+    /**
+     * Emit the prolog of a function, saving the callee-saved registers it clobbers
+     * @param[in]  e      Emitter
+     * @param[in]  frame  Frame layout of the function
+     */
+    void emitProlog(X86Emitter& e, const X86Frame& frame) const;
+
+    /**
+     * Emit the epilog of a function, restoring the callee-saved registers it clobbers
+     * @param[in]  e      Emitter
+     * @param[in]  frame  Frame layout of the function
+     */
+    void emitEpilog(X86Emitter& e, const X86Frame& frame) const;
+
 public:
     // Available x86 extensions
     U32 extensions;
@@ -38,8 +106,13 @@ public:
     virtual bool compile(hir::Block* block) override;
     virtual bool compile(hir::Function* function) override;
     virtual bool compile(hir::Module* module) override;
+    virtual bool compileInlineCache(InlineCache& cache) override;
+
+    virtual bool call(hir::Function* function, void* state, const std::vector<hir::Value*>& args = {}, V128* result = nullptr) override;
+
+    virtual U64 getTargetId() const override;
 
-    virtual bool call(hir::Function* function, void* state, const std::vector<hir::Value*>& args = {}) override;
+    virtual bool patchCall(void* writable, const void* address, const void* target) override;
 };
 
 }  // namespace x86
@@ -4,7 +4,12 @@
  */
 
 #include "x86_emitter.h"
+#include "nucleus/assert.h"
 #include "nucleus/cpu/backend/x86/x86_compiler.h"
+#include "nucleus/cpu/backend/x86/x86_constants.h"
+#include "nucleus/cpu/hir/instruction.h"
+
+#include <algorithm>
 
 namespace cpu {
 namespace backend {
@@ -28,6 +33,144 @@ const Settings& X86Emitter::settings() const {
     return compiler->settings;
 }
 
+void X86Emitter::mov(const Xbyak::Operand& op, size_t imm) {
+    const size_t start = getSize();
+    CodeGenerator::mov(op, imm);
+
+    // Only the encoding REX.W + B8+r + imm64 takes 10 bytes when moving to a register
+    if (op.isREG(64) && getSize() - start == 10) {
+        immediates.push_back(U32(getSize() - 8));
+    }
+}
+
+void X86Emitter::callLinkable(const hir::Function* target) {
+    // Align the displacement, so that threads running the call see either the old or the new one while patching it
+    while ((getSize() + 1) % 4) {
+        nop();
+    }
+    callSites.push_back({ target, U32(getSize()), 0 });
+    db(0xE8);
+    dd(0);
+}
+
+void X86Emitter::emitCallStubs() {
+    for (auto& site : callSites) {
+        site.stub = U32(getSize());
+        rewrite(site.offset + 1, site.stub - (site.offset + 5), 4);
+        mov(rax, reinterpret_cast<size_t>(site.target));
+        jmp(qword[rax + offsetof(hir::Function, nativeAddress)]);
+    }
+}
+
+bool X86Emitter::hasPhiCopies(const hir::Block* pred, const hir::Block* succ) const {
+    for (const auto& i : succ->instructions) {
+        if (i->opcode != hir::OPCODE_PHI) {
+            break;
+        }
+        if (i->src2.block == pred) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Register-to-register copy, with register indices of the same register file
+struct RegCopy {
+    int dest;
+    int src;
+};
+
+template <typename MoveFunc>
+static void emitParallelCopies(std::vector<RegCopy>& copies, int temp, MoveFunc move) {
+    while (!copies.empty()) {
+        // Emit a copy whose destination is not read by any pending copy
+        auto ready = std::find_if(copies.begin(), copies.end(), [&](const RegCopy& copy) {
+            return std::none_of(copies.begin(), copies.end(), [&](const RegCopy& other) {
+                return other.src == copy.dest;
+            });
+        });
+        if (ready != copies.end()) {
+            move(ready->dest, ready->src);
+            copies.erase(ready);
+            continue;
+        }
+        // Only cycles are left: save one destination in the temporary register to break its cycle
+        const int dest = copies.front().dest;
+        move(temp, dest);
+        for (auto& copy : copies) {
+            if (copy.src == dest) {
+                copy.src = temp;
+            }
+        }
+    }
+}
+
+void X86Emitter::emitPhiCopies(const hir::Block* pred, const hir::Block* succ) {
+    std::vector<RegCopy> intCopies;
+    std::vector<RegCopy> xmmCopies;
+    std::vector<const hir::Instruction*> constCopies;
+    for (const auto& i : succ->instructions) {
+        if (i->opcode != hir::OPCODE_PHI) {
+            break;
+        }
+        if (i->src2.block != pred) {
+            continue;
+        }
+        const hir::Value* src = i->src1.value;
+        const hir::Value* dest = i->dest;
+        if (src->isConstant()) {
+            constCopies.push_back(i);
+        } else if (src->reg != dest->reg) {
+            auto& copies = dest->isTypeInteger() ? intCopies : xmmCopies;
+            copies.push_back({ dest->reg, src->reg });
+        }
+    }
+
+    // Registers RAX and XMM0 are never allocated to values
+    emitParallelCopies(intCopies, rax.getIdx(), [&](int dest, int src) {
+        mov(Xbyak::Reg64(dest), Xbyak::Reg64(src));
+    });
+    emitParallelCopies(xmmCopies, xmm0.getIdx(), [&](int dest, int src) {
+        vmovaps(Xbyak::Xmm(dest), Xbyak::Xmm(src));
+    });
+
+    // Constants do not read any register, so they are materialized last
+    for (const auto& i : constCopies) {
+        const hir::Value* src = i->src1.value;
+        const int dest = i->dest->reg;
+        switch (src->type) {
+        case hir::TYPE_I8:   mov(Xbyak::Reg32(dest), U8(src->constant.i8));    break;
+        case hir::TYPE_I16:  mov(Xbyak::Reg32(dest), U16(src->constant.i16));  break;
+        case hir::TYPE_I32:  mov(Xbyak::Reg32(dest), U32(src->constant.i32));  break;
+        case hir::TYPE_I64:  mov(Xbyak::Reg64(dest), size_t(src->constant.i64)); break;
+        case hir::TYPE_F32:  getXmmConstant(*this, Xbyak::Xmm(dest), src->constant.f32);  break;
+        case hir::TYPE_F64:  getXmmConstant(*this, Xbyak::Xmm(dest), src->constant.f64);  break;
+        case hir::TYPE_V128: getXmmConstant(*this, Xbyak::Xmm(dest), src->constant.v128); break;
+        default:
+            assert_always("Unimplemented case");
+        }
+    }
+}
+
+const Xbyak::Label& X86Emitter::getEdgeLabel(const hir::Block* pred, const hir::Block* succ) {
+    if (!hasPhiCopies(pred, succ)) {
+        return labels[succ];
+    }
+    edgeStubs.emplace_back();
+    auto& stub = edgeStubs.back();
+    stub.pred = pred;
+    stub.succ = succ;
+    return stub.label;
+}
+
+void X86Emitter::emitEdgeStubs() {
+    for (auto& stub : edgeStubs) {
+        L(stub.label);
+        emitPhiCopies(stub.pred, stub.succ);
+        jmp(labels[stub.succ], T_NEAR);
+    }
+}
+
 }  // namespace x86
 }  // namespace backend
 }  // namespace cpu
@@ -7,13 +7,16 @@
 
 #include "nucleus/common.h"
 #include "nucleus/cpu/hir/block.h"
+#include "nucleus/cpu/hir/function.h"
 #include "nucleus/cpu/backend/settings.h"
 
 // Xbyak dependency
 #define XBYAK_NO_OP_NAMES
 #include "externals/xbyak/xbyak.h"
 
+#include <list>
 #include <unordered_map>
+#include <vector>
 
 namespace cpu {
 namespace backend {
@@ -27,6 +30,17 @@ enum X86Mode {
     X86_MODE_64BITS = (1 << 1),
 };
 
+struct X86Frame {
+    std::vector<int> savedRegs;  // Callee-saved general-purpose registers clobbered by the function
+    std::vector<int> savedXmms;  // Callee-saved XMM registers clobbered by the function
+    bool isLeaf;                 // Function does not call any other function
+
+    U32 size;                    // Bytes subtracted from RSP after pushing the saved registers
+    U32 xmmOffset;               // Offset from RSP of the XMM register save area
+    S32 localsOffset;            // Offset from RSP of the local storage area (negative if placed in the red zone)
+    U32 localsSize;              // Size of the local storage area
+};
+
 class X86Emitter : public Xbyak::CodeGenerator {
 private:
     // Available x86 extensions
@@ -42,6 +56,23 @@ public:
     Xbyak::Label labelProlog;
     Xbyak::Label labelEpilog;
 
+    // Stack frame of the function being emitted
+    X86Frame frame;
+
+    // Offsets of the 64-bit immediates emitted so far
+    std::vector<U32> immediates;
+
+    // Linkable calls emitted so far
+    std::vector<hir::NativeCallSite> callSites;
+
+    // Control flow edges whose phi copies are emitted out of line
+    struct EdgeStub {
+        Xbyak::Label label;
+        const hir::Block* pred;
+        const hir::Block* succ;
+    };
+    std::list<EdgeStub> edgeStubs;
+
     // Constructor
     X86Emitter(const X86Compiler* compiler);
     X86Emitter(const X86Compiler* compiler, void* address, U64 size);
@@ -57,6 +88,53 @@ public:
      * @return Compiler settings member
      */
     const Settings& settings() const;
+
+    /**
+     * Move an immediate, keeping track of the 64-bit immediates since they might
+     * hold host addresses that need to be relocated
+     * @param[in]  op   Destination operand
+     * @param[in]  imm  Immediate value
+     */
+    using Xbyak::CodeGenerator::mov;
+    void mov(const Xbyak::Operand& op, size_t imm);
+
+    /**
+     * Call a function through a near call that can be linked to its native code later on.
+     * Until then, the call reaches a stub that jumps to Function::nativeAddress.
+     * @param[in]  target  Function to be called
+     */
+    void callLinkable(const hir::Function* target);
+
+    // Emit the stubs of the linkable calls, once the code of the function is complete
+    void emitCallStubs();
+
+    /**
+     * Check whether the phi nodes of a block have incoming values from a predecessor
+     * @param[in]  pred  Predecessor block
+     * @param[in]  succ  Successor block
+     * @return           True if any copy is required when taking the edge
+     */
+    bool hasPhiCopies(const hir::Block* pred, const hir::Block* succ) const;
+
+    /**
+     * Copy the incoming values from a predecessor into the phi nodes of a block. The copies
+     * happen in parallel: registers read by a copy are overwritten only after being read.
+     * @param[in]  pred  Predecessor block
+     * @param[in]  succ  Successor block
+     */
+    void emitPhiCopies(const hir::Block* pred, const hir::Block* succ);
+
+    /**
+     * Get the label to jump to for a conditional branch, which is an out of line stub
+     * performing the phi copies if the edge requires any
+     * @param[in]  pred  Block containing the branch
+     * @param[in]  succ  Target block
+     * @return           Label of the target block or of the stub
+     */
+    const Xbyak::Label& getEdgeLabel(const hir::Block* pred, const hir::Block* succ);
+
+    // Emit the stubs of the edges requiring phi copies, once the code of the function is complete
+    void emitEdgeStubs();
 };
 
 }  // namespace x86
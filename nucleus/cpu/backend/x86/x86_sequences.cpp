@@ -11,7 +11,7 @@
 #include "nucleus/cpu/backend/x86/x86_emitter.h"
 #include "nucleus/logger/logger.h"
 
-#include <unordered_map>
+#include <cstring>
 
 namespace cpu {
 namespace backend {
@@ -907,6 +907,70 @@ struct SHRA_I64 : Sequence<SHRA_I64, I<OPCODE_SHRA, I64Op, I64Op, I8Op>> {
     }
 };
 
+/**
+ * Opcode: ROL, ROR
+ */
+// Rotate to right by an immediate with BMI2's rorx, which needs no fixed registers
+template <typename RegType>
+bool emitRotateRightImm(X86Emitter& e, const RegType& dest, const RegType& src, U8 amount) {
+    return false;
+}
+bool emitRotateRightImm(X86Emitter& e, const Xbyak::Reg32& dest, const Xbyak::Reg32& src, U8 amount) {
+    if (!e.isExtensionAvailable(X86Extension::BMI2)) {
+        return false;
+    }
+    e.rorx(dest, src, amount);
+    return true;
+}
+bool emitRotateRightImm(X86Emitter& e, const Xbyak::Reg64& dest, const Xbyak::Reg64& src, U8 amount) {
+    if (!e.isExtensionAvailable(X86Extension::BMI2)) {
+        return false;
+    }
+    e.rorx(dest, src, amount);
+    return true;
+}
+
+template <typename S, Opcode O, typename T>
+struct RotateSequence : Sequence<S, I<O, T, T, I8Op>> {
+    static void emit(X86Emitter& e, I<O, T, T, I8Op>& i) {
+        // Rotations to left by n bits are rotations to right by (bits - n) bits
+        if (!i.src1.isConstant && i.src2.isConstant) {
+            const U32 bits = i.dest.reg.getBit();
+            const U32 amount = U8(i.src2.constant()) % bits;
+            const U32 right = (O == OPCODE_ROL) ? (bits - amount) % bits : amount;
+            if (emitRotateRightImm(e, i.dest.reg, i.src1.reg, right)) {
+                return;
+            }
+        }
+        Sequence<S, I<O, T, T, I8Op>>::emitAssociativeBinaryOp(e, i,
+            [](X86Emitter& e, auto dest, auto srcReg) {
+                e.mov(e.cl, srcReg);
+                if (O == OPCODE_ROL) {
+                    e.rol(dest, e.cl);
+                } else {
+                    e.ror(dest, e.cl);
+                }
+                // TODO: Restore cl
+            },
+            [](X86Emitter& e, auto dest, auto srcConst) {
+                if (O == OPCODE_ROL) {
+                    e.rol(dest, srcConst);
+                } else {
+                    e.ror(dest, srcConst);
+                }
+            }
+        );
+    }
+};
+struct ROL_I8 : RotateSequence<ROL_I8, OPCODE_ROL, I8Op> {};
+struct ROL_I16 : RotateSequence<ROL_I16, OPCODE_ROL, I16Op> {};
+struct ROL_I32 : RotateSequence<ROL_I32, OPCODE_ROL, I32Op> {};
+struct ROL_I64 : RotateSequence<ROL_I64, OPCODE_ROL, I64Op> {};
+struct ROR_I8 : RotateSequence<ROR_I8, OPCODE_ROR, I8Op> {};
+struct ROR_I16 : RotateSequence<ROR_I16, OPCODE_ROR, I16Op> {};
+struct ROR_I32 : RotateSequence<ROR_I32, OPCODE_ROR, I32Op> {};
+struct ROR_I64 : RotateSequence<ROR_I64, OPCODE_ROR, I64Op> {};
+
 /**
  * Opcode: ZEXT
  */
@@ -1371,6 +1435,50 @@ struct STORE_V128 : Sequence<STORE_V128, I<OPCODE_STORE, VoidOp, PtrOp, V128Op>>
     }
 };
 
+/**
+ * Opcode: CMPXCHG
+ */
+// The expected value goes in the accumulator, the desired value in RCX and constant addresses
+// in RDX. These are the scratch registers of the target, which the register allocator keeps free
+// of live values at instructions with OPCODE_FLAG_CLOBBER.
+template <typename T, typename RegType>
+void emitCmpXchg(X86Emitter& e, T& i, const RegType& expected, const RegType& desired) {
+    Xbyak::Reg64 addr = e.rdx;
+    if (i.src1.isConstant) {
+        e.mov(addr, U64(i.src1.value->constant.i64));
+    } else {
+        addr = i.src1.reg;
+    }
+    if (i.src2.isConstant) {
+        e.mov(expected, i.src2.constant());
+    } else {
+        e.mov(expected, i.src2);
+    }
+    if (i.src3.isConstant) {
+        e.mov(desired, i.src3.constant());
+    } else {
+        e.mov(desired, i.src3);
+    }
+    if (i.instr->flags & ENDIAN_BIG) {
+        e.bswap(expected);
+        e.bswap(desired);
+    }
+    e.lock();
+    e.cmpxchg(e.ptr[addr], desired);
+    e.setz(i.dest);
+}
+
+struct CMPXCHG_I32 : Sequence<CMPXCHG_I32, I<OPCODE_CMPXCHG, I8Op, PtrOp, I32Op, I32Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitCmpXchg(e, i, e.eax, e.ecx);
+    }
+};
+struct CMPXCHG_I64 : Sequence<CMPXCHG_I64, I<OPCODE_CMPXCHG, I8Op, PtrOp, I64Op, I64Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitCmpXchg(e, i, e.rax, e.rcx);
+    }
+};
+
 /**
  * Opcode: CTXLOAD
  */
@@ -1492,6 +1600,98 @@ struct CTXSTORE_V128 : Sequence<CTXSTORE_V128, I<OPCODE_CTXSTORE, VoidOp, Immedi
     }
 };
 
+/**
+ * Opcode: LOCALLOAD
+ */
+struct LOCALLOAD_I8 : Sequence<LOCALLOAD_I8, I<OPCODE_LOCALLOAD, I8Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.mov(i.dest, e.byte[addr]);
+    }
+};
+struct LOCALLOAD_I16 : Sequence<LOCALLOAD_I16, I<OPCODE_LOCALLOAD, I16Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.mov(i.dest, e.word[addr]);
+    }
+};
+struct LOCALLOAD_I32 : Sequence<LOCALLOAD_I32, I<OPCODE_LOCALLOAD, I32Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.mov(i.dest, e.dword[addr]);
+    }
+};
+struct LOCALLOAD_I64 : Sequence<LOCALLOAD_I64, I<OPCODE_LOCALLOAD, I64Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.mov(i.dest, e.qword[addr]);
+    }
+};
+struct LOCALLOAD_F32 : Sequence<LOCALLOAD_F32, I<OPCODE_LOCALLOAD, F32Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.vmovss(i.dest, e.dword[addr]);
+    }
+};
+struct LOCALLOAD_F64 : Sequence<LOCALLOAD_F64, I<OPCODE_LOCALLOAD, F64Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.vmovsd(i.dest, e.qword[addr]);
+    }
+};
+struct LOCALLOAD_V128 : Sequence<LOCALLOAD_V128, I<OPCODE_LOCALLOAD, V128Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.vmovups(i.dest, e.ptr[addr]);
+    }
+};
+
+/**
+ * Opcode: LOCALSTORE
+ */
+struct LOCALSTORE_I8 : Sequence<LOCALSTORE_I8, I<OPCODE_LOCALSTORE, VoidOp, ImmediateOp, I8Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.mov(e.byte[addr], i.src2);
+    }
+};
+struct LOCALSTORE_I16 : Sequence<LOCALSTORE_I16, I<OPCODE_LOCALSTORE, VoidOp, ImmediateOp, I16Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.mov(e.word[addr], i.src2);
+    }
+};
+struct LOCALSTORE_I32 : Sequence<LOCALSTORE_I32, I<OPCODE_LOCALSTORE, VoidOp, ImmediateOp, I32Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.mov(e.dword[addr], i.src2);
+    }
+};
+struct LOCALSTORE_I64 : Sequence<LOCALSTORE_I64, I<OPCODE_LOCALSTORE, VoidOp, ImmediateOp, I64Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.mov(e.qword[addr], i.src2);
+    }
+};
+struct LOCALSTORE_F32 : Sequence<LOCALSTORE_F32, I<OPCODE_LOCALSTORE, VoidOp, ImmediateOp, F32Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.vmovss(e.dword[addr], i.src2);
+    }
+};
+struct LOCALSTORE_F64 : Sequence<LOCALSTORE_F64, I<OPCODE_LOCALSTORE, VoidOp, ImmediateOp, F64Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.vmovsd(e.qword[addr], i.src2);
+    }
+};
+struct LOCALSTORE_V128 : Sequence<LOCALSTORE_V128, I<OPCODE_LOCALSTORE, VoidOp, ImmediateOp, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        auto addr = e.rsp + (e.frame.localsOffset + S32(i.src1.immediate));
+        e.vmovups(e.ptr[addr], i.src2);
+    }
+};
+
 /**
  * Opcode: MEMFENCE
  */
@@ -1614,6 +1814,39 @@ struct SELECT_F64 : Sequence<SELECT_F64, I<OPCODE_SELECT, F64Op, I8Op, F64Op, F6
 /**
  * Opcode: CMP
  */
+
+// Get the integer comparison used only by the conditional branch right after it, which are emitted
+// together as a cmp+jcc pair (see BRCOND_I8). Returns nullptr if the block does not end in such pair.
+static const Instruction* getFusedCompare(const Block* block) {
+    const auto& instructions = block->instructions;
+
+    // Conditional branches are followed at most by an unconditional one
+    auto it = instructions.rbegin();
+    for (int count = 0; count < 2 && it != instructions.rend(); count++, it++) {
+        if ((*it)->opcode != OPCODE_BRCOND) {
+            continue;
+        }
+        auto prev = std::next(it);
+        if (prev == instructions.rend()) {
+            return nullptr;
+        }
+        const Instruction* cmp = *prev;
+        if (cmp->opcode != OPCODE_CMP || cmp->dest != (*it)->src1.value || cmp->dest->usage != 1) {
+            return nullptr;
+        }
+        switch (cmp->src1.value->type) {
+        case TYPE_I8:
+        case TYPE_I16:
+        case TYPE_I32:
+        case TYPE_I64:
+            return cmp;
+        default:
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
 #define EMIT_COMMUTATIVE_INTEGER_COMPARE(set) \
     emitCompareOp(e, i, [](X86Emitter& e, auto dest, auto lhs, auto rhs, bool inverse) { \
         e.cmp(lhs, rhs); \
@@ -1645,6 +1878,9 @@ struct SELECT_F64 : Sequence<SELECT_F64, I<OPCODE_SELECT, F64Op, I8Op, F64Op, F6
 
 struct CMP_I8 : Sequence<CMP_I8, I<OPCODE_CMP, I8Op, I8Op, I8Op>> {
     static void emit(X86Emitter& e, InstrType& i) {
+        if (getFusedCompare(i.instr->parent) == i.instr) {
+            return;
+        }
         switch (i.instr->flags) {
         case COMPARE_EQ:  EMIT_COMMUTATIVE_INTEGER_COMPARE(sete);          break;
         case COMPARE_NE:  EMIT_COMMUTATIVE_INTEGER_COMPARE(setne);         break;
@@ -1663,6 +1899,9 @@ struct CMP_I8 : Sequence<CMP_I8, I<OPCODE_CMP, I8Op, I8Op, I8Op>> {
 };
 struct CMP_I16 : Sequence<CMP_I16, I<OPCODE_CMP, I8Op, I16Op, I16Op>> {
     static void emit(X86Emitter& e, InstrType& i) {
+        if (getFusedCompare(i.instr->parent) == i.instr) {
+            return;
+        }
         switch (i.instr->flags) {
         case COMPARE_EQ:  EMIT_COMMUTATIVE_INTEGER_COMPARE(sete);          break;
         case COMPARE_NE:  EMIT_COMMUTATIVE_INTEGER_COMPARE(setne);         break;
@@ -1682,6 +1921,9 @@ struct CMP_I16 : Sequence<CMP_I16, I<OPCODE_CMP, I8Op, I16Op, I16Op>> {
 
 struct CMP_I32 : Sequence<CMP_I32, I<OPCODE_CMP, I8Op, I32Op, I32Op>> {
     static void emit(X86Emitter& e, InstrType& i) {
+        if (getFusedCompare(i.instr->parent) == i.instr) {
+            return;
+        }
         switch (i.instr->flags) {
         case COMPARE_EQ:  EMIT_COMMUTATIVE_INTEGER_COMPARE(sete);          break;
         case COMPARE_NE:  EMIT_COMMUTATIVE_INTEGER_COMPARE(setne);         break;
@@ -1701,6 +1943,9 @@ struct CMP_I32 : Sequence<CMP_I32, I<OPCODE_CMP, I8Op, I32Op, I32Op>> {
 
 struct CMP_I64 : Sequence<CMP_I64, I<OPCODE_CMP, I8Op, I64Op, I64Op>> {
     static void emit(X86Emitter& e, InstrType& i) {
+        if (getFusedCompare(i.instr->parent) == i.instr) {
+            return;
+        }
         switch (i.instr->flags) {
         case COMPARE_EQ:  EMIT_COMMUTATIVE_INTEGER_COMPARE(sete);          break;
         case COMPARE_NE:  EMIT_COMMUTATIVE_INTEGER_COMPARE(setne);         break;
@@ -1756,6 +2001,38 @@ struct CMP_F64 : Sequence<CMP_F64, I<OPCODE_CMP, I8Op, F64Op, F64Op>> {
     }
 };
 
+#define EMIT_FUSED_BRANCH(jcc, jccInv) \
+    if (!inverse) { \
+        e.jcc(label, e.T_NEAR); \
+    } else { \
+        e.jccInv(label, e.T_NEAR); \
+    }
+
+// Emit a comparison skipped by its sequence along with the conditional branch using it
+template <typename S>
+static void emitFusedBranch(X86Emitter& e, const Instruction* cmp, const Xbyak::Label& label) {
+    typename S::InstrType i(cmp);
+    const OpcodeFlags flags = cmp->flags;
+    S::emitCompareOp(e, i, [&label, flags](X86Emitter& e, auto dest, auto lhs, auto rhs, bool inverse) {
+        e.cmp(lhs, rhs);
+        switch (flags) {
+        case COMPARE_EQ:  EMIT_FUSED_BRANCH(je,  je);   break;
+        case COMPARE_NE:  EMIT_FUSED_BRANCH(jne, jne);  break;
+        case COMPARE_SLT: EMIT_FUSED_BRANCH(jl,  jg);   break;
+        case COMPARE_SLE: EMIT_FUSED_BRANCH(jle, jge);  break;
+        case COMPARE_SGE: EMIT_FUSED_BRANCH(jge, jle);  break;
+        case COMPARE_SGT: EMIT_FUSED_BRANCH(jg,  jl);   break;
+        case COMPARE_ULT: EMIT_FUSED_BRANCH(jb,  ja);   break;
+        case COMPARE_ULE: EMIT_FUSED_BRANCH(jbe, jae);  break;
+        case COMPARE_UGE: EMIT_FUSED_BRANCH(jae, jbe);  break;
+        case COMPARE_UGT: EMIT_FUSED_BRANCH(ja,  jb);   break;
+        default:
+            assert_always("Unimplemented case");
+        }
+    });
+}
+
+#undef EMIT_FUSED_BRANCH
 #undef EMIT_COMMUTATIVE_INTEGER_COMPARE
 #undef EMIT_ASSOCIATIVE_INTEGER_COMPARE
 #undef EMIT_FLOAT_COMPARE
@@ -1766,6 +2043,7 @@ struct CMP_F64 : Sequence<CMP_F64, I<OPCODE_CMP, I8Op, F64Op, F64Op>> {
 struct BR : Sequence<BR, I<OPCODE_BR, VoidOp, BlockOp>> {
     static void emit(X86Emitter& e, InstrType& i) {
         const Xbyak::Label& label = e.labels[i.src1.block];
+        e.emitPhiCopies(i.instr->parent, i.src1.block);
         e.jmp(label, e.T_NEAR);
     }
 };
@@ -1821,9 +2099,7 @@ struct CALL_VOID : Sequence<CALL_VOID, I<OPCODE_CALL, VoidOp, FunctionOp>> {
             e.call(e.rax);
         } else {
             if (e.settings().isJIT) {
-                e.mov(e.rax, reinterpret_cast<size_t>(target));
-                e.mov(e.rax, e.qword[e.rax + offsetof(hir::Function, nativeAddress)]);
-                e.call(e.rax);
+                e.callLinkable(target);
             } else {
                 e.mov(e.rax, reinterpret_cast<size_t>(target->nativeAddress));
                 e.call(e.rax);
@@ -1839,9 +2115,7 @@ struct CALL_I8 : Sequence<CALL_I8, I<OPCODE_CALL, I8Op, FunctionOp>> {
             e.call(e.rax);
         } else {
             if (e.settings().isJIT) {
-                e.mov(e.rax, reinterpret_cast<size_t>(target));
-                e.mov(e.rax, e.qword[e.rax + offsetof(hir::Function, nativeAddress)]);
-                e.call(e.rax);
+                e.callLinkable(target);
             } else {
                 e.mov(e.rax, reinterpret_cast<size_t>(target->nativeAddress));
                 e.call(e.rax);
@@ -1859,9 +2133,7 @@ struct CALL_I16 : Sequence<CALL_I16, I<OPCODE_CALL, I16Op, FunctionOp>> {
             e.call(e.rax);
         } else {
             if (e.settings().isJIT) {
-                e.mov(e.rax, reinterpret_cast<size_t>(target));
-                e.mov(e.rax, e.qword[e.rax + offsetof(hir::Function, nativeAddress)]);
-                e.call(e.rax);
+                e.callLinkable(target);
             } else {
                 e.mov(e.rax, reinterpret_cast<size_t>(target->nativeAddress));
                 e.call(e.rax);
@@ -1879,9 +2151,7 @@ struct CALL_I32 : Sequence<CALL_I32, I<OPCODE_CALL, I32Op, FunctionOp>> {
             e.call(e.rax);
         } else {
             if (e.settings().isJIT) {
-                e.mov(e.rax, reinterpret_cast<size_t>(target));
-                e.mov(e.rax, e.qword[e.rax + offsetof(hir::Function, nativeAddress)]);
-                e.call(e.rax);
+                e.callLinkable(target);
             } else {
                 e.mov(e.rax, reinterpret_cast<size_t>(target->nativeAddress));
                 e.call(e.rax);
@@ -1899,9 +2169,7 @@ struct CALL_I64 : Sequence<CALL_I64, I<OPCODE_CALL, I64Op, FunctionOp>> {
             e.call(e.rax);
         } else {
             if (e.settings().isJIT) {
-                e.mov(e.rax, reinterpret_cast<size_t>(target));
-                e.mov(e.rax, e.qword[e.rax + offsetof(hir::Function, nativeAddress)]);
-                e.call(e.rax);
+                e.callLinkable(target);
             } else {
                 e.mov(e.rax, reinterpret_cast<size_t>(target->nativeAddress));
                 e.call(e.rax);
@@ -1917,28 +2185,37 @@ struct CALL_I64 : Sequence<CALL_I64, I<OPCODE_CALL, I64Op, FunctionOp>> {
  */
 struct BRCOND_I8 : Sequence<BRCOND_I8, I<OPCODE_BRCOND, VoidOp, I8Op, BlockOp>> {
     static void emit(X86Emitter& e, InstrType& i) {
-        const Xbyak::Label& label = e.labels[i.src2.block];
+        const Xbyak::Label& label = e.getEdgeLabel(i.instr->parent, i.src2.block);
+        const Instruction* cmp = getFusedCompare(i.instr->parent);
+        if (cmp && cmp->dest == i.src1.value) {
+            switch (cmp->src1.value->type) {
+            case TYPE_I8:   emitFusedBranch<CMP_I8>(e, cmp, label);   return;
+            case TYPE_I16:  emitFusedBranch<CMP_I16>(e, cmp, label);  return;
+            case TYPE_I32:  emitFusedBranch<CMP_I32>(e, cmp, label);  return;
+            case TYPE_I64:  emitFusedBranch<CMP_I64>(e, cmp, label);  return;
+            }
+        }
         e.test(i.src1, i.src1);
         e.jnz(label, e.T_NEAR);
     }
 };
 struct BRCOND_I16 : Sequence<BRCOND_I16, I<OPCODE_BRCOND, VoidOp, I16Op, BlockOp>> {
     static void emit(X86Emitter& e, InstrType& i) {
-        const Xbyak::Label& label = e.labels[i.src2.block];
+        const Xbyak::Label& label = e.getEdgeLabel(i.instr->parent, i.src2.block);
         e.test(i.src1, i.src1);
         e.jnz(label, e.T_NEAR);
     }
 };
 struct BRCOND_I32 : Sequence<BRCOND_I32, I<OPCODE_BRCOND, VoidOp, I32Op, BlockOp>> {
     static void emit(X86Emitter& e, InstrType& i) {
-        const Xbyak::Label& label = e.labels[i.src2.block];
+        const Xbyak::Label& label = e.getEdgeLabel(i.instr->parent, i.src2.block);
         e.test(i.src1, i.src1);
         e.jnz(label, e.T_NEAR);
     }
 };
 struct BRCOND_I64 : Sequence<BRCOND_I64, I<OPCODE_BRCOND, VoidOp, I64Op, BlockOp>> {
     static void emit(X86Emitter& e, InstrType& i) {
-        const Xbyak::Label& label = e.labels[i.src2.block];
+        const Xbyak::Label& label = e.getEdgeLabel(i.instr->parent, i.src2.block);
         e.test(i.src1, i.src1);
         e.jnz(label, e.T_NEAR);
     }
@@ -1947,6 +2224,93 @@ struct BRCOND_I64 : Sequence<BRCOND_I64, I<OPCODE_BRCOND, VoidOp, I64Op, BlockOp
 /**
  * Opcode: CALLCOND
  */
+// Branches around the call sequence if the condition is zero
+template <typename InstrType, typename FuncType>
+void emitCallCond(X86Emitter& e, InstrType& i, FuncType saveResult) {
+    const Function* target = i.src2.function;
+    Xbyak::Label skip;
+    if (i.src1.isConstant) {
+        if (i.src1.constant() == 0) {
+            return;
+        }
+    } else {
+        e.test(i.src1, i.src1);
+        e.jz(skip, e.T_NEAR);
+    }
+    if (i.instr->flags & CALL_EXTERN) {
+        e.mov(e.rax, reinterpret_cast<size_t>(target->nativeAddress));
+        e.call(e.rax);
+    } else {
+        if (e.settings().isJIT) {
+            e.callLinkable(target);
+        } else {
+            e.mov(e.rax, reinterpret_cast<size_t>(target->nativeAddress));
+            e.call(e.rax);
+        }
+    }
+    saveResult(e, i);
+    e.L(skip);
+}
+
+struct CALLCOND_VOID : Sequence<CALLCOND_VOID, I<OPCODE_CALLCOND, VoidOp, I8Op, FunctionOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitCallCond(e, i, [](X86Emitter& e, InstrType& i) {});
+    }
+};
+struct CALLCOND_I8 : Sequence<CALLCOND_I8, I<OPCODE_CALLCOND, I8Op, I8Op, FunctionOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitCallCond(e, i, [](X86Emitter& e, InstrType& i) {
+            e.mov(i.dest, e.al);
+        });
+    }
+};
+struct CALLCOND_I16 : Sequence<CALLCOND_I16, I<OPCODE_CALLCOND, I16Op, I8Op, FunctionOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitCallCond(e, i, [](X86Emitter& e, InstrType& i) {
+            e.mov(i.dest, e.ax);
+        });
+    }
+};
+struct CALLCOND_I32 : Sequence<CALLCOND_I32, I<OPCODE_CALLCOND, I32Op, I8Op, FunctionOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitCallCond(e, i, [](X86Emitter& e, InstrType& i) {
+            e.mov(i.dest, e.eax);
+        });
+    }
+};
+struct CALLCOND_I64 : Sequence<CALLCOND_I64, I<OPCODE_CALLCOND, I64Op, I8Op, FunctionOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitCallCond(e, i, [](X86Emitter& e, InstrType& i) {
+            e.mov(i.dest, e.rax);
+        });
+    }
+};
+
+/**
+ * Opcode: PHI
+ */
+// Phi nodes emit no code: X86Emitter::emitPhiCopies resolves them as copies on the incoming edges
+struct PHI_I8 : Sequence<PHI_I8, I<OPCODE_PHI, I8Op, I8Op, BlockOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {}
+};
+struct PHI_I16 : Sequence<PHI_I16, I<OPCODE_PHI, I16Op, I16Op, BlockOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {}
+};
+struct PHI_I32 : Sequence<PHI_I32, I<OPCODE_PHI, I32Op, I32Op, BlockOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {}
+};
+struct PHI_I64 : Sequence<PHI_I64, I<OPCODE_PHI, I64Op, I64Op, BlockOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {}
+};
+struct PHI_F32 : Sequence<PHI_F32, I<OPCODE_PHI, F32Op, F32Op, BlockOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {}
+};
+struct PHI_F64 : Sequence<PHI_F64, I<OPCODE_PHI, F64Op, F64Op, BlockOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {}
+};
+struct PHI_V128 : Sequence<PHI_V128, I<OPCODE_PHI, V128Op, V128Op, BlockOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {}
+};
 
 /**
  * Opcode: RET
@@ -2081,14 +2445,922 @@ struct FNEG_F64 : Sequence<FNEG_F64, I<OPCODE_FNEG, F64Op, F64Op>> {
     }
 };
 
+/**
+ * Vector helpers
+ * Vector sequences load their constant operands in XMM1, XMM2 and XMM3 (first, second and third operand),
+ * while XMM0, XMM3, XMM4 and XMM5 hold temporary values. Destination registers are only written once all
+ * sources have been read, since they might alias them.
+ */
+static U32 getComponentSize(OpcodeFlags flags) {
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I8:   return 1;
+    case COMPONENT_I16:  return 2;
+    case COMPONENT_I32:  return 4;
+    case COMPONENT_I64:  return 8;
+    case COMPONENT_F32:  return 4;
+    case COMPONENT_F64:  return 8;
+    default:
+        assert_always("Unimplemented case");
+        return 0;
+    }
+}
+
+// Get a vector whose integer components, of the given type, are set to the same value
+static V128 getSplatConstant(OpcodeFlags flags, U64 value) {
+    const U32 size = getComponentSize(flags);
+    V128 constant;
+    for (U32 offset = 0; offset < sizeof(V128); offset += size) {
+        std::memcpy(&constant.u8[offset], &value, size);
+    }
+    return constant;
+}
+
+// Get the register of a vector operand, loading constants in the given temporary register
+static Xbyak::Xmm getXmm(X86Emitter& e, const V128Op& op, const Xbyak::Xmm& temp) {
+    if (op.isConstant) {
+        getXmmConstant(e, temp, op.constant());
+        return temp;
+    }
+    return op.reg;
+}
+
+// Replace the components flagged by the sign bits of a mask with the saturated value towards the sign of a reference
+static void emitSaturateI32(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm result, Xbyak::Xmm overflow, Xbyak::Xmm reference) {
+    e.vpsrad(e.xmm5, reference, 31);
+    getXmmConstantCompI32(e, e.xmm3, 0x7FFFFFFF);
+    e.vpxor(e.xmm5, e.xmm5, e.xmm3);
+    e.vblendvps(dest, result, e.xmm5, overflow);
+}
+
+static void emitVectorAdd(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src1, Xbyak::Xmm src2, OpcodeFlags flags) {
+    const bool isSaturated = (flags & VECTOR_SATURATE);
+    const bool isUnsigned = (flags & VECTOR_UNSIGNED);
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I8:
+        if (!isSaturated) {
+            e.vpaddb(dest, src1, src2);
+        } else if (isUnsigned) {
+            e.vpaddusb(dest, src1, src2);
+        } else {
+            e.vpaddsb(dest, src1, src2);
+        }
+        break;
+    case COMPONENT_I16:
+        if (!isSaturated) {
+            e.vpaddw(dest, src1, src2);
+        } else if (isUnsigned) {
+            e.vpaddusw(dest, src1, src2);
+        } else {
+            e.vpaddsw(dest, src1, src2);
+        }
+        break;
+    case COMPONENT_I32:
+        if (!isSaturated) {
+            e.vpaddd(dest, src1, src2);
+        } else if (isUnsigned) {
+            // Overflowed results wrap around below the first operand
+            e.vpaddd(e.xmm0, src1, src2);
+            e.vpmaxud(e.xmm4, src1, e.xmm0);
+            e.vpcmpeqd(e.xmm4, e.xmm4, e.xmm0);
+            e.vpcmpeqd(e.xmm5, e.xmm5, e.xmm5);
+            e.vpxor(e.xmm4, e.xmm4, e.xmm5);
+            e.vpor(dest, e.xmm0, e.xmm4);
+        } else {
+            // Overflow happens if both operands have the same sign and the result has a different one
+            e.vpaddd(e.xmm0, src1, src2);
+            e.vpxor(e.xmm4, src1, e.xmm0);
+            e.vpxor(e.xmm5, src2, e.xmm0);
+            e.vpand(e.xmm4, e.xmm4, e.xmm5);
+            emitSaturateI32(e, dest, e.xmm0, e.xmm4, src1);
+        }
+        break;
+    case COMPONENT_I64:
+        e.vpaddq(dest, src1, src2);
+        break;
+    case COMPONENT_F32:
+        e.vaddps(dest, src1, src2);
+        break;
+    case COMPONENT_F64:
+        e.vaddpd(dest, src1, src2);
+        break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+static void emitVectorSub(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src1, Xbyak::Xmm src2, OpcodeFlags flags) {
+    const bool isSaturated = (flags & VECTOR_SATURATE);
+    const bool isUnsigned = (flags & VECTOR_UNSIGNED);
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I8:
+        if (!isSaturated) {
+            e.vpsubb(dest, src1, src2);
+        } else if (isUnsigned) {
+            e.vpsubusb(dest, src1, src2);
+        } else {
+            e.vpsubsb(dest, src1, src2);
+        }
+        break;
+    case COMPONENT_I16:
+        if (!isSaturated) {
+            e.vpsubw(dest, src1, src2);
+        } else if (isUnsigned) {
+            e.vpsubusw(dest, src1, src2);
+        } else {
+            e.vpsubsw(dest, src1, src2);
+        }
+        break;
+    case COMPONENT_I32:
+        if (!isSaturated) {
+            e.vpsubd(dest, src1, src2);
+        } else if (isUnsigned) {
+            // Clamp the first operand so that the result never goes below zero
+            e.vpmaxud(e.xmm0, src1, src2);
+            e.vpsubd(dest, e.xmm0, src2);
+        } else {
+            // Overflow happens if the operands have different signs and the result has not the sign of the first one
+            e.vpsubd(e.xmm0, src1, src2);
+            e.vpxor(e.xmm4, src1, src2);
+            e.vpxor(e.xmm5, src1, e.xmm0);
+            e.vpand(e.xmm4, e.xmm4, e.xmm5);
+            emitSaturateI32(e, dest, e.xmm0, e.xmm4, src1);
+        }
+        break;
+    case COMPONENT_I64:
+        e.vpsubq(dest, src1, src2);
+        break;
+    case COMPONENT_F32:
+        e.vsubps(dest, src1, src2);
+        break;
+    case COMPONENT_F64:
+        e.vsubpd(dest, src1, src2);
+        break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+static void emitVectorMul(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src1, Xbyak::Xmm src2, OpcodeFlags flags) {
+    // Integer multiplications keep the lower half of the products
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I16:
+        e.vpmullw(dest, src1, src2);
+        break;
+    case COMPONENT_I32:
+        e.vpmulld(dest, src1, src2);
+        break;
+    case COMPONENT_F32:
+        e.vmulps(dest, src1, src2);
+        break;
+    case COMPONENT_F64:
+        e.vmulpd(dest, src1, src2);
+        break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+static void emitVectorAvg(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src1, Xbyak::Xmm src2, OpcodeFlags flags) {
+    // Results are rounded up: (a + b + 1) >> 1
+    const bool isUnsigned = (flags & VECTOR_UNSIGNED);
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I8:
+        if (isUnsigned) {
+            e.vpavgb(dest, src1, src2);
+        } else {
+            // Bias the signed components into the unsigned range
+            getXmmConstant(e, e.xmm0, getSplatConstant(COMPONENT_I8, 0x80));
+            e.vpxor(e.xmm4, src1, e.xmm0);
+            e.vpxor(e.xmm5, src2, e.xmm0);
+            e.vpavgb(e.xmm4, e.xmm4, e.xmm5);
+            e.vpxor(dest, e.xmm4, e.xmm0);
+        }
+        break;
+    case COMPONENT_I16:
+        if (isUnsigned) {
+            e.vpavgw(dest, src1, src2);
+        } else {
+            getXmmConstant(e, e.xmm0, getSplatConstant(COMPONENT_I16, 0x8000));
+            e.vpxor(e.xmm4, src1, e.xmm0);
+            e.vpxor(e.xmm5, src2, e.xmm0);
+            e.vpavgw(e.xmm4, e.xmm4, e.xmm5);
+            e.vpxor(dest, e.xmm4, e.xmm0);
+        }
+        break;
+    case COMPONENT_I32:
+        // Compute (a >> 1) + (b >> 1) + ((a | b) & 1) to avoid overflowing
+        e.vpor(e.xmm0, src1, src2);
+        getXmmConstantCompI32(e, e.xmm3, 1);
+        e.vpand(e.xmm0, e.xmm0, e.xmm3);
+        if (isUnsigned) {
+            e.vpsrld(e.xmm4, src1, 1);
+            e.vpsrld(e.xmm5, src2, 1);
+        } else {
+            e.vpsrad(e.xmm4, src1, 1);
+            e.vpsrad(e.xmm5, src2, 1);
+        }
+        e.vpaddd(e.xmm4, e.xmm4, e.xmm5);
+        e.vpaddd(dest, e.xmm4, e.xmm0);
+        break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+static void emitVectorMinMax(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src1, Xbyak::Xmm src2, OpcodeFlags flags, bool isMax) {
+    const bool isUnsigned = (flags & VECTOR_UNSIGNED);
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I8:
+        if (isMax) {
+            isUnsigned ? e.vpmaxub(dest, src1, src2) : e.vpmaxsb(dest, src1, src2);
+        } else {
+            isUnsigned ? e.vpminub(dest, src1, src2) : e.vpminsb(dest, src1, src2);
+        }
+        break;
+    case COMPONENT_I16:
+        if (isMax) {
+            isUnsigned ? e.vpmaxuw(dest, src1, src2) : e.vpmaxsw(dest, src1, src2);
+        } else {
+            isUnsigned ? e.vpminuw(dest, src1, src2) : e.vpminsw(dest, src1, src2);
+        }
+        break;
+    case COMPONENT_I32:
+        if (isMax) {
+            isUnsigned ? e.vpmaxud(dest, src1, src2) : e.vpmaxsd(dest, src1, src2);
+        } else {
+            isUnsigned ? e.vpminud(dest, src1, src2) : e.vpminsd(dest, src1, src2);
+        }
+        break;
+    case COMPONENT_F32:
+        isMax ? e.vmaxps(dest, src1, src2) : e.vminps(dest, src1, src2);
+        break;
+    case COMPONENT_F64:
+        isMax ? e.vmaxpd(dest, src1, src2) : e.vminpd(dest, src1, src2);
+        break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+static void emitVectorCmpEQ(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src1, Xbyak::Xmm src2, OpcodeFlags flags) {
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I8:   e.vpcmpeqb(dest, src1, src2);  break;
+    case COMPONENT_I16:  e.vpcmpeqw(dest, src1, src2);  break;
+    case COMPONENT_I32:  e.vpcmpeqd(dest, src1, src2);  break;
+    case COMPONENT_I64:  e.vpcmpeqq(dest, src1, src2);  break;
+    case COMPONENT_F32:  e.vcmpeqps(dest, src1, src2);  break;
+    case COMPONENT_F64:  e.vcmpeqpd(dest, src1, src2);  break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+static void emitVectorCmpSGT(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src1, Xbyak::Xmm src2, OpcodeFlags flags) {
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I8:   e.vpcmpgtb(dest, src1, src2);  break;
+    case COMPONENT_I16:  e.vpcmpgtw(dest, src1, src2);  break;
+    case COMPONENT_I32:  e.vpcmpgtd(dest, src1, src2);  break;
+    case COMPONENT_I64:  e.vpcmpgtq(dest, src1, src2);  break;
+    case COMPONENT_F32:  e.vcmpgtps(dest, src1, src2);  break;
+    case COMPONENT_F64:  e.vcmpgtpd(dest, src1, src2);  break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+static void emitVectorCmp(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src1, Xbyak::Xmm src2, OpcodeFlags flags) {
+    const OpcodeFlags comp = (flags & COMPONENT_MASK);
+    const bool isFloat = (comp == COMPONENT_F32 || comp == COMPONENT_F64);
+    const bool isUnsigned = (flags & VECTOR_UNSIGNED) && !isFloat;
+
+    switch (flags & VECTOR_CMP_MASK) {
+    case VECTOR_CMP_EQ:
+        emitVectorCmpEQ(e, dest, src1, src2, flags);
+        break;
+
+    case VECTOR_CMP_GT:
+        if (isUnsigned) {
+            // Flip the sign bits to compare unsigned components as signed ones
+            getXmmConstant(e, e.xmm0, getSplatConstant(comp, 1ULL << (getComponentSize(comp) * 8 - 1)));
+            e.vpxor(e.xmm4, src1, e.xmm0);
+            e.vpxor(e.xmm5, src2, e.xmm0);
+            emitVectorCmpSGT(e, dest, e.xmm4, e.xmm5, flags);
+        } else {
+            emitVectorCmpSGT(e, dest, src1, src2, flags);
+        }
+        break;
+
+    case VECTOR_CMP_GE:
+        if (comp == COMPONENT_F32) {
+            e.vcmpgeps(dest, src1, src2);
+        } else if (comp == COMPONENT_F64) {
+            e.vcmpgepd(dest, src1, src2);
+        } else {
+            // Components are greater or equal if they are the maximum of both
+            emitVectorMinMax(e, e.xmm0, src1, src2, flags, true);
+            emitVectorCmpEQ(e, dest, e.xmm0, src1, flags);
+        }
+        break;
+
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+// Shift the components by the same amount (lower than their width)
+static void emitVectorShiftImm(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src, Opcode opcode, OpcodeFlags flags, U32 amount) {
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I8:
+        // Shift 16-bit components and clear the bits moved across bytes
+        if (opcode == OPCODE_VSHL) {
+            getXmmConstant(e, e.xmm3, getSplatConstant(COMPONENT_I8, U8(0xFF << amount)));
+            e.vpsllw(dest, src, amount);
+            e.vpand(dest, dest, e.xmm3);
+        } else if (opcode == OPCODE_VSHR) {
+            getXmmConstant(e, e.xmm3, getSplatConstant(COMPONENT_I8, U8(0xFF >> amount)));
+            e.vpsrlw(dest, src, amount);
+            e.vpand(dest, dest, e.xmm3);
+        } else {
+            // Compute ((x ^ 0x80) >> n) - (0x80 >> n)
+            getXmmConstant(e, e.xmm3, getSplatConstant(COMPONENT_I8, 0x80));
+            e.vpxor(dest, src, e.xmm3);
+            getXmmConstant(e, e.xmm3, getSplatConstant(COMPONENT_I8, U8(0xFF >> amount)));
+            e.vpsrlw(dest, dest, amount);
+            e.vpand(dest, dest, e.xmm3);
+            getXmmConstant(e, e.xmm3, getSplatConstant(COMPONENT_I8, U8(0x80 >> amount)));
+            e.vpsubb(dest, dest, e.xmm3);
+        }
+        break;
+    case COMPONENT_I16:
+        switch (opcode) {
+        case OPCODE_VSHL:  e.vpsllw(dest, src, amount);  break;
+        case OPCODE_VSHR:  e.vpsrlw(dest, src, amount);  break;
+        default:           e.vpsraw(dest, src, amount);  break;
+        }
+        break;
+    case COMPONENT_I32:
+        switch (opcode) {
+        case OPCODE_VSHL:  e.vpslld(dest, src, amount);  break;
+        case OPCODE_VSHR:  e.vpsrld(dest, src, amount);  break;
+        default:           e.vpsrad(dest, src, amount);  break;
+        }
+        break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+// Shift each component by the amount held in the same component of another vector (modulo their width)
+static void emitVectorShift(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src, Xbyak::Xmm amount, Opcode opcode, OpcodeFlags flags) {
+    const OpcodeFlags comp = (flags & COMPONENT_MASK);
+    if (comp == COMPONENT_I32 && e.isExtensionAvailable(X86Extension::AVX2)) {
+        getXmmConstantCompI32(e, e.xmm0, 31);
+        e.vpand(e.xmm0, amount, e.xmm0);
+        switch (opcode) {
+        case OPCODE_VSHL:  e.vpsllvd(dest, src, e.xmm0);  break;
+        case OPCODE_VSHR:  e.vpsrlvd(dest, src, e.xmm0);  break;
+        default:           e.vpsravd(dest, src, e.xmm0);  break;
+        }
+        return;
+    }
+
+    // Each bit of the amount selects whether the component is shifted by the corresponding power of two
+    U32 amountBits;
+    switch (comp) {
+    case COMPONENT_I8:   amountBits = 3;  break;
+    case COMPONENT_I16:  amountBits = 4;  break;
+    case COMPONENT_I32:  amountBits = 5;  break;
+    default:
+        assert_always("Unimplemented case");
+        return;
+    }
+    e.vmovdqa(e.xmm0, src);
+    for (U32 bit = 0; bit < amountBits; bit++) {
+        // Move the selecting bit into the sign bit of every byte (16-bit components) or component (otherwise)
+        switch (comp) {
+        case COMPONENT_I8:
+            e.vpsllw(e.xmm4, amount, 7 - bit);
+            break;
+        case COMPONENT_I16:
+            e.vpsllw(e.xmm4, amount, 15 - bit);
+            e.vpsraw(e.xmm4, e.xmm4, 15);
+            break;
+        case COMPONENT_I32:
+            e.vpslld(e.xmm4, amount, 31 - bit);
+            break;
+        }
+        emitVectorShiftImm(e, e.xmm5, e.xmm0, opcode, flags, 1 << bit);
+        if (comp == COMPONENT_I32) {
+            e.vblendvps(e.xmm0, e.xmm0, e.xmm5, e.xmm4);
+        } else {
+            e.vpblendvb(e.xmm0, e.xmm0, e.xmm5, e.xmm4);
+        }
+    }
+    e.vmovdqa(dest, e.xmm0);
+}
+
+// Permute the bytes of two vectors: byte i of the result is byte (control[i] & 31) of src2:src1
+static void emitVectorPerm(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src1, Xbyak::Xmm src2, Xbyak::Xmm control) {
+    getXmmConstant(e, e.xmm0, getSplatConstant(COMPONENT_I8, 0x1F));
+    e.vpand(e.xmm3, control, e.xmm0);
+    e.vpshufb(e.xmm4, src1, e.xmm3);
+    e.vpshufb(e.xmm5, src2, e.xmm3);
+    getXmmConstant(e, e.xmm0, getSplatConstant(COMPONENT_I8, 0x0F));
+    e.vpcmpgtb(e.xmm3, e.xmm3, e.xmm0);
+    e.vpblendvb(dest, e.xmm4, e.xmm5, e.xmm3);
+}
+
+/**
+ * Opcode: VADD
+ */
+struct VADD_V128 : Sequence<VADD_V128, I<OPCODE_VADD, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitVectorAdd(e, i.dest, getXmm(e, i.src1, e.xmm1), getXmm(e, i.src2, e.xmm2), i.instr->flags);
+    }
+};
+
+/**
+ * Opcode: VSUB
+ */
+struct VSUB_V128 : Sequence<VSUB_V128, I<OPCODE_VSUB, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitVectorSub(e, i.dest, getXmm(e, i.src1, e.xmm1), getXmm(e, i.src2, e.xmm2), i.instr->flags);
+    }
+};
+
+/**
+ * Opcode: VMUL
+ */
+struct VMUL_V128 : Sequence<VMUL_V128, I<OPCODE_VMUL, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitVectorMul(e, i.dest, getXmm(e, i.src1, e.xmm1), getXmm(e, i.src2, e.xmm2), i.instr->flags);
+    }
+};
+
+/**
+ * Opcode: VAVG
+ */
+struct VAVG_V128 : Sequence<VAVG_V128, I<OPCODE_VAVG, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitVectorAvg(e, i.dest, getXmm(e, i.src1, e.xmm1), getXmm(e, i.src2, e.xmm2), i.instr->flags);
+    }
+};
+
+/**
+ * Opcode: VMIN
+ */
+struct VMIN_V128 : Sequence<VMIN_V128, I<OPCODE_VMIN, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitVectorMinMax(e, i.dest, getXmm(e, i.src1, e.xmm1), getXmm(e, i.src2, e.xmm2), i.instr->flags, false);
+    }
+};
+
+/**
+ * Opcode: VMAX
+ */
+struct VMAX_V128 : Sequence<VMAX_V128, I<OPCODE_VMAX, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitVectorMinMax(e, i.dest, getXmm(e, i.src1, e.xmm1), getXmm(e, i.src2, e.xmm2), i.instr->flags, true);
+    }
+};
+
+/**
+ * Opcode: VCMP
+ */
+struct VCMP_V128 : Sequence<VCMP_V128, I<OPCODE_VCMP, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitVectorCmp(e, i.dest, getXmm(e, i.src1, e.xmm1), getXmm(e, i.src2, e.xmm2), i.instr->flags);
+    }
+};
+
+/**
+ * Opcode: VSHL, VSHR, VSHRA
+ */
+template <typename S, Opcode O>
+struct VectorShiftSequence : Sequence<S, I<O, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, I<O, V128Op, V128Op, V128Op>& i) {
+        const OpcodeFlags flags = i.instr->flags;
+        const U32 size = getComponentSize(flags);
+        const auto src1 = getXmm(e, i.src1, e.xmm1);
+
+        // Shift by an immediate if all components are shifted by the same constant amount
+        if (i.src2.isConstant) {
+            const V128 amounts = i.src2.constant();
+            U64 amount = 0;
+            std::memcpy(&amount, &amounts.u8[0], size);
+            bool isUniform = true;
+            for (U32 offset = size; offset < sizeof(V128); offset += size) {
+                U64 other = 0;
+                std::memcpy(&other, &amounts.u8[offset], size);
+                isUniform &= (other % (size * 8)) == (amount % (size * 8));
+            }
+            if (isUniform) {
+                emitVectorShiftImm(e, i.dest, src1, O, flags, amount % (size * 8));
+                return;
+            }
+        }
+        emitVectorShift(e, i.dest, src1, getXmm(e, i.src2, e.xmm2), O, flags);
+    }
+};
+struct VSHL_V128 : VectorShiftSequence<VSHL_V128, OPCODE_VSHL> {};
+struct VSHR_V128 : VectorShiftSequence<VSHR_V128, OPCODE_VSHR> {};
+struct VSHRA_V128 : VectorShiftSequence<VSHRA_V128, OPCODE_VSHRA> {};
+
+/**
+ * Opcode: VROUND
+ */
+struct VROUND_V128 : Sequence<VROUND_V128, I<OPCODE_VROUND, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        assert_true((i.instr->flags & COMPONENT_MASK) == COMPONENT_F32);
+        U8 mode;
+        switch (i.instr->flags & VECTOR_ROUND_MASK) {
+        case VECTOR_ROUND_NEAREST:  mode = 0b00;  break;
+        case VECTOR_ROUND_DOWN:     mode = 0b01;  break;
+        case VECTOR_ROUND_UP:       mode = 0b10;  break;
+        default:                    mode = 0b11;  break;
+        }
+        // Bit 3 suppresses precision exceptions
+        e.vroundps(i.dest, getXmm(e, i.src1, e.xmm1), mode | 0b1000);
+    }
+};
+
+/**
+ * Opcode: VRCP
+ */
+struct VRCP_V128 : Sequence<VRCP_V128, I<OPCODE_VRCP, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        assert_true((i.instr->flags & COMPONENT_MASK) == COMPONENT_F32);
+        e.vrcpps(i.dest, getXmm(e, i.src1, e.xmm1));
+    }
+};
+
+/**
+ * Opcode: VRSQRT
+ */
+struct VRSQRT_V128 : Sequence<VRSQRT_V128, I<OPCODE_VRSQRT, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        assert_true((i.instr->flags & COMPONENT_MASK) == COMPONENT_F32);
+        e.vrsqrtps(i.dest, getXmm(e, i.src1, e.xmm1));
+    }
+};
+
+/**
+ * Opcode: VCONVERT
+ */
+struct VCONVERT_V128 : Sequence<VCONVERT_V128, I<OPCODE_VCONVERT, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        const auto src = getXmm(e, i.src1, e.xmm1);
+        const bool isUnsigned = (i.instr->flags & VECTOR_UNSIGNED);
+        switch (i.instr->flags & COMPONENT_MASK) {
+        // Integers to floats
+        case COMPONENT_I32:
+            if (!isUnsigned) {
+                e.vcvtdq2ps(i.dest, src);
+            } else {
+                // Convert both 16-bit halves exactly, so that their sum is rounded only once
+                e.vpsrld(e.xmm0, src, 16);
+                e.vcvtdq2ps(e.xmm0, e.xmm0);
+                getXmmConstantCompF32(e, e.xmm4, 65536.0f);
+                e.vmulps(e.xmm0, e.xmm0, e.xmm4);
+                e.vpslld(e.xmm4, src, 16);
+                e.vpsrld(e.xmm4, e.xmm4, 16);
+                e.vcvtdq2ps(e.xmm4, e.xmm4);
+                e.vaddps(i.dest, e.xmm0, e.xmm4);
+            }
+            break;
+
+        // Floats to integers (rounding towards zero, saturating, NaNs converted to zero)
+        case COMPONENT_F32:
+            if (!isUnsigned) {
+                // Out-of-range components convert to 0x80000000, fix the positive ones
+                e.vcvttps2dq(e.xmm0, src);
+                getXmmConstantCompF32(e, e.xmm4, 2147483648.0f);
+                e.vcmpgeps(e.xmm4, src, e.xmm4);
+                e.vpxor(e.xmm0, e.xmm0, e.xmm4);
+                e.vcmpordps(e.xmm4, src, src);
+                e.vpand(i.dest, e.xmm0, e.xmm4);
+            } else {
+                // Clamp negative components and NaNs to zero, and convert the components above 2^31 minus 2^31
+                e.vpxor(e.xmm0, e.xmm0, e.xmm0);
+                e.vmaxps(e.xmm5, src, e.xmm0);
+                getXmmConstantCompF32(e, e.xmm4, 2147483648.0f);
+                e.vcmpgeps(e.xmm3, e.xmm5, e.xmm4);
+                e.vsubps(e.xmm0, e.xmm5, e.xmm4);
+                e.vblendvps(e.xmm0, e.xmm5, e.xmm0, e.xmm3);
+                e.vcvttps2dq(e.xmm0, e.xmm0);
+                e.vpslld(e.xmm3, e.xmm3, 31);
+                e.vpor(e.xmm0, e.xmm0, e.xmm3);
+                getXmmConstantCompF32(e, e.xmm4, 4294967296.0f);
+                e.vcmpgeps(e.xmm4, e.xmm5, e.xmm4);
+                e.vpor(i.dest, e.xmm0, e.xmm4);
+            }
+            break;
+
+        default:
+            assert_always("Unimplemented case");
+        }
+    }
+};
+
+/**
+ * Opcode: VSPLAT
+ */
+struct VSPLAT_I8 : Sequence<VSPLAT_I8, I<OPCODE_VSPLAT, V128Op, I8Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        assert_false(i.src1.isConstant);
+        e.vmovd(e.xmm0, i.src1.reg.cvt32());
+        if (e.isExtensionAvailable(X86Extension::AVX2)) {
+            e.vpbroadcastb(i.dest, e.xmm0);
+        } else {
+            e.vpxor(e.xmm4, e.xmm4, e.xmm4);
+            e.vpshufb(i.dest, e.xmm0, e.xmm4);
+        }
+    }
+};
+struct VSPLAT_I16 : Sequence<VSPLAT_I16, I<OPCODE_VSPLAT, V128Op, I16Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        assert_false(i.src1.isConstant);
+        e.vmovd(e.xmm0, i.src1.reg.cvt32());
+        if (e.isExtensionAvailable(X86Extension::AVX2)) {
+            e.vpbroadcastw(i.dest, e.xmm0);
+        } else {
+            e.vpshuflw(e.xmm0, e.xmm0, 0);
+            e.vpshufd(i.dest, e.xmm0, 0);
+        }
+    }
+};
+struct VSPLAT_I32 : Sequence<VSPLAT_I32, I<OPCODE_VSPLAT, V128Op, I32Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        assert_false(i.src1.isConstant);
+        e.vmovd(e.xmm0, i.src1.reg);
+        if (e.isExtensionAvailable(X86Extension::AVX2)) {
+            e.vpbroadcastd(i.dest, e.xmm0);
+        } else {
+            e.vpshufd(i.dest, e.xmm0, 0);
+        }
+    }
+};
+struct VSPLAT_F32 : Sequence<VSPLAT_F32, I<OPCODE_VSPLAT, V128Op, F32Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        assert_false(i.src1.isConstant);
+        if (e.isExtensionAvailable(X86Extension::AVX2)) {
+            e.vbroadcastss(i.dest, i.src1.reg);
+        } else {
+            e.vshufps(i.dest, i.src1.reg, i.src1.reg, 0);
+        }
+    }
+};
+
+/**
+ * Opcode: VEXTRACT
+ */
+struct VEXTRACT_I8 : Sequence<VEXTRACT_I8, I<OPCODE_VEXTRACT, I8Op, V128Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        e.vpextrb(i.dest.reg.cvt32(), getXmm(e, i.src1, e.xmm1), i.src2.immediate);
+    }
+};
+struct VEXTRACT_I16 : Sequence<VEXTRACT_I16, I<OPCODE_VEXTRACT, I16Op, V128Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        e.vpextrw(i.dest.reg.cvt32(), getXmm(e, i.src1, e.xmm1), i.src2.immediate);
+    }
+};
+struct VEXTRACT_I32 : Sequence<VEXTRACT_I32, I<OPCODE_VEXTRACT, I32Op, V128Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        e.vpextrd(i.dest.reg, getXmm(e, i.src1, e.xmm1), i.src2.immediate);
+    }
+};
+struct VEXTRACT_I64 : Sequence<VEXTRACT_I64, I<OPCODE_VEXTRACT, I64Op, V128Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        e.vpextrq(i.dest.reg, getXmm(e, i.src1, e.xmm1), i.src2.immediate);
+    }
+};
+struct VEXTRACT_F32 : Sequence<VEXTRACT_F32, I<OPCODE_VEXTRACT, F32Op, V128Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        e.vpshufd(i.dest, getXmm(e, i.src1, e.xmm1), i.src2.immediate);
+    }
+};
+struct VEXTRACT_F64 : Sequence<VEXTRACT_F64, I<OPCODE_VEXTRACT, F64Op, V128Op, ImmediateOp>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        e.vpshufd(i.dest, getXmm(e, i.src1, e.xmm1), i.src2.immediate ? 0b11101110 : 0b01000100);
+    }
+};
+
+/**
+ * Opcode: VPERM
+ */
+struct VPERM_V128 : Sequence<VPERM_V128, I<OPCODE_VPERM, V128Op, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        const auto src1 = getXmm(e, i.src1, e.xmm1);
+        const auto src2 = getXmm(e, i.src2, e.xmm2);
+        if (!i.src3.isConstant) {
+            emitVectorPerm(e, i.dest, src1, src2, i.src3);
+            return;
+        }
+
+        // Constant permutations reading a single vector take one shuffle, and shifts of src2:src1 one alignment
+        V128 control = i.src3.constant();
+        bool isSrc1 = true;
+        bool isSrc2 = true;
+        bool isShift = true;
+        for (U32 index = 0; index < 16; index++) {
+            control.u8[index] &= 0x1F;
+            isSrc1 &= (control.u8[index] < 16);
+            isSrc2 &= (control.u8[index] >= 16);
+            isShift &= (control.u8[index] == control.u8[0] + index);
+        }
+        if (isSrc1) {
+            getXmmConstant(e, e.xmm3, control);
+            e.vpshufb(i.dest, src1, e.xmm3);
+        } else if (isSrc2) {
+            for (U32 index = 0; index < 16; index++) {
+                control.u8[index] &= 0x0F;
+            }
+            getXmmConstant(e, e.xmm3, control);
+            e.vpshufb(i.dest, src2, e.xmm3);
+        } else if (isShift) {
+            e.vpalignr(i.dest, src2, src1, control.u8[0]);
+        } else {
+            getXmmConstant(e, e.xmm3, control);
+            emitVectorPerm(e, i.dest, src1, src2, e.xmm3);
+        }
+    }
+};
+
+/**
+ * Opcode: VMERGEH
+ */
+struct VMERGEH_V128 : Sequence<VMERGEH_V128, I<OPCODE_VMERGEH, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        const auto src1 = getXmm(e, i.src1, e.xmm1);
+        const auto src2 = getXmm(e, i.src2, e.xmm2);
+        switch (getComponentSize(i.instr->flags)) {
+        case 1:  e.vpunpckhbw(i.dest, src1, src2);   break;
+        case 2:  e.vpunpckhwd(i.dest, src1, src2);   break;
+        case 4:  e.vpunpckhdq(i.dest, src1, src2);   break;
+        case 8:  e.vpunpckhqdq(i.dest, src1, src2);  break;
+        }
+    }
+};
+
+/**
+ * Opcode: VMERGEL
+ */
+struct VMERGEL_V128 : Sequence<VMERGEL_V128, I<OPCODE_VMERGEL, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        const auto src1 = getXmm(e, i.src1, e.xmm1);
+        const auto src2 = getXmm(e, i.src2, e.xmm2);
+        switch (getComponentSize(i.instr->flags)) {
+        case 1:  e.vpunpcklbw(i.dest, src1, src2);   break;
+        case 2:  e.vpunpcklwd(i.dest, src1, src2);   break;
+        case 4:  e.vpunpckldq(i.dest, src1, src2);   break;
+        case 8:  e.vpunpcklqdq(i.dest, src1, src2);  break;
+        }
+    }
+};
+
+/**
+ * Opcode: VPACK
+ */
+struct VPACK_V128 : Sequence<VPACK_V128, I<OPCODE_VPACK, V128Op, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        const OpcodeFlags flags = i.instr->flags;
+        const auto src1 = getXmm(e, i.src1, e.xmm1);
+        const auto src2 = getXmm(e, i.src2, e.xmm2);
+        switch (flags & COMPONENT_MASK) {
+        case COMPONENT_I16:
+            if (!(flags & VECTOR_SATURATE)) {
+                // Truncate by clearing the upper halves before an unsigned saturating pack
+                getXmmConstant(e, e.xmm0, getSplatConstant(COMPONENT_I16, 0x00FF));
+                e.vpand(e.xmm4, src1, e.xmm0);
+                e.vpand(e.xmm5, src2, e.xmm0);
+                e.vpackuswb(i.dest, e.xmm4, e.xmm5);
+            } else if (flags & VECTOR_UNSIGNED) {
+                getXmmConstant(e, e.xmm0, getSplatConstant(COMPONENT_I16, 0x00FF));
+                e.vpminuw(e.xmm4, src1, e.xmm0);
+                e.vpminuw(e.xmm5, src2, e.xmm0);
+                e.vpackuswb(i.dest, e.xmm4, e.xmm5);
+            } else if (flags & VECTOR_SATURATE_UNSIGNED) {
+                e.vpackuswb(i.dest, src1, src2);
+            } else {
+                e.vpacksswb(i.dest, src1, src2);
+            }
+            break;
+        case COMPONENT_I32:
+            if (!(flags & VECTOR_SATURATE)) {
+                getXmmConstant(e, e.xmm0, getSplatConstant(COMPONENT_I32, 0xFFFF));
+                e.vpand(e.xmm4, src1, e.xmm0);
+                e.vpand(e.xmm5, src2, e.xmm0);
+                e.vpackusdw(i.dest, e.xmm4, e.xmm5);
+            } else if (flags & VECTOR_UNSIGNED) {
+                getXmmConstant(e, e.xmm0, getSplatConstant(COMPONENT_I32, 0xFFFF));
+                e.vpminud(e.xmm4, src1, e.xmm0);
+                e.vpminud(e.xmm5, src2, e.xmm0);
+                e.vpackusdw(i.dest, e.xmm4, e.xmm5);
+            } else if (flags & VECTOR_SATURATE_UNSIGNED) {
+                e.vpackusdw(i.dest, src1, src2);
+            } else {
+                e.vpackssdw(i.dest, src1, src2);
+            }
+            break;
+        default:
+            assert_always("Unimplemented case");
+        }
+    }
+};
+
+/**
+ * Opcode: VUNPACKH, VUNPACKL
+ */
+static void emitVectorUnpack(X86Emitter& e, Xbyak::Xmm dest, Xbyak::Xmm src, OpcodeFlags flags) {
+    const bool isUnsigned = (flags & VECTOR_UNSIGNED);
+    switch (flags & COMPONENT_MASK) {
+    case COMPONENT_I8:
+        isUnsigned ? e.vpmovzxbw(dest, src) : e.vpmovsxbw(dest, src);
+        break;
+    case COMPONENT_I16:
+        isUnsigned ? e.vpmovzxwd(dest, src) : e.vpmovsxwd(dest, src);
+        break;
+    case COMPONENT_I32:
+        isUnsigned ? e.vpmovzxdq(dest, src) : e.vpmovsxdq(dest, src);
+        break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+struct VUNPACKH_V128 : Sequence<VUNPACKH_V128, I<OPCODE_VUNPACKH, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        const auto src = getXmm(e, i.src1, e.xmm1);
+        e.vpunpckhqdq(e.xmm0, src, src);
+        emitVectorUnpack(e, i.dest, e.xmm0, i.instr->flags);
+    }
+};
+struct VUNPACKL_V128 : Sequence<VUNPACKL_V128, I<OPCODE_VUNPACKL, V128Op, V128Op>> {
+    static void emit(X86Emitter& e, InstrType& i) {
+        emitVectorUnpack(e, i.dest, getXmm(e, i.src1, e.xmm1), i.instr->flags);
+    }
+};
+
 /**
  * x86 Sequences
  */
-std::unordered_map<InstrKey::Value, X86Sequences::SelectFunction> X86Sequences::sequences;
+std::vector<X86Sequences::Entry> X86Sequences::sequences;
+std::array<U16, X86Sequences::TABLE_SIZE> X86Sequences::table;
+
+// Get the type of an instruction operand as indexed by the selection table
+static U32 getOperandType(U8 signature, const hir::Value* value) {
+    if (signature == OPCODE_SIG_TYPE_V || (signature == OPCODE_SIG_TYPE_M && value)) {
+        return value->type;
+    }
+    return TYPE_VOID;
+}
+
+// Get the type of a sequence key field as indexed by the selection table, returning false if it does not match the signature
+static bool getKeyType(U8 signature, U32 field, U32& type) {
+    type = TYPE_VOID;
+    switch (signature) {
+    case OPCODE_SIG_TYPE_M:
+        if (field == OPCODE_SIG_TYPE_X) {
+            return true;
+        }
+        // Fallthrough
+    case OPCODE_SIG_TYPE_V:
+        type = field - OPCODE_SIG_TYPE_V;
+        return field > OPCODE_SIG_TYPE_V && field <= OPCODE_SIG_TYPE_V + TYPE_V256;
+    default:
+        return field == signature;
+    }
+}
+
+void X86Sequences::addSequence(InstrKey key, SelectFunction select) {
+    if (key.opcode >= __OPCODE_COUNT) {
+        logger.error(LOG_CPU, "X86Sequences: Sequence for invalid opcode %d", key.opcode);
+        return;
+    }
+
+    const auto& info = opcodeInfo[key.opcode];
+    U32 dest, src1, src2, src3;
+    if (!getKeyType(info.getSignatureDest(), key.dest, dest) ||
+        !getKeyType(info.getSignatureSrc1(), key.src1, src1) ||
+        !getKeyType(info.getSignatureSrc2(), key.src2, src2) ||
+        !getKeyType(info.getSignatureSrc3(), key.src3, src3)) {
+        logger.error(LOG_CPU, "X86Sequences: Sequence for %s does not match its signature", info.name);
+        return;
+    }
+
+    U16& index = table[getTableIndex(key.opcode, dest, src1, src2)];
+    if (index) {
+        logger.error(LOG_CPU, "X86Sequences: Duplicate sequence for %s", info.name);
+        return;
+    }
+    index = U16(sequences.size());
+    sequences.push_back({ select, U8(src3) });
+}
 
 void X86Sequences::init() {
     // Initialize sequences if necessary
     if (sequences.empty()) {
+        sequences.push_back({ nullptr, TYPE_VOID });
         registerSequence<ADD_I8, ADD_I16, ADD_I32, ADD_I64>();
         registerSequence<SUB_I8, SUB_I16, SUB_I32, SUB_I64>();
         registerSequence<MUL_I8, MUL_I16, MUL_I32, MUL_I64>();
@@ -2104,6 +3376,8 @@ void X86Sequences::init() {
         registerSequence<SHL_I8, SHL_I16, SHL_I32, SHL_I64>();
         registerSequence<SHR_I8, SHR_I16, SHR_I32, SHR_I64>();
         registerSequence<SHRA_I8, SHRA_I16, SHRA_I32, SHRA_I64>();
+        registerSequence<ROL_I8, ROL_I16, ROL_I32, ROL_I64>();
+        registerSequence<ROR_I8, ROR_I16, ROR_I32, ROR_I64>();
         registerSequence<ZEXT_I16_I8, ZEXT_I32_I8, ZEXT_I64_I8, ZEXT_I32_I16, ZEXT_I64_I16, ZEXT_I64_I32>();
         registerSequence<SEXT_I16_I8, SEXT_I32_I8, SEXT_I64_I8, SEXT_I32_I16, SEXT_I64_I16, SEXT_I64_I32>();
         registerSequence<TRUNC_I8_I16, TRUNC_I8_I32, TRUNC_I8_I64, TRUNC_I16_I32, TRUNC_I16_I64, TRUNC_I32_I64>();
@@ -2112,8 +3386,11 @@ void X86Sequences::init() {
         registerSequence<CTLZ_I8, CTLZ_I16, CTLZ_I32, CTLZ_I64>();
         registerSequence<LOAD_I8, LOAD_I16, LOAD_I32, LOAD_I64, LOAD_F32, LOAD_F64, LOAD_V128>();
         registerSequence<STORE_I8, STORE_I16, STORE_I32, STORE_I64, STORE_F32, STORE_F64, STORE_V128>();
+        registerSequence<CMPXCHG_I32, CMPXCHG_I64>();
         registerSequence<CTXLOAD_I8, CTXLOAD_I16, CTXLOAD_I32, CTXLOAD_I64, CTXLOAD_F32, CTXLOAD_F64, CTXLOAD_V128>();
         registerSequence<CTXSTORE_I8, CTXSTORE_I16, CTXSTORE_I32, CTXSTORE_I64, CTXSTORE_F32, CTXSTORE_F64, CTXSTORE_V128>();
+        registerSequence<LOCALLOAD_I8, LOCALLOAD_I16, LOCALLOAD_I32, LOCALLOAD_I64, LOCALLOAD_F32, LOCALLOAD_F64, LOCALLOAD_V128>();
+        registerSequence<LOCALSTORE_I8, LOCALSTORE_I16, LOCALSTORE_I32, LOCALSTORE_I64, LOCALSTORE_F32, LOCALSTORE_F64, LOCALSTORE_V128>();
         registerSequence<MEMFENCE>();
         registerSequence<SELECT_I8, SELECT_I16, SELECT_I32, SELECT_I64, SELECT_F32, SELECT_F64>();
         registerSequence<CMP_I8, CMP_I16, CMP_I32, CMP_I64, CMP_F32, CMP_F64>();
@@ -2121,24 +3398,52 @@ void X86Sequences::init() {
         registerSequence<BR>();
         registerSequence<CALL_VOID, CALL_I8, CALL_I16, CALL_I32, CALL_I64>();
         registerSequence<BRCOND_I8, BRCOND_I16, BRCOND_I32, BRCOND_I64>();
+        registerSequence<CALLCOND_VOID, CALLCOND_I8, CALLCOND_I16, CALLCOND_I32, CALLCOND_I64>();
+        registerSequence<PHI_I8, PHI_I16, PHI_I32, PHI_I64, PHI_F32, PHI_F64, PHI_V128>();
         registerSequence<RET_VOID, RET_I8, RET_I16, RET_I32, RET_I64, RET_F32, RET_F64>();
         registerSequence<FADD_F32, FADD_F64>();
         registerSequence<FSUB_F32, FSUB_F64>();
         registerSequence<FMUL_F32, FMUL_F64>();
         registerSequence<FDIV_F32, FDIV_F64>();
         registerSequence<FNEG_F32, FNEG_F64>();
+        registerSequence<VADD_V128, VSUB_V128, VMUL_V128, VAVG_V128, VMIN_V128, VMAX_V128>();
+        registerSequence<VCMP_V128>();
+        registerSequence<VSHL_V128, VSHR_V128, VSHRA_V128>();
+        registerSequence<VROUND_V128, VRCP_V128, VRSQRT_V128, VCONVERT_V128>();
+        registerSequence<VSPLAT_I8, VSPLAT_I16, VSPLAT_I32, VSPLAT_F32>();
+        registerSequence<VEXTRACT_I8, VEXTRACT_I16, VEXTRACT_I32, VEXTRACT_I64, VEXTRACT_F32, VEXTRACT_F64>();
+        registerSequence<VPERM_V128, VMERGEH_V128, VMERGEL_V128>();
+        registerSequence<VPACK_V128, VUNPACKH_V128, VUNPACKL_V128>();
+
+        // Report opcodes that cannot be selected
+        std::vector<bool> registered(__OPCODE_COUNT);
+        for (size_t i = 0; i < TABLE_SIZE; i++) {
+            if (table[i]) {
+                registered[i / (TYPE_COUNT * TYPE_COUNT * TYPE_COUNT)] = true;
+            }
+        }
+        for (U32 opcode = 0; opcode < __OPCODE_COUNT; opcode++) {
+            if (!registered[opcode]) {
+                logger.warning(LOG_CPU, "X86Sequences: No sequences for %s", opcodeInfo[opcode].name);
+            }
+        }
     }
 }
 
 bool X86Sequences::select(X86Emitter& emitter, const hir::Instruction* instr) {
-    auto key = InstrKey(instr).value;
-    auto it = sequences.find(key);
-    if (it != sequences.end()) {
-        it->second(emitter, instr);
+    const auto& info = opcodeInfo[instr->opcode];
+    const U32 dest = getOperandType(info.getSignatureDest(), instr->dest);
+    const U32 src1 = getOperandType(info.getSignatureSrc1(), instr->src1.value);
+    const U32 src2 = getOperandType(info.getSignatureSrc2(), instr->src2.value);
+    const U32 src3 = getOperandType(info.getSignatureSrc3(), instr->src3.value);
+
+    const Entry& entry = sequences[table[getTableIndex(instr->opcode, dest, src1, src2)]];
+    if (entry.select && entry.src3 == src3) {
+        entry.select(emitter, instr);
         return true;
     }
 
-    logger.error(LOG_CPU, "No sequence found");
+    logger.error(LOG_CPU, "No sequence found for %s", info.name);
     return false;
 }
 
@@ -9,7 +9,8 @@
 #include "nucleus/cpu/backend/sequences.h"
 #include "nucleus/cpu/backend/x86/x86_emitter.h"
 
-#include <unordered_map>
+#include <array>
+#include <vector>
 
 namespace cpu {
 namespace backend {
@@ -19,13 +20,32 @@ class X86Sequences {
     // Sequence selection function type
     using SelectFunction = void(*)(X86Emitter&, const hir::Instruction*);
 
-    // Registered sequences
-    static std::unordered_map<InstrKey::Value, SelectFunction> sequences;
+    // Registered sequence, along with the type of its third source (not part of the table index)
+    struct Entry {
+        SelectFunction select;
+        U8 src3;
+    };
+
+    // Number of rows per operand in the selection table, indexed by value type (TYPE_VOID if not a value)
+    static constexpr size_t TYPE_COUNT = hir::TYPE_V256 + 1;
+    static constexpr size_t TABLE_SIZE = hir::__OPCODE_COUNT * TYPE_COUNT * TYPE_COUNT * TYPE_COUNT;
+
+    // Registered sequences (entry 0 is reserved for missing sequences)
+    static std::vector<Entry> sequences;
+
+    // Selection table, mapping opcode and types of destination, source 1 and source 2 to sequences
+    static std::array<U16, TABLE_SIZE> table;
+
+    // Get the index of a signature in the selection table
+    static size_t getTableIndex(U32 opcode, U32 dest, U32 src1, U32 src2) {
+        return ((opcode * TYPE_COUNT + dest) * TYPE_COUNT + src1) * TYPE_COUNT + src2;
+    }
 
     // Sequence registration
+    static void addSequence(InstrKey key, SelectFunction select);
     template <typename T>
     static void registerSequence() {
-        sequences.insert({ T::key, T::select });
+        addSequence(InstrKey(T::key), T::select);
     }
     template <typename T0, typename T1, typename... Ts>
     static void registerSequence() {
@@ -35,7 +55,7 @@ class X86Sequences {
 
 public:
     /**
-     * Initialize the table of sequences
+     * Initialize the table of sequences, reporting registrations that do not match the opcode signatures
      */
     static void init();
 
@@ -8,6 +8,8 @@
 namespace cpu {
 
 Cell::Cell(std::shared_ptr<mem::Memory> memory) : CPU(std::move(memory)) {
+    ppu_translator = std::make_unique<frontend::ppu::Translator>();
+    ppu_blocks = std::make_unique<frontend::ppu::BlockCache>(this);
 }
 
 }  // namespace cpu
@@ -7,7 +7,12 @@
 
 #include "nucleus/common.h"
 #include "nucleus/cpu/cpu.h"
+#include "nucleus/cpu/frontend/ppu/ppu_block_cache.h"
 #include "nucleus/cpu/frontend/ppu/ppu_decoder.h"
+#include "nucleus/cpu/frontend/ppu/ppu_dispatch.h"
+#include "nucleus/cpu/frontend/ppu/ppu_translator.h"
+
+#include <memory>
 
 namespace cpu {
 
@@ -16,6 +21,15 @@ public:
     // Executable memory segments
     std::vector<frontend::ppu::Module*> ppu_modules;
 
+    // Functions of the PPU modules, indexed by guest address
+    frontend::ppu::DispatchTable ppu_dispatch;
+
+    // Background translation of PPU functions
+    std::unique_ptr<frontend::ppu::Translator> ppu_translator;
+
+    // Blocks translated on their own, if block translation is enabled
+    std::unique_ptr<frontend::ppu::BlockCache> ppu_blocks;
+
     Cell(std::shared_ptr<mem::Memory> memory);
 };
 
@@ -31,6 +31,10 @@ CPU::CPU(std::shared_ptr<mem::Memory> memory) : memory(std::move(memory)) {
 #endif
 
     // Compiler passes
+    compiler->addPass(std::make_unique<hir::passes::ContextCachingPass>());
+    compiler->addPass(std::make_unique<hir::passes::ConstantPropagationPass>());
+    compiler->addPass(std::make_unique<hir::passes::ValueNumberingPass>());
+    compiler->addPass(std::make_unique<hir::passes::DeadCodeEliminationPass>());
     compiler->addPass(std::make_unique<hir::passes::RegisterAllocationPass>(compiler->targetInfo));
 }
 
@@ -9,6 +9,7 @@
 #include "nucleus/memory/memory.h"
 #include "nucleus/cpu/thread.h"
 #include "nucleus/cpu/backend/compiler.h"
+#include "nucleus/cpu/frontend/ppu/ppu_reservation.h"
 
 #include <mutex>
 
@@ -24,6 +25,9 @@ public:
 
     std::vector<Thread*> threads;
 
+    // Reservations of the PPU threads, shared by all of them
+    frontend::ppu::ReservationTable ppu_reservations;
+
     // Constructor
     CPU(std::shared_ptr<mem::Memory> memory);
 
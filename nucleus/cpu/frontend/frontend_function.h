@@ -9,6 +9,7 @@
 #include "nucleus/cpu/frontend/frontend_block.h"
 #include "nucleus/cpu/frontend/frontend_module.h"
 
+#include <iterator>
 #include <map>
 #include <string>
 
@@ -40,15 +41,13 @@ public:
     // Control Flow Graph
     std::map<TAddr, Block<TAddr>*> blocks;
 
-    // Check whether an address is inside any CFG block
+    // Check whether an address is inside any CFG block (blocks never overlap)
     bool contains(TAddr addr) const {
-        for (const auto& item : blocks) {
-            const auto& block = block.second;
-            if (block.contains(addr)) {
-                return true;
-            }
+        auto it = blocks.upper_bound(addr);
+        if (it == blocks.begin()) {
+            return false;
         }
-        return false;
+        return std::prev(it)->second->contains(addr);
     }
 };
 
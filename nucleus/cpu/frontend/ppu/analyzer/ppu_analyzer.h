@@ -47,6 +47,9 @@ public:
     AnalyzerEvent vr[32] = {};
     AnalyzerEvent vscr = REG_NONE;
 
+    // Reservation Registers (address, value and version, accessed together)
+    AnalyzerEvent reserve = REG_NONE;
+
     // Record of analyzed functions
     std::set<U32> analyzedFunctions;
 
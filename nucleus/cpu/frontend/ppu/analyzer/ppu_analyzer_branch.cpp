@@ -16,22 +16,49 @@ namespace ppu {
 
 void Analyzer::bx(Instruction code)
 {
-    // TODO: ?
+    if (code.lk) {
+        setFlag(lr, REG_WRITE);
+    }
 }
 
 void Analyzer::bcx(Instruction code)
 {
-    // TODO: ?
+    if (!(code.bo & 0x04)) {
+        setFlag(ctr, REG_READ);
+        setFlag(ctr, REG_WRITE);
+    }
+    if (!(code.bo & 0x10)) {
+        setFlag(cr[code.bi / 4], REG_READ);
+    }
+    if (code.lk) {
+        setFlag(lr, REG_WRITE);
+    }
 }
 
 void Analyzer::bcctrx(Instruction code)
 {
-    // TODO: ?
+    setFlag(ctr, REG_READ);
+    if (!(code.bo & 0x10)) {
+        setFlag(cr[code.bi / 4], REG_READ);
+    }
+    if (code.lk) {
+        setFlag(lr, REG_WRITE);
+    }
 }
 
 void Analyzer::bclrx(Instruction code)
 {
-    // TODO: ?
+    setFlag(lr, REG_READ);
+    if (!(code.bo & 0x04)) {
+        setFlag(ctr, REG_READ);
+        setFlag(ctr, REG_WRITE);
+    }
+    if (!(code.bo & 0x10)) {
+        setFlag(cr[code.bi / 4], REG_READ);
+    }
+    if (code.lk) {
+        setFlag(lr, REG_WRITE);
+    }
 }
 
 void Analyzer::crand(Instruction code)
@@ -21,6 +21,7 @@ void Analyzer::addx(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -36,6 +37,7 @@ void Analyzer::addcx(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -52,6 +54,7 @@ void Analyzer::addex(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -79,6 +82,7 @@ void Analyzer::addic_(Instruction code)
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
     setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer, REG_READ); // XER SO
     setFlag(cr[0], REG_WRITE);
 }
 
@@ -98,6 +102,7 @@ void Analyzer::addmex(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -113,6 +118,7 @@ void Analyzer::addzex(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -127,6 +133,7 @@ void Analyzer::andx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -138,6 +145,7 @@ void Analyzer::andcx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -146,6 +154,7 @@ void Analyzer::andi_(Instruction code)
 {
     setFlag(gpr[code.rs], REG_READ);
     setFlag(gpr[code.ra], REG_WRITE);
+    setFlag(xer, REG_READ); // XER SO
     setFlag(cr[0], REG_WRITE);
 }
 
@@ -153,6 +162,7 @@ void Analyzer::andis_(Instruction code)
 {
     setFlag(gpr[code.rs], REG_READ);
     setFlag(gpr[code.ra], REG_WRITE);
+    setFlag(xer, REG_READ); // XER SO
     setFlag(cr[0], REG_WRITE);
 }
 
@@ -160,12 +170,14 @@ void Analyzer::cmp(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
+    setFlag(xer, REG_READ); // XER SO
     setFlag(cr[code.crfd], REG_WRITE);
 }
 
 void Analyzer::cmpi(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
+    setFlag(xer, REG_READ); // XER SO
     setFlag(cr[code.crfd], REG_WRITE);
 }
 
@@ -173,12 +185,14 @@ void Analyzer::cmpl(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
+    setFlag(xer, REG_READ); // XER SO
     setFlag(cr[code.crfd], REG_WRITE);
 }
 
 void Analyzer::cmpli(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
+    setFlag(xer, REG_READ); // XER SO
     setFlag(cr[code.crfd], REG_WRITE);
 }
 
@@ -189,6 +203,7 @@ void Analyzer::divdx(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -202,6 +217,7 @@ void Analyzer::cntlzdx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -212,6 +228,7 @@ void Analyzer::cntlzwx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -223,6 +240,7 @@ void Analyzer::divdux(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -237,6 +255,7 @@ void Analyzer::divwx(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -251,6 +270,7 @@ void Analyzer::divwux(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -265,6 +285,7 @@ void Analyzer::eqvx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -275,6 +296,7 @@ void Analyzer::extsbx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -285,6 +307,7 @@ void Analyzer::extshx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -295,6 +318,7 @@ void Analyzer::extswx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -306,6 +330,7 @@ void Analyzer::mulhdx(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -317,6 +342,7 @@ void Analyzer::mulhdux(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -328,6 +354,7 @@ void Analyzer::mulhwx(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -339,6 +366,7 @@ void Analyzer::mulhwux(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -350,6 +378,7 @@ void Analyzer::mulldx(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -370,6 +399,7 @@ void Analyzer::mullwx(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -384,6 +414,7 @@ void Analyzer::nandx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -394,6 +425,7 @@ void Analyzer::negx(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -408,6 +440,7 @@ void Analyzer::norx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -419,6 +452,7 @@ void Analyzer::orx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -430,6 +464,7 @@ void Analyzer::orcx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -453,6 +488,7 @@ void Analyzer::rldc_lr(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -463,6 +499,7 @@ void Analyzer::rldicx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -473,6 +510,7 @@ void Analyzer::rldiclx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -483,6 +521,7 @@ void Analyzer::rldicrx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -494,6 +533,7 @@ void Analyzer::rldimix(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -505,6 +545,7 @@ void Analyzer::rlwimix(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -515,6 +556,7 @@ void Analyzer::rlwinmx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -526,6 +568,7 @@ void Analyzer::rlwnmx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -537,6 +580,7 @@ void Analyzer::sldx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -548,6 +592,7 @@ void Analyzer::slwx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -560,6 +605,7 @@ void Analyzer::sradx(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -571,6 +617,7 @@ void Analyzer::sradix(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -583,6 +630,7 @@ void Analyzer::srawx(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -594,6 +642,7 @@ void Analyzer::srawix(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -605,6 +654,7 @@ void Analyzer::srdx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -616,6 +666,7 @@ void Analyzer::srwx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -627,6 +678,7 @@ void Analyzer::subfx(Instruction code)
     setFlag(gpr[code.rd], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -642,6 +694,7 @@ void Analyzer::subfcx(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -658,6 +711,7 @@ void Analyzer::subfex(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -680,6 +734,7 @@ void Analyzer::subfmex(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -695,6 +750,7 @@ void Analyzer::subfzex(Instruction code)
     setFlag(xer, REG_WRITE); // XER CA
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
@@ -709,6 +765,7 @@ void Analyzer::xorx(Instruction code)
     setFlag(gpr[code.ra], REG_WRITE);
 
     if (code.rc) {
+        setFlag(xer, REG_READ); // XER SO
         setFlag(cr[0], REG_WRITE);
     }
 }
@@ -55,8 +55,7 @@ void Analyzer::ldarx(Instruction code)
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    //thread.reserve_addr = addr;
-    //thread.reserve_value = re64(thread.gpr[code.rd]);
+    setFlag(reserve, REG_WRITE);
 }
 
 void Analyzer::ldbrx(Instruction code)
@@ -243,8 +242,7 @@ void Analyzer::lwarx(Instruction code)
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    //thread.reserve_addr = addr;
-    //thread.reserve_value = re32(thread.gpr[code.rd]);
+    setFlag(reserve, REG_WRITE);
 }
 
 void Analyzer::lwaux(Instruction code)
@@ -336,8 +334,9 @@ void Analyzer::stdcx_(Instruction code)
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.rs], REG_READ);
-    //thread.reserve_addr REG_READ
-    //thread.reserve_value REG_READ
+    setFlag(reserve, REG_READ);
+    setFlag(reserve, REG_WRITE);
+    setFlag(xer, REG_READ); // XER SO
     setFlag(cr[0], REG_WRITE);
 }
 
@@ -504,8 +503,9 @@ void Analyzer::stwcx_(Instruction code)
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.rs], REG_READ);
-    //thread.reserve_addr REG_READ
-    //thread.reserve_value REG_READ
+    setFlag(reserve, REG_READ);
+    setFlag(reserve, REG_WRITE);
+    setFlag(xer, REG_READ); // XER SO
     setFlag(cr[0], REG_WRITE);
 }
 
@@ -0,0 +1,189 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter.h"
+#include "nucleus/core/config.h"
+#include "nucleus/cpu/cell.h"
+#include "nucleus/cpu/frontend/ppu/ppu_state.h"
+#include "nucleus/cpu/frontend/ppu/ppu_tables.h"
+#include "nucleus/cpu/frontend/ppu/ppu_thread.h"
+#include "nucleus/logger/logger.h"
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+Interpreter::Interpreter(PPUThread* thread) {
+    parent = static_cast<Cell*>(thread->parent);
+    state = thread->state.get();
+    memory = parent->memory.get();
+
+    // Hot functions can only be handed to the JIT if function translation is enabled
+    tierUp = (config.ppuTranslator & CPU_TRANSLATOR_FUNCTION) != 0;
+}
+
+void Interpreter::step() {
+    Instruction code;
+    code.value = memory->read32(state->pc);
+    currentAddress = state->pc;
+    state->pc += 4;
+
+    const auto& entry = get_entry(code);
+    if (entry.type != ENTRY_INSTRUCTION) {
+        logger.error(LOG_CPU, "Interpreter::step error: Invalid instruction at 0x%08X", currentAddress);
+        return;
+    }
+    (this->*entry.interpret)(code);
+}
+
+bool Interpreter::enter(U32 addr) {
+    auto it = targets.find(addr);
+    if (it == targets.end()) {
+        Function* function = nullptr;
+        for (auto* module : parent->ppu_modules) {
+            if (module->contains(addr)) {
+                function = module->addFunction(addr);
+                break;
+            }
+        }
+        it = targets.emplace(addr, CallTarget{ function, false }).first;
+    }
+
+    auto& target = it->second;
+    if (!target.function) {
+        return false;
+    }
+    if (!target.native) {
+        auto* function = target.function;
+        const U32 count = function->execution_count.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (!function->hooked && !(tierUp && count >= config.ppuTierUpThreshold)) {
+            return false;
+        }
+        if (!parent->ppu_translator->require(function)) {
+            target.function = nullptr;
+            return false;
+        }
+        target.native = true;
+    }
+
+    // The native code returns once the guest function does
+    const U64 returnAddr = state->lr;
+    parent->compiler->call(target.function->hirFunction, state);
+    state->pc = U32(returnAddr);
+    return true;
+}
+
+void Interpreter::call(U32 addr) {
+    if (!enter(addr)) {
+        state->pc = addr;
+    }
+}
+
+/**
+ * Memory reservations (see ReservationTable)
+ */
+U64 Interpreter::readReserved(U32 addr, U32 size) {
+    auto* slots = static_cast<std::atomic<U64>*>(parent->ppu_reservations.getBaseAddr());
+    auto& slot = slots[(addr >> ReservationTable::GRANULE_BITS) & (ReservationTable::SLOT_COUNT - 1)];
+
+    // Read the version first: a conditional store completed after it makes the reservation fail
+    const U64 version = slot.load(std::memory_order_acquire);
+    const U64 value = (size == 8) ? memory->read64(addr) : memory->read32(addr);
+
+    state->reserve_addr = addr;
+    state->reserve_value = value;
+    state->reserve_version = version;
+    return value;
+}
+
+bool Interpreter::writeConditional(U32 addr, U64 value, U32 size) {
+    auto* slots = static_cast<std::atomic<U64>*>(parent->ppu_reservations.getBaseAddr());
+    auto& slot = slots[(addr >> ReservationTable::GRANULE_BITS) & (ReservationTable::SLOT_COUNT - 1)];
+
+    // Claim the granule, unless another thread did since the reservation or it was made elsewhere
+    U64 version = (state->reserve_addr == addr) ? state->reserve_version : ReservationTable::INVALID_VERSION;
+    const bool claimed = slot.compare_exchange_strong(version, version + 2, std::memory_order_acq_rel);
+
+    // Write the value if the memory still holds the reserved one. Without the granule,
+    // the memory is left unchanged (at most, the reserved value is rewritten).
+    const U64 desired = claimed ? value : state->reserve_value;
+    void* hostAddr = static_cast<U8*>(memory->getBaseAddr()) + addr;
+    bool stored;
+    if (size == 8) {
+        U64 expected = SE64(state->reserve_value);
+        stored = static_cast<std::atomic<U64>*>(hostAddr)->compare_exchange_strong(expected, SE64(desired));
+    } else {
+        U32 expected = SE32(U32(state->reserve_value));
+        stored = static_cast<std::atomic<U32>*>(hostAddr)->compare_exchange_strong(expected, SE32(U32(desired)));
+    }
+
+    // The reservation is lost in any case
+    state->reserve_version = ReservationTable::INVALID_VERSION;
+    return claimed && stored;
+}
+
+/**
+ * Operation flags
+ */
+template <typename T>
+void Interpreter::updateCR(int field, T lhs, T rhs) {
+    U32 value = (lhs < rhs) ? PPUState::CR_LT : (lhs > rhs) ? PPUState::CR_GT : PPUState::CR_EQ;
+    if (state->xer.so) {
+        value |= PPUState::CR_SO;
+    }
+    state->setCRField(field, value);
+}
+
+template void Interpreter::updateCR<S32>(int field, S32 lhs, S32 rhs);
+template void Interpreter::updateCR<U32>(int field, U32 lhs, U32 rhs);
+template void Interpreter::updateCR<S64>(int field, S64 lhs, S64 rhs);
+template void Interpreter::updateCR<U64>(int field, U64 lhs, U64 rhs);
+
+void Interpreter::updateCR0(U64 value) {
+    updateCR<S64>(0, value, 0);
+}
+
+void Interpreter::updateCR1() {
+    // Copy the FX, FEX, VX and OX bits of the FPSCR
+    state->setCRField(1, state->fpscr.FPSCR >> 28);
+}
+
+void Interpreter::updateCR6(bool allTrue, bool allFalse) {
+    state->setCRField(6, (allTrue ? PPUState::CR_LT : 0) | (allFalse ? PPUState::CR_EQ : 0));
+}
+
+void Interpreter::updateOV(bool overflow) {
+    state->xer.ov = overflow;
+    state->xer.so |= overflow;
+}
+
+bool Interpreter::getCRBit(U32 bit) const {
+    return state->getCRBit(bit);
+}
+
+void Interpreter::setCRBit(U32 bit, bool value) {
+    state->setCRBit(bit, value);
+}
+
+/**
+ * Branching
+ */
+bool Interpreter::checkCondition(Instruction code) {
+    const bool bo0 = (code.bo & 0x10) != 0;
+    const bool bo1 = (code.bo & 0x08) != 0;
+    const bool bo2 = (code.bo & 0x04) != 0;
+    const bool bo3 = (code.bo & 0x02) != 0;
+
+    if (!bo2) {
+        state->ctr -= 1;
+    }
+    const bool ctr_ok = bo2 || ((state->ctr != 0) ^ bo3);
+    const bool cond_ok = bo0 || (getCRBit(code.bi) == bo1);
+    return ctr_ok && cond_ok;
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
@@ -0,0 +1,171 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter.h"
+#include "nucleus/cpu/util.h"
+#include "nucleus/cpu/frontend/ppu/ppu_state.h"
+#include "nucleus/logger/logger.h"
+
+#include <type_traits>
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * PPC64 Instructions:
+ *  - UISA: Branch and Flow Control Instructions (Section: 4.2.4)
+ */
+
+// Evaluate the TO field of the trap instructions
+template <typename T>
+static bool checkTrap(U32 to, T a, T b) {
+    using UT = typename std::make_unsigned<T>::type;
+    return ((to & 0x10) && a < b) || ((to & 0x08) && a > b) || ((to & 0x04) && a == b) ||
+           ((to & 0x02) && UT(a) < UT(b)) || ((to & 0x01) && UT(a) > UT(b));
+}
+
+void Interpreter::bx(Instruction code)
+{
+    const U32 target = code.aa ? (code.li << 2) : currentAddress + (code.li << 2);
+    if (code.lk) {
+        state->lr = currentAddress + 4;
+        call(target);
+    } else {
+        state->pc = target;
+    }
+}
+
+void Interpreter::bcx(Instruction code)
+{
+    const U32 target = code.aa ? (code.bd << 2) : currentAddress + (code.bd << 2);
+    const bool taken = checkCondition(code);
+    if (code.lk) {
+        state->lr = currentAddress + 4;
+    }
+    if (taken) {
+        if (code.lk) {
+            call(target);
+        } else {
+            state->pc = target;
+        }
+    }
+}
+
+void Interpreter::bcctrx(Instruction code)
+{
+    // The CTR is never decremented by this instruction
+    const U32 target = U32(state->ctr) & ~3;
+    const bool taken = (code.bo & 0x10) || (getCRBit(code.bi) == ((code.bo & 0x08) != 0));
+    if (code.lk) {
+        state->lr = currentAddress + 4;
+    }
+    if (taken) {
+        if (code.lk) {
+            call(target);
+        } else {
+            state->pc = target;
+        }
+    }
+}
+
+void Interpreter::bclrx(Instruction code)
+{
+    const U32 target = U32(state->lr) & ~3;
+    const bool taken = checkCondition(code);
+    if (code.lk) {
+        state->lr = currentAddress + 4;
+    }
+    if (taken) {
+        if (code.lk) {
+            call(target);
+        } else {
+            state->pc = target;
+        }
+    }
+}
+
+void Interpreter::crand(Instruction code)
+{
+    setCRBit(code.crbd, getCRBit(code.crba) & getCRBit(code.crbb));
+}
+
+void Interpreter::crandc(Instruction code)
+{
+    setCRBit(code.crbd, getCRBit(code.crba) & !getCRBit(code.crbb));
+}
+
+void Interpreter::creqv(Instruction code)
+{
+    setCRBit(code.crbd, getCRBit(code.crba) == getCRBit(code.crbb));
+}
+
+void Interpreter::crnand(Instruction code)
+{
+    setCRBit(code.crbd, !(getCRBit(code.crba) & getCRBit(code.crbb)));
+}
+
+void Interpreter::crnor(Instruction code)
+{
+    setCRBit(code.crbd, !(getCRBit(code.crba) | getCRBit(code.crbb)));
+}
+
+void Interpreter::cror(Instruction code)
+{
+    setCRBit(code.crbd, getCRBit(code.crba) | getCRBit(code.crbb));
+}
+
+void Interpreter::crorc(Instruction code)
+{
+    setCRBit(code.crbd, getCRBit(code.crba) | !getCRBit(code.crbb));
+}
+
+void Interpreter::crxor(Instruction code)
+{
+    setCRBit(code.crbd, getCRBit(code.crba) != getCRBit(code.crbb));
+}
+
+void Interpreter::mcrf(Instruction code)
+{
+    state->setCRField(code.crfd, state->getCRField(code.crfs));
+}
+
+void Interpreter::sc(Instruction code)
+{
+    // TODO: Use code.lev fields
+    nucleusSysCall();
+}
+
+void Interpreter::td(Instruction code)
+{
+    if (checkTrap<S64>(code.to, state->r[code.ra], state->r[code.rb])) {
+        logger.error(LOG_CPU, "Interpreter::td: Trap at 0x%08X", currentAddress);
+    }
+}
+
+void Interpreter::tdi(Instruction code)
+{
+    if (checkTrap<S64>(code.to, state->r[code.ra], code.simm)) {
+        logger.error(LOG_CPU, "Interpreter::tdi: Trap at 0x%08X", currentAddress);
+    }
+}
+
+void Interpreter::tw(Instruction code)
+{
+    if (checkTrap<S32>(code.to, S32(state->r[code.ra]), S32(state->r[code.rb]))) {
+        logger.error(LOG_CPU, "Interpreter::tw: Trap at 0x%08X", currentAddress);
+    }
+}
+
+void Interpreter::twi(Instruction code)
+{
+    if (checkTrap<S32>(code.to, S32(state->r[code.ra]), code.simm)) {
+        logger.error(LOG_CPU, "Interpreter::twi: Trap at 0x%08X", currentAddress);
+    }
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
@@ -0,0 +1,146 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter.h"
+#include "nucleus/cpu/util.h"
+#include "nucleus/cpu/frontend/ppu/ppu_state.h"
+#include "nucleus/logger/logger.h"
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * PPC64 Instructions:
+ *  - UISA: Processor Control Instructions (Section: 4.2.5)
+ *  - VEA: Processor Control Instructions (Section: 4.3.1)
+ *  - VEA: Memory Control Instructions (Section: 4.3.3)
+ *  - VEA: External Control Instructions (Section: 4.3.4)
+ */
+
+void Interpreter::mfocrf(Instruction code)
+{
+    state->r[code.rd] = state->getCR();
+}
+
+void Interpreter::mfspr(Instruction code)
+{
+    const U32 n = (code.spr >> 5) | ((code.spr & 0x1F) << 5);
+    switch (n) {
+    case 0x001: // XER register
+        state->r[code.rd] =
+            (U64(state->xer.so) << 31) |
+            (U64(state->xer.ov) << 30) |
+            (U64(state->xer.ca) << 29) |
+            (U64(state->xer.bc) << 0);
+        break;
+    case 0x008: // LR register
+        state->r[code.rd] = state->lr;
+        break;
+    case 0x009: // CTR register
+        state->r[code.rd] = state->ctr;
+        break;
+
+    default:
+        logger.error(LOG_CPU, "Interpreter::mfspr error: Unknown SPR");
+    }
+}
+
+void Interpreter::mtocrf(Instruction code)
+{
+    // Expand each bit of CRM into the mask of its field
+    U32 mask = 0;
+    for (U32 field = 0; field < 8; field++) {
+        if (code.crm & (1 << (7 - field))) {
+            mask |= 0xF << (4 * (7 - field));
+        }
+    }
+    state->setCRMasked(mask, U32(state->r[code.rs]));
+}
+
+void Interpreter::mtspr(Instruction code)
+{
+    const U64 rs = state->r[code.rs];
+
+    const U32 n = (code.spr >> 5) | ((code.spr & 0x1F) << 5);
+    switch (n) {
+    case 0x001: // XER register
+        state->xer.so = (rs >> 31) & 1;
+        state->xer.ov = (rs >> 30) & 1;
+        state->xer.ca = (rs >> 29) & 1;
+        state->xer.bc = rs & 0x7F;
+        break;
+    case 0x008: // LR register
+        state->lr = rs;
+        break;
+    case 0x009: // CTR register
+        state->ctr = rs;
+        break;
+
+    default:
+        logger.error(LOG_CPU, "Interpreter::mtspr error: Unknown SPR");
+    }
+}
+
+void Interpreter::mftb(Instruction code)
+{
+    const U64 timestamp = nucleusTime();
+
+    const U32 tbr = (code.spr >> 5) | ((code.spr & 0x1f) << 5);
+    switch (tbr) {
+    case 0x10C:
+        state->r[code.rd] = timestamp;
+        break;
+    case 0x10D:
+        state->r[code.rd] = timestamp >> 32;
+        break;
+
+    default:
+        logger.error(LOG_CPU, "Interpreter::mftb error: Invalid timebase register");
+    }
+}
+
+void Interpreter::dcbf(Instruction code)
+{
+}
+
+void Interpreter::dcbst(Instruction code)
+{
+}
+
+void Interpreter::dcbt(Instruction code)
+{
+}
+
+void Interpreter::dcbtst(Instruction code)
+{
+}
+
+void Interpreter::dcbz(Instruction code)
+{
+    // Clear the 128-byte cache line containing the address
+    const U32 addr = U32((code.ra ? state->r[code.ra] : 0) + state->r[code.rb]) & ~0x7F;
+    for (U32 offset = 0; offset < 128; offset += 8) {
+        memory->write64(addr + offset, 0);
+    }
+}
+
+void Interpreter::icbi(Instruction code)
+{
+}
+
+void Interpreter::eciwx(Instruction code)
+{
+    logger.error(LOG_CPU, "Interpreter::eciwx error: Unimplemented");
+}
+
+void Interpreter::ecowx(Instruction code)
+{
+    logger.error(LOG_CPU, "Interpreter::ecowx error: Unimplemented");
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
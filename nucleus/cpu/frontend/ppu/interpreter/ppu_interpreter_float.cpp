@@ -0,0 +1,406 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter.h"
+#include "nucleus/cpu/frontend/ppu/ppu_state.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * PPC64 Instructions:
+ *  - UISA: Floating-Point Instructions (Section: 4.2.2)
+ */
+
+static U64 getBits(F64 value) {
+    U64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static F64 fromBits(U64 bits) {
+    F64 value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Round to single-precision, as done by the single-precision arithmetic instructions
+static F64 toSingle(F64 value) {
+    return F64(F32(value));
+}
+
+// Round to an integral value according to the FPSCR rounding control
+static F64 roundInteger(F64 value, U32 mode) {
+    switch (mode) {
+    case FPSCR_RN_ZERO:
+        return std::trunc(value);
+    case FPSCR_RN_PINF:
+        return std::ceil(value);
+    case FPSCR_RN_MINF:
+        return std::floor(value);
+    default:
+        return std::nearbyint(value);
+    }
+}
+
+void Interpreter::fabsx(Instruction code)
+{
+    state->f[code.frd] = fromBits(getBits(state->f[code.frb]) & ~0x8000000000000000ULL);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::faddx(Instruction code)
+{
+    state->f[code.frd] = state->f[code.fra] + state->f[code.frb];
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::faddsx(Instruction code)
+{
+    state->f[code.frd] = toSingle(state->f[code.fra] + state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fcfidx(Instruction code)
+{
+    state->f[code.frd] = F64(S64(getBits(state->f[code.frb])));
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fcmpo(Instruction code)
+{
+    fcmpu(code);
+}
+
+void Interpreter::fcmpu(Instruction code)
+{
+    const F64 fra = state->f[code.fra];
+    const F64 frb = state->f[code.frb];
+
+    // Unordered comparisons set the FU bit, which shares the position of SO
+    U32 field = PPUState::CR_SO;
+    if (fra < frb) {
+        field = PPUState::CR_LT;
+    } else if (fra > frb) {
+        field = PPUState::CR_GT;
+    } else if (fra == frb) {
+        field = PPUState::CR_EQ;
+    }
+    state->setCRField(code.crfd, field);
+    state->fpscr.FPRF = (state->fpscr.FPRF & 0x10) | field;
+}
+
+void Interpreter::fctidx(Instruction code)
+{
+    const F64 frb = roundInteger(state->f[code.frb], state->fpscr.RN);
+    S64 result;
+    if (std::isnan(frb) || frb < -9223372036854775808.0) {
+        result = S64(0x8000000000000000ULL);
+        state->fpscr.setException(FPSCR_VXCVI | FPSCR_VX);
+    } else if (frb >= 9223372036854775808.0) {
+        result = 0x7FFFFFFFFFFFFFFFLL;
+        state->fpscr.setException(FPSCR_VXCVI | FPSCR_VX);
+    } else {
+        result = S64(frb);
+    }
+    state->f[code.frd] = fromBits(result);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fctidzx(Instruction code)
+{
+    const U32 rn = state->fpscr.RN;
+    state->fpscr.RN = FPSCR_RN_ZERO;
+    fctidx(code);
+    state->fpscr.RN = rn;
+}
+
+void Interpreter::fctiwx(Instruction code)
+{
+    const F64 frb = roundInteger(state->f[code.frb], state->fpscr.RN);
+    S32 result;
+    if (std::isnan(frb) || frb < -2147483648.0) {
+        result = S32(0x80000000);
+        state->fpscr.setException(FPSCR_VXCVI | FPSCR_VX);
+    } else if (frb >= 2147483648.0) {
+        result = 0x7FFFFFFF;
+        state->fpscr.setException(FPSCR_VXCVI | FPSCR_VX);
+    } else {
+        result = S32(frb);
+    }
+    state->f[code.frd] = fromBits(U32(result));
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fctiwzx(Instruction code)
+{
+    const U32 rn = state->fpscr.RN;
+    state->fpscr.RN = FPSCR_RN_ZERO;
+    fctiwx(code);
+    state->fpscr.RN = rn;
+}
+
+void Interpreter::fdivx(Instruction code)
+{
+    state->f[code.frd] = state->f[code.fra] / state->f[code.frb];
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fdivsx(Instruction code)
+{
+    state->f[code.frd] = toSingle(state->f[code.fra] / state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fmaddx(Instruction code)
+{
+    state->f[code.frd] = std::fma(state->f[code.fra], state->f[code.frc], state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fmaddsx(Instruction code)
+{
+    state->f[code.frd] = toSingle(std::fma(state->f[code.fra], state->f[code.frc], state->f[code.frb]));
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fmrx(Instruction code)
+{
+    state->f[code.frd] = state->f[code.frb];
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fmsubx(Instruction code)
+{
+    state->f[code.frd] = std::fma(state->f[code.fra], state->f[code.frc], -state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fmsubsx(Instruction code)
+{
+    state->f[code.frd] = toSingle(std::fma(state->f[code.fra], state->f[code.frc], -state->f[code.frb]));
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fmulx(Instruction code)
+{
+    state->f[code.frd] = state->f[code.fra] * state->f[code.frc];
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fmulsx(Instruction code)
+{
+    state->f[code.frd] = toSingle(state->f[code.fra] * state->f[code.frc]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fnabsx(Instruction code)
+{
+    state->f[code.frd] = fromBits(getBits(state->f[code.frb]) | 0x8000000000000000ULL);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fnegx(Instruction code)
+{
+    state->f[code.frd] = fromBits(getBits(state->f[code.frb]) ^ 0x8000000000000000ULL);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fnmaddx(Instruction code)
+{
+    state->f[code.frd] = -std::fma(state->f[code.fra], state->f[code.frc], state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fnmaddsx(Instruction code)
+{
+    state->f[code.frd] = -toSingle(std::fma(state->f[code.fra], state->f[code.frc], state->f[code.frb]));
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fnmsubx(Instruction code)
+{
+    state->f[code.frd] = -std::fma(state->f[code.fra], state->f[code.frc], -state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fnmsubsx(Instruction code)
+{
+    state->f[code.frd] = -toSingle(std::fma(state->f[code.fra], state->f[code.frc], -state->f[code.frb]));
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fresx(Instruction code)
+{
+    state->f[code.frd] = toSingle(1.0 / state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::frspx(Instruction code)
+{
+    state->f[code.frd] = toSingle(state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::frsqrtex(Instruction code)
+{
+    state->f[code.frd] = 1.0 / std::sqrt(state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fselx(Instruction code)
+{
+    state->f[code.frd] = (state->f[code.fra] >= 0.0) ? state->f[code.frc] : state->f[code.frb];
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fsqrtx(Instruction code)
+{
+    state->f[code.frd] = std::sqrt(state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fsqrtsx(Instruction code)
+{
+    state->f[code.frd] = toSingle(std::sqrt(state->f[code.frb]));
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fsubx(Instruction code)
+{
+    state->f[code.frd] = state->f[code.fra] - state->f[code.frb];
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::fsubsx(Instruction code)
+{
+    state->f[code.frd] = toSingle(state->f[code.fra] - state->f[code.frb]);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::mcrfs(Instruction code)
+{
+    const U32 shift = 4 * (7 - code.crfs);
+    const U32 field = (state->fpscr.FPSCR >> shift) & 0xF;
+    state->setCRField(code.crfd, field);
+
+    // Clear the exception bits copied, except the summaries FEX and VX
+    const U32 exceptionBits = 0x9FF80700;
+    state->fpscr.FPSCR &= ~((0xFU << shift) & exceptionBits);
+}
+
+void Interpreter::mffsx(Instruction code)
+{
+    state->f[code.frd] = fromBits(state->fpscr.FPSCR);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::mtfsb0x(Instruction code)
+{
+    state->fpscr.FPSCR &= ~(0x80000000U >> code.crbd);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::mtfsb1x(Instruction code)
+{
+    state->fpscr.FPSCR |= (0x80000000U >> code.crbd);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::mtfsfix(Instruction code)
+{
+    const U32 shift = 4 * (7 - code.crfd);
+    state->fpscr.FPSCR = (state->fpscr.FPSCR & ~(0xFU << shift)) | (code.imm << shift);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+void Interpreter::mtfsfx(Instruction code)
+{
+    U32 mask = 0;
+    for (U32 field = 0; field < 8; field++) {
+        if (code.fm & (1 << (7 - field))) {
+            mask |= 0xF0000000U >> (4 * field);
+        }
+    }
+    const U32 frb = U32(getBits(state->f[code.frb]));
+    state->fpscr.FPSCR = (state->fpscr.FPSCR & ~mask) | (frb & mask);
+    if (code.rc) {
+        updateCR1();
+    }
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
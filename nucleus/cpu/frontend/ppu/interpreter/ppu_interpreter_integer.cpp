@@ -0,0 +1,760 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter.h"
+#include "nucleus/cpu/frontend/ppu/ppu_state.h"
+#include "nucleus/cpu/frontend/ppu/ppu_utils.h"
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * PPC64 Instructions:
+ *  - UISA: Integer instructions (Section: 4.2.1)
+ */
+
+// Add with carry-in, computing the carry-out and the signed overflow
+static U64 addWithCarry(U64 a, U64 b, U64 carry, U8& ca, bool& ov) {
+    const U64 result = a + b + carry;
+    ca = carry ? (result <= a) : (result < a);
+    ov = (((a ^ result) & (b ^ result)) >> 63) != 0;
+    return result;
+}
+
+static U64 rotl64(U64 value, U32 shift) {
+    shift &= 63;
+    return shift ? (value << shift) | (value >> (64 - shift)) : value;
+}
+
+// Rotate the lower word of a register, duplicated on the upper word
+static U64 rotl32(U64 value, U32 shift) {
+    const U64 word = U32(value);
+    return rotl64(word | (word << 32), shift);
+}
+
+static U32 countLeadingZeros64(U64 value) {
+    if (value == 0) {
+        return 64;
+    }
+    U32 count = 0;
+    for (U32 shift = 32; shift > 0; shift >>= 1) {
+        if (!(value >> (64 - shift))) {
+            value <<= shift;
+            count += shift;
+        }
+    }
+    return count;
+}
+
+// Upper 64 bits of the 128-bit product
+static U64 mulhu64(U64 a, U64 b) {
+    const U64 a_lo = U32(a), a_hi = a >> 32;
+    const U64 b_lo = U32(b), b_hi = b >> 32;
+    const U64 lo_lo = a_lo * b_lo;
+    const U64 hi_lo = a_hi * b_lo;
+    const U64 lo_hi = a_lo * b_hi;
+    const U64 hi_hi = a_hi * b_hi;
+    const U64 cross = (lo_lo >> 32) + U32(hi_lo) + lo_hi;
+    return hi_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+static S64 mulhs64(S64 a, S64 b) {
+    U64 result = mulhu64(a, b);
+    result -= (a < 0) ? U64(b) : 0;
+    result -= (b < 0) ? U64(a) : 0;
+    return result;
+}
+
+void Interpreter::addx(Instruction code)
+{
+    bool ov;
+    U8 ca;
+    const U64 rd = addWithCarry(state->r[code.ra], state->r[code.rb], 0, ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::addcx(Instruction code)
+{
+    bool ov;
+    const U64 rd = addWithCarry(state->r[code.ra], state->r[code.rb], 0, state->xer.ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::addex(Instruction code)
+{
+    bool ov;
+    const U64 rd = addWithCarry(state->r[code.ra], state->r[code.rb], state->xer.ca, state->xer.ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::addi(Instruction code)
+{
+    const U64 ra = code.ra ? state->r[code.ra] : 0;
+    state->r[code.rd] = ra + S64(code.simm);
+}
+
+void Interpreter::addic(Instruction code)
+{
+    bool ov;
+    state->r[code.rd] = addWithCarry(state->r[code.ra], S64(code.simm), 0, state->xer.ca, ov);
+}
+
+void Interpreter::addic_(Instruction code)
+{
+    bool ov;
+    const U64 rd = addWithCarry(state->r[code.ra], S64(code.simm), 0, state->xer.ca, ov);
+    updateCR0(rd);
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::addis(Instruction code)
+{
+    const U64 ra = code.ra ? state->r[code.ra] : 0;
+    state->r[code.rd] = ra + (S64(code.simm) << 16);
+}
+
+void Interpreter::addmex(Instruction code)
+{
+    bool ov;
+    const U64 rd = addWithCarry(state->r[code.ra], ~0ULL, state->xer.ca, state->xer.ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::addzex(Instruction code)
+{
+    bool ov;
+    const U64 rd = addWithCarry(state->r[code.ra], 0, state->xer.ca, state->xer.ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::andx(Instruction code)
+{
+    const U64 ra = state->r[code.rs] & state->r[code.rb];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::andcx(Instruction code)
+{
+    const U64 ra = state->r[code.rs] & ~state->r[code.rb];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::andi_(Instruction code)
+{
+    const U64 ra = state->r[code.rs] & code.uimm;
+    updateCR0(ra);
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::andis_(Instruction code)
+{
+    const U64 ra = state->r[code.rs] & (U64(code.uimm) << 16);
+    updateCR0(ra);
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::cmp(Instruction code)
+{
+    if (code.l10) {
+        updateCR<S64>(code.crfd, state->r[code.ra], state->r[code.rb]);
+    } else {
+        updateCR<S32>(code.crfd, state->r[code.ra], state->r[code.rb]);
+    }
+}
+
+void Interpreter::cmpi(Instruction code)
+{
+    if (code.l10) {
+        updateCR<S64>(code.crfd, state->r[code.ra], code.simm);
+    } else {
+        updateCR<S32>(code.crfd, state->r[code.ra], code.simm);
+    }
+}
+
+void Interpreter::cmpl(Instruction code)
+{
+    if (code.l10) {
+        updateCR<U64>(code.crfd, state->r[code.ra], state->r[code.rb]);
+    } else {
+        updateCR<U32>(code.crfd, state->r[code.ra], state->r[code.rb]);
+    }
+}
+
+void Interpreter::cmpli(Instruction code)
+{
+    if (code.l10) {
+        updateCR<U64>(code.crfd, state->r[code.ra], code.uimm);
+    } else {
+        updateCR<U32>(code.crfd, state->r[code.ra], code.uimm);
+    }
+}
+
+void Interpreter::cntlzdx(Instruction code)
+{
+    const U64 ra = countLeadingZeros64(state->r[code.rs]);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::cntlzwx(Instruction code)
+{
+    const U64 ra = countLeadingZeros64(U32(state->r[code.rs])) - 32;
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::divdx(Instruction code)
+{
+    const S64 ra = state->r[code.ra];
+    const S64 rb = state->r[code.rb];
+
+    // Results of invalid divisions are undefined
+    const bool invalid = (rb == 0) || (ra == S64(0x8000000000000000ULL) && rb == -1);
+    const U64 rd = invalid ? 0 : U64(ra / rb);
+    if (code.oe) {
+        updateOV(invalid);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::divdux(Instruction code)
+{
+    const U64 ra = state->r[code.ra];
+    const U64 rb = state->r[code.rb];
+
+    const bool invalid = (rb == 0);
+    const U64 rd = invalid ? 0 : ra / rb;
+    if (code.oe) {
+        updateOV(invalid);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::divwx(Instruction code)
+{
+    const S32 ra = S32(state->r[code.ra]);
+    const S32 rb = S32(state->r[code.rb]);
+
+    const bool invalid = (rb == 0) || (ra == S32(0x80000000) && rb == -1);
+    const U64 rd = invalid ? 0 : U32(ra / rb);
+    if (code.oe) {
+        updateOV(invalid);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::divwux(Instruction code)
+{
+    const U32 ra = U32(state->r[code.ra]);
+    const U32 rb = U32(state->r[code.rb]);
+
+    const bool invalid = (rb == 0);
+    const U64 rd = invalid ? 0 : ra / rb;
+    if (code.oe) {
+        updateOV(invalid);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::eqvx(Instruction code)
+{
+    const U64 ra = ~(state->r[code.rs] ^ state->r[code.rb]);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::extsbx(Instruction code)
+{
+    const U64 ra = S64(S8(state->r[code.rs]));
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::extshx(Instruction code)
+{
+    const U64 ra = S64(S16(state->r[code.rs]));
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::extswx(Instruction code)
+{
+    const U64 ra = S64(S32(state->r[code.rs]));
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::mulhdx(Instruction code)
+{
+    const U64 rd = mulhs64(state->r[code.ra], state->r[code.rb]);
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::mulhdux(Instruction code)
+{
+    const U64 rd = mulhu64(state->r[code.ra], state->r[code.rb]);
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::mulhwx(Instruction code)
+{
+    const S64 product = S64(S32(state->r[code.ra])) * S64(S32(state->r[code.rb]));
+    const U64 rd = U32(product >> 32);
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::mulhwux(Instruction code)
+{
+    const U64 product = U64(U32(state->r[code.ra])) * U64(U32(state->r[code.rb]));
+    const U64 rd = product >> 32;
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::mulldx(Instruction code)
+{
+    const S64 ra = state->r[code.ra];
+    const S64 rb = state->r[code.rb];
+    const U64 rd = U64(ra) * U64(rb);
+    if (code.oe) {
+        // Overflow if the upper half of the product is not the sign extension of the lower half
+        updateOV(mulhs64(ra, rb) != (S64(rd) >> 63));
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::mulli(Instruction code)
+{
+    state->r[code.rd] = U64(state->r[code.ra]) * U64(S64(code.simm));
+}
+
+void Interpreter::mullwx(Instruction code)
+{
+    const S64 product = S64(S32(state->r[code.ra])) * S64(S32(state->r[code.rb]));
+    if (code.oe) {
+        updateOV(product != S64(S32(product)));
+    }
+    if (code.rc) {
+        updateCR0(product);
+    }
+    state->r[code.rd] = product;
+}
+
+void Interpreter::nandx(Instruction code)
+{
+    const U64 ra = ~(state->r[code.rs] & state->r[code.rb]);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::negx(Instruction code)
+{
+    bool ov;
+    U8 ca;
+    const U64 rd = addWithCarry(~state->r[code.ra], 0, 1, ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::norx(Instruction code)
+{
+    const U64 ra = ~(state->r[code.rs] | state->r[code.rb]);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::orx(Instruction code)
+{
+    const U64 ra = state->r[code.rs] | state->r[code.rb];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::orcx(Instruction code)
+{
+    const U64 ra = state->r[code.rs] | ~state->r[code.rb];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::ori(Instruction code)
+{
+    state->r[code.ra] = state->r[code.rs] | code.uimm;
+}
+
+void Interpreter::oris(Instruction code)
+{
+    state->r[code.ra] = state->r[code.rs] | (U64(code.uimm) << 16);
+}
+
+void Interpreter::rldc_lr(Instruction code)
+{
+    U64 ra = rotl64(state->r[code.rs], U32(state->r[code.rb]));
+
+    // Bit 30 selects between rldcl and rldcr, which share the mask field
+    if (code.sh_ == 0) {
+        const U32 mb = code.mb | (code.mb_ << 5);
+        ra &= rotateMask[mb][63];
+    } else {
+        const U32 me = code.me_ | (code.me__ << 5);
+        ra &= rotateMask[0][me];
+    }
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::rldicx(Instruction code)
+{
+    const U32 sh = code.sh | (code.sh_ << 5);
+    const U32 mb = code.mb | (code.mb_ << 5);
+    const U64 ra = rotl64(state->r[code.rs], sh) & rotateMask[mb][63 - sh];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::rldiclx(Instruction code)
+{
+    const U32 sh = code.sh | (code.sh_ << 5);
+    const U32 mb = code.mb | (code.mb_ << 5);
+    const U64 ra = rotl64(state->r[code.rs], sh) & rotateMask[mb][63];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::rldicrx(Instruction code)
+{
+    const U32 sh = code.sh | (code.sh_ << 5);
+    const U32 me = code.me_ | (code.me__ << 5);
+    const U64 ra = rotl64(state->r[code.rs], sh) & rotateMask[0][me];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::rldimix(Instruction code)
+{
+    const U32 sh = code.sh | (code.sh_ << 5);
+    const U32 mb = code.mb | (code.mb_ << 5);
+    const U64 mask = rotateMask[mb][63 - sh];
+    const U64 ra = (rotl64(state->r[code.rs], sh) & mask) | (state->r[code.ra] & ~mask);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::rlwimix(Instruction code)
+{
+    const U64 mask = rotateMask[32 + code.mb][32 + code.me];
+    const U64 ra = (rotl32(state->r[code.rs], code.sh) & mask) | (state->r[code.ra] & ~mask);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::rlwinmx(Instruction code)
+{
+    const U64 ra = rotl32(state->r[code.rs], code.sh) & rotateMask[32 + code.mb][32 + code.me];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::rlwnmx(Instruction code)
+{
+    const U32 sh = state->r[code.rb] & 0x1F;
+    const U64 ra = rotl32(state->r[code.rs], sh) & rotateMask[32 + code.mb][32 + code.me];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::sldx(Instruction code)
+{
+    const U32 sh = state->r[code.rb] & 0x7F;
+    const U64 ra = (sh & 0x40) ? 0 : state->r[code.rs] << sh;
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::slwx(Instruction code)
+{
+    const U32 sh = state->r[code.rb] & 0x3F;
+    const U64 ra = (sh & 0x20) ? 0 : U32(state->r[code.rs] << sh);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::sradx(Instruction code)
+{
+    const S64 rs = state->r[code.rs];
+    const U32 sh = state->r[code.rb] & 0x7F;
+
+    // Shifting 64 bits or more fills the register with the sign bit
+    const S64 ra = (sh & 0x40) ? (rs >> 63) : (rs >> sh);
+    const U64 lost = (sh & 0x40) ? rs : (rs & ((1ULL << sh) - 1));
+    state->xer.ca = (rs < 0) && (lost != 0);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::sradix(Instruction code)
+{
+    const S64 rs = state->r[code.rs];
+    const U32 sh = code.sh | (code.sh_ << 5);
+
+    const S64 ra = rs >> sh;
+    state->xer.ca = (rs < 0) && ((rs & ((1ULL << sh) - 1)) != 0);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::srawx(Instruction code)
+{
+    const S32 rs = S32(state->r[code.rs]);
+    const U32 sh = state->r[code.rb] & 0x3F;
+
+    const S64 ra = (sh & 0x20) ? (rs >> 31) : (rs >> sh);
+    const U32 lost = (sh & 0x20) ? rs : (rs & ((1U << sh) - 1));
+    state->xer.ca = (rs < 0) && (lost != 0);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::srawix(Instruction code)
+{
+    const S32 rs = S32(state->r[code.rs]);
+    const U32 sh = code.sh;
+
+    const S64 ra = rs >> sh;
+    state->xer.ca = (rs < 0) && ((rs & ((1U << sh) - 1)) != 0);
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::srdx(Instruction code)
+{
+    const U32 sh = state->r[code.rb] & 0x7F;
+    const U64 ra = (sh & 0x40) ? 0 : state->r[code.rs] >> sh;
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::srwx(Instruction code)
+{
+    const U32 sh = state->r[code.rb] & 0x3F;
+    const U64 ra = (sh & 0x20) ? 0 : U32(state->r[code.rs]) >> sh;
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::subfx(Instruction code)
+{
+    bool ov;
+    U8 ca;
+    const U64 rd = addWithCarry(~state->r[code.ra], state->r[code.rb], 1, ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::subfcx(Instruction code)
+{
+    bool ov;
+    const U64 rd = addWithCarry(~state->r[code.ra], state->r[code.rb], 1, state->xer.ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::subfex(Instruction code)
+{
+    bool ov;
+    const U64 rd = addWithCarry(~state->r[code.ra], state->r[code.rb], state->xer.ca, state->xer.ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::subfic(Instruction code)
+{
+    bool ov;
+    state->r[code.rd] = addWithCarry(~state->r[code.ra], S64(code.simm), 1, state->xer.ca, ov);
+}
+
+void Interpreter::subfmex(Instruction code)
+{
+    bool ov;
+    const U64 rd = addWithCarry(~state->r[code.ra], ~0ULL, state->xer.ca, state->xer.ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::subfzex(Instruction code)
+{
+    bool ov;
+    const U64 rd = addWithCarry(~state->r[code.ra], 0, state->xer.ca, state->xer.ca, ov);
+    if (code.oe) {
+        updateOV(ov);
+    }
+    if (code.rc) {
+        updateCR0(rd);
+    }
+    state->r[code.rd] = rd;
+}
+
+void Interpreter::xorx(Instruction code)
+{
+    const U64 ra = state->r[code.rs] ^ state->r[code.rb];
+    if (code.rc) {
+        updateCR0(ra);
+    }
+    state->r[code.ra] = ra;
+}
+
+void Interpreter::xori(Instruction code)
+{
+    state->r[code.ra] = state->r[code.rs] ^ code.uimm;
+}
+
+void Interpreter::xoris(Instruction code)
+{
+    state->r[code.ra] = state->r[code.rs] ^ (U64(code.uimm) << 16);
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
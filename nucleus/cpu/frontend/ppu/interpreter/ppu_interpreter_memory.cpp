@@ -0,0 +1,535 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter.h"
+#include "nucleus/cpu/frontend/ppu/ppu_state.h"
+
+#include <atomic>
+#include <cstring>
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * PPC64 Instructions:
+ *  - UISA: Load and Store Instructions (Section: 4.2.3)
+ *  - UISA: Memory Synchronization Instructions (Section: 4.2.6)
+ *  - VEA: Memory Synchronization Instructions (Section: 4.3.2)
+ */
+
+// Effective address of D-form instructions
+static U32 addrD(const PPUState* state, Instruction code) {
+    return U32((code.ra ? state->r[code.ra] : 0) + code.d);
+}
+
+// Effective address of DS-form instructions
+static U32 addrDS(const PPUState* state, Instruction code) {
+    return U32((code.ra ? state->r[code.ra] : 0) + (S64(code.ds) << 2));
+}
+
+// Effective address of X-form instructions
+static U32 addrX(const PPUState* state, Instruction code) {
+    return U32((code.ra ? state->r[code.ra] : 0) + state->r[code.rb]);
+}
+
+static F64 loadSingle(U32 bits) {
+    F32 value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static U32 storeSingle(F64 value) {
+    const F32 single = F32(value);
+    U32 bits;
+    std::memcpy(&bits, &single, sizeof(bits));
+    return bits;
+}
+
+static U64& getBits(F64& value) {
+    return reinterpret_cast<U64&>(value);
+}
+
+void Interpreter::lbz(Instruction code)
+{
+    state->r[code.rd] = memory->read8(addrD(state, code));
+}
+
+void Interpreter::lbzu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    state->r[code.rd] = memory->read8(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lbzux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    state->r[code.rd] = memory->read8(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lbzx(Instruction code)
+{
+    state->r[code.rd] = memory->read8(addrX(state, code));
+}
+
+void Interpreter::ld(Instruction code)
+{
+    state->r[code.rd] = memory->read64(addrDS(state, code));
+}
+
+void Interpreter::ldarx(Instruction code)
+{
+    state->r[code.rd] = readReserved(addrX(state, code), 8);
+}
+
+void Interpreter::ldbrx(Instruction code)
+{
+    state->r[code.rd] = SE64(memory->read64(addrX(state, code)));
+}
+
+void Interpreter::ldu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + (S64(code.ds) << 2);
+    state->r[code.rd] = memory->read64(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::ldux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    state->r[code.rd] = memory->read64(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::ldx(Instruction code)
+{
+    state->r[code.rd] = memory->read64(addrX(state, code));
+}
+
+void Interpreter::lfd(Instruction code)
+{
+    getBits(state->f[code.frd]) = memory->read64(addrD(state, code));
+}
+
+void Interpreter::lfdu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    getBits(state->f[code.frd]) = memory->read64(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lfdux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    getBits(state->f[code.frd]) = memory->read64(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lfdx(Instruction code)
+{
+    getBits(state->f[code.frd]) = memory->read64(addrX(state, code));
+}
+
+void Interpreter::lfs(Instruction code)
+{
+    state->f[code.frd] = loadSingle(memory->read32(addrD(state, code)));
+}
+
+void Interpreter::lfsu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    state->f[code.frd] = loadSingle(memory->read32(U32(addr)));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lfsux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    state->f[code.frd] = loadSingle(memory->read32(U32(addr)));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lfsx(Instruction code)
+{
+    state->f[code.frd] = loadSingle(memory->read32(addrX(state, code)));
+}
+
+void Interpreter::lha(Instruction code)
+{
+    state->r[code.rd] = S64(S16(memory->read16(addrD(state, code))));
+}
+
+void Interpreter::lhau(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    state->r[code.rd] = S64(S16(memory->read16(U32(addr))));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lhaux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    state->r[code.rd] = S64(S16(memory->read16(U32(addr))));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lhax(Instruction code)
+{
+    state->r[code.rd] = S64(S16(memory->read16(addrX(state, code))));
+}
+
+void Interpreter::lhbrx(Instruction code)
+{
+    state->r[code.rd] = SE16(memory->read16(addrX(state, code)));
+}
+
+void Interpreter::lhz(Instruction code)
+{
+    state->r[code.rd] = memory->read16(addrD(state, code));
+}
+
+void Interpreter::lhzu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    state->r[code.rd] = memory->read16(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lhzux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    state->r[code.rd] = memory->read16(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lhzx(Instruction code)
+{
+    state->r[code.rd] = memory->read16(addrX(state, code));
+}
+
+void Interpreter::lmw(Instruction code)
+{
+    U32 addr = addrD(state, code);
+    for (U32 reg = code.rd; reg < 32; reg++) {
+        state->r[reg] = memory->read32(addr);
+        addr += 4;
+    }
+}
+
+void Interpreter::lswi(Instruction code)
+{
+    U32 addr = code.ra ? U32(state->r[code.ra]) : 0;
+    U32 count = code.nb ? code.nb : 32;
+    U32 reg = code.rd;
+    while (count > 0) {
+        // Bytes are loaded left-justified, wrapping around from r31 to r0
+        U64 value = 0;
+        for (U32 i = 0; i < 4; i++) {
+            const U32 byte = (count > 0) ? memory->read8(addr++) : 0;
+            value |= U64(byte) << (24 - 8 * i);
+            count -= (count > 0) ? 1 : 0;
+        }
+        state->r[reg] = value;
+        reg = (reg + 1) & 0x1F;
+    }
+}
+
+void Interpreter::lswx(Instruction code)
+{
+    U32 addr = addrX(state, code);
+    U32 count = state->xer.bc;
+    U32 reg = code.rd;
+    while (count > 0) {
+        U64 value = 0;
+        for (U32 i = 0; i < 4; i++) {
+            const U32 byte = (count > 0) ? memory->read8(addr++) : 0;
+            value |= U64(byte) << (24 - 8 * i);
+            count -= (count > 0) ? 1 : 0;
+        }
+        state->r[reg] = value;
+        reg = (reg + 1) & 0x1F;
+    }
+}
+
+void Interpreter::lwa(Instruction code)
+{
+    state->r[code.rd] = S64(S32(memory->read32(addrDS(state, code))));
+}
+
+void Interpreter::lwarx(Instruction code)
+{
+    state->r[code.rd] = readReserved(addrX(state, code), 4);
+}
+
+void Interpreter::lwaux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    state->r[code.rd] = S64(S32(memory->read32(U32(addr))));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lwax(Instruction code)
+{
+    state->r[code.rd] = S64(S32(memory->read32(addrX(state, code))));
+}
+
+void Interpreter::lwbrx(Instruction code)
+{
+    state->r[code.rd] = SE32(memory->read32(addrX(state, code)));
+}
+
+void Interpreter::lwz(Instruction code)
+{
+    state->r[code.rd] = memory->read32(addrD(state, code));
+}
+
+void Interpreter::lwzu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    state->r[code.rd] = memory->read32(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lwzux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    state->r[code.rd] = memory->read32(U32(addr));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::lwzx(Instruction code)
+{
+    state->r[code.rd] = memory->read32(addrX(state, code));
+}
+
+void Interpreter::stb(Instruction code)
+{
+    memory->write8(addrD(state, code), U8(state->r[code.rs]));
+}
+
+void Interpreter::stbu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    memory->write8(U32(addr), U8(state->r[code.rs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stbux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    memory->write8(U32(addr), U8(state->r[code.rs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stbx(Instruction code)
+{
+    memory->write8(addrX(state, code), U8(state->r[code.rs]));
+}
+
+void Interpreter::std(Instruction code)
+{
+    memory->write64(addrDS(state, code), state->r[code.rs]);
+}
+
+void Interpreter::stdcx_(Instruction code)
+{
+    // CR0 = 0b00 || success || XER[SO]
+    const bool success = writeConditional(addrX(state, code), state->r[code.rs], 8);
+    state->setCRField(0, (success ? PPUState::CR_EQ : 0) | (state->xer.so ? PPUState::CR_SO : 0));
+}
+
+void Interpreter::stdu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + (S64(code.ds) << 2);
+    memory->write64(U32(addr), state->r[code.rs]);
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stdux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    memory->write64(U32(addr), state->r[code.rs]);
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stdx(Instruction code)
+{
+    memory->write64(addrX(state, code), state->r[code.rs]);
+}
+
+void Interpreter::stfd(Instruction code)
+{
+    memory->write64(addrD(state, code), getBits(state->f[code.frs]));
+}
+
+void Interpreter::stfdu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    memory->write64(U32(addr), getBits(state->f[code.frs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stfdux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    memory->write64(U32(addr), getBits(state->f[code.frs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stfdx(Instruction code)
+{
+    memory->write64(addrX(state, code), getBits(state->f[code.frs]));
+}
+
+void Interpreter::stfiwx(Instruction code)
+{
+    memory->write32(addrX(state, code), U32(getBits(state->f[code.frs])));
+}
+
+void Interpreter::stfs(Instruction code)
+{
+    memory->write32(addrD(state, code), storeSingle(state->f[code.frs]));
+}
+
+void Interpreter::stfsu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    memory->write32(U32(addr), storeSingle(state->f[code.frs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stfsux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    memory->write32(U32(addr), storeSingle(state->f[code.frs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stfsx(Instruction code)
+{
+    memory->write32(addrX(state, code), storeSingle(state->f[code.frs]));
+}
+
+void Interpreter::sth(Instruction code)
+{
+    memory->write16(addrD(state, code), U16(state->r[code.rs]));
+}
+
+void Interpreter::sthbrx(Instruction code)
+{
+    memory->write16(addrX(state, code), SE16(U16(state->r[code.rs])));
+}
+
+void Interpreter::sthu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    memory->write16(U32(addr), U16(state->r[code.rs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::sthux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    memory->write16(U32(addr), U16(state->r[code.rs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::sthx(Instruction code)
+{
+    memory->write16(addrX(state, code), U16(state->r[code.rs]));
+}
+
+void Interpreter::stmw(Instruction code)
+{
+    U32 addr = addrD(state, code);
+    for (U32 reg = code.rs; reg < 32; reg++) {
+        memory->write32(addr, U32(state->r[reg]));
+        addr += 4;
+    }
+}
+
+void Interpreter::stswi(Instruction code)
+{
+    U32 addr = code.ra ? U32(state->r[code.ra]) : 0;
+    U32 count = code.nb ? code.nb : 32;
+    U32 reg = code.rs;
+    while (count > 0) {
+        const U32 value = U32(state->r[reg]);
+        for (U32 i = 0; i < 4 && count > 0; i++, count--) {
+            memory->write8(addr++, U8(value >> (24 - 8 * i)));
+        }
+        reg = (reg + 1) & 0x1F;
+    }
+}
+
+void Interpreter::stswx(Instruction code)
+{
+    U32 addr = addrX(state, code);
+    U32 count = state->xer.bc;
+    U32 reg = code.rs;
+    while (count > 0) {
+        const U32 value = U32(state->r[reg]);
+        for (U32 i = 0; i < 4 && count > 0; i++, count--) {
+            memory->write8(addr++, U8(value >> (24 - 8 * i)));
+        }
+        reg = (reg + 1) & 0x1F;
+    }
+}
+
+void Interpreter::stw(Instruction code)
+{
+    memory->write32(addrD(state, code), U32(state->r[code.rs]));
+}
+
+void Interpreter::stwbrx(Instruction code)
+{
+    memory->write32(addrX(state, code), SE32(U32(state->r[code.rs])));
+}
+
+void Interpreter::stwcx_(Instruction code)
+{
+    // CR0 = 0b00 || success || XER[SO]
+    const bool success = writeConditional(addrX(state, code), U32(state->r[code.rs]), 4);
+    state->setCRField(0, (success ? PPUState::CR_EQ : 0) | (state->xer.so ? PPUState::CR_SO : 0));
+}
+
+void Interpreter::stwu(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + code.d;
+    memory->write32(U32(addr), U32(state->r[code.rs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stwux(Instruction code)
+{
+    const U64 addr = state->r[code.ra] + state->r[code.rb];
+    memory->write32(U32(addr), U32(state->r[code.rs]));
+    state->r[code.ra] = addr;
+}
+
+void Interpreter::stwx(Instruction code)
+{
+    memory->write32(addrX(state, code), U32(state->r[code.rs]));
+}
+
+void Interpreter::eieio(Instruction code)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void Interpreter::sync(Instruction code)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void Interpreter::isync(Instruction code)
+{
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
@@ -0,0 +1,1537 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter.h"
+#include "nucleus/cpu/frontend/ppu/ppu_state.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * Vector registers are loaded with a byte swap of the whole quadword, so the element i of
+ * a guest vector with N elements is held in the host component N-1-i. Operations that work
+ * on each element independently iterate over the host components directly.
+ */
+
+template <typename T>
+static T* lanes(V128& v) {
+    return reinterpret_cast<T*>(v.u8);
+}
+
+template <typename T>
+static const T* lanes(const V128& v) {
+    return reinterpret_cast<const T*>(v.u8);
+}
+
+// Get the element i of a vector, in guest order
+template <typename T>
+static T& elem(V128& v, U32 i) {
+    return lanes<T>(v)[16 / sizeof(T) - 1 - i];
+}
+
+template <typename T>
+static T elem(const V128& v, U32 i) {
+    return lanes<T>(v)[16 / sizeof(T) - 1 - i];
+}
+
+// Apply a function to each element of the operands
+template <typename T, typename F>
+static V128 map(const V128& a, F func) {
+    V128 result;
+    for (U32 i = 0; i < 16 / sizeof(T); i++) {
+        lanes<T>(result)[i] = T(func(lanes<T>(a)[i]));
+    }
+    return result;
+}
+
+template <typename T, typename F>
+static V128 map(const V128& a, const V128& b, F func) {
+    V128 result;
+    for (U32 i = 0; i < 16 / sizeof(T); i++) {
+        lanes<T>(result)[i] = T(func(lanes<T>(a)[i], lanes<T>(b)[i]));
+    }
+    return result;
+}
+
+template <typename T, typename F>
+static V128 map(const V128& a, const V128& b, const V128& c, F func) {
+    V128 result;
+    for (U32 i = 0; i < 16 / sizeof(T); i++) {
+        lanes<T>(result)[i] = T(func(lanes<T>(a)[i], lanes<T>(b)[i], lanes<T>(c)[i]));
+    }
+    return result;
+}
+
+// Compare each element of the operands, setting all its bits if the condition holds
+template <typename T, typename F>
+static V128 compare(const V128& a, const V128& b, F func) {
+    V128 result;
+    for (U32 i = 0; i < 4; i++) {
+        lanes<U32>(result)[i] = 0;
+    }
+    for (U32 i = 0; i < 16 / sizeof(T); i++) {
+        std::memset(&lanes<T>(result)[i], func(lanes<T>(a)[i], lanes<T>(b)[i]) ? 0xFF : 0x00, sizeof(T));
+    }
+    return result;
+}
+
+// Clamp a value to the range of T, recording whether it was out of range
+template <typename T>
+static T saturate(S64 value, bool& sat) {
+    if (value > S64(std::numeric_limits<T>::max())) {
+        sat = true;
+        return std::numeric_limits<T>::max();
+    }
+    if (value < S64(std::numeric_limits<T>::min())) {
+        sat = true;
+        return std::numeric_limits<T>::min();
+    }
+    return T(value);
+}
+
+template <typename T>
+static T saturateFloat(F64 value, bool& sat) {
+    if (std::isnan(value)) {
+        sat = true;
+        return 0;
+    }
+    if (value > F64(std::numeric_limits<T>::max())) {
+        sat = true;
+        return std::numeric_limits<T>::max();
+    }
+    if (value < F64(std::numeric_limits<T>::min())) {
+        sat = true;
+        return std::numeric_limits<T>::min();
+    }
+    return T(value);
+}
+
+static V128 toV128(U128 value) {
+    V128 result;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+static U128 toU128(const V128& value) {
+    U128 result;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+static bool isAllOnes(const V128& v) {
+    return v.u64[0] == ~0ULL && v.u64[1] == ~0ULL;
+}
+
+static bool isAllZeros(const V128& v) {
+    return v.u64[0] == 0 && v.u64[1] == 0;
+}
+
+// Effective address of X-form instructions
+static U32 addrX(const PPUState* state, Instruction code) {
+    return U32((code.ra ? state->r[code.ra] : 0) + state->r[code.rb]);
+}
+
+void Interpreter::dss(Instruction code)
+{
+}
+
+void Interpreter::dst(Instruction code)
+{
+}
+
+void Interpreter::dstst(Instruction code)
+{
+}
+
+void Interpreter::lvebx(Instruction code)
+{
+    // Loading the whole quadword places the element at its position, the others are undefined
+    state->v[code.vd] = toV128(memory->read128(addrX(state, code) & ~0xF));
+}
+
+void Interpreter::lvehx(Instruction code)
+{
+    state->v[code.vd] = toV128(memory->read128(addrX(state, code) & ~0xF));
+}
+
+void Interpreter::lvewx(Instruction code)
+{
+    state->v[code.vd] = toV128(memory->read128(addrX(state, code) & ~0xF));
+}
+
+void Interpreter::lvlx(Instruction code)
+{
+    // Load the bytes from the address to the end of its aligned quadword into the left of the register
+    const U32 addr = addrX(state, code);
+    const U32 sh = addr & 0xF;
+    V128 vd;
+    for (U32 i = 0; i < 16; i++) {
+        elem<U8>(vd, i) = (i < 16 - sh) ? memory->read8(addr + i) : 0;
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::lvlxl(Instruction code)
+{
+    lvlx(code);
+}
+
+void Interpreter::lvrx(Instruction code)
+{
+    // Load the bytes from the start of the aligned quadword to the address into the right of the register
+    const U32 addr = addrX(state, code);
+    const U32 sh = addr & 0xF;
+    V128 vd;
+    for (U32 i = 0; i < 16; i++) {
+        elem<U8>(vd, i) = (i >= 16 - sh) ? memory->read8((addr & ~0xF) + i - (16 - sh)) : 0;
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::lvrxl(Instruction code)
+{
+    lvrx(code);
+}
+
+void Interpreter::lvsl(Instruction code)
+{
+    const U32 sh = addrX(state, code) & 0xF;
+    V128 vd;
+    for (U32 i = 0; i < 16; i++) {
+        elem<U8>(vd, i) = U8(sh + i);
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::lvsr(Instruction code)
+{
+    const U32 sh = addrX(state, code) & 0xF;
+    V128 vd;
+    for (U32 i = 0; i < 16; i++) {
+        elem<U8>(vd, i) = U8(16 - sh + i);
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::lvx(Instruction code)
+{
+    state->v[code.vd] = toV128(memory->read128(addrX(state, code) & ~0xF));
+}
+
+void Interpreter::lvxl(Instruction code)
+{
+    lvx(code);
+}
+
+void Interpreter::mfvscr(Instruction code)
+{
+    V128 vd = {};
+    elem<U32>(vd, 3) = state->vscr.VSCR;
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::mtvscr(Instruction code)
+{
+    state->vscr.VSCR = elem<U32>(state->v[code.vb], 3);
+}
+
+void Interpreter::stvebx(Instruction code)
+{
+    const U32 addr = addrX(state, code);
+    memory->write8(addr, elem<U8>(state->v[code.vs], addr & 0xF));
+}
+
+void Interpreter::stvehx(Instruction code)
+{
+    const U32 addr = addrX(state, code) & ~1;
+    memory->write16(addr, elem<U16>(state->v[code.vs], (addr & 0xF) >> 1));
+}
+
+void Interpreter::stvewx(Instruction code)
+{
+    const U32 addr = addrX(state, code) & ~3;
+    memory->write32(addr, elem<U32>(state->v[code.vs], (addr & 0xF) >> 2));
+}
+
+void Interpreter::stvlx(Instruction code)
+{
+    // Store the left bytes of the register from the address to the end of its aligned quadword
+    const U32 addr = addrX(state, code);
+    const U32 sh = addr & 0xF;
+    const V128& vs = state->v[code.vs];
+    for (U32 i = 0; i < 16 - sh; i++) {
+        memory->write8(addr + i, elem<U8>(vs, i));
+    }
+}
+
+void Interpreter::stvlxl(Instruction code)
+{
+    stvlx(code);
+}
+
+void Interpreter::stvrx(Instruction code)
+{
+    // Store the right bytes of the register from the start of the aligned quadword to the address
+    const U32 addr = addrX(state, code);
+    const U32 sh = addr & 0xF;
+    const V128& vs = state->v[code.vs];
+    for (U32 i = 16 - sh; i < 16; i++) {
+        memory->write8((addr & ~0xF) + i - (16 - sh), elem<U8>(vs, i));
+    }
+}
+
+void Interpreter::stvrxl(Instruction code)
+{
+    stvrx(code);
+}
+
+void Interpreter::stvx(Instruction code)
+{
+    memory->write128(addrX(state, code) & ~0xF, toU128(state->v[code.vs]));
+}
+
+void Interpreter::stvxl(Instruction code)
+{
+    stvx(code);
+}
+
+void Interpreter::vaddcuw(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return U32(a + b < a);
+    });
+}
+
+void Interpreter::vaddfp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.va], state->v[code.vb], [](F32 a, F32 b) {
+        return a + b;
+    });
+}
+
+void Interpreter::vaddsbs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<S8>(state->v[code.va], state->v[code.vb], [&](S8 a, S8 b) {
+        return saturate<S8>(S64(a) + b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vaddshs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<S16>(state->v[code.va], state->v[code.vb], [&](S16 a, S16 b) {
+        return saturate<S16>(S64(a) + b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vaddsws(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<S32>(state->v[code.va], state->v[code.vb], [&](S32 a, S32 b) {
+        return saturate<S32>(S64(a) + b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vaddubm(Instruction code)
+{
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        return a + b;
+    });
+}
+
+void Interpreter::vaddubs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [&](U8 a, U8 b) {
+        return saturate<U8>(S64(a) + b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vadduhm(Instruction code)
+{
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        return a + b;
+    });
+}
+
+void Interpreter::vadduhs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [&](U16 a, U16 b) {
+        return saturate<U16>(S64(a) + b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vadduwm(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return a + b;
+    });
+}
+
+void Interpreter::vadduws(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [&](U32 a, U32 b) {
+        return saturate<U32>(S64(a) + b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vand(Instruction code)
+{
+    state->v[code.vd] = map<U64>(state->v[code.va], state->v[code.vb], [](U64 a, U64 b) {
+        return a & b;
+    });
+}
+
+void Interpreter::vandc(Instruction code)
+{
+    state->v[code.vd] = map<U64>(state->v[code.va], state->v[code.vb], [](U64 a, U64 b) {
+        return a & ~b;
+    });
+}
+
+void Interpreter::vavgsb(Instruction code)
+{
+    state->v[code.vd] = map<S8>(state->v[code.va], state->v[code.vb], [](S8 a, S8 b) {
+        return (S64(a) + b + 1) >> 1;
+    });
+}
+
+void Interpreter::vavgsh(Instruction code)
+{
+    state->v[code.vd] = map<S16>(state->v[code.va], state->v[code.vb], [](S16 a, S16 b) {
+        return (S64(a) + b + 1) >> 1;
+    });
+}
+
+void Interpreter::vavgsw(Instruction code)
+{
+    state->v[code.vd] = map<S32>(state->v[code.va], state->v[code.vb], [](S32 a, S32 b) {
+        return (S64(a) + b + 1) >> 1;
+    });
+}
+
+void Interpreter::vavgub(Instruction code)
+{
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        return (U64(a) + b + 1) >> 1;
+    });
+}
+
+void Interpreter::vavguh(Instruction code)
+{
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        return (U64(a) + b + 1) >> 1;
+    });
+}
+
+void Interpreter::vavguw(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return (U64(a) + b + 1) >> 1;
+    });
+}
+
+void Interpreter::vcfsx(Instruction code)
+{
+    const F64 scale = std::ldexp(1.0, -S32(code.vuimm));
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        lanes<F32>(vd)[i] = F32(lanes<S32>(state->v[code.vb])[i] * scale);
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vcfux(Instruction code)
+{
+    const F64 scale = std::ldexp(1.0, -S32(code.vuimm));
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        lanes<F32>(vd)[i] = F32(lanes<U32>(state->v[code.vb])[i] * scale);
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vcmpbfp(Instruction code)
+{
+    // Bit 0 is set if the element is above the bound and bit 1 if it is below the negated bound
+    const V128& va = state->v[code.va];
+    const V128& vb = state->v[code.vb];
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        const F32 a = lanes<F32>(va)[i];
+        const F32 b = lanes<F32>(vb)[i];
+        lanes<U32>(vd)[i] = (!(a <= b) ? 0x80000000 : 0) | (!(a >= -b) ? 0x40000000 : 0);
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vcmpbfp_(Instruction code)
+{
+    vcmpbfp(code);
+    updateCR6(false, isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpeqfp(Instruction code)
+{
+    state->v[code.vd] = compare<F32>(state->v[code.va], state->v[code.vb], [](F32 a, F32 b) {
+        return a == b;
+    });
+}
+
+void Interpreter::vcmpeqfp_(Instruction code)
+{
+    vcmpeqfp(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpequb(Instruction code)
+{
+    state->v[code.vd] = compare<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        return a == b;
+    });
+}
+
+void Interpreter::vcmpequb_(Instruction code)
+{
+    vcmpequb(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpequh(Instruction code)
+{
+    state->v[code.vd] = compare<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        return a == b;
+    });
+}
+
+void Interpreter::vcmpequh_(Instruction code)
+{
+    vcmpequh(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpequw(Instruction code)
+{
+    state->v[code.vd] = compare<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return a == b;
+    });
+}
+
+void Interpreter::vcmpequw_(Instruction code)
+{
+    vcmpequw(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpgefp(Instruction code)
+{
+    state->v[code.vd] = compare<F32>(state->v[code.va], state->v[code.vb], [](F32 a, F32 b) {
+        return a >= b;
+    });
+}
+
+void Interpreter::vcmpgefp_(Instruction code)
+{
+    vcmpgefp(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpgtfp(Instruction code)
+{
+    state->v[code.vd] = compare<F32>(state->v[code.va], state->v[code.vb], [](F32 a, F32 b) {
+        return a > b;
+    });
+}
+
+void Interpreter::vcmpgtfp_(Instruction code)
+{
+    vcmpgtfp(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpgtsb(Instruction code)
+{
+    state->v[code.vd] = compare<S8>(state->v[code.va], state->v[code.vb], [](S8 a, S8 b) {
+        return a > b;
+    });
+}
+
+void Interpreter::vcmpgtsb_(Instruction code)
+{
+    vcmpgtsb(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpgtsh(Instruction code)
+{
+    state->v[code.vd] = compare<S16>(state->v[code.va], state->v[code.vb], [](S16 a, S16 b) {
+        return a > b;
+    });
+}
+
+void Interpreter::vcmpgtsh_(Instruction code)
+{
+    vcmpgtsh(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpgtsw(Instruction code)
+{
+    state->v[code.vd] = compare<S32>(state->v[code.va], state->v[code.vb], [](S32 a, S32 b) {
+        return a > b;
+    });
+}
+
+void Interpreter::vcmpgtsw_(Instruction code)
+{
+    vcmpgtsw(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpgtub(Instruction code)
+{
+    state->v[code.vd] = compare<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        return a > b;
+    });
+}
+
+void Interpreter::vcmpgtub_(Instruction code)
+{
+    vcmpgtub(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpgtuh(Instruction code)
+{
+    state->v[code.vd] = compare<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        return a > b;
+    });
+}
+
+void Interpreter::vcmpgtuh_(Instruction code)
+{
+    vcmpgtuh(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vcmpgtuw(Instruction code)
+{
+    state->v[code.vd] = compare<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return a > b;
+    });
+}
+
+void Interpreter::vcmpgtuw_(Instruction code)
+{
+    vcmpgtuw(code);
+    updateCR6(isAllOnes(state->v[code.vd]), isAllZeros(state->v[code.vd]));
+}
+
+void Interpreter::vctsxs(Instruction code)
+{
+    const F64 scale = std::ldexp(1.0, S32(code.vuimm));
+    bool sat = false;
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        lanes<S32>(vd)[i] = saturateFloat<S32>(std::trunc(lanes<F32>(state->v[code.vb])[i] * scale), sat);
+    }
+    state->v[code.vd] = vd;
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vctuxs(Instruction code)
+{
+    const F64 scale = std::ldexp(1.0, S32(code.vuimm));
+    bool sat = false;
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        lanes<U32>(vd)[i] = saturateFloat<U32>(std::trunc(lanes<F32>(state->v[code.vb])[i] * scale), sat);
+    }
+    state->v[code.vd] = vd;
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vexptefp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.vb], [](F32 b) {
+        return std::exp2(b);
+    });
+}
+
+void Interpreter::vlogefp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.vb], [](F32 b) {
+        return std::log2(b);
+    });
+}
+
+void Interpreter::vmaddfp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.va], state->v[code.vb], state->v[code.vc], [](F32 a, F32 b, F32 c) {
+        return a * c + b;
+    });
+}
+
+void Interpreter::vmaxfp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.va], state->v[code.vb], [](F32 a, F32 b) {
+        return (a > b) ? a : b;
+    });
+}
+
+void Interpreter::vmaxsb(Instruction code)
+{
+    state->v[code.vd] = map<S8>(state->v[code.va], state->v[code.vb], [](S8 a, S8 b) {
+        return std::max(a, b);
+    });
+}
+
+void Interpreter::vmaxsh(Instruction code)
+{
+    state->v[code.vd] = map<S16>(state->v[code.va], state->v[code.vb], [](S16 a, S16 b) {
+        return std::max(a, b);
+    });
+}
+
+void Interpreter::vmaxsw(Instruction code)
+{
+    state->v[code.vd] = map<S32>(state->v[code.va], state->v[code.vb], [](S32 a, S32 b) {
+        return std::max(a, b);
+    });
+}
+
+void Interpreter::vmaxub(Instruction code)
+{
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        return std::max(a, b);
+    });
+}
+
+void Interpreter::vmaxuh(Instruction code)
+{
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        return std::max(a, b);
+    });
+}
+
+void Interpreter::vmaxuw(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return std::max(a, b);
+    });
+}
+
+void Interpreter::vmhaddshs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<S16>(state->v[code.va], state->v[code.vb], state->v[code.vc], [&](S16 a, S16 b, S16 c) {
+        return saturate<S16>(((S32(a) * b) >> 15) + S64(c), sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vmhraddshs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<S16>(state->v[code.va], state->v[code.vb], state->v[code.vc], [&](S16 a, S16 b, S16 c) {
+        return saturate<S16>(((S32(a) * b + 0x4000) >> 15) + S64(c), sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vminfp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.va], state->v[code.vb], [](F32 a, F32 b) {
+        return (a < b) ? a : b;
+    });
+}
+
+void Interpreter::vminsb(Instruction code)
+{
+    state->v[code.vd] = map<S8>(state->v[code.va], state->v[code.vb], [](S8 a, S8 b) {
+        return std::min(a, b);
+    });
+}
+
+void Interpreter::vminsh(Instruction code)
+{
+    state->v[code.vd] = map<S16>(state->v[code.va], state->v[code.vb], [](S16 a, S16 b) {
+        return std::min(a, b);
+    });
+}
+
+void Interpreter::vminsw(Instruction code)
+{
+    state->v[code.vd] = map<S32>(state->v[code.va], state->v[code.vb], [](S32 a, S32 b) {
+        return std::min(a, b);
+    });
+}
+
+void Interpreter::vminub(Instruction code)
+{
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        return std::min(a, b);
+    });
+}
+
+void Interpreter::vminuh(Instruction code)
+{
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        return std::min(a, b);
+    });
+}
+
+void Interpreter::vminuw(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return std::min(a, b);
+    });
+}
+
+void Interpreter::vmladduhm(Instruction code)
+{
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], state->v[code.vc], [](U16 a, U16 b, U16 c) {
+        return U32(a) * b + c;
+    });
+}
+
+// Interleave the elements of the high (first) or low (second) half of two vectors
+template <typename T>
+static V128 merge(const V128& a, const V128& b, U32 offset) {
+    V128 result;
+    for (U32 i = 0; i < 8 / sizeof(T); i++) {
+        elem<T>(result, 2 * i + 0) = elem<T>(a, offset + i);
+        elem<T>(result, 2 * i + 1) = elem<T>(b, offset + i);
+    }
+    return result;
+}
+
+void Interpreter::vmrghb(Instruction code)
+{
+    state->v[code.vd] = merge<U8>(state->v[code.va], state->v[code.vb], 0);
+}
+
+void Interpreter::vmrghh(Instruction code)
+{
+    state->v[code.vd] = merge<U16>(state->v[code.va], state->v[code.vb], 0);
+}
+
+void Interpreter::vmrghw(Instruction code)
+{
+    state->v[code.vd] = merge<U32>(state->v[code.va], state->v[code.vb], 0);
+}
+
+void Interpreter::vmrglb(Instruction code)
+{
+    state->v[code.vd] = merge<U8>(state->v[code.va], state->v[code.vb], 8);
+}
+
+void Interpreter::vmrglh(Instruction code)
+{
+    state->v[code.vd] = merge<U16>(state->v[code.va], state->v[code.vb], 4);
+}
+
+void Interpreter::vmrglw(Instruction code)
+{
+    state->v[code.vd] = merge<U32>(state->v[code.va], state->v[code.vb], 2);
+}
+
+// Sum the products of the subelements of each word plus the word of the third operand
+template <typename TA, typename TB>
+static S64 sumProducts(const V128& a, const V128& b, U32 word) {
+    constexpr U32 count = 4 / sizeof(TA);
+    S64 sum = 0;
+    for (U32 j = 0; j < count; j++) {
+        sum += S64(TA(elem<TA>(a, count * word + j))) * S64(TB(elem<TB>(b, count * word + j)));
+    }
+    return sum;
+}
+
+void Interpreter::vmsummbm(Instruction code)
+{
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        elem<S32>(vd, i) = S32(sumProducts<S8, U8>(state->v[code.va], state->v[code.vb], i) + elem<S32>(state->v[code.vc], i));
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vmsumshm(Instruction code)
+{
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        elem<S32>(vd, i) = S32(sumProducts<S16, S16>(state->v[code.va], state->v[code.vb], i) + elem<S32>(state->v[code.vc], i));
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vmsumshs(Instruction code)
+{
+    bool sat = false;
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        const S64 sum = sumProducts<S16, S16>(state->v[code.va], state->v[code.vb], i) + elem<S32>(state->v[code.vc], i);
+        elem<S32>(vd, i) = saturate<S32>(sum, sat);
+    }
+    state->v[code.vd] = vd;
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vmsumubm(Instruction code)
+{
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        elem<U32>(vd, i) = U32(sumProducts<U8, U8>(state->v[code.va], state->v[code.vb], i) + elem<U32>(state->v[code.vc], i));
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vmsumuhm(Instruction code)
+{
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        elem<U32>(vd, i) = U32(sumProducts<U16, U16>(state->v[code.va], state->v[code.vb], i) + elem<U32>(state->v[code.vc], i));
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vmsumuhs(Instruction code)
+{
+    bool sat = false;
+    V128 vd;
+    for (U32 i = 0; i < 4; i++) {
+        const S64 sum = sumProducts<U16, U16>(state->v[code.va], state->v[code.vb], i) + elem<U32>(state->v[code.vc], i);
+        elem<U32>(vd, i) = saturate<U32>(sum, sat);
+    }
+    state->v[code.vd] = vd;
+    state->vscr.SAT |= sat;
+}
+
+// Multiply the even (offset 0) or odd (offset 1) elements of two vectors into elements of twice their size
+template <typename T, typename TR>
+static V128 multiply(const V128& a, const V128& b, U32 offset) {
+    V128 result;
+    for (U32 i = 0; i < 8 / sizeof(T); i++) {
+        elem<TR>(result, i) = TR(elem<T>(a, 2 * i + offset)) * TR(elem<T>(b, 2 * i + offset));
+    }
+    return result;
+}
+
+void Interpreter::vmulesb(Instruction code)
+{
+    state->v[code.vd] = multiply<S8, S16>(state->v[code.va], state->v[code.vb], 0);
+}
+
+void Interpreter::vmulesh(Instruction code)
+{
+    state->v[code.vd] = multiply<S16, S32>(state->v[code.va], state->v[code.vb], 0);
+}
+
+void Interpreter::vmuleub(Instruction code)
+{
+    state->v[code.vd] = multiply<U8, U16>(state->v[code.va], state->v[code.vb], 0);
+}
+
+void Interpreter::vmuleuh(Instruction code)
+{
+    state->v[code.vd] = multiply<U16, U32>(state->v[code.va], state->v[code.vb], 0);
+}
+
+void Interpreter::vmulosb(Instruction code)
+{
+    state->v[code.vd] = multiply<S8, S16>(state->v[code.va], state->v[code.vb], 1);
+}
+
+void Interpreter::vmulosh(Instruction code)
+{
+    state->v[code.vd] = multiply<S16, S32>(state->v[code.va], state->v[code.vb], 1);
+}
+
+void Interpreter::vmuloub(Instruction code)
+{
+    state->v[code.vd] = multiply<U8, U16>(state->v[code.va], state->v[code.vb], 1);
+}
+
+void Interpreter::vmulouh(Instruction code)
+{
+    state->v[code.vd] = multiply<U16, U32>(state->v[code.va], state->v[code.vb], 1);
+}
+
+void Interpreter::vnmsubfp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.va], state->v[code.vb], state->v[code.vc], [](F32 a, F32 b, F32 c) {
+        return -(a * c - b);
+    });
+}
+
+void Interpreter::vnor(Instruction code)
+{
+    state->v[code.vd] = map<U64>(state->v[code.va], state->v[code.vb], [](U64 a, U64 b) {
+        return ~(a | b);
+    });
+}
+
+void Interpreter::vor(Instruction code)
+{
+    state->v[code.vd] = map<U64>(state->v[code.va], state->v[code.vb], [](U64 a, U64 b) {
+        return a | b;
+    });
+}
+
+void Interpreter::vperm(Instruction code)
+{
+    const V128& va = state->v[code.va];
+    const V128& vb = state->v[code.vb];
+    const V128& vc = state->v[code.vc];
+    V128 vd;
+    for (U32 i = 0; i < 16; i++) {
+        const U32 index = elem<U8>(vc, i) & 0x1F;
+        elem<U8>(vd, i) = (index < 16) ? elem<U8>(va, index) : elem<U8>(vb, index - 16);
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vpkpx(Instruction code)
+{
+    // Pack the 8:8:8:8 pixels into 1:5:5:5 pixels
+    const V128* sources[2] = { &state->v[code.va], &state->v[code.vb] };
+    V128 vd;
+    for (U32 i = 0; i < 8; i++) {
+        const U32 w = elem<U32>(*sources[i / 4], i % 4);
+        elem<U16>(vd, i) = U16(((w >> 24) & 0x1) << 15 | ((w >> 19) & 0x1F) << 10 | ((w >> 11) & 0x1F) << 5 | ((w >> 3) & 0x1F));
+    }
+    state->v[code.vd] = vd;
+}
+
+// Pack the elements of two vectors into elements of half their size, with optional saturation
+template <typename T, typename TR, bool Saturate>
+static V128 pack(const V128& a, const V128& b, bool& sat) {
+    constexpr U32 count = 16 / sizeof(T);
+    V128 result;
+    for (U32 i = 0; i < count; i++) {
+        const S64 va = elem<T>(a, i);
+        const S64 vb = elem<T>(b, i);
+        elem<TR>(result, i) = Saturate ? saturate<TR>(va, sat) : TR(va);
+        elem<TR>(result, count + i) = Saturate ? saturate<TR>(vb, sat) : TR(vb);
+    }
+    return result;
+}
+
+void Interpreter::vpkshss(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = pack<S16, S8, true>(state->v[code.va], state->v[code.vb], sat);
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vpkshus(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = pack<S16, U8, true>(state->v[code.va], state->v[code.vb], sat);
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vpkswss(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = pack<S32, S16, true>(state->v[code.va], state->v[code.vb], sat);
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vpkswus(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = pack<S32, U16, true>(state->v[code.va], state->v[code.vb], sat);
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vpkuhum(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = pack<U16, U8, false>(state->v[code.va], state->v[code.vb], sat);
+}
+
+void Interpreter::vpkuhus(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = pack<U16, U8, true>(state->v[code.va], state->v[code.vb], sat);
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vpkuwum(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = pack<U32, U16, false>(state->v[code.va], state->v[code.vb], sat);
+}
+
+void Interpreter::vpkuwus(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = pack<U32, U16, true>(state->v[code.va], state->v[code.vb], sat);
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vrefp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.vb], [](F32 b) {
+        return 1.0f / b;
+    });
+}
+
+void Interpreter::vrfim(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.vb], [](F32 b) {
+        return std::floor(b);
+    });
+}
+
+void Interpreter::vrfin(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.vb], [](F32 b) {
+        return std::nearbyint(b);
+    });
+}
+
+void Interpreter::vrfip(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.vb], [](F32 b) {
+        return std::ceil(b);
+    });
+}
+
+void Interpreter::vrfiz(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.vb], [](F32 b) {
+        return std::trunc(b);
+    });
+}
+
+void Interpreter::vrlb(Instruction code)
+{
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        const U32 sh = b & 0x7;
+        return sh ? U8((a << sh) | (a >> (8 - sh))) : a;
+    });
+}
+
+void Interpreter::vrlh(Instruction code)
+{
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        const U32 sh = b & 0xF;
+        return sh ? U16((a << sh) | (a >> (16 - sh))) : a;
+    });
+}
+
+void Interpreter::vrlw(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        const U32 sh = b & 0x1F;
+        return sh ? U32((a << sh) | (a >> (32 - sh))) : a;
+    });
+}
+
+void Interpreter::vrsqrtefp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.vb], [](F32 b) {
+        return 1.0f / std::sqrt(b);
+    });
+}
+
+void Interpreter::vsel(Instruction code)
+{
+    state->v[code.vd] = map<U64>(state->v[code.va], state->v[code.vb], state->v[code.vc], [](U64 a, U64 b, U64 c) {
+        return (a & ~c) | (b & c);
+    });
+}
+
+void Interpreter::vsl(Instruction code)
+{
+    // The shift amount is taken from the last byte, the architecture requires all of them to match
+    const U32 sh = elem<U8>(state->v[code.vb], 15) & 0x7;
+    const U128 va = toU128(state->v[code.va]);
+    state->v[code.vd] = toV128(va << sh);
+}
+
+void Interpreter::vslb(Instruction code)
+{
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        return a << (b & 0x7);
+    });
+}
+
+void Interpreter::vsldoi(Instruction code)
+{
+    const V128& va = state->v[code.va];
+    const V128& vb = state->v[code.vb];
+    V128 vd;
+    for (U32 i = 0; i < 16; i++) {
+        const U32 index = i + code.vshb;
+        elem<U8>(vd, i) = (index < 16) ? elem<U8>(va, index) : elem<U8>(vb, index - 16);
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vslh(Instruction code)
+{
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        return a << (b & 0xF);
+    });
+}
+
+void Interpreter::vslo(Instruction code)
+{
+    const U32 sh = (elem<U8>(state->v[code.vb], 15) >> 3) & 0xF;
+    const V128& va = state->v[code.va];
+    V128 vd;
+    for (U32 i = 0; i < 16; i++) {
+        elem<U8>(vd, i) = (i + sh < 16) ? elem<U8>(va, i + sh) : 0;
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vslw(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return a << (b & 0x1F);
+    });
+}
+
+void Interpreter::vspltb(Instruction code)
+{
+    const U8 value = elem<U8>(state->v[code.vb], code.vuimm & 0xF);
+    state->v[code.vd] = map<U8>(state->v[code.vb], [=](U8) {
+        return value;
+    });
+}
+
+void Interpreter::vsplth(Instruction code)
+{
+    const U16 value = elem<U16>(state->v[code.vb], code.vuimm & 0x7);
+    state->v[code.vd] = map<U16>(state->v[code.vb], [=](U16) {
+        return value;
+    });
+}
+
+void Interpreter::vspltisb(Instruction code)
+{
+    const S8 value = S8(code.vsimm);
+    state->v[code.vd] = map<S8>(state->v[code.vd], [=](S8) {
+        return value;
+    });
+}
+
+void Interpreter::vspltish(Instruction code)
+{
+    const S16 value = S16(code.vsimm);
+    state->v[code.vd] = map<S16>(state->v[code.vd], [=](S16) {
+        return value;
+    });
+}
+
+void Interpreter::vspltisw(Instruction code)
+{
+    const S32 value = S32(code.vsimm);
+    state->v[code.vd] = map<S32>(state->v[code.vd], [=](S32) {
+        return value;
+    });
+}
+
+void Interpreter::vspltw(Instruction code)
+{
+    const U32 value = elem<U32>(state->v[code.vb], code.vuimm & 0x3);
+    state->v[code.vd] = map<U32>(state->v[code.vb], [=](U32) {
+        return value;
+    });
+}
+
+void Interpreter::vsr(Instruction code)
+{
+    const U32 sh = elem<U8>(state->v[code.vb], 15) & 0x7;
+    const U128 va = toU128(state->v[code.va]);
+    state->v[code.vd] = toV128(va >> sh);
+}
+
+void Interpreter::vsrab(Instruction code)
+{
+    state->v[code.vd] = map<S8>(state->v[code.va], state->v[code.vb], [](S8 a, S8 b) {
+        return a >> (b & 0x7);
+    });
+}
+
+void Interpreter::vsrah(Instruction code)
+{
+    state->v[code.vd] = map<S16>(state->v[code.va], state->v[code.vb], [](S16 a, S16 b) {
+        return a >> (b & 0xF);
+    });
+}
+
+void Interpreter::vsraw(Instruction code)
+{
+    state->v[code.vd] = map<S32>(state->v[code.va], state->v[code.vb], [](S32 a, S32 b) {
+        return a >> (b & 0x1F);
+    });
+}
+
+void Interpreter::vsrb(Instruction code)
+{
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        return a >> (b & 0x7);
+    });
+}
+
+void Interpreter::vsrh(Instruction code)
+{
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        return a >> (b & 0xF);
+    });
+}
+
+void Interpreter::vsro(Instruction code)
+{
+    const U32 sh = (elem<U8>(state->v[code.vb], 15) >> 3) & 0xF;
+    const V128& va = state->v[code.va];
+    V128 vd;
+    for (U32 i = 0; i < 16; i++) {
+        elem<U8>(vd, i) = (i >= sh) ? elem<U8>(va, i - sh) : 0;
+    }
+    state->v[code.vd] = vd;
+}
+
+void Interpreter::vsrw(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return a >> (b & 0x1F);
+    });
+}
+
+void Interpreter::vsubcuw(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return U32(a >= b);
+    });
+}
+
+void Interpreter::vsubfp(Instruction code)
+{
+    state->v[code.vd] = map<F32>(state->v[code.va], state->v[code.vb], [](F32 a, F32 b) {
+        return a - b;
+    });
+}
+
+void Interpreter::vsubsbs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<S8>(state->v[code.va], state->v[code.vb], [&](S8 a, S8 b) {
+        return saturate<S8>(S64(a) - b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vsubshs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<S16>(state->v[code.va], state->v[code.vb], [&](S16 a, S16 b) {
+        return saturate<S16>(S64(a) - b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vsubsws(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<S32>(state->v[code.va], state->v[code.vb], [&](S32 a, S32 b) {
+        return saturate<S32>(S64(a) - b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vsububm(Instruction code)
+{
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [](U8 a, U8 b) {
+        return a - b;
+    });
+}
+
+void Interpreter::vsububs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<U8>(state->v[code.va], state->v[code.vb], [&](U8 a, U8 b) {
+        return saturate<U8>(S64(a) - b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vsubuhm(Instruction code)
+{
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [](U16 a, U16 b) {
+        return a - b;
+    });
+}
+
+void Interpreter::vsubuhs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<U16>(state->v[code.va], state->v[code.vb], [&](U16 a, U16 b) {
+        return saturate<U16>(S64(a) - b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vsubuwm(Instruction code)
+{
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [](U32 a, U32 b) {
+        return a - b;
+    });
+}
+
+void Interpreter::vsubuws(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = map<U32>(state->v[code.va], state->v[code.vb], [&](U32 a, U32 b) {
+        return saturate<U32>(S64(a) - b, sat);
+    });
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vsum2sws(Instruction code)
+{
+    const V128& va = state->v[code.va];
+    const V128& vb = state->v[code.vb];
+    bool sat = false;
+    V128 vd = {};
+    for (U32 i = 1; i < 4; i += 2) {
+        const S64 sum = S64(elem<S32>(va, i - 1)) + elem<S32>(va, i) + elem<S32>(vb, i);
+        elem<S32>(vd, i) = saturate<S32>(sum, sat);
+    }
+    state->v[code.vd] = vd;
+    state->vscr.SAT |= sat;
+}
+
+// Sum the subelements of each word of the first vector plus the word of the second one
+template <typename T, typename TR>
+static V128 sumAcross(const V128& a, const V128& b, bool& sat) {
+    constexpr U32 count = 4 / sizeof(T);
+    V128 result;
+    for (U32 i = 0; i < 4; i++) {
+        S64 sum = elem<TR>(b, i);
+        for (U32 j = 0; j < count; j++) {
+            sum += elem<T>(a, count * i + j);
+        }
+        elem<TR>(result, i) = saturate<TR>(sum, sat);
+    }
+    return result;
+}
+
+void Interpreter::vsum4sbs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = sumAcross<S8, S32>(state->v[code.va], state->v[code.vb], sat);
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vsum4shs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = sumAcross<S16, S32>(state->v[code.va], state->v[code.vb], sat);
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vsum4ubs(Instruction code)
+{
+    bool sat = false;
+    state->v[code.vd] = sumAcross<U8, U32>(state->v[code.va], state->v[code.vb], sat);
+    state->vscr.SAT |= sat;
+}
+
+void Interpreter::vsumsws(Instruction code)
+{
+    const V128& va = state->v[code.va];
+    const V128& vb = state->v[code.vb];
+    S64 sum = elem<S32>(vb, 3);
+    for (U32 i = 0; i < 4; i++) {
+        sum += elem<S32>(va, i);
+    }
+    bool sat = false;
+    V128 vd = {};
+    elem<S32>(vd, 3) = saturate<S32>(sum, sat);
+    state->v[code.vd] = vd;
+    state->vscr.SAT |= sat;
+}
+
+// Unpack the 1:5:5:5 pixels of the high (first) or low (second) half of a vector into 8:8:8:8 pixels
+static V128 unpackPixels(const V128& b, U32 offset) {
+    V128 result;
+    for (U32 i = 0; i < 4; i++) {
+        const U16 h = elem<U16>(b, offset + i);
+        elem<U32>(result, i) = ((h & 0x8000) ? 0xFF000000 : 0) | ((h >> 10) & 0x1F) << 16 | ((h >> 5) & 0x1F) << 8 | (h & 0x1F);
+    }
+    return result;
+}
+
+// Sign-extend the elements of the high (first) or low (second) half of a vector
+template <typename T, typename TR>
+static V128 unpack(const V128& b, U32 offset) {
+    V128 result;
+    for (U32 i = 0; i < 8 / sizeof(T); i++) {
+        elem<TR>(result, i) = TR(elem<T>(b, offset + i));
+    }
+    return result;
+}
+
+void Interpreter::vupkhpx(Instruction code)
+{
+    state->v[code.vd] = unpackPixels(state->v[code.vb], 0);
+}
+
+void Interpreter::vupkhsb(Instruction code)
+{
+    state->v[code.vd] = unpack<S8, S16>(state->v[code.vb], 0);
+}
+
+void Interpreter::vupkhsh(Instruction code)
+{
+    state->v[code.vd] = unpack<S16, S32>(state->v[code.vb], 0);
+}
+
+void Interpreter::vupklpx(Instruction code)
+{
+    state->v[code.vd] = unpackPixels(state->v[code.vb], 4);
+}
+
+void Interpreter::vupklsb(Instruction code)
+{
+    state->v[code.vd] = unpack<S8, S16>(state->v[code.vb], 8);
+}
+
+void Interpreter::vupklsh(Instruction code)
+{
+    state->v[code.vd] = unpack<S16, S32>(state->v[code.vb], 4);
+}
+
+void Interpreter::vxor(Instruction code)
+{
+    state->v[code.vd] = map<U64>(state->v[code.va], state->v[code.vb], [](U64 a, U64 b) {
+        return a ^ b;
+    });
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
@@ -0,0 +1,228 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_block_cache.h"
+#include "nucleus/cpu/hir/block.h"
+#include "nucleus/cpu/hir/builder.h"
+#include "nucleus/cpu/frontend/ppu/ppu_instruction.h"
+#include "nucleus/cpu/frontend/ppu/ppu_state.h"
+#include "nucleus/cpu/frontend/ppu/recompiler/ppu_recompiler.h"
+#include "nucleus/memory/memory.h"
+#include "nucleus/logger/logger.h"
+
+#include <unordered_set>
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+BlockCache::BlockCache(CPU* parent) : parent(parent) {
+    hirModule = std::make_unique<hir::Module>();
+}
+
+BlockCache::~BlockCache() {
+    for (auto* function : hirModule->functions) {
+        delete function;
+    }
+}
+
+TranslatedBlock* BlockCache::link(TranslatedBlock* previous, U32 address) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    TranslatedBlock* block = lookup(address);
+    if (previous && block) {
+        const U32 slot = (address == previous->branch_a) ? 0 : 1;
+        previous->links[slot].store(block, std::memory_order_release);
+    }
+    return block;
+}
+
+TranslatedBlock* BlockCache::lookup(U32 address) {
+    auto it = blocks.lower_bound(address);
+    if (it != blocks.end() && it->first == address) {
+        return it->second.get();
+    }
+
+    // Split the block containing the address, if any
+    if (it != blocks.begin()) {
+        auto& head = *std::prev(it)->second;
+        if (head.contains(address)) {
+            frontend::Block<U32> shortHead = head;
+            frontend::Block<U32> tailData = shortHead.split(address);
+
+            // Both parts are compiled before the head is modified, so it stays valid on failure
+            hir::Function* tailFunction = compile(tailData);
+            hir::Function* headFunction = tailFunction ? compile(shortHead) : nullptr;
+            if (!headFunction) {
+                return nullptr;
+            }
+
+            // The tail inherits the exits of the original block
+            auto tail = std::make_unique<TranslatedBlock>(tailData);
+            tail->hirFunction.store(tailFunction, std::memory_order_release);
+            tail->links[0].store(head.links[0].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            tail->links[1].store(head.links[1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+            head.size = shortHead.size;
+            head.branch_a = shortHead.branch_a;
+            head.branch_b = shortHead.branch_b;
+            head.links[0].store(tail.get(), std::memory_order_release);
+            head.links[1].store(nullptr, std::memory_order_release);
+            head.hirFunction.store(headFunction, std::memory_order_release);
+
+            TranslatedBlock* block = tail.get();
+            blocks[address] = std::move(tail);
+            return block;
+        }
+    }
+
+    // Blocks end at the first branch, before an invalid instruction or at the start of the next block
+    U32 maxSize = MAX_BLOCK_SIZE;
+    if (it != blocks.end() && it->first - address < maxSize) {
+        maxSize = it->first - address;
+    }
+
+    auto* memory = parent->memory.get();
+    Instruction code;
+    code.value = memory->read32(address);
+    if (!code.is_valid()) {
+        return nullptr;
+    }
+    U32 size = 4;
+    while (!code.is_branch() && size < maxSize) {
+        Instruction next;
+        next.value = memory->read32(address + size);
+        if (!next.is_valid()) {
+            break;
+        }
+        code = next;
+        size += 4;
+    }
+
+    frontend::Block<U32> data{};
+    data.parent = nullptr;
+    data.address = address;
+    data.size = size;
+    if (!code.is_branch()) {
+        data.branch_a = address + size;
+    } else {
+        if (code.is_branch_unconditional() || code.opcode == 0x10) {
+            data.branch_a = code.get_target(address + size - 4);
+        }
+        if (code.is_branch_conditional()) {
+            data.branch_b = address + size;
+        }
+    }
+
+    hir::Function* function = compile(data);
+    if (!function) {
+        return nullptr;
+    }
+    auto block = std::make_unique<TranslatedBlock>(data);
+    block->hirFunction.store(function, std::memory_order_release);
+
+    TranslatedBlock* result = block.get();
+    blocks[address] = std::move(block);
+    return result;
+}
+
+hir::Function* BlockCache::compile(const frontend::Block<U32>& block) {
+    auto* memory = parent->memory.get();
+    auto* hirFunction = new hir::Function(hirModule.get(), hir::TYPE_VOID);
+
+    Recompiler recompiler(parent, nullptr);
+    recompiler.blockMode = true;
+    hir::Builder& builder = recompiler.builder;
+
+    hir::Block* entry = hir::Block::create(hirFunction);
+    entry->flags |= hir::BLOCK_IS_ENTRY;
+
+    // Exits to the addresses known at translation time: the fall-through address and the target of bx/bcx
+    const U32 end = block.address + block.size;
+    Instruction last;
+    last.value = memory->read32(end - 4);
+    std::vector<U32> exits = { end };
+    if (last.is_branch_unconditional() || last.opcode == 0x10) {
+        exits.push_back(last.get_target(end - 4) & ~0x3);
+    }
+    for (U32 target : exits) {
+        if (recompiler.blocks.find(target) != recompiler.blocks.end()) {
+            continue;
+        }
+        hir::Block* exit = hir::Block::create(hirFunction);
+        builder.setInsertPoint(exit);
+        builder.createCtxStore(offsetof(PPUState, pc), builder.getConstantI32(target));
+        builder.createRet();
+        recompiler.blocks[target] = exit;
+    }
+
+    // Exit to the address stored by bcctrx/bclrx
+    recompiler.epilog = hir::Block::create(hirFunction);
+    builder.setInsertPoint(recompiler.epilog);
+    builder.createRet();
+
+    // Recompile the block instructions
+    builder.setInsertPoint(entry);
+    for (U32 addr = block.address; addr < end; addr += 4) {
+        recompiler.currentAddress = addr;
+        Instruction code;
+        code.value = memory->read32(addr);
+        recompiler.recompileInstruction(code);
+    }
+    if (!last.is_branch()) {
+        recompiler.flushCR();
+        builder.createBr(recompiler.blocks.at(end));
+    }
+
+    hirFunction->flags &= ~hir::FUNCTION_IS_DEFINING;
+    hirFunction->flags |= hir::FUNCTION_IS_DEFINED;
+
+    if (!parent->compiler->compile(entry)) {
+        logger.error(LOG_CPU, "BlockCache::compile: Cannot compile block at 0x%08X", block.address);
+        return nullptr;
+    }
+    hirFunction->release();
+    return hirFunction;
+}
+
+void BlockCache::invalidate(U32 address, U32 size) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Retire the blocks overlapping the range
+    const U64 end = U64(address) + size;
+    std::unordered_set<const TranslatedBlock*> removed;
+    auto it = blocks.upper_bound(address);
+    if (it != blocks.begin()) {
+        it--;
+    }
+    while (it != blocks.end() && it->first < end) {
+        auto& block = it->second;
+        if (U64(block->address) + block->size <= address) {
+            it++;
+            continue;
+        }
+        block->links[0].store(nullptr, std::memory_order_release);
+        block->links[1].store(nullptr, std::memory_order_release);
+        removed.insert(block.get());
+        retired.push_back(std::move(block));
+        it = blocks.erase(it);
+    }
+    if (removed.empty()) {
+        return;
+    }
+
+    // Unlink the remaining blocks from them
+    for (auto& item : blocks) {
+        for (auto& slot : item.second->links) {
+            if (removed.count(slot.load(std::memory_order_relaxed))) {
+                slot.store(nullptr, std::memory_order_release);
+            }
+        }
+    }
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
@@ -0,0 +1,130 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/cpu.h"
+#include "nucleus/cpu/hir/function.h"
+#include "nucleus/cpu/hir/module.h"
+#include "nucleus/cpu/frontend/frontend_block.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * Basic block translated on its own by the BlockCache
+ */
+class TranslatedBlock : public frontend::Block<U32> {
+public:
+    // Native code of this block, replaced when the block is split
+    std::atomic<hir::Function*> hirFunction{nullptr};
+
+    // Blocks executed after this one, resolved on the first exit through branch_a (first slot)
+    // or through any other address (second slot, holding the last one seen)
+    std::atomic<TranslatedBlock*> links[2];
+
+    TranslatedBlock(const frontend::Block<U32>& block) : frontend::Block<U32>(block) {
+        links[0] = nullptr;
+        links[1] = nullptr;
+    }
+};
+
+/**
+ * PPU Block Cache
+ * ===============
+ * Translates guest code one basic block at a time (CPU_TRANSLATOR_BLOCK), without analyzing
+ * the control flow graph of the function holding it. This avoids the cost of whole-function
+ * analysis for huge or irregular functions and makes the first execution of any code cheap.
+ *
+ * Each block becomes a HIR function that stores the address of the next block in PPUState::pc
+ * and returns. The blocks are chained through their exits: after the first exit through an
+ * address, the next block is found without looking up the cache.
+ *
+ * A block ends at the first branch or at the start of the next translated block. If a branch
+ * target falls inside an existing block, that block is split: its head is translated again to
+ * fall through into the tail, which becomes a block on its own. Replaced and invalidated code is
+ * kept until the cache is destroyed, since other threads might still be running it.
+ */
+class BlockCache {
+    // Maximum number of bytes of guest code translated in a single block
+    static constexpr U32 MAX_BLOCK_SIZE = 0x400;
+
+    CPU* parent;
+
+    // HIR module holding the functions of the blocks
+    std::unique_ptr<hir::Module> hirModule;
+
+    // Blocks indexed by their starting address
+    std::map<U32, std::unique_ptr<TranslatedBlock>> blocks;
+
+    // Blocks removed by invalidate, which might still be in use
+    std::vector<std::unique_ptr<TranslatedBlock>> retired;
+
+    // Guards the blocks and their metadata
+    std::mutex mutex;
+
+    /**
+     * Find the block starting at an address, translating it (or splitting the block containing it) if missing
+     * @param[in]  address  Guest address of the block
+     * @return              Translated block, or nullptr if it could not be translated
+     */
+    TranslatedBlock* lookup(U32 address);
+
+    /**
+     * Generate and compile the HIR function of a block
+     * @param[in]  block  Block whose address and size are already determined
+     * @return            Compiled HIR function, or nullptr on failure
+     */
+    hir::Function* compile(const frontend::Block<U32>& block);
+
+public:
+    BlockCache(CPU* parent);
+    ~BlockCache();
+
+    /**
+     * Get the block to be executed at an address, following the links of the previous block if possible
+     * @param[in]  previous  Block executed before, or nullptr
+     * @param[in]  address   Guest address of the next block
+     * @return               Translated block, or nullptr if it could not be translated
+     */
+    TranslatedBlock* next(TranslatedBlock* previous, U32 address) {
+        if (previous) {
+            for (auto& slot : previous->links) {
+                TranslatedBlock* block = slot.load(std::memory_order_acquire);
+                if (block && block->address == address) {
+                    return block;
+                }
+            }
+        }
+        return link(previous, address);
+    }
+
+    /**
+     * Find or translate the block at an address and link the previous block to it
+     * @param[in]  previous  Block executed before, or nullptr
+     * @param[in]  address   Guest address of the next block
+     * @return               Translated block, or nullptr if it could not be translated
+     */
+    TranslatedBlock* link(TranslatedBlock* previous, U32 address);
+
+    /**
+     * Remove the blocks overlapping a range of guest addresses, e.g. after the code was modified
+     * @param[in]  address  First guest address of the range
+     * @param[in]  size     Number of bytes of the range
+     */
+    void invalidate(U32 address, U32 size);
+};
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
@@ -4,6 +4,9 @@
  */
 
 #include "ppu_decoder.h"
+#include "nucleus/core/config.h"
+#include "nucleus/cpu/cell.h"
+#include "nucleus/filesystem/utils.h"
 #include "nucleus/memory/memory.h"
 #include "nucleus/cpu/util.h"
 #include "nucleus/cpu/hir/builder.h"
@@ -11,15 +14,48 @@
 #include "nucleus/cpu/frontend/ppu/ppu_instruction.h"
 #include "nucleus/cpu/frontend/ppu/ppu_state.h"
 #include "nucleus/cpu/frontend/ppu/ppu_tables.h"
+#include "nucleus/logger/logger.h"
+
+#include "externals/sha1.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <queue>
+#include <unordered_map>
+#include <utility>
 
 namespace cpu {
 namespace frontend {
 namespace ppu {
 
+// Host functions that might be called by cached code, indexed by the key of RELOCATION_HELPER relocations
+static void* const cacheHelpers[] = {
+    reinterpret_cast<void*>(nucleusTranslate),
+    reinterpret_cast<void*>(nucleusCall),
+    reinterpret_cast<void*>(nucleusSysCall),
+    reinterpret_cast<void*>(nucleusHook),
+    reinterpret_cast<void*>(nucleusLog),
+    reinterpret_cast<void*>(nucleusTime),
+};
+static const U64 cacheHelperCount = sizeof(cacheHelpers) / sizeof(cacheHelpers[0]);
+
+// Host addresses below 4 GB might be emitted as 32-bit immediates, which cannot be relocated
+static bool isRelocatable(const void* hostAddr)
+{
+    return reinterpret_cast<U64>(hostAddr) > 0xFFFFFFFFULL;
+}
+
+static void hashCodeRanges(mem::Memory* memory, const std::vector<backend::CodeCacheRange>& ranges, U8 hash[20])
+{
+    sha1_context ctx;
+    sha1_starts(&ctx);
+    for (const auto& range : ranges) {
+        sha1_update(&ctx, memory->ptr<const unsigned char>(range.address), range.size);
+    }
+    sha1_finish(&ctx, hash);
+}
+
 /**
  * PPU Block methods
  */
@@ -27,6 +63,11 @@ bool Block::is_split() const
 {
     Instruction lastInstr;
     lastInstr.value = parent->parent->parent->memory->read32(address + size - 4);
+    return is_split(lastInstr);
+}
+
+bool Block::is_split(Instruction lastInstr)
+{
     if (!lastInstr.is_branch() || lastInstr.is_call() || (lastInstr.opcode == 0x13 && lastInstr.op19 == 0x210) /*bcctr*/) {
         return true;
     }
@@ -71,6 +112,58 @@ void Function::do_register_analysis(Analyzer* status)
     }
 }
 
+bool Function::do_context_analysis(Analyzer* status)
+{
+    // This function already went through the analyzer
+    if (status->analyzedFunctions.find(address) != status->analyzedFunctions.end()) {
+        return true;
+    }
+    status->analyzedFunctions.insert(address);
+
+    // HLE implementations might access any register
+    if (hooked || (blocks.empty() && !analyze_cfg())) {
+        return false;
+    }
+
+    // Analyze read/written registers in every block
+    std::vector<Instruction> codes;
+    std::vector<const Entry*> entries;
+    for (const auto& item : blocks) {
+        const auto& block = *item.second;
+        if (block.size < 4) {
+            continue;
+        }
+        codes.resize(block.size / 4);
+        entries.resize(block.size / 4);
+        parent->parent->memory->readBlock32(reinterpret_cast<U32*>(codes.data()), block.address, U32(codes.size()));
+        get_entries(codes.data(), codes.size(), entries.data());
+
+        for (U32 index = 0; index < codes.size(); index++) {
+            const U32 i = block.address + 4 * index;
+            const Instruction code = codes[index];
+
+            // Indirect branches and system calls might reach any code
+            if (code.is_call_unknown() || (code.opcode == 0x13 && code.op19 == 0x210) || code.opcode == 0x11) {
+                return false;
+            }
+
+            // Check if called functions use any other registers
+            if (code.is_call_known()) {
+                auto it = parent->functions.find(code.get_target(i));
+                if (it == parent->functions.end()) {
+                    return false;
+                }
+                if (!static_cast<Function&>(*it->second).do_context_analysis(status)) {
+                    return false;
+                }
+            }
+            auto method = entries[index]->analyze;
+            (status->*method)(code);
+        }
+    }
+    return true;
+}
+
 bool Function::analyze_cfg()
 {
     blocks.clear();
@@ -83,49 +176,55 @@ bool Function::analyze_cfg()
     current.parent = this;
     current.initial = false;
 
+    // Guest code is fetched in spans of words, which never cross the page of their first word
+    constexpr U32 FETCH_WORDS = 64;
+    U32 words[FETCH_WORDS];
+    auto* memory = parent->parent->memory.get();
+
     // Control Flow Graph generation
     while (!labels.empty()) {
-        U32 addr = labels.front();
-        code.value = parent->parent->memory->read32(addr);
+        const U32 label = labels.front();
+        labels.pop();
 
         // Check if block was already processed
-        if (blocks.find(addr) != blocks.end()) {
-            labels.pop();
+        auto next = blocks.lower_bound(label);
+        if (next != blocks.end() && next->first == label) {
             continue;
         }
 
+        // Split block if label (Block B) is inside an existing block (Block A), which can only be the previous one
+        if (next != blocks.begin()) {
+            auto& block_a = *std::prev(next)->second;
+            if (block_a.contains(label)) {
+                blocks[label] = new Block(block_a.split(label));
+                continue;
+            }
+        }
+
         // Initial Block properties
-        current.address = addr;
-        current.size = 4;
+        current.address = label;
+        current.size = 0;
         current.branch_a = 0;
         current.branch_b = 0;
 
-        U32 maxSize = 0xFFFFFFFF;
-        bool continueLoop = false;
-        for (auto& item : blocks) {
-            auto& block_a = *item.second;
-            // Determine maximum possible size for the current block
-            if ((block_a.address - current.address) < maxSize) {
-                maxSize = block_a.address - current.address;
-            }
-            // Split block if label (Block B) is inside an existing block (Block A)
-            if (block_a.contains(addr)) {
-                blocks[addr] = new Block(block_a.split(addr));
-                continueLoop = true;
-                break;
-            }
-        }
-        if (continueLoop) {
-            labels.pop();
-            continue;
-        }
+        // Determine maximum possible size for the current block
+        const U32 maxSize = (next != blocks.end()) ? (next->first - label) : 0xFFFFFFFF;
 
         // Wait for the end
-        while ((!code.is_branch() || code.is_call()) && (current.size < maxSize)) {
-            addr += 4;
+        U32 index = 0;
+        U32 count = 0;
+        do {
+            if (index == count) {
+                const U32 fetch = label + current.size;
+                count = std::min(FETCH_WORDS, 1 + (maxSize - current.size - 1) / 4);
+                count = std::min(count, (0x1000 - (fetch & 0xFFF)) / 4);
+                memory->readBlock32(words, fetch, count);
+                index = 0;
+            }
+            code.value = words[index++];
             current.size += 4;
-            code.value = parent->parent->memory->read32(addr);
-        }
+        } while ((!code.is_branch() || code.is_call()) && (current.size < maxSize));
+        const U32 addr = label + current.size - 4;
 
         // Push new labels
         if (code.is_branch_conditional() && !code.is_call()) {
@@ -148,8 +247,7 @@ bool Function::analyze_cfg()
             current.branch_a = target;
         }
 
-        blocks[labels.front()] = new Block(current);
-        labels.pop();
+        blocks[label] = new Block(current);
     }
     return true;
 }
@@ -195,6 +293,147 @@ void Function::analyze_type()
     }
 }
 
+void Function::analyze_cr_liveness()
+{
+    // CR fields read before being overwritten (use), overwritten (def) and live at the start of each block
+    struct Liveness {
+        U8 use = 0;
+        U8 def = 0;
+        U8 in = 0;
+        bool exit = false;  // Leaves the function, so any field might be read afterwards
+        U32 next = 0;       // Address of the following block, if control might fall through to it
+    };
+    std::map<U32, Liveness> liveness;
+
+    std::vector<Instruction> codes;
+    std::vector<const Entry*> entries;
+    Analyzer status;
+    for (const auto& item : blocks) {
+        const auto& block = static_cast<Block&>(*item.second);
+        auto& info = liveness[item.first];
+        if (block.size < 4) {
+            info.exit = true;
+            continue;
+        }
+        codes.resize(block.size / 4);
+        entries.resize(block.size / 4);
+        parent->parent->memory->readBlock32(reinterpret_cast<U32*>(codes.data()), block.address, U32(codes.size()));
+        get_entries(codes.data(), codes.size(), entries.data());
+
+        for (U32 index = 0; index < codes.size(); index++) {
+            const Instruction code = codes[index];
+
+            // Callees and system calls might read any field
+            if ((code.is_branch() && code.lk) || code.opcode == 0x11) {
+                info.use |= ~info.def;
+            }
+
+            std::fill(std::begin(status.cr), std::end(status.cr), REG_NONE);
+            auto method = entries[index]->analyze;
+            (status.*method)(code);
+            for (U32 field = 0; field < 8; field++) {
+                const U8 bit = (1 << field);
+                if (status.cr[field] & REG_READ) {
+                    info.use |= bit & ~info.def;
+                }
+                if (status.cr[field] & REG_WRITE) {
+                    // CR logical instructions {crand, crandc, creqv, crnand, crnor, cror, crorc, crxor} write a single bit
+                    if (code.opcode == 0x13 && (code.op19 & 0x1F) == 0x01) {
+                        info.use |= bit & ~info.def;
+                    } else {
+                        info.def |= bit;
+                    }
+                }
+            }
+        }
+        // Returns and indirect branches {bclr*, bcctr*}
+        const Instruction lastInstr = codes.back();
+        if (lastInstr.opcode == 0x13 && (lastInstr.op19 == 0x010 || lastInstr.op19 == 0x210)) {
+            info.exit = true;
+        }
+        if (Block::is_split(lastInstr)) {
+            info.next = block.address + block.size;
+        }
+    }
+
+    // Propagate the fields read by the successors until reaching a fixed point
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = blocks.rbegin(); it != blocks.rend(); it++) {
+            auto& block = static_cast<Block&>(*it->second);
+            auto& info = liveness[it->first];
+
+            U8 out = info.exit ? 0xFF : 0;
+            const U32 successors[] = { block.branch_a, block.branch_b, info.next };
+            for (U32 successor : successors) {
+                if (!successor) {
+                    continue;
+                }
+                auto target = liveness.find(successor);
+                out |= (target != liveness.end()) ? target->second.in : 0xFF;
+            }
+            block.cr_live_out = out;
+
+            const U8 in = info.use | (out & ~info.def);
+            if (in != info.in) {
+                info.in = in;
+                changed = true;
+            }
+        }
+    }
+}
+
+void Function::analyze_context()
+{
+    // Callers being compiled might read the result, so it is determined only once
+    if (context_analyzed) {
+        return;
+    }
+    context_analyzed = true;
+
+    Analyzer status;
+    if (!do_context_analysis(&status)) {
+        return;
+    }
+
+    hir::ContextAccess access;
+
+    auto addRange = [&](AnalyzerEvent event, U32 offset, U32 size) {
+        if (event & REG_READ) {
+            access.reads.push_back({ offset, size });
+        }
+        if (event & REG_WRITE) {
+            access.writes.push_back({ offset, size });
+        }
+    };
+    for (int index = 0; index < 32; index++) {
+        addRange(status.gpr[index], offsetof(PPUState, r[index]), sizeof(PPUState::r[0]));
+        addRange(status.fpr[index], offsetof(PPUState, f[index]), sizeof(PPUState::f[0]));
+        addRange(status.vr[index], offsetof(PPUState, v[index]), sizeof(PPUState::v[0]));
+    }
+
+    // CR fields share a packed word, so writing any of them also reads the others
+    U8 crEvent = REG_NONE;
+    for (int index = 0; index < 8; index++) {
+        crEvent |= status.cr[index];
+    }
+    if (crEvent & REG_WRITE) {
+        crEvent |= REG_READ;
+    }
+    addRange(AnalyzerEvent(crEvent), offsetof(PPUState, cr), sizeof(PPUState::cr));
+    addRange(status.fpscr, offsetof(PPUState, fpscr), sizeof(PPUState::fpscr));
+    addRange(status.xer, offsetof(PPUState, xer), sizeof(PPUState::xer));
+    addRange(status.lr, offsetof(PPUState, lr), sizeof(PPUState::lr));
+    addRange(status.ctr, offsetof(PPUState, ctr), sizeof(PPUState::ctr));
+    addRange(status.tb, offsetof(PPUState, tb), sizeof(PPUState::tb));
+    addRange(status.vscr, offsetof(PPUState, vscr), sizeof(PPUState::vscr));
+    addRange(status.reserve, offsetof(PPUState, reserve_addr),
+        offsetof(PPUState, reserve_version) + sizeof(PPUState::reserve_version) - offsetof(PPUState, reserve_addr));
+    access.known = true;
+    hirFunction->contextAccess = std::move(access);
+}
+
 void Function::declare()
 {
     hir::Module* hirModule = parent->hirModule;
@@ -252,11 +491,12 @@ void Function::recompile()
     hir::Builder& builder = recompiler.builder;
 
     hirFunction->reset();
+    analyze_cr_liveness();
 
     // Declare CFG blocks
     for (const auto& item : blocks) {
         const U32 labelAddr = item.first;
-        recompiler.blocks[labelAddr] = new hir::Block(hirFunction);
+        recompiler.blocks[labelAddr] = hir::Block::create(hirFunction);
     }
 
     // Generate prolog/epilog blocks
@@ -271,6 +511,7 @@ void Function::recompile()
 
         // Recompile block instructions
         builder.setInsertPoint(recompiler.blocks[block.address]);
+        recompiler.crLiveOut = block.cr_live_out;
 
         // Get function (TODO: This gets loaded multiple times into the module)
         //hir::Function* logFunc = builder.getExternFunction(nucleusLog);
@@ -279,14 +520,14 @@ void Function::recompile()
             recompiler.currentAddress = block.address + offset;
             Instruction instr;
             instr.value = parent->parent->memory->read32(recompiler.currentAddress);
-            auto method = get_entry(instr).recompile;
             //builder.createCall(logFunc, {builder.getConstantI64(recompiler.currentAddress)}, hir::CALL_EXTERN);
-            (recompiler.*method)(instr);
+            recompiler.recompileInstruction(instr);
         }
 
         // Block was splitted
         if (block.is_split()) {
             const U32 target = block.address + block.size;
+            recompiler.flushCR();
             if (blocks.find(target) != blocks.end()) {
                 builder.createBr(recompiler.blocks[target]);
             }
@@ -295,12 +536,15 @@ void Function::recompile()
 
     // Validate the generated code, checking for consistency (TODO: Remove this once the recompiler is stable)
     //llvm::verifyFunction(*function.function, &llvm::outs());
+
+    hirFunction->flags &= ~hir::FUNCTION_IS_DEFINING;
+    hirFunction->flags |= hir::FUNCTION_IS_DEFINED;
 }
 
 void Function::createPlaceholder()
 {
     hir::Builder builder;
-    hir::Block* block = new hir::Block(hirFunction);
+    hir::Block* block = hir::Block::create(hirFunction);
     builder.setInsertPoint(block);
 
     hir::Function* translateFunc = builder.getExternFunction(nucleusTranslate);
@@ -308,6 +552,197 @@ void Function::createPlaceholder()
     hir::Value* guestAddrValue = builder.getConstantI64(address);
     builder.createCall(translateFunc, {guestFuncValue, guestAddrValue}, hir::CALL_EXTERN);
     builder.createRet();
+
+    hirFunction->flags &= ~hir::FUNCTION_IS_DEFINING;
+    hirFunction->flags |= hir::FUNCTION_IS_DEFINED;
+}
+
+bool Function::load_cache()
+{
+    auto* module = static_cast<Module*>(parent);
+    auto* memory = parent->parent->memory.get();
+    auto* compiler = parent->parent->compiler.get();
+
+    backend::CodeCache* cache = module->get_cache();
+    backend::CodeCacheEntry entry;
+    if (!cache || hooked || !cache->find(address, entry)) {
+        return false;
+    }
+
+    // Validate the guest code and the type signature
+    for (const auto& range : entry.ranges) {
+        if (!parent->contains(range.address) || !parent->contains(range.address + range.size - 1)) {
+            return false;
+        }
+    }
+    U8 hash[20];
+    hashCodeRanges(memory, entry.ranges, hash);
+    if (memcmp(hash, entry.hash, sizeof(hash)) != 0) {
+        return false;
+    }
+    if (entry.typeOut != hirFunction->typeOut || entry.typeIn.size() != hirFunction->typeIn.size() ||
+        !std::equal(entry.typeIn.begin(), entry.typeIn.end(), hirFunction->typeIn.begin())) {
+        return false;
+    }
+
+    // Patch the host addresses of this session
+    for (const auto& reloc : entry.relocations) {
+        U64 value;
+        switch (reloc.type) {
+        case backend::RELOCATION_MEMORY_BASE:
+            value = reinterpret_cast<U64>(memory->getBaseAddr()) + reloc.key;
+            break;
+        case backend::RELOCATION_HELPER:
+            if (reloc.key >= cacheHelperCount) {
+                return false;
+            }
+            value = reinterpret_cast<U64>(cacheHelpers[reloc.key]);
+            break;
+        case backend::RELOCATION_FUNCTION:
+            if (!parent->contains(reloc.key)) {
+                return false;
+            }
+            value = reinterpret_cast<U64>(module->addFunction(reloc.key)->hirFunction);
+            break;
+        case backend::RELOCATION_RESERVATIONS:
+            if (reloc.key >= ReservationTable::SLOT_COUNT * sizeof(U64)) {
+                return false;
+            }
+            value = reinterpret_cast<U64>(parent->parent->ppu_reservations.getBaseAddr()) + reloc.key;
+            break;
+        default:
+            return false;
+        }
+        if (reloc.offset + sizeof(value) > entry.code.size()) {
+            return false;
+        }
+        memcpy(&entry.code[reloc.offset], &value, sizeof(value));
+    }
+    std::vector<hir::NativeCallSite> callSites;
+    for (const auto& site : entry.callSites) {
+        if (!parent->contains(site.target) || site.offset >= entry.code.size() || site.stub >= entry.code.size()) {
+            return false;
+        }
+        callSites.push_back({ module->addFunction(site.target)->hirFunction, site.offset, site.stub });
+    }
+    return compiler->install(hirFunction, entry.code, callSites);
+}
+
+void Function::store_cache()
+{
+    auto* module = static_cast<Module*>(parent);
+    auto* memory = parent->parent->memory.get();
+    auto* compiler = parent->parent->compiler.get();
+
+    backend::CodeCache* cache = module->get_cache();
+    if (!cache || hooked || !(hirFunction->flags & hir::FUNCTION_IS_COMPILED)) {
+        return;
+    }
+
+    // Host addresses that can be referenced by the native code
+    const U64 memoryBase = reinterpret_cast<U64>(memory->getBaseAddr());
+    const U64 reservationsBase = reinterpret_cast<U64>(parent->parent->ppu_reservations.getBaseAddr());
+    std::unordered_map<U64, U64> helperKeys;
+    for (U64 index = 0; index < cacheHelperCount; index++) {
+        helperKeys[reinterpret_cast<U64>(cacheHelpers[index])] = index;
+    }
+    std::unordered_map<U64, U64> functionKeys;
+    for (const auto& item : parent->functions) {
+        functionKeys[reinterpret_cast<U64>(item.second->hirFunction)] = item.first;
+    }
+    auto findRelocation = [&](U64 value, backend::CodeCacheRelocation& reloc) -> bool {
+        if (memoryBase <= value && value - memoryBase <= 0xFFFFFFFFULL) {
+            reloc.type = backend::RELOCATION_MEMORY_BASE;
+            reloc.key = value - memoryBase;
+        } else if (reservationsBase <= value && value - reservationsBase < ReservationTable::SLOT_COUNT * sizeof(U64)) {
+            reloc.type = backend::RELOCATION_RESERVATIONS;
+            reloc.key = value - reservationsBase;
+        } else if (helperKeys.find(value) != helperKeys.end()) {
+            reloc.type = backend::RELOCATION_HELPER;
+            reloc.key = helperKeys[value];
+        } else if (functionKeys.find(value) != functionKeys.end()) {
+            reloc.type = backend::RELOCATION_FUNCTION;
+            reloc.key = functionKeys[value];
+        } else {
+            return false;
+        }
+        return true;
+    };
+
+    // Make sure every host address referenced by the function will be found among its 64-bit immediates
+    if (!isRelocatable(memory->getBaseAddr())) {
+        return;
+    }
+    for (const auto& block : hirFunction->blocks) {
+        for (const auto& instr : block->instructions) {
+            // Pointer constants left unrelocated would reference the memory of this session
+            const auto& info = hir::opcodeInfo[instr->opcode];
+            const std::pair<U8, const hir::Value*> sources[] = {
+                { info.getSignatureSrc1(), instr->src1.value },
+                { info.getSignatureSrc2(), instr->src2.value },
+                { info.getSignatureSrc3(), instr->src3.value },
+            };
+            for (const auto& source : sources) {
+                const hir::Value* value = source.second;
+                const bool isValue = source.first == hir::OPCODE_SIG_TYPE_V || (source.first == hir::OPCODE_SIG_TYPE_M && value);
+                if (!isValue || !value->isConstant() || !(value->flags & hir::VALUE_IS_POINTER)) {
+                    continue;
+                }
+                backend::CodeCacheRelocation reloc;
+                if (!isRelocatable(reinterpret_cast<void*>(value->constant.i64)) || !findRelocation(value->constant.i64, reloc)) {
+                    return;
+                }
+            }
+
+            const hir::Function* callee;
+            if (instr->opcode == hir::OPCODE_CALL) {
+                callee = instr->src1.function;
+            } else if (instr->opcode == hir::OPCODE_CALLCOND) {
+                callee = instr->src2.function;
+            } else {
+                continue;
+            }
+            const bool isExtern = (instr->flags & hir::CALL_EXTERN) != 0;
+            const U64 hostAddr = isExtern ? reinterpret_cast<U64>(callee->nativeAddress) : reinterpret_cast<U64>(callee);
+            const auto& keys = isExtern ? helperKeys : functionKeys;
+            if (!isRelocatable(reinterpret_cast<void*>(hostAddr)) || keys.find(hostAddr) == keys.end()) {
+                return;
+            }
+        }
+    }
+
+    backend::CodeCacheEntry entry;
+    entry.address = address;
+    for (const auto& item : blocks) {
+        entry.ranges.push_back({ item.second->address, item.second->size });
+    }
+    hashCodeRanges(memory, entry.ranges, entry.hash);
+    entry.typeOut = hirFunction->typeOut;
+    entry.typeIn.assign(hirFunction->typeIn.begin(), hirFunction->typeIn.end());
+
+    const U8* code = static_cast<const U8*>(hirFunction->nativeAddress);
+    entry.code.assign(code, code + hirFunction->nativeSize);
+    for (const auto& offset : hirFunction->nativeImmediates) {
+        U64 value;
+        memcpy(&value, &entry.code[offset], sizeof(value));
+
+        // Other immediates are plain constants, since every pointer constant was checked above
+        backend::CodeCacheRelocation reloc = { offset, 0, 0 };
+        if (findRelocation(value, reloc)) {
+            entry.relocations.push_back(reloc);
+        }
+    }
+
+    // Calls might have been linked to the code of this session, so they are stored pointing to their stubs
+    for (const auto& site : hirFunction->nativeCallSites) {
+        const auto it = functionKeys.find(reinterpret_cast<U64>(site.target));
+        if (it == functionKeys.end()) {
+            return;
+        }
+        entry.callSites.push_back({ site.offset, site.stub, it->second });
+        compiler->patchCall(&entry.code[site.offset], code + site.offset, code + site.stub);
+    }
+    cache->insert(entry);
 }
 
 /**
@@ -318,6 +753,8 @@ Module::Module(CPU* parent) : frontend::Module<U32>(parent) {
 
 Function* Module::addFunction(U32 addr)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
     // Return function if already present
     if (functions.find(addr) != functions.end()) {
         return static_cast<Function*>(functions[addr]);
@@ -330,12 +767,80 @@ Function* Module::addFunction(U32 addr)
     function->declare();
     function->createPlaceholder();
     parent->compiler->compile(function->hirFunction);
+    function->hirFunction->release();
 
     // Save and return the function
     functions[addr] = function;
+    static_cast<Cell*>(parent)->ppu_dispatch.install(addr, function->hirFunction);
     return function;
 }
 
+backend::InlineCache* Module::addInlineCache(U32 addr)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
+    // Return the inline cache if already present
+    auto& cache = inline_caches[addr];
+    if (cache) {
+        return cache.get();
+    }
+
+    // Create the inline cache otherwise, with the generic path as the native code of its function
+    cache = std::make_unique<backend::InlineCache>();
+    cache->contextOffset = offsetof(PPUState, ctr);
+    cache->function = new hir::Function(hirModule, hir::TYPE_VOID);
+
+    hir::Builder builder;
+    hir::Block* block = hir::Block::create(cache->function);
+    block->flags |= hir::BLOCK_IS_ENTRY;
+    builder.setInsertPoint(block);
+
+    hir::Function* dispatchFunc = builder.getExternFunction(nucleusDispatch);
+    hir::Value* cacheValue = builder.getConstantPointer(cache.get());
+    hir::Value* targetValue = builder.createCtxLoad(cache->contextOffset, hir::TYPE_I64);
+    builder.createCall(dispatchFunc, {cacheValue, targetValue}, hir::CALL_EXTERN);
+    builder.createRet();
+
+    cache->function->flags |= hir::FUNCTION_IS_DEFINED;
+    parent->compiler->compile(cache->function);
+    cache->function->release();
+    cache->missAddress = cache->function->nativeAddress;
+    return cache.get();
+}
+
+backend::CodeCache* Module::get_cache()
+{
+    std::call_once(cacheFlag, [this] {
+        auto* compiler = parent->compiler.get();
+        const U64 target = compiler->getTargetId();
+        if (!compiler->settings.isCached || !target || !(config.ppuTranslator & CPU_TRANSLATOR_IS_CACHED)) {
+            return;
+        }
+
+        // Identify the module by its address and guest code
+        U8 hash[20];
+        sha1_context ctx;
+        sha1_starts(&ctx);
+        sha1_update(&ctx, reinterpret_cast<const unsigned char*>(&address), sizeof(address));
+        sha1_update(&ctx, parent->memory->ptr<const unsigned char>(address), size);
+        sha1_finish(&ctx, hash);
+
+        const fs::Path cachePath = fs::getEmulatorPath() + "cache/";
+        if (!fs::createDirectory(cachePath)) {
+            return;
+        }
+        std::string name = "ppu_";
+        for (const auto& byte : hash) {
+            name += format("%02x", byte);
+        }
+        auto moduleCache = std::make_unique<backend::CodeCache>();
+        if (moduleCache->open(cachePath + name + ".bin", hash, target)) {
+            cache = std::move(moduleCache);
+        }
+    });
+    return cache.get();
+}
+
 void Module::analyze()
 {
     // Lists of labels
@@ -383,154 +888,72 @@ void Module::analyze()
     std::set_difference(labelBlocks.begin(), labelBlocks.end(), labelJumps.begin(), labelJumps.end(), std::inserter(labelFunctions, labelFunctions.end()));
     std::set_union(labelFunctions.begin(), labelFunctions.end(), labelCalls.begin(), labelCalls.end(), std::inserter(labelFunctions, labelFunctions.end()));
 
-    // List the functions and get their CFG
+    // Declare the functions, their CFG is analyzed when translating them
     for (const auto& label : labelFunctions) {
-        if (this->contains(label)) {
-            Function function(this);
-            function.name = format("func_%X", label);
-            function.address = label;
-            if (function.analyze_cfg()) {
-                functions[label] = new Function(function);
-            }
+        if (contains(label)) {
+            addFunction(label);
         }
     }
-    // Get type of every listed function
-    for (auto& item : functions) {
-        auto& function = static_cast<Function&>(*item.second);
-        function.analyze_type();
-    }
 }
 
 void Module::recompile()
 {
-    //module = hir::Module::Create(name);
-
-    // Optimization passes
-    /*auto fpm = new llvm::legacy::FunctionPassManager(module.module);
-    fpm->add(llvm::createPromoteMemoryToRegisterPass());  // Promote allocas to registers
-    fpm->add(llvm::createInstructionCombiningPass());     // Simple peephole and bit-twiddling optimizations
-    fpm->add(llvm::createReassociatePass());              // Reassociate expressions
-    fpm->add(llvm::createGVNPass());                      // Eliminate Common SubExpressions
-    fpm->add(llvm::createCFGSimplificationPass());        // Simplify the Control Flow Graph (e.g.: deleting unreachable blocks)
-    fpm->doInitialization();*/
-
-    // Global variables
-    /*memoryBase = module.getOrInsertGlobal<hir::I64>("memoryBase");
-    funcGetState = hir::Function::Create(
-        llvm::FunctionType::get(hir::Pointer<StateType>::getType().type, false),
-        llvm::Function::ExternalLinkage, "nucleusGetState", module);
-    funcLogState = hir::Function::Create(
-        llvm::FunctionType::get(hir::Void::getType().type, { hir::I64::getType().type }, false),
-        llvm::Function::ExternalLinkage, "nucleusLogState", module);
-    funcDebugState = hir::Function::Create(
-        llvm::FunctionType::get(hir::Void::getType().type, { hir::I64::getType().type }, false),
-        llvm::Function::ExternalLinkage, "nucleusDebugState", module);
-    funcIntermodularCall = hir::Function::Create(
-        llvm::FunctionType::get(hir::Void::getType().type, { hir::I64::getType().type }, false),
-        llvm::Function::ExternalLinkage, "nucleusIntermodularCall", module);
-    funcSystemCall = hir::Function::Create(
-        llvm::FunctionType::get(hir::Void::getType().type, false),
-        llvm::Function::ExternalLinkage, "nucleusSystemCall", module);*/
-    /*
-    // Declare all functions
-    for (auto& item : functions) {
-        auto& function = static_cast<Function&>(*item.second);
-        function.declare(module);
-    }
-
-    // Recompile and optimize all functions
-    for (auto& item : functions) {
-        auto& function = static_cast<Function&>(*item.second);
-        function.recompile();
-        fpm->run(*function.function.function); // TODO: This is unreadable
-    }
-
-    // Add function caller
-    llvm::FunctionType* callerType = llvm::FunctionType::get(
-        llvm::Type::getVoidTy(llvm::getGlobalContext()),
-        llvm::Type::getInt32Ty(llvm::getGlobalContext()),
-        false);
-    hir::Function callerFunction = hir::Function::Create(callerType, llvm::Function::InternalLinkage, "caller", module);
-    hir::Block entryBlock = hir::Block::Create("entry", callerFunction);
-    hir::Block defaultBlock = hir::Block::Create("caller", callerFunction);
-
-    hir::Builder builder;
-    builder.setInsertPoint(entryBlock);
-    hir::Value* state = builder.createCall(funcGetState);
-    auto switchInst = builder.createSwitch(hir::Value<hir::I32>{ callerFunction.function->arg_begin() }, defaultBlock);
-
-    for (auto& item : functions) {
-        auto& function = static_cast<Function&>(*item.second);
-
-        // Declare block
-        hir::Block callerBlock = hir::Block::Create(function.name + "_caller", callerFunction);
-        switchInst->addCase(llvm::ConstantInt::get(
-            llvm::IntegerType::getInt32Ty(llvm::getGlobalContext()), function.address),
-            callerBlock.bb);
-
-        // Proxy
-        int index = 0;
-        builder.setInsertPoint(callerBlock);
-        std::vector<hir::Value*> args;
-        for (auto& type : function.type_in) {
-            switch (type) {
-            case FUNCTION_IN_INTEGER:
-                args.push_back(builder.createLoad<hir::I64>(
-                    builder.createInBoundsGEP(state, {
-                        builder.get<hir::I32>(0),
-                        builder.get<hir::I32>(0),
-                        builder.get<hir::I32>(3 + index++)
-                    })
-                ));
-                break;
-
-            case FUNCTION_IN_FLOAT: {
-                args.push_back(builder.createLoad<hir::I64>(
-                    builder.createInBoundsGEP(state, {
-                        builder.get<hir::I32>(0),
-                        builder.get<hir::I32>(1),
-                        builder.get<hir::I32>(1 + index++)
-                    })
-                ));
-                break;
+    auto* translator = static_cast<Cell*>(parent)->ppu_translator.get();
+
+    // Functions declared while translating others (call targets missed by the analysis) are compiled as well
+    std::set<U32> translated;
+    U32 failed = 0;
+    while (true) {
+        std::vector<Function*> pending;
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            for (const auto& item : functions) {
+                if (contains(item.first) && translated.find(item.first) == translated.end()) {
+                    pending.push_back(static_cast<Function*>(item.second));
+                }
             }
-            case FUNCTION_IN_VECTOR: {
-                // TODO
-                break;
+        }
+        if (pending.empty()) {
+            break;
+        }
+
+        // Queue all functions for the translator threads and translate them on this thread as well
+        for (auto* function : pending) {
+            translator->enqueue(function, 0);
+        }
+        const size_t total = translated.size() + pending.size();
+        const size_t step = std::max<size_t>(pending.size() / 10, 1);
+        for (size_t index = 0; index < pending.size(); index++) {
+            auto* function = pending[index];
+            if (!translator->require(function)) {
+                failed += 1;
             }
-            default:
-                break;
+            translated.insert(function->address);
+            if ((index + 1) % step == 0 || index + 1 == pending.size()) {
+                logger.notice(LOG_CPU, "Compiling module 0x%08X: %d/%d functions", address, U32(translated.size()), U32(total));
             }
         }
-
-        hir::Value* value = builder.createCall(function.function, args);
-
-        // TODO: ?
-
-        builder.createRetVoid();
     }
-
-    builder.SetInsertPoint(defaultBlock);
-    builder.createRetVoid();
-
-    // NOTE: Debugging purposes
-    module.dump();
-
-    // Compile
-    backend::Generate(static_cast<frontend::Module<U32>*>(this));*/
+    logger.notice(LOG_CPU, "Compiled module 0x%08X: %d functions (%d failed)", address, U32(translated.size()), failed);
 }
 
 void Module::hook(U32 funcAddr, U32 fnid) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
     if (functions.find(funcAddr) == functions.end()) {
         auto* func = new Function(this);
         func->declare();
         functions[funcAddr] = func;
     }
+    auto* function = static_cast<Function*>(functions[funcAddr]);
+    function->hooked = true;
+    function->context_analyzed = true;
     auto* hirFunc = functions[funcAddr]->hirFunction;
     hirFunc->reset();
+    hirFunc->contextAccess = hir::ContextAccess();
 
     hir::Builder builder;
-    hir::Block* block = new hir::Block(hirFunc);
+    hir::Block* block = hir::Block::create(hirFunc);
     block->flags |= hir::BLOCK_IS_ENTRY;
     builder.setInsertPoint(block);
 
@@ -538,7 +961,14 @@ void Module::hook(U32 funcAddr, U32 fnid) {
     builder.createCall(hookFunc, { builder.getConstantI32(fnid) }, hir::CALL_EXTERN);
     builder.createRet();
 
-    parent->compiler->compile(hirFunc);
+    // Callers only find the hook through the dispatch table once it can run
+    const bool compiled = parent->compiler->compile(hirFunc);
+    hirFunc->release();
+    if (!compiled) {
+        logger.error(LOG_CPU, "Could not compile hook of function 0x%08X", funcAddr);
+        return;
+    }
+    static_cast<Cell*>(parent)->ppu_dispatch.install(funcAddr, hirFunc);
 }
 
 }  // namespace ppu
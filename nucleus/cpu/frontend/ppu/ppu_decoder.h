@@ -8,6 +8,8 @@
 #include "nucleus/common.h"
 #include "nucleus/format.h"
 #include "nucleus/cpu/cpu.h"
+#include "nucleus/cpu/backend/code_cache.h"
+#include "nucleus/cpu/backend/inline_cache.h"
 #include "nucleus/cpu/hir/module.h"
 #include "nucleus/cpu/hir/type.h"
 #include "nucleus/cpu/hir/value.h"
@@ -16,7 +18,10 @@
 #include "nucleus/cpu/frontend/frontend_module.h"
 #include "nucleus/cpu/frontend/ppu/analyzer/ppu_analyzer.h"
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -48,11 +53,21 @@ enum FunctionTypeOut {
     FUNCTION_OUT_VOID,        // Nothing is returned
 };
 
+// Translation state of a function, see ppu::Translator
+enum TranslationState {
+    TRANSLATION_NONE = 0,     // Only the placeholder is available
+    TRANSLATION_QUEUED,       // Waiting for a translator thread
+    TRANSLATION_RUNNING,      // Being translated by some thread
+    TRANSLATION_DONE,         // Native code is installed
+    TRANSLATION_FAILED,       // Could not be translated
+};
+
 class Block : public frontend::Block<U32> {
 public:
     bool initial;                   // Is this a function entry block?
     bool jump_destination = false;  // Is this a target of a bx/bcx instruction?
     bool call_destination = false;  // Is this a target of a bl instruction
+    U8 cr_live_out = 0xFF;          // CR fields that might be read after this block (bit N selects CR field N)
 
     // Constructors
     Block() {}
@@ -60,13 +75,30 @@ public:
 
     // Determines whether an extra branch is required to connect this with the immediate block after
     bool is_split() const;
+    static bool is_split(Instruction lastInstr);
 };
 
 class Function : public frontend::Function<U32> {
     // Analyzer auxiliary method: Determine register read/writes
     void do_register_analysis(Analyzer* status);
 
+    // Analyzer auxiliary method: Determine register read/writes in every block (returns false if unknown code is reachable)
+    bool do_context_analysis(Analyzer* status);
+
 public:
+    // Is this function replaced by a HLE implementation?
+    bool hooked = false;
+
+    // Were the context accesses of the HIR function determined already?
+    bool context_analyzed = false;
+
+    // Translation state and priority (guarded by the translator)
+    TranslationState translation_state = TRANSLATION_NONE;
+    U32 translation_priority = 0;
+
+    // Number of calls made to this function by the interpreter, see Config::ppuTierUpThreshold
+    std::atomic<U32> execution_count{0};
+
     // Return/Arguments type
     FunctionTypeOut type_out;
     std::vector<FunctionTypeIn> type_in;
@@ -78,6 +110,8 @@ public:
     // Analysis
     bool analyze_cfg();  // Generate CFG (and return if branching addresses stay inside the parent segment)
     void analyze_type(); // Determine function arguments/return types
+    void analyze_context(); // Determine context accesses of the HIR function, including callees
+    void analyze_cr_liveness(); // Determine the CR fields live at the end of each block
 
     // Create placeholder
     void createPlaceholder();
@@ -87,19 +121,40 @@ public:
 
     // Recompile function
     void recompile();
+
+    // Code cache
+    bool load_cache();  // Install the native code of this function from the code cache (returns false if missing or outdated)
+    void store_cache(); // Save the native code of this function in the code cache
 };
 
 class Module : public frontend::Module<U32> {
+    // Cache of compiled functions, opened on first use
+    std::unique_ptr<backend::CodeCache> cache;
+    std::once_flag cacheFlag;
+
 public:
+    // Guards the functions of this module and their frontend state, which can be accessed by several translator threads.
+    // HIR functions can be compiled by the backend without holding it.
+    std::recursive_mutex mutex;
+
     Function* addFunction(U32 addr);
 
+    // Get the code cache of this module (returns nullptr if caching is disabled)
+    backend::CodeCache* get_cache();
+
+    // Inline caches of the indirect call sites, indexed by guest address
+    std::map<U32, std::unique_ptr<backend::InlineCache>> inline_caches;
+
+    // Get the inline cache of an indirect call site, creating it if missing
+    backend::InlineCache* addInlineCache(U32 addr);
+
     // Constructor
     Module(CPU* parent);
 
-    // Generate a list of functions and analyze them
+    // Discover the functions of this module and declare them
     void analyze();
 
-    // Recompile each of the functions
+    // Translate all declared functions ahead of time, returning once their native code is installed
     void recompile();
 
     // Replace a function with a HLE hook
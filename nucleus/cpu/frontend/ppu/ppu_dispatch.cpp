@@ -0,0 +1,55 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_dispatch.h"
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+DispatchTable::DispatchTable() {
+    pages.reset(new std::atomic<Page*>[PAGE_COUNT]());
+}
+
+DispatchTable::~DispatchTable() {
+    for (U32 index = 0; index < PAGE_COUNT; index++) {
+        delete pages[index].load(std::memory_order_relaxed);
+    }
+}
+
+void DispatchTable::install(U32 address, hir::Function* function) {
+    auto& slot = pages[address >> PAGE_BITS];
+    Page* page = slot.load(std::memory_order_acquire);
+    if (!page) {
+        // Another thread might allocate the same page at once, in which case its page is used
+        Page* newPage = new Page();
+        if (slot.compare_exchange_strong(page, newPage, std::memory_order_acq_rel)) {
+            page = newPage;
+        } else {
+            delete newPage;
+        }
+    }
+    page->entries[(address & (PAGE_SIZE - 1)) >> 2].store(function, std::memory_order_release);
+}
+
+void DispatchTable::invalidate(U32 address, U32 size) {
+    const U64 end = U64(address) + size;
+    U64 current = address & ~3ULL;
+    while (current < end) {
+        Page* page = pages[current >> PAGE_BITS].load(std::memory_order_acquire);
+        const U64 pageEnd = (current | (PAGE_SIZE - 1)) + 1;
+        const U64 last = (pageEnd < end) ? pageEnd : end;
+        if (page) {
+            for (; current < last; current += 4) {
+                page->entries[(current & (PAGE_SIZE - 1)) >> 2].store(nullptr, std::memory_order_release);
+            }
+        }
+        current = last;
+    }
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
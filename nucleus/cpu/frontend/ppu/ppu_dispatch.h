@@ -0,0 +1,79 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/hir/function.h"
+
+#include <atomic>
+#include <memory>
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * PPU Dispatch Table
+ * ==================
+ * Maps guest addresses to the HIR functions starting at them, whose Function::nativeAddress
+ * is the current entry point of their native code (a placeholder until they are translated).
+ *
+ * The table is a sparse two-level page table over the 32-bit guest address space: the upper
+ * bits of an address select a page, allocated on the first installation inside it, and the
+ * lower bits select one of its entries. Lookups are wait-free (two atomic loads), entries are
+ * installed with a single atomic store, and pages are kept until the table is destroyed so
+ * that concurrent lookups never see a released page.
+ */
+class DispatchTable {
+    // Guest bytes covered by each page
+    static constexpr U32 PAGE_BITS = 16;
+    static constexpr U32 PAGE_SIZE = 1 << PAGE_BITS;
+    static constexpr U32 PAGE_COUNT = 1 << (32 - PAGE_BITS);
+
+    // Entries of each page, one per instruction
+    static constexpr U32 ENTRY_COUNT = PAGE_SIZE / 4;
+
+    struct Page {
+        std::atomic<hir::Function*> entries[ENTRY_COUNT];
+    };
+
+    std::unique_ptr<std::atomic<Page*>[]> pages;
+
+public:
+    DispatchTable();
+    ~DispatchTable();
+
+    /**
+     * Find the function starting at a guest address
+     * @param[in]  address  Guest address
+     * @return              HIR function, or nullptr if none is installed at that address
+     */
+    hir::Function* find(U32 address) const {
+        const Page* page = pages[address >> PAGE_BITS].load(std::memory_order_acquire);
+        if (!page) {
+            return nullptr;
+        }
+        return page->entries[(address & (PAGE_SIZE - 1)) >> 2].load(std::memory_order_acquire);
+    }
+
+    /**
+     * Install the function starting at a guest address, replacing any previous one
+     * @param[in]  address   Guest address
+     * @param[in]  function  HIR function
+     */
+    void install(U32 address, hir::Function* function);
+
+    /**
+     * Remove the functions starting in a range of guest addresses
+     * @param[in]  address  First guest address of the range
+     * @param[in]  size     Number of bytes of the range
+     */
+    void invalidate(U32 address, U32 size);
+};
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
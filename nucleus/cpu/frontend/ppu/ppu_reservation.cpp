@@ -0,0 +1,29 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_reservation.h"
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+ReservationTable::ReservationTable() {
+    versions.reset(new std::atomic<U64>[SLOT_COUNT]());
+}
+
+void ReservationTable::invalidate(U32 address, U32 size) {
+    if (size == 0) {
+        return;
+    }
+    const U64 first = address >> GRANULE_BITS;
+    const U64 last = (U64(address) + size - 1) >> GRANULE_BITS;
+    for (U64 granule = first; granule <= last && granule < first + SLOT_COUNT; granule++) {
+        versions[granule & (SLOT_COUNT - 1)].fetch_add(2, std::memory_order_acq_rel);
+    }
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
@@ -0,0 +1,73 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+#include <atomic>
+#include <memory>
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * PPU Reservation Table
+ * =====================
+ * Global state of the reservations created by lwarx/ldarx and consumed by stwcx./stdcx.
+ * Each thread keeps its own reservation in PPUState (address, value loaded and version),
+ * while this table holds a version counter for every reservation granule (128 bytes),
+ * hashed into a fixed number of slots.
+ *
+ * Conditional stores are emitted inline by the recompiler as two compare-exchanges:
+ *  1. The slot version is advanced if it still matches the reserved version. This claims
+ *     the granule and invalidates the reservations of every other thread on it.
+ *  2. The memory is written if it still holds the reserved value, which detects the plain
+ *     stores of other threads.
+ *
+ * Versions are even and advance by 2, so that INVALID_VERSION never matches any slot.
+ * Granules sharing a slot only cause spurious failures, which the architecture allows.
+ */
+class ReservationTable {
+public:
+    // Bytes covered by each reservation
+    static constexpr U32 GRANULE_BITS = 7;
+
+    // Slots of the table
+    static constexpr U32 SLOT_BITS = 16;
+    static constexpr U32 SLOT_COUNT = 1 << SLOT_BITS;
+
+    // Version of a thread without reservation
+    static constexpr U64 INVALID_VERSION = 1;
+
+private:
+    std::unique_ptr<std::atomic<U64>[]> versions;
+
+public:
+    ReservationTable();
+
+    /**
+     * Get the base address of the slots, accessed directly by the recompiled code
+     * @return  Host address of the first slot
+     */
+    void* getBaseAddr() const {
+        return versions.get();
+    }
+
+    /**
+     * Invalidate the reservations of all threads on a range of guest addresses,
+     * e.g. after the host modified that memory
+     * @param[in]  address  First guest address of the range
+     * @param[in]  size     Number of bytes of the range
+     */
+    void invalidate(U32 address, U32 size);
+};
+
+static_assert(sizeof(std::atomic<U64>) == sizeof(U64), "Reservation versions have to be accessible as plain 64-bit words");
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
@@ -241,24 +241,28 @@ public:
      *  +-----+-----+-----+-----+-----+-----+-----+-----+
      *  | CR0 | CR1 | CR2 | CR3 | CR4 | CR5 | CR6 | CR7 |
      *  +-----+-----+-----+-----+-----+-----+-----+-----+
+     *
+     * It is stored packed as in the guest, so that mfcr/mtcrf are plain copies. Each field
+     * holds the following bits, ordered from MSb to LSb:
+     *
+     *  +----+----+----+----+
+     *  | LT | GT | EQ | SO |  Negative, Positive, Zero, Summary overflow
+     *  | FX | FEX| VX | OX |  Floating-point exception bits (CR1)
+     *  +----+----+----+----+
      */
-    struct CR {
-        union Field {
-            struct {
-                U8 lt;   // Negative (Bit 0)
-                U8 gt;   // Positive (Bit 1)
-                U8 eq;   // Zero (Bit 2)
-                U8 so;   // Summary overflow (Bit 3)
-            };
-            struct {
-                U8 fx;   // Floating-point exception summary (Bit 0)
-                U8 fex;  // Floating-point enabled exception summary (Bit 1)
-                U8 vx;   // Floating-point invalid operation exception summary (Bit 2)
-                U8 ox;   // Floating-point overflow exception (Bit 3)
-            };
-            U8 bit[4];
-        } field[8];
-    } cr;
+    U32 cr;
+
+    // CR field bits
+    enum : U32 {
+        CR_LT  = 0x8,
+        CR_GT  = 0x4,
+        CR_EQ  = 0x2,
+        CR_SO  = 0x1,
+        CR_FX  = 0x8,
+        CR_FEX = 0x4,
+        CR_VX  = 0x2,
+        CR_OX  = 0x1,
+    };
 
     /**
      * XER register
@@ -281,7 +285,7 @@ public:
     PPU_LR lr;
     PPU_CTR ctr;
 
-    U32 padding_;
+    U32 padding_[3];
 
     // Vector/SIMD Registers
     V128 v[32];     // Vector Register
@@ -293,16 +297,40 @@ public:
     // Reservation Registers
     U64 reserve_addr;
     U64 reserve_value;
+    U64 reserve_version;  // Version of the reservation granule (see ReservationTable)
 
     // Program Counter
     U32 pc;
 
 public:
     // Register read
-    U32 getCR();
+    U32 getCR() const {
+        return cr;
+    }
+    U32 getCRField(U32 field) const {
+        return (cr >> (4 * (7 - field))) & 0xF;
+    }
+    bool getCRBit(U32 bit) const {
+        return (cr >> (31 - bit)) & 1;
+    }
 
     // Register write
-    void setCR(U32 value);
+    void setCR(U32 value) {
+        cr = value;
+    }
+    void setCRField(U32 field, U32 value) {
+        const U32 shift = 4 * (7 - field);
+        cr = (cr & ~(0xFU << shift)) | ((value & 0xF) << shift);
+    }
+    void setCRBit(U32 bit, bool value) {
+        const U32 mask = 1U << (31 - bit);
+        cr = value ? (cr | mask) : (cr & ~mask);
+    }
+
+    // Replace the bits of the CR selected by a mask (e.g. 0xF0000000 for CR0), as mtcrf does
+    void setCRMasked(U32 mask, U32 value) {
+        cr = (cr & ~mask) | (value & mask);
+    }
 };
 
 #ifdef NUCLEUS_ARCH_X86
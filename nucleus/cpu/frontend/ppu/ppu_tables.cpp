@@ -5,11 +5,15 @@
 
 #include "ppu_tables.h"
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 // Instruction entry
-#define INSTRUCTION(name) { ENTRY_INSTRUCTION, nullptr, #name, &Analyzer::name, &Recompiler::name }
+#define INSTRUCTION(name) { ENTRY_INSTRUCTION, nullptr, #name, &Analyzer::name, &Recompiler::name, &Interpreter::name }
 
 // Table entry
-#define TABLE(caller) { ENTRY_TABLE, caller, nullptr, nullptr, nullptr }
+#define TABLE(caller) { ENTRY_TABLE, caller, nullptr, nullptr, nullptr, nullptr }
 
 namespace cpu {
 namespace frontend {
@@ -18,6 +22,7 @@ namespace ppu {
 /**
  * PPU tables:
  * Initialized as static constant data when Nucleus starts up.
+ * Decoding goes through the flattened table at the end of this file, generated from these ones.
  * Invalid entries are zero-filled, therefore matching the ENTRY_INVALID type.
  * NOTE: Use designated initializers instead as soon as they become available on C++.
  */
@@ -499,7 +504,7 @@ static const struct table63_ext_t : Table<0x400> {
 /**
  * Return entries from tables
  */
-const Entry& get_entry(Instruction code)
+const Entry& resolve_entry(Instruction code)
 {
     if (tablePrimary[code.opcode].type == ENTRY_TABLE) {
         return tablePrimary[code.opcode].caller(code);
@@ -532,6 +537,55 @@ const Entry& get_table59 (Instruction code) { return table59[code.op59]; }
 const Entry& get_table62 (Instruction code) { return table62[code.op62]; }
 const Entry& get_table63_(Instruction code) { return table63_[code.op63_]; }
 
+/**
+ * Flattened table:
+ * Every extended opcode is contained in the 11 least significant bits of the instruction, so the
+ * primary opcode along with those bits determine the final entry. The flattened table is generated
+ * from the tables above when Nucleus starts up, mapping these 17 bits to a copy of the entry.
+ */
+static const struct table_flat_t {
+    // Unique entries (entry 0 is invalid)
+    std::vector<Entry> entries;
+
+    // Entry index of every combination of primary opcode and extended opcode bits
+    std::unique_ptr<U16[]> index;
+
+    table_flat_t() : entries(1), index(new U16[0x20000]) {
+        std::unordered_map<const Entry*, U16> unique;
+        for (U32 i = 0; i < 0x20000; i++) {
+            Instruction code;
+            code.value = ((i & 0x1F800) << 15) | (i & 0x7FF);
+            const Entry& entry = resolve_entry(code);
+            if (entry.type != ENTRY_INSTRUCTION) {
+                index[i] = 0;
+                continue;
+            }
+            auto it = unique.find(&entry);
+            if (it == unique.end()) {
+                it = unique.emplace(&entry, U16(entries.size())).first;
+                entries.push_back(entry);
+            }
+            index[i] = it->second;
+        }
+    }
+
+    const Entry& operator[] (Instruction code) const {
+        return entries[index[((code.value >> 15) & 0x1F800) | (code.value & 0x7FF)]];
+    }
+} tableFlat;
+
+const Entry& get_entry(Instruction code)
+{
+    return tableFlat[code];
+}
+
+void get_entries(const Instruction* codes, size_t count, const Entry** entries)
+{
+    for (size_t i = 0; i < count; i++) {
+        entries[i] = &tableFlat[codes[i]];
+    }
+}
+
 }  // namespace ppu
 }  // namespace frontend
 }  // namespace cpu
@@ -8,6 +8,7 @@
 #include "nucleus/common.h"
 #include "nucleus/cpu/frontend/ppu/ppu_instruction.h"
 #include "nucleus/cpu/frontend/ppu/analyzer/ppu_analyzer.h"
+#include "nucleus/cpu/frontend/ppu/interpreter/ppu_interpreter.h"
 #include "nucleus/cpu/frontend/ppu/recompiler/ppu_recompiler.h"
 
 #include <string>
@@ -36,10 +37,32 @@ struct Entry
     const char* name;
     void (Analyzer::*analyze)(Instruction);
     void (Recompiler::*recompile)(Instruction);
+    void (Interpreter::*interpret)(Instruction);
 };
 
-// Instruction callers
+/**
+ * Get the entry of an instruction with a single lookup in the flattened table
+ * @param[in]  code  Instruction to be decoded
+ * @return           Instruction entry, or an entry of type ENTRY_INVALID
+ */
 const Entry& get_entry(Instruction code);
+
+/**
+ * Get the entries of a sequence of instructions
+ * @param[in]   codes    Instructions to be decoded
+ * @param[in]   count    Number of instructions
+ * @param[out]  entries  Array receiving a pointer to the entry of each instruction
+ */
+void get_entries(const Instruction* codes, size_t count, const Entry** entries);
+
+/**
+ * Get the entry of an instruction walking the nested tables, as done to build the flattened table
+ * @param[in]  code  Instruction to be decoded
+ * @return           Instruction entry, or an entry of type ENTRY_INVALID or ENTRY_TABLE
+ */
+const Entry& resolve_entry(Instruction code);
+
+// Table callers
 const Entry& get_table4  (Instruction code);
 const Entry& get_table4_ (Instruction code);
 const Entry& get_table19 (Instruction code);
@@ -7,6 +7,7 @@
 #include "nucleus/core/config.h"
 #include "nucleus/cpu/cell.h"
 #include "nucleus/cpu/frontend/ppu/ppu_state.h"
+#include "nucleus/cpu/frontend/ppu/interpreter/ppu_interpreter.h"
 
 namespace cpu {
 namespace frontend {
@@ -14,6 +15,11 @@ namespace ppu {
 
 PPUThread::PPUThread(CPU* parent) : Thread(parent) {
     state = std::make_unique<PPUState>();
+    state->reserve_version = ReservationTable::INVALID_VERSION;
+    interpreter = std::make_unique<Interpreter>(this);
+}
+
+PPUThread::~PPUThread() {
 }
 
 void PPUThread::start() {
@@ -26,44 +32,57 @@ void PPUThread::start() {
 
 void PPUThread::task() {
     if (config.ppuTranslator & CPU_TRANSLATOR_INSTRUCTION) {
-        while (true) {
-            // Handle events
-            if (m_event) {
-                std::unique_lock<std::mutex> lock(m_mutex);
-                if (m_event == NUCLEUS_EVENT_PAUSE) {
-                    m_status = NUCLEUS_STATUS_PAUSED;
-                    m_cv.wait(lock, [&]{ return m_event == NUCLEUS_EVENT_RUN; });
-                    m_status = NUCLEUS_STATUS_RUNNING;
-                }
-                if (m_event == NUCLEUS_EVENT_STOP) {
-                    break;
-                }
-                m_event = NUCLEUS_EVENT_NONE;
-            }
+        // Functions that are hooked or hot enough run natively from the start
+        if (interpreter->enter(state->pc)) {
+            return;
+        }
+
+        // Interpret until the entry function returns to its caller
+        const U64 returnAddr = state->lr;
+        const U64 stack = state->r[1];
+        while (handleEvents()) {
             // Callback finished
-            if (state->pc == 0) {
+            if (state->pc == returnAddr && state->r[1] == stack) {
                 break;
             }
-            //interpreter->step();
+            interpreter->step();
         }
+        return;
     }
     if (config.ppuTranslator & CPU_TRANSLATOR_BLOCK) {
-        for (auto* ppu_segment : static_cast<Cell*>(parent)->ppu_modules) {
-            if (!ppu_segment->contains(state->pc)) {
-                continue;
-            }
+        auto* blockCache = static_cast<Cell*>(parent)->ppu_blocks.get();
 
-            // TODO: ?
+        // Run blocks until the entry function returns to its caller
+        const U64 returnAddr = state->lr;
+        const U64 stack = state->r[1];
+        TranslatedBlock* block = nullptr;
+        while (handleEvents()) {
+            if (state->pc == returnAddr && state->r[1] == stack) {
+                break;
+            }
+            block = blockCache->next(block, state->pc);
+            if (block) {
+                parent->compiler->call(block->hirFunction.load(std::memory_order_acquire), state.get());
+            } else {
+                // Code that cannot be translated is interpreted
+                interpreter->step();
+            }
         }
+        return;
     }
-    if (config.ppuTranslator & CPU_TRANSLATOR_FUNCTION) {
-        for (auto* ppu_segment : static_cast<Cell*>(parent)->ppu_modules) {
-            if (!ppu_segment->contains(state->pc)) {
-                continue;
+    // Modules compiled ahead of time are entered through the dispatch table as well
+    if (config.ppuTranslator & (CPU_TRANSLATOR_FUNCTION | CPU_TRANSLATOR_MODULE)) {
+        auto* cell = static_cast<Cell*>(parent);
+        auto* hirFunction = cell->ppu_dispatch.find(state->pc);
+        if (!hirFunction) {
+            for (auto* ppu_segment : cell->ppu_modules) {
+                if (ppu_segment->contains(state->pc)) {
+                    hirFunction = ppu_segment->addFunction(state->pc)->hirFunction;
+                    break;
+                }
             }
-
-            auto* function = ppu_segment->addFunction(state->pc);
-            auto* hirFunction = function->hirFunction;
+        }
+        if (hirFunction) {
             if (!(hirFunction->flags & hir::FUNCTION_IS_COMPILED)) {
                 parent->compiler->compile(hirFunction);
             }
@@ -71,15 +90,22 @@ void PPUThread::task() {
             return;
         }
     }
-    if (config.ppuTranslator & CPU_TRANSLATOR_MODULE) {
-        for (auto* ppu_segment : static_cast<Cell*>(parent)->ppu_modules) {
-            if (!ppu_segment->contains(state->pc)) {
-                continue;
-            }
+}
 
-            // TODO: ?
+bool PPUThread::handleEvents() {
+    if (m_event) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_event == NUCLEUS_EVENT_PAUSE) {
+            m_status = NUCLEUS_STATUS_PAUSED;
+            m_cv.wait(lock, [&]{ return m_event == NUCLEUS_EVENT_RUN; });
+            m_status = NUCLEUS_STATUS_RUNNING;
+        }
+        if (m_event == NUCLEUS_EVENT_STOP) {
+            return false;
         }
+        m_event = NUCLEUS_EVENT_NONE;
     }
+    return true;
 }
 
 void PPUThread::run()
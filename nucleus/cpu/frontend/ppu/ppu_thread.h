@@ -13,11 +13,16 @@ namespace frontend {
 namespace ppu {
 
 // Forward declarations
+class Interpreter;
 class PPUState;
 
 class PPUThread : public Thread {
+    // Handle the pause and stop requests, returns false if the thread has to stop
+    bool handleEvents();
+
 public:
     std::unique_ptr<PPUState> state;
+    std::unique_ptr<Interpreter> interpreter;
 
     PPUThread(CPU* parent = nullptr);
     ~PPUThread();
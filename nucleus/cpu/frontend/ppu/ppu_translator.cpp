@@ -0,0 +1,166 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_translator.h"
+#include "nucleus/logger/logger.h"
+#include "nucleus/memory/memory.h"
+#include "nucleus/cpu/frontend/ppu/ppu_instruction.h"
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+Translator::Translator(U32 threadCount) {
+    if (threadCount == 0) {
+        // Leave one host core for the guest threads
+        const U32 cores = std::thread::hardware_concurrency();
+        threadCount = (cores > 1) ? (cores - 1) : 0;
+    }
+    for (U32 index = 0; index < threadCount; index++) {
+        workers.emplace_back(&Translator::task, this);
+    }
+}
+
+Translator::~Translator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queueCv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void Translator::task() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queueCv.wait(lock, [&]{ return stopping || !queue.empty(); });
+        if (stopping) {
+            return;
+        }
+        const Request request = queue.top();
+        queue.pop();
+
+        // Skip requests superseded by one of higher priority or served by another thread
+        Function* function = request.function;
+        if (function->translation_state != TRANSLATION_QUEUED || function->translation_priority != request.priority) {
+            continue;
+        }
+        function->translation_state = TRANSLATION_RUNNING;
+
+        lock.unlock();
+        finish(function, translate(function, request.priority));
+        lock.lock();
+    }
+}
+
+bool Translator::translate(Function* function, U32 priority) {
+    auto* module = static_cast<Module*>(function->parent);
+    auto* memory = module->parent->memory.get();
+    auto* compiler = module->parent->compiler.get();
+    auto* hirFunction = function->hirFunction;
+
+    std::vector<Function*> callees;
+    {
+        std::lock_guard<std::recursive_mutex> lock(module->mutex);
+
+        // HLE implementations are compiled when hooking the function
+        if (function->hooked) {
+            return true;
+        }
+        // Reuse the code compiled in previous sessions if the guest code did not change
+        if (function->load_cache()) {
+            return true;
+        }
+        if (!function->analyze_cfg()) {
+            logger.warning(LOG_CPU, "Could not analyze function: %s", function->name.c_str());
+            return false;
+        }
+        function->recompile();
+
+        // Find the functions called through bl/bcl, which were declared during the recompilation
+        for (const auto& item : function->blocks) {
+            const auto& block = *item.second;
+            for (U32 addr = block.address; addr < block.address + block.size; addr += 4) {
+                Instruction code;
+                code.value = memory->read32(addr);
+                if ((code.opcode != 0x10 && code.opcode != 0x12) || !code.lk) {
+                    continue;
+                }
+                const auto it = module->functions.find(code.get_target(addr));
+                if (it != module->functions.end() && it->second != function) {
+                    callees.push_back(static_cast<Function*>(it->second));
+                }
+            }
+        }
+    }
+
+    if (!compiler->compile(hirFunction)) {
+        logger.error(LOG_CPU, "Could not compile function: %s", function->name.c_str());
+        return false;
+    }
+    {
+        std::lock_guard<std::recursive_mutex> lock(module->mutex);
+        function->store_cache();
+    }
+    hirFunction->release();
+
+    for (auto* callee : callees) {
+        enqueue(callee, priority + 1);
+    }
+    return true;
+}
+
+void Translator::finish(Function* function, bool success) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        function->translation_state = success ? TRANSLATION_DONE : TRANSLATION_FAILED;
+    }
+    doneCv.notify_all();
+}
+
+void Translator::enqueue(Function* function, U32 priority) {
+    // Without translator threads, functions are only translated when required
+    if (workers.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto state = function->translation_state;
+        if (state != TRANSLATION_NONE && !(state == TRANSLATION_QUEUED && priority < function->translation_priority)) {
+            return;
+        }
+        function->translation_state = TRANSLATION_QUEUED;
+        function->translation_priority = priority;
+        queue.push({ priority, sequence++, function });
+    }
+    queueCv.notify_one();
+}
+
+bool Translator::require(Function* function) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (function->translation_state == TRANSLATION_RUNNING) {
+        doneCv.wait(lock);
+    }
+    if (function->translation_state == TRANSLATION_DONE) {
+        return true;
+    }
+    if (function->translation_state == TRANSLATION_FAILED) {
+        return false;
+    }
+
+    // Translate it on the calling thread rather than waiting for a translator thread
+    function->translation_state = TRANSLATION_RUNNING;
+    function->translation_priority = 0;
+    lock.unlock();
+    const bool success = translate(function, 0);
+    finish(function, success);
+    return success;
+}
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
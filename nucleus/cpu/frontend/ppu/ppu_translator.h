@@ -0,0 +1,101 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/frontend/ppu/ppu_decoder.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace cpu {
+namespace frontend {
+namespace ppu {
+
+/**
+ * PPU Translator
+ * ==============
+ * Translates PPU functions (CFG analysis, recompilation to HIR and compilation to native
+ * code) on a pool of background threads, so that guest threads only stall on the functions
+ * they are about to execute.
+ *
+ * Functions are queued by priority, lower values first. Functions requested by a guest
+ * thread get priority 0 and are translated right away on that thread, unless a translator
+ * thread is already working on them. Once a function is recompiled, the functions it calls
+ * through bl/bcl are queued with the priority of their caller plus one, so that callees get
+ * compiled before the guest code reaches them.
+ *
+ * The frontend stages run with the mutex of the parent ppu::Module held, while the backend
+ * compiles the resulting HIR function without it.
+ */
+class Translator {
+    struct Request {
+        U32 priority;
+        U64 sequence;  // Order of arrival, requests of equal priority are served FIFO
+        Function* function;
+
+        bool operator<(const Request& other) const {
+            if (priority != other.priority) {
+                return priority > other.priority;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    std::priority_queue<Request> queue;
+    U64 sequence = 0;
+    bool stopping = false;
+
+    std::vector<std::thread> workers;
+
+    // Guards the queue and the translation state of every function
+    std::mutex mutex;
+    std::condition_variable queueCv;
+    std::condition_variable doneCv;
+
+    // Main loop of the translator threads
+    void task();
+
+    /**
+     * Translate a function and queue its callees
+     * @param[in]  function  Function to be translated
+     * @param[in]  priority  Priority of the function, its callees are queued with the next one
+     * @return               True on success
+     */
+    bool translate(Function* function, U32 priority);
+
+    // Mark a function as translated and wake up the threads waiting for it
+    void finish(Function* function, bool success);
+
+public:
+    /**
+     * Constructor
+     * @param[in]  threadCount  Number of translator threads (by default, one less than the host cores)
+     */
+    Translator(U32 threadCount = 0);
+    ~Translator();
+
+    /**
+     * Queue a function to be translated in the background
+     * @param[in]  function  Function to be translated
+     * @param[in]  priority  Priority of the request (lower values are served first)
+     */
+    void enqueue(Function* function, U32 priority);
+
+    /**
+     * Make sure a function is translated, blocking the caller until it is
+     * @param[in]  function  Function to be translated
+     * @return               True if the native code of the function is installed
+     */
+    bool require(Function* function);
+};
+
+}  // namespace ppu
+}  // namespace frontend
+}  // namespace cpu
@@ -4,7 +4,9 @@
  */
 
 #include "ppu_recompiler.h"
+#include "nucleus/cpu/cell.h"
 #include "nucleus/cpu/frontend/ppu/ppu_state.h"
+#include "nucleus/cpu/frontend/ppu/ppu_tables.h"
 #include "nucleus/memory/memory.h"
 #include "nucleus/core/config.h"
 #include "nucleus/logger/logger.h"
@@ -53,13 +55,15 @@ void Recompiler::createProlog() {
 void Recompiler::createEpilog() {
     assert_true(epilog == nullptr, "The frontend epilog block was already declared");
 
-    epilog = new hir::Block(function->hirFunction);
+    epilog = hir::Block::create(function->hirFunction);
     builder.setInsertPoint(epilog);
 
-    if (config.ppuTranslator != CPU_TRANSLATOR_MODULE) {
+    // Functions whose type was not analyzed leave their results in the guest state,
+    // so that they can be called through the dispatch table and inline caches
+    auto ppuFunc = static_cast<Function*>(function);
+    if (ppuFunc->type_out == FUNCTION_OUT_UNKNOWN) {
         builder.createRet();
     } else {
-        auto ppuFunc = static_cast<Function*>(function);
         switch (ppuFunc->type_out) {
         case FUNCTION_OUT_INTEGER:
             builder.createRet(getGPR(3));
@@ -129,35 +133,58 @@ Value* Recompiler::getVR(int index) {
 }
 
 Value* Recompiler::getCRField(int index) {
-    // TODO: Use volatility information?
-
-    Value* field = builder.createShl(builder.createCtxLoad(
-        offsetof(PPUState, cr.field[index].bit[0]), TYPE_I8), U64(3));
-    field = builder.createOr(field, builder.createShl(builder.createCtxLoad(
-        offsetof(PPUState, cr.field[index].bit[1]), TYPE_I8), U64(2)));
-    field = builder.createOr(field, builder.createShl(builder.createCtxLoad(
-        offsetof(PPUState, cr.field[index].bit[2]), TYPE_I8), U64(1)));
-    field = builder.createOr(field, builder.createShl(builder.createCtxLoad(
-        offsetof(PPUState, cr.field[index].bit[3]), TYPE_I8), U64(0)));
-
+    const auto& compare = crCompare[index];
+    if (compare.lhs) {
+        return compareCR(compare.lhs, compare.rhs, compare.logical, compare.so);
+    }
+    constexpr U32 offset = offsetof(PPUState, cr);
+    Value* field = builder.createShr(builder.createCtxLoad(offset, TYPE_I32), U64(4 * (7 - index)));
+    field = builder.createAnd(builder.createTrunc(field, TYPE_I8), builder.getConstantI8(0xF));
     return field;
 }
 
 Value* Recompiler::getCRBit(int index) {
-    const U32 offset = offsetof(PPUState, cr.field[index >> 2].bit[index & 0b11]);
-
-     // TODO: Use volatility information?
+    return getCRCondition(index, true);
+}
+
+Value* Recompiler::getCRCondition(int index, bool value) {
+    constexpr U32 offset = offsetof(PPUState, cr);
+
+    // Evaluate the condition on the operands of the comparison, which lets the backend fuse it with a branch
+    const auto& compare = crCompare[index >> 2];
+    if (compare.lhs) {
+        switch (index & 0b11) {
+        case 0:
+            if (compare.logical) {
+                return value ? builder.createCmpULT(compare.lhs, compare.rhs) : builder.createCmpUGE(compare.lhs, compare.rhs);
+            } else {
+                return value ? builder.createCmpSLT(compare.lhs, compare.rhs) : builder.createCmpSGE(compare.lhs, compare.rhs);
+            }
+        case 1:
+            if (compare.logical) {
+                return value ? builder.createCmpUGT(compare.lhs, compare.rhs) : builder.createCmpULE(compare.lhs, compare.rhs);
+            } else {
+                return value ? builder.createCmpSGT(compare.lhs, compare.rhs) : builder.createCmpSLE(compare.lhs, compare.rhs);
+            }
+        case 2:
+            return value ? builder.createCmpEQ(compare.lhs, compare.rhs) : builder.createCmpNE(compare.lhs, compare.rhs);
+        case 3:
+            return value ? compare.so : builder.createXor(compare.so, builder.getConstantI8(1));
+        }
+    }
 
-    return builder.createCtxLoad(offset, TYPE_I8);
+    Value* bit = builder.createShr(builder.createCtxLoad(offset, TYPE_I32), U64(31 - index));
+    bit = builder.createAnd(builder.createTrunc(bit, TYPE_I8), builder.getConstantI8(1));
+    if (!value) {
+        bit = builder.createXor(bit, builder.getConstantI8(1));
+    }
+    return bit;
 }
 
 Value* Recompiler::getCR() {
-    Value* cr = builder.getConstantI32(0);
-    for (int field = 0; field < 8; field++) {
-        cr = builder.createOr(cr, builder.createShl(
-            builder.createZExt(getCRField(field), TYPE_I32), 4 * (7 - field)));
-    }
-    return cr;
+    constexpr U32 offset = offsetof(PPUState, cr);
+    storeCR(0xFF);
+    return builder.createCtxLoad(offset, TYPE_I32);
 }
 
 Value* Recompiler::getLR() {
@@ -248,48 +275,62 @@ void Recompiler::setVR(int index, Value* value) {
 }
 
 void Recompiler::setCRField(int index, Value* value) {
-    // TODO: Use volatility information?
-
-    switch (value->type) {
-    // Unpack and store the value bits
-    case TYPE_I8:
-        builder.createCtxStore(offsetof(PPUState, cr.field[index].bit[0]),
-            builder.createAnd(builder.createShr(value, U64(3)), builder.getConstantI8(1)));
-        builder.createCtxStore(offsetof(PPUState, cr.field[index].bit[1]),
-            builder.createAnd(builder.createShr(value, U64(2)), builder.getConstantI8(1)));
-        builder.createCtxStore(offsetof(PPUState, cr.field[index].bit[2]),
-            builder.createAnd(builder.createShr(value, U64(1)), builder.getConstantI8(1)));
-        builder.createCtxStore(offsetof(PPUState, cr.field[index].bit[3]),
-            builder.createAnd(builder.createShr(value, U64(0)), builder.getConstantI8(1)));
-        break;
-
-    // Store the unpacked value directly
-    case TYPE_I32:
-        builder.createCtxStore(offsetof(PPUState, cr.field[index]), value);
-        break;
-
-    default:
-        logger.error(LOG_CPU, "Wrong value type for CR register");
+    if (value->type != TYPE_I8) {
+        logger.error(LOG_CPU, "Wrong value type for CR field");
+        return;
     }
+
+    const U32 shift = 4 * (7 - index);
+    value = builder.createZExt(builder.createAnd(value, builder.getConstantI8(0xF)), TYPE_I32);
+    setCRMasked(0xFU << shift, builder.createShl(value, U64(shift)));
 }
 
 void Recompiler::setCRBit(int index, Value* value) {
-    const U32 offset = offsetof(PPUState, cr.field[index >> 2].bit[index & 0b11]);
-
-     // TODO: Use volatility information?
+    if (value->type != TYPE_I8) {
+        logger.error(LOG_CPU, "Wrong value type for CR bit");
+        return;
+    }
 
-    builder.createCtxStore(offset, value);
+    const U32 shift = 31 - index;
+    value = builder.createZExt(builder.createAnd(value, builder.getConstantI8(1)), TYPE_I32);
+    setCRMasked(1U << shift, builder.createShl(value, U64(shift)));
 }
 
-void Recompiler::setCR(Value* value) {
+void Recompiler::setCRMasked(U32 mask, Value* value) {
     if (value->type != TYPE_I32) {
         logger.error(LOG_CPU, "Wrong value type for CR register");
         return;
     }
 
+    // Fields partially overwritten are stored first. None of the fields written holds a known comparison afterwards.
+    U8 partial = 0;
     for (int field = 0; field < 8; field++) {
-        setCRField(field, builder.createTrunc(builder.createShr(value, (4 * (7 - field))), TYPE_I8));
+        const U32 fieldMask = 0xFU << (4 * (7 - field));
+        if ((mask & fieldMask) != 0 && (mask & fieldMask) != fieldMask) {
+            partial |= (1 << field);
+        }
     }
+    storeCR(partial);
+    for (int field = 0; field < 8; field++) {
+        if (mask & (0xFU << (4 * (7 - field)))) {
+            crCompare[field] = CRCompare();
+        }
+    }
+    writeCR(mask, value);
+}
+
+void Recompiler::writeCR(U32 mask, Value* value) {
+    constexpr U32 offset = offsetof(PPUState, cr);
+
+    if (mask != 0xFFFFFFFF) {
+        Value* cr = builder.createAnd(builder.createCtxLoad(offset, TYPE_I32), builder.getConstantI32(~mask));
+        value = builder.createOr(cr, builder.createAnd(value, builder.getConstantI32(mask)));
+    }
+    builder.createCtxStore(offset, value);
+}
+
+void Recompiler::setCR(Value* value) {
+    setCRMasked(0xFFFFFFFF, value);
 }
 
 void Recompiler::setLR(Value* value) {
@@ -366,6 +407,16 @@ void Recompiler::setFPSCR(Value* value) {
     builder.createCtxStore(offset, value);
 }
 
+void Recompiler::setPC(Value* value) {
+    constexpr U32 offset = offsetof(PPUState, pc);
+
+    if (value->type != TYPE_I32) {
+        logger.error(LOG_CPU, "Wrong value type for PC register");
+        return;
+    }
+    builder.createCtxStore(offset, value);
+}
+
 /**
  * Memory access
  */
@@ -393,10 +444,57 @@ void Recompiler::writeMemory(Value* addr, Value* value) {
     }
 }
 
+/**
+ * Memory reservations
+ */
+Value* Recompiler::getReservationSlot(Value* addr) {
+    auto& reservations = parent->ppu_reservations;
+    Value* index = builder.createShr(addr, U64(ReservationTable::GRANULE_BITS));
+    index = builder.createAnd(index, builder.getConstantI64(ReservationTable::SLOT_COUNT - 1));
+    return builder.createAdd(builder.createShl(index, U64(3)), builder.getConstantPointer(reservations.getBaseAddr()));
+}
+
+Value* Recompiler::readReserved(Value* addr, Type type) {
+    // Read the version first: a conditional store completed after it makes the reservation fail
+    Value* version = builder.createLoad(getReservationSlot(addr), TYPE_I64);
+    Value* value = readMemory(addr, type);
+
+    builder.createCtxStore(offsetof(PPUState, reserve_addr), addr);
+    builder.createCtxStore(offsetof(PPUState, reserve_value), (type == TYPE_I64) ? value : builder.createZExt(value, TYPE_I64));
+    builder.createCtxStore(offsetof(PPUState, reserve_version), version);
+    return value;
+}
+
+Value* Recompiler::writeConditional(Value* addr, Value* value) {
+    Value* reserveAddr = builder.createCtxLoad(offsetof(PPUState, reserve_addr), TYPE_I64);
+    Value* reserveValue = builder.createCtxLoad(offsetof(PPUState, reserve_value), TYPE_I64);
+    Value* reserveVersion = builder.createCtxLoad(offsetof(PPUState, reserve_version), TYPE_I64);
+    if (value->type != TYPE_I64) {
+        reserveValue = builder.createTrunc(reserveValue, value->type);
+    }
+
+    // Claim the granule, unless another thread did since the reservation or it was made elsewhere
+    Value* version = builder.createSelect(builder.createCmpEQ(reserveAddr, addr),
+        reserveVersion, builder.getConstantI64(ReservationTable::INVALID_VERSION));
+    Value* claimed = builder.createCmpXchg(getReservationSlot(addr),
+        version, builder.createAdd(version, builder.getConstantI64(2)));
+
+    // Write the value if the memory still holds the reserved one. Without the granule,
+    // the memory is left unchanged (at most, the reserved value is rewritten).
+    void* baseAddress = parent->memory->getBaseAddr();
+    Value* hostAddr = builder.createAdd(addr, builder.getConstantPointer(baseAddress));
+    Value* desired = builder.createSelect(claimed, value, reserveValue);
+    Value* stored = builder.createCmpXchg(hostAddr, reserveValue, desired, ENDIAN_BIG);
+
+    // The reservation is lost in any case
+    builder.createCtxStore(offsetof(PPUState, reserve_version), builder.getConstantI64(ReservationTable::INVALID_VERSION));
+    return builder.createAnd(claimed, stored);
+}
+
 /**
  * Operation flags
  */
-void Recompiler::updateCR(int field, Value* lhs, Value* rhs, bool logicalComparison) {
+Value* Recompiler::compareCR(Value* lhs, Value* rhs, bool logicalComparison, Value* so) {
     Value* isLT;
     Value* isGT;
     Value* result;
@@ -409,9 +507,20 @@ void Recompiler::updateCR(int field, Value* lhs, Value* rhs, bool logicalCompari
         isGT = builder.createCmpSGT(lhs, rhs);
     }
 
-    result = builder.createSelect(isGT, builder.getConstantI32(0x00000100), builder.getConstantI32(0x00010000));
-    result = builder.createSelect(isLT, builder.getConstantI32(0x00000001), result);
-    setCRField(field, result);
+    result = builder.createSelect(isGT, builder.getConstantI8(PPUState::CR_GT), builder.getConstantI8(PPUState::CR_EQ));
+    result = builder.createSelect(isLT, builder.getConstantI8(PPUState::CR_LT), result);
+    return builder.createOr(result, so);
+}
+
+void Recompiler::updateCR(int field, Value* lhs, Value* rhs, bool logicalComparison) {
+    // Keep the operands and the summary overflow at this point. Most comparisons are only read by a branch
+    // in the same block, or overwritten by another one, so they rarely need to be stored.
+    auto& compare = crCompare[field];
+    compare.lhs = lhs;
+    compare.rhs = rhs;
+    compare.so = getXER_SO();
+    compare.logical = logicalComparison;
+    compare.stored = false;
 }
 
 void Recompiler::updateCR0(Value* value) {
@@ -421,12 +530,57 @@ void Recompiler::updateCR0(Value* value) {
 void Recompiler::updateCR1(Value* value) {
 }
 
+void Recompiler::storeCR(U8 fields) {
+    for (int field = 0; field < 8; field++) {
+        auto& compare = crCompare[field];
+        if (!(fields & (1 << field)) || !compare.lhs || compare.stored) {
+            continue;
+        }
+        const U32 shift = 4 * (7 - field);
+        Value* value = builder.createZExt(compareCR(compare.lhs, compare.rhs, compare.logical, compare.so), TYPE_I32);
+        writeCR(0xFU << shift, builder.createShl(value, U64(shift)));
+        compare.stored = true;
+    }
+}
+
 void Recompiler::updateCR6(Value* value) {
+    // Set LT if all bits of the result are set and EQ if all of them are cleared
+    Value* lo = builder.createVExtract(value, 0, TYPE_I64);
+    Value* hi = builder.createVExtract(value, 1, TYPE_I64);
+    Value* allTrue = builder.createCmpEQ(builder.createAnd(lo, hi), builder.getConstantI64(~0ULL));
+    Value* allFalse = builder.createCmpEQ(builder.createOr(lo, hi), builder.getConstantI64(0));
+
+    Value* field = builder.createOr(builder.createShl(allTrue, U64(3)), builder.createShl(allFalse, U64(1)));
+    setCRField(6, field);
 }
 
 /**
  * Branching
  */
+void Recompiler::recompileInstruction(Instruction code) {
+    // Callees and system calls might read any field
+    if ((code.is_branch() && code.lk) || code.opcode == 0x11) {
+        storeCR(0xFF);
+    }
+
+    auto method = get_entry(code).recompile;
+    (this->*method)(code);
+
+    // Comparisons are only tracked within a block, and callees might overwrite them
+    if (code.is_branch() || code.opcode == 0x11) {
+        for (auto& compare : crCompare) {
+            compare = CRCompare();
+        }
+    }
+}
+
+void Recompiler::flushCR() {
+    storeCR(crLiveOut);
+    for (auto& compare : crCompare) {
+        compare = CRCompare();
+    }
+}
+
 void Recompiler::createFunctionCall(U32 nia, Value* condition) {
     auto* module = function->parent;
     auto& targetFunc = static_cast<Function&>(*module->functions.at(nia));
@@ -449,6 +603,9 @@ void Recompiler::createFunctionCall(U32 nia, Value* condition) {
         index += 1;
     }
 
+    // Determine the registers accessed by the target, so that other registers can stay cached across the call
+    targetFunc.analyze_context();
+
     Value* result;
     if (condition) {
         result = builder.createCallCond(condition, targetFunc.hirFunction, arguments);
@@ -26,6 +26,7 @@ private:
     hir::Value* getVR(int index);
     hir::Value* getCRField(int index);
     hir::Value* getCRBit(int index);
+    hir::Value* getCRCondition(int index, bool value); // Returns whether a CR bit holds the given value
     hir::Value* getCR();
     hir::Value* getLR();
     hir::Value* getXER();
@@ -42,6 +43,8 @@ private:
     void setVR(int index, hir::Value* value);
     void setCRField(int index, hir::Value* value);
     void setCRBit(int index, hir::Value* value);
+    void setCRMasked(U32 mask, hir::Value* value); // Replaces the CR bits selected by the mask
+    void writeCR(U32 mask, hir::Value* value);      // Same, ignoring the comparisons held by the CR fields
     void setCR(hir::Value* value);
     void setLR(hir::Value* value);
     void setXER(hir::Value* value);
@@ -51,16 +54,34 @@ private:
     void setXER_BC(hir::Value* value);
     void setCTR(hir::Value* value);
     void setFPSCR(hir::Value* value);
+    void setPC(hir::Value* value);
 
     // Memory access
     hir::Value* readMemory(hir::Value* addr, hir::Type type);
     void writeMemory(hir::Value* addr, hir::Value* value);
 
+    // Memory reservations
+    hir::Value* getReservationSlot(hir::Value* addr);
+    hir::Value* readReserved(hir::Value* addr, hir::Type type);
+    hir::Value* writeConditional(hir::Value* addr, hir::Value* value); // Returns whether the store succeeded
+
     // Operation flags
+    hir::Value* compareCR(hir::Value* lhs, hir::Value* rhs, bool logicalComparison, hir::Value* so);
     void updateCR(int field, hir::Value* lhs, hir::Value* rhs, bool logicalComparison);
     void updateCR0(hir::Value* value); // Integer instructions with RC bit
     void updateCR1(hir::Value* value); // Floating-Point instructions with RC bit
     void updateCR6(hir::Value* value); // Vector instructions with RC bit
+    void storeCR(U8 fields);           // Stores the selected fields holding a comparison (bit N selects CR field N)
+
+    // Comparison held by a CR field, from which its bits are computed instead of being loaded.
+    // Fields are stored only when control might leave the current block (see crLiveOut).
+    struct CRCompare {
+        hir::Value* lhs = nullptr;  // Left operand, or nullptr if the field holds no known comparison
+        hir::Value* rhs = nullptr;  // Right operand
+        hir::Value* so = nullptr;   // XER[SO] at the time of the comparison
+        bool logical = false;       // Unsigned comparison
+        bool stored = false;        // Was the field already stored?
+    } crCompare[8];
 
     // Branching
     void createFunctionCall(U32 nia, hir::Value* condition = nullptr);
@@ -76,6 +97,25 @@ public:
     // Recompiler status
     U32 currentAddress;
 
+    // CR fields that might be read after the current block (bit N selects CR field N), see Function::analyze_cr_liveness
+    U8 crLiveOut = 0xFF;
+
+    /**
+     * Recompile the instruction at currentAddress, storing the CR fields it might read from PPUState
+     * @param[in]  code  Instruction to recompile
+     */
+    void recompileInstruction(Instruction code);
+
+    /**
+     * Store the CR fields holding a comparison that are in crLiveOut, and forget the comparisons.
+     * This has to be done at the end of every block falling through into the next one.
+     */
+    void flushCR();
+
+    // Translating a single block (see BlockCache): branches and calls leave through the exit blocks,
+    // which are indexed by their target in IRecompiler::blocks, or through the epilog after setting the PC
+    bool blockMode = false;
+
     /**
      * PPC64 Instructions:
      * Organized according to the chapter 4 of the Programming Environments Manual
@@ -22,18 +22,20 @@ using namespace cpu::hir;
 void Recompiler::bx(Instruction code)
 {
     const U32 targetAddr = code.aa ? (code.li << 2) : (currentAddress + (code.li << 2)) & ~0x3;
+    storeCR(crLiveOut);
 
     // Unconditional call
-    if (code.lk) {
-        if (config.ppuTranslator & CPU_TRANSLATOR_IS_JIT) {
-            auto* module = static_cast<Module*>(function->parent);
-            module->addFunction(targetAddr);
-        }
+    if (code.lk && !blockMode) {
+        auto* module = static_cast<Module*>(function->parent);
+        module->addFunction(targetAddr);
         createFunctionCall(targetAddr);
     }
 
     // Unconditional branch
     else {
+        if (code.lk) {
+            setLR(builder.getConstantI64(currentAddress + 4));
+        }
         hir::Block* targetBlock = blocks.at(targetAddr);
         builder.createBr(targetBlock);
     }
@@ -43,6 +45,7 @@ void Recompiler::bcx(Instruction code)
 {
     const U32 targetAddr = code.aa ? (code.bd << 2) : (currentAddress + (code.bd << 2)) & ~0x3;
     const U32 nextAddr = (currentAddress + 4) & ~0x3;
+    storeCR(crLiveOut);
 
     // Check condition
     const U8 bo0 = (code.bo & 0x10) ? 1 : 0;
@@ -64,16 +67,12 @@ void Recompiler::bcx(Instruction code)
 
     Value* cond_ok = nullptr;
     if (!bo0) {
-        if (!bo1) {
-            cond_ok = builder.createXor(getCRBit(code.bi), builder.getConstantI8(1));
-        } else {
-            cond_ok = getCRBit(code.bi);
-        }
+        cond_ok = getCRCondition(code.bi, bo1);
     }
 
     Value* cond = nullptr;
     if (ctr_ok && cond_ok) {
-        builder.createAnd(ctr_ok, cond_ok);
+        cond = builder.createAnd(ctr_ok, cond_ok);
     } else if (ctr_ok) {
         cond = ctr_ok;
     }  else if (cond_ok) {
@@ -81,16 +80,17 @@ void Recompiler::bcx(Instruction code)
     }
 
     // Unconditional/conditional call
-    if (code.lk) {
-        if (config.ppuTranslator & CPU_TRANSLATOR_IS_JIT) {
-            auto* module = static_cast<Module*>(function->parent);
-            module->addFunction(targetAddr);
-        }
+    if (code.lk && !blockMode) {
+        auto* module = static_cast<Module*>(function->parent);
+        module->addFunction(targetAddr);
         createFunctionCall(targetAddr, cond);
     }
 
     // Unconditional/conditional branch
     else {
+        if (code.lk) {
+            setLR(builder.getConstantI64(nextAddr));
+        }
         if (cond) {
             builder.createBrCond(cond, blocks.at(targetAddr), blocks.at(nextAddr));
         } else {
@@ -101,46 +101,59 @@ void Recompiler::bcx(Instruction code)
 
 void Recompiler::bcctrx(Instruction code)
 {
-    Value* targetAddr = getCTR();
     const U32 nextAddr = (currentAddress + 4) & ~0x3;
+    storeCR(crLiveOut);
 
     // Check condition
     Value* cond_ok = nullptr;
     const auto bo0 = code.bo & 0x10;
     const auto bo1 = code.bo & 0x08;
     if (!bo0) {
-        assert_always("Unimplemented");
-        // TODO: Set cond_ok
+        cond_ok = getCRCondition(code.bi, bo1 != 0);
+    }
+
+    // Leave the block through the epilog
+    if (blockMode) {
+        setPC(builder.createAnd(builder.createTrunc(getCTR(), TYPE_I32), builder.getConstantI32(~0x3)));
+        if (code.lk) {
+            setLR(builder.getConstantI64(nextAddr));
+        }
+        if (cond_ok) {
+            builder.createBrCond(cond_ok, epilog, blocks.at(nextAddr));
+        } else {
+            builder.createBr(epilog);
+        }
+        return;
     }
 
     // Conditional function call
     if (code.lk) {
-        if (config.ppuTranslator & CPU_TRANSLATOR_IS_JIT) {
-            hir::Function* proxyFunc = builder.getExternFunction(nucleusCall);
-            if (cond_ok) {
-                builder.createCallCond(cond_ok, proxyFunc, {targetAddr}, hir::CALL_EXTERN);
-            } else {
-                builder.createCall(proxyFunc, {targetAddr}, hir::CALL_EXTERN);
-            }
+        auto* module = static_cast<Module*>(function->parent);
+        hir::Function* cacheFunc = module->addInlineCache(currentAddress)->function;
+        if (cond_ok) {
+            builder.createCallCond(cond_ok, cacheFunc, {});
+        } else {
+            builder.createCall(cacheFunc, {});
         }
     }
 
     // Simple conditional branch
     else {
-        if (config.ppuTranslator & CPU_TRANSLATOR_IS_JIT) {
-            hir::Function* proxyFunc = builder.getExternFunction(nucleusCall);
-            if (cond_ok) {
-                builder.createCallCond(cond_ok, proxyFunc, {targetAddr}, hir::CALL_EXTERN);
-            } else {
-                builder.createCall(proxyFunc, {targetAddr}, hir::CALL_EXTERN);
-            }
-            builder.createRet();
+        auto* module = static_cast<Module*>(function->parent);
+        hir::Function* cacheFunc = module->addInlineCache(currentAddress)->function;
+        if (cond_ok) {
+            builder.createCallCond(cond_ok, cacheFunc, {});
+        } else {
+            builder.createCall(cacheFunc, {});
         }
+        builder.createRet();
     }
 }
 
 void Recompiler::bclrx(Instruction code)
 {
+    storeCR(crLiveOut);
+
     // Check condition
     const U8 bo0 = (code.bo & 0x10) ? 1 : 0;
     const U8 bo1 = (code.bo & 0x08) ? 1 : 0;
@@ -161,22 +174,32 @@ void Recompiler::bclrx(Instruction code)
 
     Value* cond_ok = nullptr;
     if (!bo0) {
-        if (!bo1) {
-            cond_ok = builder.createXor(getCRBit(code.bi), builder.getConstantI8(1));
-        } else {
-            cond_ok = getCRBit(code.bi);
-        }
+        cond_ok = getCRCondition(code.bi, bo1);
     }
 
     Value* cond = nullptr;
     if (ctr_ok && cond_ok) {
-        builder.createAnd(ctr_ok, cond_ok);
+        cond = builder.createAnd(ctr_ok, cond_ok);
     } else if (ctr_ok) {
         cond = ctr_ok;
     }  else if (cond_ok) {
         cond = cond_ok;
     }
 
+    // Leave the block through the epilog
+    if (blockMode) {
+        setPC(builder.createAnd(builder.createTrunc(getLR(), TYPE_I32), builder.getConstantI32(~0x3)));
+        if (code.lk) {
+            setLR(builder.getConstantI64(currentAddress + 4));
+        }
+        if (cond) {
+            builder.createBrCond(cond, epilog, blocks.at(currentAddress + 4));
+        } else {
+            builder.createBr(epilog);
+        }
+        return;
+    }
+
     // Call the return
     if (code.lk) {
         assert_always("Unimplemented");
@@ -274,7 +297,8 @@ void Recompiler::crxor(Instruction code)
 
 void Recompiler::mcrf(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* field = getCRField(code.crfs);
+    setCRField(code.crfd, field);
 }
 
 void Recompiler::sc(Instruction code)
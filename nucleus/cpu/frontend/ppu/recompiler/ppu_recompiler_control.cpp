@@ -66,18 +66,19 @@ void Recompiler::mtocrf(Instruction code)
             }
         }
         if (count == 1) {
-            Value* value = builder.createTrunc(builder.createShr(rs, 4 * (7 - field)), TYPE_I8);
-            value = builder.createAnd(value, builder.getConstantI8(0xF));
-            setCRField(field, value);
+            setCRMasked(0xFU << (4 * (7 - field)), rs);
         }
     } else {
+        // Expand each bit of CRM into the mask of its field
+        U32 mask = 0;
         for (int field = 0; field < 8; field++) {
             if (code.crm & (1 << (7 - field))) {
-                Value* value = builder.createTrunc(builder.createShr(rs, 4 * (7 - field)), TYPE_I8);
-                value = builder.createAnd(value, builder.getConstantI8(0xF));
-                setCRField(field, value);
+                mask |= 0xFU << (4 * (7 - field));
             }
         }
+        if (mask) {
+            setCRMasked(mask, rs);
+        }
     }
 }
 
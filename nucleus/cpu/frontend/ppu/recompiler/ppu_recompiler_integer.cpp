@@ -687,7 +687,25 @@ void Recompiler::oris(Instruction code)
 
 void Recompiler::rldc_lr(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* rs = getGPR(code.rs);
+    Value* rb = getGPR(code.rb);
+    Value* ra;
+
+    ra = builder.createRol(rs, builder.createAnd(rb, builder.getConstantI64(0x3F)));
+
+    // Bit 30 selects between rldcl and rldcr, which share the mask field
+    if (code.sh_ == 0) {
+        const U32 mb = code.mb | (code.mb_ << 5);
+        ra = builder.createAnd(ra, builder.getConstantI64(rotateMask[mb][63]));
+    } else {
+        const U32 me = code.me_ | (code.me__ << 5);
+        ra = builder.createAnd(ra, builder.getConstantI64(rotateMask[0][me]));
+    }
+    if (code.rc) {
+        updateCR0(ra);
+    }
+
+    setGPR(code.ra, ra);
 }
 
 void Recompiler::rldicx(Instruction code)
@@ -698,9 +716,7 @@ void Recompiler::rldicx(Instruction code)
     const U32 sh = code.sh | (code.sh_ << 5);
     const U32 mb = code.mb | (code.mb_ << 5);
     if (sh) {
-        auto resl = builder.createShr(rs, 64 - sh);
-        auto resh = builder.createShl(rs, sh);
-        ra = builder.createOr(resh, resl);
+        ra = builder.createRol(rs, sh);
     }
 
     ra = builder.createAnd(ra, builder.getConstantI64(rotateMask[mb][63 - sh]));
@@ -719,9 +735,7 @@ void Recompiler::rldiclx(Instruction code)
     const U32 sh = code.sh | (code.sh_ << 5);
     const U32 mb = code.mb | (code.mb_ << 5);
     if (sh) {
-        auto resl = builder.createShr(rs, 64 - sh);
-        auto resh = builder.createShl(rs, sh);
-        ra = builder.createOr(resh, resl);
+        ra = builder.createRol(rs, sh);
     }
 
     ra = builder.createAnd(ra, builder.getConstantI64(rotateMask[mb][63]));
@@ -740,9 +754,7 @@ void Recompiler::rldicrx(Instruction code)
     const U32 sh = code.sh | (code.sh_ << 5);
     const U32 me = code.me_ | (code.me__ << 5);
     if (sh) {
-        auto resl = builder.createShr(rs, 64 - sh);
-        auto resh = builder.createShl(rs, sh);
-        ra = builder.createOr(resh, resl);
+        ra = builder.createRol(rs, sh);
     }
 
     ra = builder.createAnd(ra, builder.getConstantI64(rotateMask[0][me]));
@@ -762,9 +774,7 @@ void Recompiler::rldimix(Instruction code)
     const U32 sh = code.sh | (code.sh_ << 5);
     const U32 mb = code.mb | (code.mb_ << 5);
     if (sh) {
-        auto resl = builder.createShr(rs, 64 - sh);
-        auto resh = builder.createShl(rs, sh);
-        temp = builder.createOr(resh, resl);
+        temp = builder.createRol(rs, sh);
     }
 
     const U64 mask = rotateMask[mb][63 - sh];
@@ -788,9 +798,7 @@ void Recompiler::rlwimix(Instruction code)
     Value* temp = rs;
 
     if (code.sh) {
-        auto resl = builder.createShr(rs, 64 - code.sh);
-        auto resh = builder.createShl(rs, code.sh);
-        temp = builder.createOr(resh, resl);
+        temp = builder.createRol(rs, code.sh);
     }
 
     const U64 mask = rotateMask[32 + code.mb][32 + code.me];
@@ -813,9 +821,7 @@ void Recompiler::rlwinmx(Instruction code)
     Value* ra = rs;
 
     if (code.sh) {
-        auto resl = builder.createShr(rs, 64 - code.sh);
-        auto resh = builder.createShl(rs, code.sh);
-        ra = builder.createOr(resh, resl);
+        ra = builder.createRol(rs, code.sh);
     }
 
     ra = builder.createAnd(ra, builder.getConstantI64(rotateMask[32 + code.mb][32 + code.me]));
@@ -835,11 +841,7 @@ void Recompiler::rlwnmx(Instruction code)
     Value* rb = getGPR(code.rb);
     Value* ra;
 
-    auto shl = builder.createAnd(rb, builder.getConstantI64(0x1F));
-    auto shr = builder.createSub(builder.getConstantI64(32), shl);
-    auto resl = builder.createShr(rs, shr);
-    auto resh = builder.createShl(rs, shl);
-    ra = builder.createOr(resh, resl);
+    ra = builder.createRol(rs, builder.createAnd(rb, builder.getConstantI64(0x1F)));
     ra = builder.createAnd(ra, builder.getConstantI64(rotateMask[32 + code.mb][32 + code.me]));
     if (code.rc) {
         updateCR0(ra);
@@ -101,9 +101,7 @@ void Recompiler::ldarx(Instruction code)
         addr = builder.createAdd(addr, ra);
     }
 
-    // TODO: Reservation
-
-    rd = readMemory(addr, TYPE_I64);
+    rd = readReserved(addr, TYPE_I64);
     setGPR(code.rd, rd);
 }
 
@@ -410,9 +408,7 @@ void Recompiler::lwarx(Instruction code)
         addr = builder.createAdd(addr, ra);
     }
 
-    // TODO: Reservation
-
-    rd = readMemory(addr, TYPE_I32);
+    rd = readReserved(addr, TYPE_I32);
     setGPR(code.rd, rd);
 }
 
@@ -570,12 +566,10 @@ void Recompiler::stdcx_(Instruction code)
         addr = builder.createAdd(addr, ra);
     }
 
-    // TODO: Reservation
-
-    // TODO: Is this correct?
-    setCRField(0, builder.getConstantI8(2));
-
-    writeMemory(addr, rs);
+    // CR0 = 0b00 || success || XER[SO]
+    Value* success = writeConditional(addr, rs);
+    Value* cr0 = builder.createOr(builder.createShl(success, U64(1)), getXER_SO());
+    setCRField(0, cr0);
 }
 
 void Recompiler::stdu(Instruction code)
@@ -812,12 +806,10 @@ void Recompiler::stwcx_(Instruction code)
         addr = builder.createAdd(addr, ra);
     }
 
-    // TODO: Reservation
-
-    // TODO: Is this correct?
-    setCRField(0, builder.getConstantI8(2));
-
-    writeMemory(addr, rs);
+    // CR0 = 0b00 || success || XER[SO]
+    Value* success = writeConditional(addr, rs);
+    Value* cr0 = builder.createOr(builder.createShl(success, U64(1)), getXER_SO());
+    setCRField(0, cr0);
 }
 
 void Recompiler::stwu(Instruction code)
@@ -4,14 +4,94 @@
  */
 
 #include "ppu_recompiler.h"
+#include "nucleus/cpu/frontend/ppu/ppu_state.h"
 #include "nucleus/assert.h"
 
+#include <cmath>
+
 namespace cpu {
 namespace frontend {
 namespace ppu {
 
 using namespace cpu::hir;
 
+/**
+ * Vector registers are loaded with a byte swap of the whole quadword, so the element i of
+ * a guest vector with N elements is held in the host component N-1-i.
+ */
+
+// Get a vector whose bytes are the result of a function of their host index
+template <typename F>
+static Value* getConstantBytes(Builder& builder, F func) {
+    V128 constant;
+    for (U32 j = 0; j < 16; j++) {
+        constant.u8[j] = U8(func(j));
+    }
+    return builder.getConstantV128(constant);
+}
+
+static Value* getConstantZero(Builder& builder) {
+    V128 constant = {};
+    return builder.getConstantV128(constant);
+}
+
+static Value* getConstantOnes(Builder& builder) {
+    V128 constant;
+    constant.u64[0] = ~0ULL;
+    constant.u64[1] = ~0ULL;
+    return builder.getConstantV128(constant);
+}
+
+// Get a vector whose bytes are the offset of an address in its aligned quadword
+static Value* getVectorShift(Builder& builder, Value* addr) {
+    Value* sh = builder.createAnd(builder.createTrunc(addr, TYPE_I8), builder.getConstantI8(0xF));
+    return builder.createVSplat(sh);
+}
+
+// Extend the subcomponents of each component (from the least significant one)
+static Value* extractSubcomponent(Builder& builder, Value* value, Type subType, Type compType, U32 index, ArithmeticFlags flags) {
+    const U32 compBits = getTypeSize(compType) * 8;
+    const U32 subBits = getTypeSize(subType) * 8;
+    const U32 shift = compBits - subBits * (index + 1);
+    if (shift) {
+        value = builder.createVShl(value, shift, compType);
+    }
+    if (flags & ARITHMETIC_UNSIGNED) {
+        return builder.createVShr(value, compBits - subBits, compType);
+    } else {
+        return builder.createVShrA(value, compBits - subBits, compType);
+    }
+}
+
+// Saturate a 64-bit integer to the 32-bit range
+static Value* saturateI32(Builder& builder, Value* value, ArithmeticFlags flags) {
+    if (flags & ARITHMETIC_UNSIGNED) {
+        value = builder.createSelect(builder.createCmpUGT(value, builder.getConstantI64(0xFFFFFFFFULL)),
+            builder.getConstantI64(0xFFFFFFFFULL), value);
+    } else {
+        value = builder.createSelect(builder.createCmpSGT(value, builder.getConstantI64(0x7FFFFFFFLL)),
+            builder.getConstantI64(0x7FFFFFFFLL), value);
+        value = builder.createSelect(builder.createCmpSLT(value, builder.getConstantI64(~0x7FFFFFFFULL)),
+            builder.getConstantI64(~0x7FFFFFFFULL), value);
+    }
+    return builder.createTrunc(value, TYPE_I32);
+}
+
+// Build a vector from the 32-bit integers of each host component
+static Value* createVectorI32(Builder& builder, Value* words[4]) {
+    Value* result = nullptr;
+    for (U32 index = 0; index < 4; index++) {
+        if (words[index]->isConstantZero()) {
+            continue;
+        }
+        V128 mask = {};
+        mask.u32[index] = 0xFFFFFFFF;
+        Value* word = builder.createAnd(builder.createVSplat(words[index]), builder.getConstantV128(mask));
+        result = result ? builder.createOr(result, word) : word;
+    }
+    return result ? result : getConstantZero(builder);
+}
+
 /**
  * PPC64 Vector/SIMD Instructions (aka AltiVec):
  *  - Vector UISA Instructions (Section: 4.2.x)
@@ -20,62 +100,140 @@ using namespace cpu::hir;
 
 void Recompiler::dss(Instruction code)
 {
-    assert_always("Unimplemented");
+    // Data stream prefetching hints have no observable effects
 }
 
 void Recompiler::dst(Instruction code)
 {
-    assert_always("Unimplemented");
+    // Data stream prefetching hints have no observable effects
 }
 
 void Recompiler::dstst(Instruction code)
 {
-    assert_always("Unimplemented");
+    // Data stream prefetching hints have no observable effects
 }
 
 void Recompiler::lvebx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+
+    // Other elements are undefined: fill them with the loaded one
+    Value* vd = builder.createVSplat(readMemory(addr, TYPE_I8));
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvehx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+    addr = builder.createAnd(addr, builder.getConstantI64(~1ULL));
+
+    // Other elements are undefined: fill them with the loaded one
+    Value* vd = builder.createVSplat(readMemory(addr, TYPE_I16));
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvewx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+    addr = builder.createAnd(addr, builder.getConstantI64(~3ULL));
+
+    // Other elements are undefined: fill them with the loaded one
+    Value* vd = builder.createVSplat(readMemory(addr, TYPE_I32));
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvlx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+
+    // Load the bytes from the address to the end of its aligned quadword into the left of the register
+    Value* sh = getVectorShift(builder, addr);
+    Value* block = readMemory(builder.createAnd(addr, builder.getConstantI64(~0xFULL)), TYPE_V128);
+    Value* control = builder.createVSub(getConstantBytes(builder, [](U32 j) { return 16 + j; }), sh, TYPE_I8);
+    Value* vd = builder.createVPerm(getConstantZero(builder), block, control);
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvlxl(Instruction code)
 {
-    assert_always("Unimplemented");
+    lvlx(code);
 }
 
 void Recompiler::lvrx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+
+    // Load the bytes from the start of the aligned quadword to the address into the right of the register
+    Value* sh = getVectorShift(builder, addr);
+    Value* block = readMemory(builder.createAnd(addr, builder.getConstantI64(~0xFULL)), TYPE_V128);
+    Value* control = builder.createVSub(getConstantBytes(builder, [](U32 j) { return 16 + j; }), sh, TYPE_I8);
+    Value* vd = builder.createVPerm(block, getConstantZero(builder), control);
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvrxl(Instruction code)
 {
-    assert_always("Unimplemented");
+    lvrx(code);
 }
 
 void Recompiler::lvsl(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+
+    Value* sh = getVectorShift(builder, addr);
+    Value* vd = builder.createVAdd(getConstantBytes(builder, [](U32 j) { return 15 - j; }), sh, TYPE_I8);
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvsr(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+
+    Value* sh = getVectorShift(builder, addr);
+    Value* vd = builder.createVSub(getConstantBytes(builder, [](U32 j) { return 31 - j; }), sh, TYPE_I8);
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvx(Instruction code)
@@ -88,6 +246,7 @@ void Recompiler::lvx(Instruction code)
     if (code.ra) {
         addr = builder.createAdd(addr, ra);
     }
+    addr = builder.createAnd(addr, builder.getConstantI64(~0xFULL));
 
     vd = readMemory(addr, TYPE_V128);
     setVR(code.vd, vd);
@@ -95,76 +254,172 @@ void Recompiler::lvx(Instruction code)
 
 void Recompiler::lvxl(Instruction code)
 {
-    assert_always("Unimplemented");
+    lvx(code);
 }
 
 void Recompiler::mfvscr(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vscr = builder.createCtxLoad(offsetof(PPUState, vscr), TYPE_I32);
+
+    // VSCR is held in the last word of the register, the other ones are cleared
+    V128 mask = {};
+    mask.u32[0] = 0xFFFFFFFF;
+    Value* vd = builder.createAnd(builder.createVSplat(vscr), builder.getConstantV128(mask));
+    setVR(code.vd, vd);
 }
 
 void Recompiler::mtvscr(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+
+    Value* vscr = builder.createVExtract(vb, 0, TYPE_I32);
+    builder.createCtxStore(offsetof(PPUState, vscr), vscr);
 }
 
 void Recompiler::stvebx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+
+    // Move the byte selected by the address to the lowest component
+    Value* vs = getVR(code.vs);
+    Value* sh = getVectorShift(builder, addr);
+    Value* control = builder.createVSub(getConstantBytes(builder, [](U32 j) { return 15; }), sh, TYPE_I8);
+    Value* element = builder.createVExtract(builder.createVPerm(vs, vs, control), 0, TYPE_I8);
+    writeMemory(addr, element);
 }
 
 void Recompiler::stvehx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+    addr = builder.createAnd(addr, builder.getConstantI64(~1ULL));
+
+    // Move the halfword selected by the address to the lowest component
+    Value* vs = getVR(code.vs);
+    Value* sh = getVectorShift(builder, addr);
+    Value* control = builder.createVSub(getConstantBytes(builder, [](U32 j) { return 14 + (j & 1); }), sh, TYPE_I8);
+    Value* element = builder.createVExtract(builder.createVPerm(vs, vs, control), 0, TYPE_I16);
+    writeMemory(addr, element);
 }
 
 void Recompiler::stvewx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+    addr = builder.createAnd(addr, builder.getConstantI64(~3ULL));
+
+    // Move the word selected by the address to the lowest component
+    Value* vs = getVR(code.vs);
+    Value* sh = getVectorShift(builder, addr);
+    Value* control = builder.createVSub(getConstantBytes(builder, [](U32 j) { return 12 + (j & 3); }), sh, TYPE_I8);
+    Value* element = builder.createVExtract(builder.createVPerm(vs, vs, control), 0, TYPE_I32);
+    writeMemory(addr, element);
 }
 
 void Recompiler::stvlx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+
+    // Store the left bytes of the register from the address to the end of its aligned quadword
+    Value* vs = getVR(code.vs);
+    Value* sh = getVectorShift(builder, addr);
+    Value* control = builder.createVAdd(getConstantBytes(builder, [](U32 j) { return j; }), sh, TYPE_I8);
+    Value* value = builder.createVPerm(vs, getConstantZero(builder), control);
+    Value* mask = builder.createVPerm(getConstantOnes(builder), getConstantZero(builder), control);
+
+    addr = builder.createAnd(addr, builder.getConstantI64(~0xFULL));
+    Value* block = readMemory(addr, TYPE_V128);
+    block = builder.createOr(builder.createAnd(block, builder.createNot(mask)), value);
+    writeMemory(addr, block);
 }
 
 void Recompiler::stvlxl(Instruction code)
 {
-    assert_always("Unimplemented");
+    stvlx(code);
 }
 
 void Recompiler::stvrx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* ra = getGPR(code.ra);
+    Value* rb = getGPR(code.rb);
+
+    Value* addr = rb;
+    if (code.ra) {
+        addr = builder.createAdd(addr, ra);
+    }
+
+    // Store the right bytes of the register from the start of the aligned quadword to the address
+    Value* vs = getVR(code.vs);
+    Value* sh = getVectorShift(builder, addr);
+    Value* control = builder.createVAdd(getConstantBytes(builder, [](U32 j) { return j; }), sh, TYPE_I8);
+    Value* value = builder.createVPerm(getConstantZero(builder), vs, control);
+    Value* mask = builder.createVPerm(getConstantZero(builder), getConstantOnes(builder), control);
+
+    addr = builder.createAnd(addr, builder.getConstantI64(~0xFULL));
+    Value* block = readMemory(addr, TYPE_V128);
+    block = builder.createOr(builder.createAnd(block, builder.createNot(mask)), value);
+    writeMemory(addr, block);
 }
 
 void Recompiler::stvrxl(Instruction code)
 {
-    assert_always("Unimplemented");
+    stvrx(code);
 }
 
 void Recompiler::stvx(Instruction code)
 {
     Value* ra = getGPR(code.ra);
     Value* rb = getGPR(code.rb);
-    Value* vs = getGPR(code.vs);
+    Value* vs = getVR(code.vs);
 
     Value* addr = rb;
     if (code.ra) {
         addr = builder.createAdd(addr, ra);
     }
+    addr = builder.createAnd(addr, builder.getConstantI64(~0xFULL));
 
     writeMemory(addr, vs);
 }
 
 void Recompiler::stvxl(Instruction code)
 {
-    assert_always("Unimplemented");
+    stvx(code);
 }
 
 void Recompiler::vaddcuw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Carry out happens if the sum wraps around below the first operand
+    vd = builder.createVAdd(va, vb, TYPE_I32);
+    vd = builder.createVCmpUGT(va, vd, TYPE_I32);
+    vd = builder.createVShr(vd, 31, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vaddfp(Instruction code)
@@ -182,9 +437,9 @@ void Recompiler::vaddsbs(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
-    Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    Value* vd;
 
-    // TODO: ? I8
+    vd = builder.createVAddSat(va, vb, TYPE_I8);
 
     setVR(code.vd, vd);
 }
@@ -193,9 +448,9 @@ void Recompiler::vaddshs(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
-    Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    Value* vd;
 
-    // TODO: ? I16
+    vd = builder.createVAddSat(va, vb, TYPE_I16);
 
     setVR(code.vd, vd);
 }
@@ -204,9 +459,9 @@ void Recompiler::vaddsws(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
-    Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    Value* vd;
 
-    // TODO: ? I32
+    vd = builder.createVAddSat(va, vb, TYPE_I32);
 
     setVR(code.vd, vd);
 }
@@ -226,9 +481,9 @@ void Recompiler::vaddubs(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
-    Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    Value* vd;
 
-    // TODO: ? I8
+    vd = builder.createVAddSat(va, vb, TYPE_I8, ARITHMETIC_UNSIGNED);
 
     setVR(code.vd, vd);
 }
@@ -248,9 +503,9 @@ void Recompiler::vadduhs(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
-    Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    Value* vd;
 
-    // TODO: ? I16
+    vd = builder.createVAddSat(va, vb, TYPE_I16, ARITHMETIC_UNSIGNED);
 
     setVR(code.vd, vd);
 }
@@ -270,9 +525,9 @@ void Recompiler::vadduws(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
-    Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    Value* vd;
 
-    // TODO: ? I32
+    vd = builder.createVAddSat(va, vb, TYPE_I32, ARITHMETIC_UNSIGNED);
 
     setVR(code.vd, vd);
 }
@@ -368,32 +623,60 @@ void Recompiler::vavguw(Instruction code)
 
 void Recompiler::vcfsx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVConvert(vb, TYPE_I32, TYPE_F32, ARITHMETIC_SIGNED);
+    if (code.vuimm) {
+        vd = builder.createVMul(vd, builder.createVSplat(builder.getConstantF32(std::ldexp(1.0f, -S32(code.vuimm)))), TYPE_F32);
+    }
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vcfux(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVConvert(vb, TYPE_I32, TYPE_F32, ARITHMETIC_UNSIGNED);
+    if (code.vuimm) {
+        vd = builder.createVMul(vd, builder.createVSplat(builder.getConstantF32(std::ldexp(1.0f, -S32(code.vuimm)))), TYPE_F32);
+    }
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vcmpbfp(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Set bit 0 if va > vb and bit 1 if va < -vb (both of them if any operand is NaN)
+    Value* vbNeg = builder.createXor(vb, builder.createVSplat(builder.getConstantI32(0x80000000)));
+    Value* le = builder.createNot(builder.createVCmpFGE(vb, va, TYPE_F32));
+    Value* ge = builder.createNot(builder.createVCmpFGE(va, vbNeg, TYPE_F32));
+    le = builder.createAnd(le, builder.createVSplat(builder.getConstantI32(0x80000000)));
+    ge = builder.createAnd(ge, builder.createVSplat(builder.getConstantI32(0x40000000)));
+    vd = builder.createOr(le, ge);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vcmpbfp_(Instruction code)
 {
     vcmpbfp(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpeqfp(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpEQ(va, vb, TYPE_F32);
-    auto vd = builder.createSExt(result, TYPE_I32);
+    vd = builder.createVCmpEQ(va, vb, TYPE_F32);
 
     setVR(code.vd, vd);
 }
@@ -401,16 +684,16 @@ void Recompiler::vcmpeqfp(Instruction code)
 void Recompiler::vcmpeqfp_(Instruction code)
 {
     vcmpeqfp(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpequb(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpEQ(va, vb, TYPE_I8);
-    auto vd = builder.createSExt(result, TYPE_I8);
+    vd = builder.createVCmpEQ(va, vb, TYPE_I8);
 
     setVR(code.vd, vd);
 }
@@ -418,16 +701,16 @@ void Recompiler::vcmpequb(Instruction code)
 void Recompiler::vcmpequb_(Instruction code)
 {
     vcmpequb(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpequh(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpEQ(va, vb, TYPE_I16);
-    auto vd = builder.createSExt(result, TYPE_I16);
+    vd = builder.createVCmpEQ(va, vb, TYPE_I16);
 
     setVR(code.vd, vd);
 }
@@ -435,16 +718,16 @@ void Recompiler::vcmpequh(Instruction code)
 void Recompiler::vcmpequh_(Instruction code)
 {
     vcmpequh(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpequw(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpEQ(va, vb, TYPE_I32);
-    auto vd = builder.createSExt(result, TYPE_I32);
+    vd = builder.createVCmpEQ(va, vb, TYPE_I32);
 
     setVR(code.vd, vd);
 }
@@ -452,16 +735,16 @@ void Recompiler::vcmpequw(Instruction code)
 void Recompiler::vcmpequw_(Instruction code)
 {
     vcmpequw(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpgefp(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpFGE(va, vb, TYPE_F32);
-    auto vd = builder.createSExt(result, TYPE_I32);
+    vd = builder.createVCmpFGE(va, vb, TYPE_F32);
 
     setVR(code.vd, vd);
 }
@@ -469,16 +752,16 @@ void Recompiler::vcmpgefp(Instruction code)
 void Recompiler::vcmpgefp_(Instruction code)
 {
     vcmpgefp(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpgtfp(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpFGT(va, vb, TYPE_F32);
-    auto vd = builder.createSExt(result, TYPE_I32);
+    vd = builder.createVCmpFGT(va, vb, TYPE_F32);
 
     setVR(code.vd, vd);
 }
@@ -486,16 +769,16 @@ void Recompiler::vcmpgtfp(Instruction code)
 void Recompiler::vcmpgtfp_(Instruction code)
 {
     vcmpgtfp(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpgtsb(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpSGT(va, vb, TYPE_I8);
-    auto vd = builder.createSExt(result, TYPE_I8);
+    vd = builder.createVCmpSGT(va, vb, TYPE_I8);
 
     setVR(code.vd, vd);
 }
@@ -503,16 +786,16 @@ void Recompiler::vcmpgtsb(Instruction code)
 void Recompiler::vcmpgtsb_(Instruction code)
 {
     vcmpgtsb(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpgtsh(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpSGT(va, vb, TYPE_I16);
-    auto vd = builder.createSExt(result, TYPE_I16);
+    vd = builder.createVCmpSGT(va, vb, TYPE_I16);
 
     setVR(code.vd, vd);
 }
@@ -520,16 +803,16 @@ void Recompiler::vcmpgtsh(Instruction code)
 void Recompiler::vcmpgtsh_(Instruction code)
 {
     vcmpgtsh(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpgtsw(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpSGT(va, vb, TYPE_I32);
-    auto vd = builder.createSExt(result, TYPE_I32);
+    vd = builder.createVCmpSGT(va, vb, TYPE_I32);
 
     setVR(code.vd, vd);
 }
@@ -537,16 +820,16 @@ void Recompiler::vcmpgtsw(Instruction code)
 void Recompiler::vcmpgtsw_(Instruction code)
 {
     vcmpgtsw(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpgtub(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpUGT(va, vb, TYPE_I8);
-    auto vd = builder.createSExt(result, TYPE_I8);
+    vd = builder.createVCmpUGT(va, vb, TYPE_I8);
 
     setVR(code.vd, vd);
 }
@@ -554,16 +837,16 @@ void Recompiler::vcmpgtub(Instruction code)
 void Recompiler::vcmpgtub_(Instruction code)
 {
     vcmpgtub(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpgtuh(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpUGT(va, vb, TYPE_I16);
-    auto vd = builder.createSExt(result, TYPE_I16);
+    vd = builder.createVCmpUGT(va, vb, TYPE_I16);
 
     setVR(code.vd, vd);
 }
@@ -571,16 +854,16 @@ void Recompiler::vcmpgtuh(Instruction code)
 void Recompiler::vcmpgtuh_(Instruction code)
 {
     vcmpgtuh(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vcmpgtuw(Instruction code)
 {
     Value* va = getVR(code.va);
     Value* vb = getVR(code.vb);
+    Value* vd;
 
-    auto result = builder.createVCmpUGT(va, vb, TYPE_I32);
-    auto vd = builder.createSExt(result, TYPE_I32);
+    vd = builder.createVCmpUGT(va, vb, TYPE_I32);
 
     setVR(code.vd, vd);
 }
@@ -588,17 +871,37 @@ void Recompiler::vcmpgtuw(Instruction code)
 void Recompiler::vcmpgtuw_(Instruction code)
 {
     vcmpgtuw(code);
-    // TODO: CR6 update
+    updateCR6(getVR(code.vd));
 }
 
 void Recompiler::vctsxs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Conversions round towards zero and saturate
+    vd = vb;
+    if (code.vuimm) {
+        vd = builder.createVMul(vd, builder.createVSplat(builder.getConstantF32(std::ldexp(1.0f, S32(code.vuimm)))), TYPE_F32);
+    }
+    vd = builder.createVConvert(vd, TYPE_F32, TYPE_I32, ARITHMETIC_SIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vctuxs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Conversions round towards zero and saturate
+    vd = vb;
+    if (code.vuimm) {
+        vd = builder.createVMul(vd, builder.createVSplat(builder.getConstantF32(std::ldexp(1.0f, S32(code.vuimm)))), TYPE_F32);
+    }
+    vd = builder.createVConvert(vd, TYPE_F32, TYPE_I32, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vexptefp(Instruction code)
@@ -638,187 +941,506 @@ void Recompiler::vmaddfp(Instruction code)
 
 void Recompiler::vmaxfp(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMax(va, vb, TYPE_F32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxsb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMax(va, vb, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxsh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMax(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxsw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMax(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxub(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMax(va, vb, TYPE_I8, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxuh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMax(va, vb, TYPE_I16, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxuw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMax(va, vb, TYPE_I32, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmhaddshs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    // Compute the high halves of the products on 32-bit components
+    Value* result[2];
+    for (int half = 0; half < 2; half++) {
+        auto unpack = [&](Value* value) {
+            return half ? builder.createVUnpackH(value, TYPE_I16) : builder.createVUnpackL(value, TYPE_I16);
+        };
+        Value* prod = builder.createVMul(unpack(va), unpack(vb), TYPE_I32);
+        prod = builder.createVShrA(prod, 15, TYPE_I32);
+        result[half] = builder.createVAdd(prod, unpack(vc), TYPE_I32);
+    }
+    vd = builder.createVPack(result[0], result[1], TYPE_I32, VECTOR_SATURATE);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmhraddshs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    // Compute the high halves of the products on 32-bit components
+    Value* result[2];
+    for (int half = 0; half < 2; half++) {
+        auto unpack = [&](Value* value) {
+            return half ? builder.createVUnpackH(value, TYPE_I16) : builder.createVUnpackL(value, TYPE_I16);
+        };
+        Value* prod = builder.createVMul(unpack(va), unpack(vb), TYPE_I32);
+        prod = builder.createVAdd(prod, builder.createVSplat(builder.getConstantI32(0x4000)), TYPE_I32);
+        prod = builder.createVShrA(prod, 15, TYPE_I32);
+        result[half] = builder.createVAdd(prod, unpack(vc), TYPE_I32);
+    }
+    vd = builder.createVPack(result[0], result[1], TYPE_I32, VECTOR_SATURATE);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminfp(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMin(va, vb, TYPE_F32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminsb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMin(va, vb, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminsh(Instruction code)
 {
-    assert_always("Unimplemented");
-}
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMin(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
+}
 
 void Recompiler::vminsw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMin(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminub(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMin(va, vb, TYPE_I8, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminuh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMin(va, vb, TYPE_I16, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminuw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMin(va, vb, TYPE_I32, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmladduhm(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    vd = builder.createVMul(va, vb, TYPE_I16);
+    vd = builder.createVAdd(vd, vc, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrghb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMergeH(vb, va, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrghh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMergeH(vb, va, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrghw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMergeH(vb, va, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrglb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMergeL(vb, va, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrglh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMergeL(vb, va, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrglw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVMergeL(vb, va, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmsummbm(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    vd = vc;
+    for (U32 index = 0; index < 4; index++) {
+        Value* a = extractSubcomponent(builder, va, TYPE_I8, TYPE_I32, index, ARITHMETIC_SIGNED);
+        Value* b = extractSubcomponent(builder, vb, TYPE_I8, TYPE_I32, index, ARITHMETIC_UNSIGNED);
+        vd = builder.createVAdd(vd, builder.createVMul(a, b, TYPE_I32), TYPE_I32);
+    }
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmsumshm(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    vd = vc;
+    for (U32 index = 0; index < 2; index++) {
+        Value* a = extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, index, ARITHMETIC_SIGNED);
+        Value* b = extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, index, ARITHMETIC_SIGNED);
+        vd = builder.createVAdd(vd, builder.createVMul(a, b, TYPE_I32), TYPE_I32);
+    }
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmsumshs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    // Sums might overflow 32 bits before saturating, so they are computed on each 64-bit scalar
+    Value* prod0 = builder.createVMul(
+        extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, 0, ARITHMETIC_SIGNED),
+        extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, 0, ARITHMETIC_SIGNED), TYPE_I32);
+    Value* prod1 = builder.createVMul(
+        extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, 1, ARITHMETIC_SIGNED),
+        extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, 1, ARITHMETIC_SIGNED), TYPE_I32);
+
+    Value* words[4];
+    for (U32 index = 0; index < 4; index++) {
+        Value* sum = builder.createSExt(builder.createVExtract(vc, index, TYPE_I32), TYPE_I64);
+        sum = builder.createAdd(sum, builder.createSExt(builder.createVExtract(prod0, index, TYPE_I32), TYPE_I64));
+        sum = builder.createAdd(sum, builder.createSExt(builder.createVExtract(prod1, index, TYPE_I32), TYPE_I64));
+        words[index] = saturateI32(builder, sum, ARITHMETIC_SIGNED);
+    }
+    vd = createVectorI32(builder, words);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmsumubm(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    vd = vc;
+    for (U32 index = 0; index < 4; index++) {
+        Value* a = extractSubcomponent(builder, va, TYPE_I8, TYPE_I32, index, ARITHMETIC_UNSIGNED);
+        Value* b = extractSubcomponent(builder, vb, TYPE_I8, TYPE_I32, index, ARITHMETIC_UNSIGNED);
+        vd = builder.createVAdd(vd, builder.createVMul(a, b, TYPE_I32), TYPE_I32);
+    }
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmsumuhm(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    vd = vc;
+    for (U32 index = 0; index < 2; index++) {
+        Value* a = extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, index, ARITHMETIC_UNSIGNED);
+        Value* b = extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, index, ARITHMETIC_UNSIGNED);
+        vd = builder.createVAdd(vd, builder.createVMul(a, b, TYPE_I32), TYPE_I32);
+    }
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmsumuhs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    // Sums might overflow 32 bits before saturating, so they are computed on each 64-bit scalar
+    Value* prod0 = builder.createVMul(
+        extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, 0, ARITHMETIC_UNSIGNED),
+        extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, 0, ARITHMETIC_UNSIGNED), TYPE_I32);
+    Value* prod1 = builder.createVMul(
+        extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, 1, ARITHMETIC_UNSIGNED),
+        extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, 1, ARITHMETIC_UNSIGNED), TYPE_I32);
+
+    Value* words[4];
+    for (U32 index = 0; index < 4; index++) {
+        Value* sum = builder.createZExt(builder.createVExtract(vc, index, TYPE_I32), TYPE_I64);
+        sum = builder.createAdd(sum, builder.createZExt(builder.createVExtract(prod0, index, TYPE_I32), TYPE_I64));
+        sum = builder.createAdd(sum, builder.createZExt(builder.createVExtract(prod1, index, TYPE_I32), TYPE_I64));
+        words[index] = saturateI32(builder, sum, ARITHMETIC_UNSIGNED);
+    }
+    vd = createVectorI32(builder, words);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmulesb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    va = extractSubcomponent(builder, va, TYPE_I8, TYPE_I16, 1, ARITHMETIC_SIGNED);
+    vb = extractSubcomponent(builder, vb, TYPE_I8, TYPE_I16, 1, ARITHMETIC_SIGNED);
+    vd = builder.createVMul(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmulesh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    va = extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, 1, ARITHMETIC_SIGNED);
+    vb = extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, 1, ARITHMETIC_SIGNED);
+    vd = builder.createVMul(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmuleub(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    va = extractSubcomponent(builder, va, TYPE_I8, TYPE_I16, 1, ARITHMETIC_UNSIGNED);
+    vb = extractSubcomponent(builder, vb, TYPE_I8, TYPE_I16, 1, ARITHMETIC_UNSIGNED);
+    vd = builder.createVMul(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmuleuh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    va = extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, 1, ARITHMETIC_UNSIGNED);
+    vb = extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, 1, ARITHMETIC_UNSIGNED);
+    vd = builder.createVMul(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmulosb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    va = extractSubcomponent(builder, va, TYPE_I8, TYPE_I16, 0, ARITHMETIC_SIGNED);
+    vb = extractSubcomponent(builder, vb, TYPE_I8, TYPE_I16, 0, ARITHMETIC_SIGNED);
+    vd = builder.createVMul(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmulosh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    va = extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, 0, ARITHMETIC_SIGNED);
+    vb = extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, 0, ARITHMETIC_SIGNED);
+    vd = builder.createVMul(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmuloub(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    va = extractSubcomponent(builder, va, TYPE_I8, TYPE_I16, 0, ARITHMETIC_UNSIGNED);
+    vb = extractSubcomponent(builder, vb, TYPE_I8, TYPE_I16, 0, ARITHMETIC_UNSIGNED);
+    vd = builder.createVMul(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmulouh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    va = extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, 0, ARITHMETIC_UNSIGNED);
+    vb = extractSubcomponent(builder, vb, TYPE_I16, TYPE_I32, 0, ARITHMETIC_UNSIGNED);
+    vd = builder.createVMul(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vnmsubfp(Instruction code)
@@ -860,312 +1482,744 @@ void Recompiler::vor(Instruction code)
 
 void Recompiler::vperm(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    // Guest bytes are held in reverse order: index i of va:vb is index 31-i of the host vb:va
+    vd = builder.createVPerm(vb, va, builder.createNot(vc));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkpx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Pack each 8:8:8:8 pixel into a 1:5:5:5 pixel
+    auto pack = [&](Value* value) {
+        Value* result = builder.createAnd(builder.createVShr(value, 9, TYPE_I32), builder.createVSplat(builder.getConstantI32(0xFC00)));
+        result = builder.createOr(result, builder.createAnd(builder.createVShr(value, 6, TYPE_I32), builder.createVSplat(builder.getConstantI32(0x03E0))));
+        result = builder.createOr(result, builder.createAnd(builder.createVShr(value, 3, TYPE_I32), builder.createVSplat(builder.getConstantI32(0x001F))));
+        return result;
+    };
+    vd = builder.createVPack(pack(vb), pack(va), TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkshss(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVPack(vb, va, TYPE_I16, VECTOR_SATURATE);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkshus(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVPack(vb, va, TYPE_I16, VectorFlags(VECTOR_SATURATE | VECTOR_SATURATE_UNSIGNED));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkswss(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVPack(vb, va, TYPE_I32, VECTOR_SATURATE);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkswus(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVPack(vb, va, TYPE_I32, VectorFlags(VECTOR_SATURATE | VECTOR_SATURATE_UNSIGNED));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkuhum(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVPack(vb, va, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkuhus(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVPack(vb, va, TYPE_I16, VectorFlags(VECTOR_SATURATE | VECTOR_UNSIGNED));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkuwum(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVPack(vb, va, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkuwus(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVPack(vb, va, TYPE_I32, VectorFlags(VECTOR_SATURATE | VECTOR_UNSIGNED));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrefp(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVRcp(vb, TYPE_F32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrfim(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVRound(vb, TYPE_F32, VECTOR_ROUND_DOWN);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrfin(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVRound(vb, TYPE_F32, VECTOR_ROUND_NEAREST);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrfip(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVRound(vb, TYPE_F32, VECTOR_ROUND_UP);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrfiz(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVRound(vb, TYPE_F32, VECTOR_ROUND_ZERO);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrlb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Shift amounts are taken modulo the component width
+    Value* vbNeg = builder.createVSub(getConstantZero(builder), vb, TYPE_I8);
+    vd = builder.createOr(builder.createVShl(va, vb, TYPE_I8), builder.createVShr(va, vbNeg, TYPE_I8));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrlh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Shift amounts are taken modulo the component width
+    Value* vbNeg = builder.createVSub(getConstantZero(builder), vb, TYPE_I16);
+    vd = builder.createOr(builder.createVShl(va, vb, TYPE_I16), builder.createVShr(va, vbNeg, TYPE_I16));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrlw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Shift amounts are taken modulo the component width
+    Value* vbNeg = builder.createVSub(getConstantZero(builder), vb, TYPE_I32);
+    vd = builder.createOr(builder.createVShl(va, vb, TYPE_I32), builder.createVShr(va, vbNeg, TYPE_I32));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrsqrtefp(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVRSqrt(vb, TYPE_F32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsel(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vc = getVR(code.vc);
+    Value* vd;
+
+    va = builder.createAnd(va, builder.createNot(vc));
+    vb = builder.createAnd(vb, vc);
+    vd = builder.createOr(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsl(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Bytes of vb hold the same amount: shift each byte, and fill it with the bits leaving the previous one
+    Value* sh = builder.createAnd(vb, builder.createVSplat(builder.getConstantI8(7)));
+    Value* shInv = builder.createXor(sh, builder.createVSplat(builder.getConstantI8(7)));
+    Value* prev = builder.createVPerm(va, getConstantZero(builder), getConstantBytes(builder, [](U32 j) { return j ? j - 1 : 16; }));
+    prev = builder.createVShr(builder.createVShr(prev, 1, TYPE_I8), shInv, TYPE_I8);
+    vd = builder.createOr(builder.createVShl(va, sh, TYPE_I8), prev);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vslb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVShl(va, vb, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsldoi(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    const U32 sh = code.vshb;
+    vd = builder.createVPerm(vb, va, getConstantBytes(builder, [=](U32 j) { return 16 - sh + j; }));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vslh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVShl(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vslo(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    Value* sh = builder.createAnd(builder.createShr(builder.createVExtract(vb, 0, TYPE_I8), U64(3)), builder.getConstantI8(0xF));
+    Value* control = builder.createVSub(getConstantBytes(builder, [](U32 j) { return 16 + j; }), builder.createVSplat(sh), TYPE_I8);
+    vd = builder.createVPerm(getConstantZero(builder), va, control);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vslw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVShl(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    const U32 index = code.vuimm;
+    vd = builder.createVPerm(vb, vb, getConstantBytes(builder, [=](U32 j) { return 15 - index; }));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsplth(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    const U32 index = code.vuimm;
+    vd = builder.createVPerm(vb, vb, getConstantBytes(builder, [=](U32 j) { return 14 - 2 * index + (j & 1); }));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltisb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vd;
+
+    vd = builder.createVSplat(builder.getConstantI8(U8(code.vsimm)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltish(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vd;
+
+    vd = builder.createVSplat(builder.getConstantI16(U16(code.vsimm)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltisw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vd;
+
+    vd = builder.createVSplat(builder.getConstantI32(U32(code.vsimm)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    const U32 index = code.vuimm;
+    vd = builder.createVPerm(vb, vb, getConstantBytes(builder, [=](U32 j) { return 12 - 4 * index + (j & 3); }));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsr(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Bytes of vb hold the same amount: shift each byte, and fill it with the bits leaving the next one
+    Value* sh = builder.createAnd(vb, builder.createVSplat(builder.getConstantI8(7)));
+    Value* shInv = builder.createXor(sh, builder.createVSplat(builder.getConstantI8(7)));
+    Value* next = builder.createVPerm(va, getConstantZero(builder), getConstantBytes(builder, [](U32 j) { return j + 1; }));
+    next = builder.createVShl(builder.createVShl(next, 1, TYPE_I8), shInv, TYPE_I8);
+    vd = builder.createOr(builder.createVShr(va, sh, TYPE_I8), next);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsrab(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVShrA(va, vb, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsrah(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVShrA(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsraw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVShrA(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsrb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVShr(va, vb, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsrh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVShr(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsro(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    Value* sh = builder.createAnd(builder.createShr(builder.createVExtract(vb, 0, TYPE_I8), U64(3)), builder.getConstantI8(0xF));
+    Value* control = builder.createVAdd(getConstantBytes(builder, [](U32 j) { return j; }), builder.createVSplat(sh), TYPE_I8);
+    vd = builder.createVPerm(va, getConstantZero(builder), control);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsrw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVShr(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubcuw(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Carry out happens unless the subtraction borrows
+    vd = builder.createVCmpUGE(va, vb, TYPE_I32);
+    vd = builder.createVShr(vd, 31, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubfp(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSub(va, vb, TYPE_F32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubsbs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSubSat(va, vb, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubshs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSubSat(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubsws(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSubSat(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsububm(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSub(va, vb, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsububs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSubSat(va, vb, TYPE_I8, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubuhm(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSub(va, vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubuhs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSubSat(va, vb, TYPE_I16, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubuwm(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSub(va, vb, TYPE_I32);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubuws(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVSubSat(va, vb, TYPE_I32, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsum2sws(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Guest words 1 and 3 are the host words 2 and 0
+    Value* words[4];
+    for (U32 index = 0; index < 4; index += 2) {
+        Value* sum = builder.createSExt(builder.createVExtract(vb, index, TYPE_I32), TYPE_I64);
+        sum = builder.createAdd(sum, builder.createSExt(builder.createVExtract(va, index, TYPE_I32), TYPE_I64));
+        sum = builder.createAdd(sum, builder.createSExt(builder.createVExtract(va, index + 1, TYPE_I32), TYPE_I64));
+        words[index] = saturateI32(builder, sum, ARITHMETIC_SIGNED);
+        words[index + 1] = builder.getConstantI32(0);
+    }
+    vd = createVectorI32(builder, words);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsum4sbs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Sums of the components of each word never overflow, only adding vb might
+    Value* sum = extractSubcomponent(builder, va, TYPE_I8, TYPE_I32, 0, ARITHMETIC_SIGNED);
+    for (U32 index = 1; index < 4; index++) {
+        sum = builder.createVAdd(sum, extractSubcomponent(builder, va, TYPE_I8, TYPE_I32, index, ARITHMETIC_SIGNED), TYPE_I32);
+    }
+    vd = builder.createVAddSat(sum, vb, TYPE_I32, ARITHMETIC_SIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsum4shs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Sums of the components of each word never overflow, only adding vb might
+    Value* sum = extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, 0, ARITHMETIC_SIGNED);
+    for (U32 index = 1; index < 2; index++) {
+        sum = builder.createVAdd(sum, extractSubcomponent(builder, va, TYPE_I16, TYPE_I32, index, ARITHMETIC_SIGNED), TYPE_I32);
+    }
+    vd = builder.createVAddSat(sum, vb, TYPE_I32, ARITHMETIC_SIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsum4ubs(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Sums of the components of each word never overflow, only adding vb might
+    Value* sum = extractSubcomponent(builder, va, TYPE_I8, TYPE_I32, 0, ARITHMETIC_UNSIGNED);
+    for (U32 index = 1; index < 4; index++) {
+        sum = builder.createVAdd(sum, extractSubcomponent(builder, va, TYPE_I8, TYPE_I32, index, ARITHMETIC_UNSIGNED), TYPE_I32);
+    }
+    vd = builder.createVAddSat(sum, vb, TYPE_I32, ARITHMETIC_UNSIGNED);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsumsws(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* va = getVR(code.va);
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Guest word 3 is the host word 0
+    Value* sum = builder.createSExt(builder.createVExtract(vb, 0, TYPE_I32), TYPE_I64);
+    for (U32 index = 0; index < 4; index++) {
+        sum = builder.createAdd(sum, builder.createSExt(builder.createVExtract(va, index, TYPE_I32), TYPE_I64));
+    }
+    Value* words[4] = {
+        saturateI32(builder, sum, ARITHMETIC_SIGNED),
+        builder.getConstantI32(0),
+        builder.getConstantI32(0),
+        builder.getConstantI32(0),
+    };
+    vd = createVectorI32(builder, words);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vupkhpx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Unpack each 1:5:5:5 pixel into a 8:8:8:8 pixel, replicating the first bit in the first byte
+    Value* value = builder.createVUnpackH(vb, TYPE_I16);
+    vd = builder.createAnd(value, builder.createVSplat(builder.getConstantI32(0xFF00001F)));
+    vd = builder.createOr(vd, builder.createAnd(builder.createVShl(value, 6, TYPE_I32), builder.createVSplat(builder.getConstantI32(0x001F0000))));
+    vd = builder.createOr(vd, builder.createAnd(builder.createVShl(value, 3, TYPE_I32), builder.createVSplat(builder.getConstantI32(0x00001F00))));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vupkhsb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVUnpackH(vb, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vupkhsh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVUnpackH(vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vupklpx(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    // Unpack each 1:5:5:5 pixel into a 8:8:8:8 pixel, replicating the first bit in the first byte
+    Value* value = builder.createVUnpackL(vb, TYPE_I16);
+    vd = builder.createAnd(value, builder.createVSplat(builder.getConstantI32(0xFF00001F)));
+    vd = builder.createOr(vd, builder.createAnd(builder.createVShl(value, 6, TYPE_I32), builder.createVSplat(builder.getConstantI32(0x001F0000))));
+    vd = builder.createOr(vd, builder.createAnd(builder.createVShl(value, 3, TYPE_I32), builder.createVSplat(builder.getConstantI32(0x00001F00))));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vupklsb(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVUnpackL(vb, TYPE_I8);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vupklsh(Instruction code)
 {
-    assert_always("Unimplemented");
+    Value* vb = getVR(code.vb);
+    Value* vd;
+
+    vd = builder.createVUnpackL(vb, TYPE_I16);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vxor(Instruction code)
@@ -0,0 +1,35 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "arena.h"
+
+namespace cpu {
+namespace hir {
+
+void Arena::grow(size_t size) {
+    const size_t chunkSize = (size > CHUNK_SIZE) ? size : CHUNK_SIZE;
+    chunks.emplace_back(new U8[chunkSize]);
+    current = chunks.back().get();
+    limit = current + chunkSize;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    uintptr_t address = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~uintptr_t(alignment - 1);
+    if (!current || address + size > reinterpret_cast<uintptr_t>(limit)) {
+        grow(size + alignment);
+        address = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~uintptr_t(alignment - 1);
+    }
+    current = reinterpret_cast<U8*>(address + size);
+    return reinterpret_cast<void*>(address);
+}
+
+void Arena::release() {
+    chunks.clear();
+    current = nullptr;
+    limit = nullptr;
+}
+
+}  // namespace hir
+}  // namespace cpu
@@ -0,0 +1,67 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cpu {
+namespace hir {
+
+/**
+ * Arena
+ * =====
+ * Bump allocator holding the blocks, instructions and values of a function. Objects are
+ * carved out of large chunks and never freed individually: the whole arena is released at
+ * once after the function has been compiled or when its definition is discarded.
+ * Only trivially destructible objects can be allocated, since no destructors are called.
+ */
+class Arena {
+    // Size of the chunks requested from the system allocator
+    static constexpr size_t CHUNK_SIZE = 0x10000;
+
+    std::vector<std::unique_ptr<U8[]>> chunks;
+
+    // Free space of the current chunk
+    U8* current = nullptr;
+    U8* limit = nullptr;
+
+    // Allocate a new chunk able to hold at least the given number of bytes
+    void grow(size_t size);
+
+public:
+    /**
+     * Allocate uninitialized memory
+     * @param[in]  size       Number of bytes
+     * @param[in]  alignment  Alignment in bytes (power of two)
+     * @return                Pointer to the allocated memory
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /**
+     * Construct an object in the arena
+     * @param[in]  args  Arguments of the constructor
+     * @return           Pointer to the constructed object
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Release all objects allocated in the arena
+     */
+    void release();
+};
+
+}  // namespace hir
+}  // namespace cpu
@@ -17,10 +17,8 @@ Block::Block(Function* parent) : parent(parent), flags(0) {
     parent->blocks.push_back(this);
 }
 
-Block::~Block() {
-    for (auto instruction : instructions) {
-        delete instruction;
-    }
+Block* Block::create(Function* parent) {
+    return parent->arena.create<Block>(parent);
 }
 
 S32 Block::getId() {
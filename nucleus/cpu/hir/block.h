@@ -6,35 +6,43 @@
 #pragma once
 
 #include "nucleus/common.h"
+#include "nucleus/cpu/hir/instruction.h"
 
-#include <list>
 #include <string>
 
 namespace cpu {
 namespace hir {
 
 // Forward declarations
+class Arena;
 class Function;
-class Instruction;
 
 enum BlockFlags {
     BLOCK_IS_ENTRY = (1 << 0),  // Block is the entry point of its parent function
 };
 
 class Block {
+    friend class Arena;
+
     // Value ID used in human-readable HIR representations
     S32 id = -1;
 
+    // Constructor
+    Block(Function* parent);
+
 public:
     Function* parent;
 
-    std::list<Instruction*> instructions;
+    InstructionList instructions;
 
     U32 flags;
 
-    // Constructor
-    Block(Function* parent);
-    ~Block();
+    /**
+     * Create a block at the end of a function, allocated in the arena of the function
+     * @param[in]  parent  Function holding the block
+     * @return             New empty block
+     */
+    static Block* create(Function* parent);
 
     // Get ID of this block
     S32 getId();
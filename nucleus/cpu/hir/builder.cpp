@@ -10,6 +10,8 @@
 #include "nucleus/cpu/hir/instruction.h"
 #include "nucleus/assert.h"
 
+#include <cstring>
+
 #define ASSERT_TYPE_EQUAL(value1, value2) \
     assert_true(value1->type == value2->type)
 
@@ -28,14 +30,14 @@ void Builder::setInsertPoint(Block* block) {
     ip = block->instructions.end();
 }
 
-void Builder::setInsertPoint(Block* block, std::list<Instruction*>::iterator insertPoint) {
+void Builder::setInsertPoint(Block* block, InstructionList::iterator insertPoint) {
     ib = block;
     ip = insertPoint;
 }
 
 // HIR values
 Value* Builder::allocValue(Type type) {
-    Value* value = new Value();
+    Value* value = ib->parent->arena.create<Value>();
     value->type = type;
     value->flags = 0;
     value->usage = 0;
@@ -46,7 +48,7 @@ Value* Builder::allocValue(Type type) {
 Value* Builder::cloneValue(Value* source) {
     assert_true(source->isConstant(), "Builder only supports cloning constants");
 
-    Value* value = new Value();
+    Value* value = ib->parent->arena.create<Value>();
     value->type = source->type;
     value->flags = source->flags;
 
@@ -107,6 +109,7 @@ Value* Builder::getConstantV256(V256 c) {
 Value* Builder::getConstantPointer(void* c) {
     Value* value = allocValue(TYPE_PTR);
     value->setConstantI64(reinterpret_cast<U64>(c));
+    value->flags |= VALUE_IS_POINTER;
     return value;
 }
 
@@ -121,6 +124,8 @@ Function* Builder::getExternFunction(void* hostAddr) {
         externFunc = new Function(parModule, TYPE_VOID, {TYPE_PTR, TYPE_I64});
     } else if (hostAddr == nucleusCall) {
         externFunc = new Function(parModule, TYPE_VOID, {TYPE_I64});
+    } else if (hostAddr == nucleusDispatch) {
+        externFunc = new Function(parModule, TYPE_VOID, {TYPE_PTR, TYPE_I64});
     } else if (hostAddr == nucleusSysCall) {
         externFunc = new Function(parModule, TYPE_VOID, {});
     } else if (hostAddr == nucleusHook) {
@@ -129,6 +134,7 @@ Function* Builder::getExternFunction(void* hostAddr) {
         externFunc = new Function(parModule, TYPE_VOID, {TYPE_I64});
     } else if (hostAddr == nucleusTime) {
         externFunc = new Function(parModule, TYPE_I64, {});
+        externFunc->contextAccess.known = true;
     }
 
     externFunc->flags |= FUNCTION_IS_EXTERN;
@@ -138,7 +144,7 @@ Function* Builder::getExternFunction(void* hostAddr) {
 
 // Instruction generation
 Instruction* Builder::appendInstr(Opcode opcode, OpcodeFlags flags, Value* dest) {
-    Instruction* instr = new Instruction();
+    Instruction* instr = ib->parent->arena.create<Instruction>();
     instr->parent = ib;
     instr->opcode = opcode;
     instr->flags = flags;
@@ -416,9 +422,9 @@ Value* Builder::createXor(Value* lhs, Value* rhs) {
     if (lhs == rhs) {
         // TODO
     } else if (lhs->isConstantZero()) {
-        return lhs;
-    } else if (rhs->isConstantZero()) {
         return rhs;
+    } else if (rhs->isConstantZero()) {
+        return lhs;
     } else if (lhs->isConstant() && rhs->isConstant()) {
         Value* dest = cloneValue(lhs);
         dest->doXor(rhs);
@@ -522,6 +528,58 @@ Value* Builder::createShrA(Value* value, U64 rhs) {
     return createShrA(value, getConstantI8(rhs));
 }
 
+Value* Builder::createRol(Value* value, Value* amount) {
+    ASSERT_TYPE_INTEGER(value);
+    ASSERT_TYPE_INTEGER(amount);
+
+    if (amount->isConstantZero()) {
+        return value;
+    }
+    if (value->isConstant() && amount->isConstant()) {
+        Value* dest = cloneValue(value);
+        dest->doRol(amount);
+        return dest;
+    }
+    if (amount->type != TYPE_I8) {
+        amount = createTrunc(amount, TYPE_I8);
+    }
+
+    Instruction* i = appendInstr(OPCODE_ROL, 0, allocValue(value->type));
+    i->src1.setValue(value);
+    i->src2.setValue(amount);
+    return i->dest;
+}
+
+Value* Builder::createRol(Value* value, U64 rhs) {
+    return createRol(value, getConstantI8(rhs));
+}
+
+Value* Builder::createRor(Value* value, Value* amount) {
+    ASSERT_TYPE_INTEGER(value);
+    ASSERT_TYPE_INTEGER(amount);
+
+    if (amount->isConstantZero()) {
+        return value;
+    }
+    if (value->isConstant() && amount->isConstant()) {
+        Value* dest = cloneValue(value);
+        dest->doRor(amount);
+        return dest;
+    }
+    if (amount->type != TYPE_I8) {
+        amount = createTrunc(amount, TYPE_I8);
+    }
+
+    Instruction* i = appendInstr(OPCODE_ROR, 0, allocValue(value->type));
+    i->src1.setValue(value);
+    i->src2.setValue(amount);
+    return i->dest;
+}
+
+Value* Builder::createRor(Value* value, U64 rhs) {
+    return createRor(value, getConstantI8(rhs));
+}
+
 // Memory access operations
 Value* Builder::createLoad(Value* address, Type type, MemoryFlags flags) {
     Instruction* i = appendInstr(OPCODE_LOAD, flags, allocValue(type));
@@ -535,6 +593,16 @@ void Builder::createStore(Value* address, Value* value, MemoryFlags flags) {
     i->src2.setValue(value);
 }
 
+Value* Builder::createCmpXchg(Value* address, Value* expected, Value* desired, MemoryFlags flags) {
+    ASSERT_TYPE_EQUAL(expected, desired);
+
+    Instruction* i = appendInstr(OPCODE_CMPXCHG, flags, allocValue(TYPE_I8));
+    i->src1.setValue(address);
+    i->src2.setValue(expected);
+    i->src3.setValue(desired);
+    return i->dest;
+}
+
 Value* Builder::createCtxLoad(U32 offset, Type type) {
     Instruction* i = appendInstr(OPCODE_CTXLOAD, 0, allocValue(type));
     i->src1.immediate = offset;
@@ -547,6 +615,18 @@ void Builder::createCtxStore(U32 offset, Value* value) {
     i->src2.setValue(value);
 }
 
+Value* Builder::createLocalLoad(U32 offset, Type type) {
+    Instruction* i = appendInstr(OPCODE_LOCALLOAD, 0, allocValue(type));
+    i->src1.immediate = offset;
+    return i->dest;
+}
+
+void Builder::createLocalStore(U32 offset, Value* value) {
+    Instruction* i = appendInstr(OPCODE_LOCALSTORE, 0);
+    i->src1.immediate = offset;
+    i->src2.setValue(value);
+}
+
 void Builder::createMemFence() {
     Instruction* i = appendInstr(OPCODE_MEMFENCE, 0);
 }
@@ -555,7 +635,7 @@ void Builder::createMemFence() {
 Value* Builder::createCmp(Value* lhs, Value* rhs, CompareFlags flags) {
     ASSERT_TYPE_EQUAL(lhs, rhs);
 
-    if (lhs->isConstant() && rhs->isConstant()) {
+    if (lhs->isConstant() && rhs->isConstant() && lhs->isTypeInteger()) {
         Value* dest = cloneValue(lhs);
         dest->doCompare(rhs, flags);
         return dest;
@@ -654,9 +734,9 @@ Value* Builder::createCallCond(Value* cond, Function* function, const std::vecto
     // Call function
     Instruction* i;
     if (function->typeOut == TYPE_VOID) {
-        i = appendInstr(OPCODE_CALL, flags);
+        i = appendInstr(OPCODE_CALLCOND, flags);
     } else {
-        i = appendInstr(OPCODE_CALL, flags, allocValue(function->typeOut));
+        i = appendInstr(OPCODE_CALLCOND, flags, allocValue(function->typeOut));
     }
     i->src1.setValue(cond);
     i->src2.function = function;
@@ -686,6 +766,27 @@ void Builder::createRet() {
     Instruction* i = appendInstr(OPCODE_RET, 0);
 }
 
+Value* Builder::createPhi(const std::vector<std::pair<Value*, Block*>>& incoming) {
+    assert_true(!incoming.empty());
+
+    // Phi nodes precede any other instruction of the block
+    const auto insertPoint = ip;
+    ip = ib->instructions.begin();
+    while (ip != ib->instructions.end() && (*ip)->opcode == OPCODE_PHI) {
+        ip++;
+    }
+
+    Value* dest = allocValue(incoming.front().first->type);
+    for (const auto& edge : incoming) {
+        ASSERT_TYPE_EQUAL(dest, edge.first);
+        Instruction* i = appendInstr(OPCODE_PHI, 0, dest);
+        i->src1.setValue(edge.first);
+        i->src2.block = edge.second;
+    }
+    ip = insertPoint;
+    return dest;
+}
+
 // Floating-point operations
 Value* Builder::createFAdd(Value* lhs, Value* rhs) {
     ASSERT_TYPE_FLOAT(lhs);
@@ -777,80 +878,296 @@ Value* Builder::createFNeg(Value* value) {
 }
 
 // Vector operations
+static OpcodeFlags getComponentFlags(Type compType) {
+    switch (compType) {
+    case TYPE_I8:   return COMPONENT_I8;
+    case TYPE_I16:  return COMPONENT_I16;
+    case TYPE_I32:  return COMPONENT_I32;
+    case TYPE_I64:  return COMPONENT_I64;
+    case TYPE_F32:  return COMPONENT_F32;
+    case TYPE_F64:  return COMPONENT_F64;
+    default:
+        assert_always("Unimplemented case");
+        return 0;
+    }
+}
+
+static OpcodeFlags getSignFlags(ArithmeticFlags flags) {
+    return (flags & ARITHMETIC_UNSIGNED) ? VECTOR_UNSIGNED : VECTOR_SIGNED;
+}
+
+static Value* createVectorOp(Builder& builder, Opcode opcode, OpcodeFlags flags, Value* lhs, Value* rhs) {
+    ASSERT_TYPE_VECTOR(lhs);
+    ASSERT_TYPE_EQUAL(lhs, rhs);
+
+    Instruction* i = builder.appendInstr(opcode, flags, builder.allocValue(lhs->type));
+    i->src1.setValue(lhs);
+    i->src2.setValue(rhs);
+    return i->dest;
+}
+
+static Value* createVectorOp(Builder& builder, Opcode opcode, OpcodeFlags flags, Value* value) {
+    ASSERT_TYPE_VECTOR(value);
+
+    Instruction* i = builder.appendInstr(opcode, flags, builder.allocValue(value->type));
+    i->src1.setValue(value);
+    return i->dest;
+}
+
 Value* Builder::createVAdd(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVectorOp(*this, OPCODE_VADD, getComponentFlags(compType), lhs, rhs);
+}
+
+Value* Builder::createVAddSat(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags) {
+    return createVectorOp(*this, OPCODE_VADD, getComponentFlags(compType) | getSignFlags(flags) | VECTOR_SATURATE, lhs, rhs);
 }
 
 Value* Builder::createVSub(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVectorOp(*this, OPCODE_VSUB, getComponentFlags(compType), lhs, rhs);
+}
+
+Value* Builder::createVSubSat(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags) {
+    return createVectorOp(*this, OPCODE_VSUB, getComponentFlags(compType) | getSignFlags(flags) | VECTOR_SATURATE, lhs, rhs);
 }
 
 Value* Builder::createVMul(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags) {
-    return nullptr;
+    return createVectorOp(*this, OPCODE_VMUL, getComponentFlags(compType) | getSignFlags(flags), lhs, rhs);
 }
 
 Value* Builder::createVAvg(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags) {
-    return nullptr;
+    return createVectorOp(*this, OPCODE_VAVG, getComponentFlags(compType) | getSignFlags(flags), lhs, rhs);
+}
+
+Value* Builder::createVMin(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags) {
+    return createVectorOp(*this, OPCODE_VMIN, getComponentFlags(compType) | getSignFlags(flags), lhs, rhs);
+}
+
+Value* Builder::createVMax(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags) {
+    return createVectorOp(*this, OPCODE_VMAX, getComponentFlags(compType) | getSignFlags(flags), lhs, rhs);
 }
 
 Value* Builder::createVAbs(Value* value, Type compType) {
-    return nullptr;
+    ASSERT_TYPE_VECTOR(value);
+
+    // Clear the sign bit of floating-point components, negate the negative integer components
+    switch (compType) {
+    case TYPE_F32:
+        return createAnd(value, createVSplat(getConstantI32(0x7FFFFFFF), value->type));
+    case TYPE_F64:
+        return createAnd(value, createVSplat(getConstantI64(0x7FFFFFFF'FFFFFFFFULL), value->type));
+    default:
+        return createVMax(value, createVSub(createVSplat(getConstantI8(0), value->type), value, compType), compType);
+    }
+}
+
+Value* Builder::createVRound(Value* value, Type compType, VectorFlags mode) {
+    return createVectorOp(*this, OPCODE_VROUND, getComponentFlags(compType) | mode, value);
+}
+
+Value* Builder::createVRcp(Value* value, Type compType) {
+    return createVectorOp(*this, OPCODE_VRCP, getComponentFlags(compType), value);
+}
+
+Value* Builder::createVRSqrt(Value* value, Type compType) {
+    return createVectorOp(*this, OPCODE_VRSQRT, getComponentFlags(compType), value);
+}
+
+Value* Builder::createVConvert(Value* value, Type compTypeIn, Type compTypeOut, ArithmeticFlags flags) {
+    // Only conversions between 32-bit integers and single-precision floats are supported
+    assert_true((compTypeIn == TYPE_I32 && compTypeOut == TYPE_F32) || (compTypeIn == TYPE_F32 && compTypeOut == TYPE_I32));
+    return createVectorOp(*this, OPCODE_VCONVERT, getComponentFlags(compTypeIn) | getSignFlags(flags), value);
+}
+
+Value* Builder::createVCmp(Value* lhs, Value* rhs, Type compType, CompareFlags flags) {
+    const OpcodeFlags comp = getComponentFlags(compType);
+    const OpcodeFlags sign = (flags & (1 << 6)) ? VECTOR_UNSIGNED : VECTOR_SIGNED;
+
+    // Only equality, greater-than and greater-or-equal comparisons are available
+    switch (flags) {
+    case COMPARE_EQ:
+        return createVectorOp(*this, OPCODE_VCMP, comp | VECTOR_CMP_EQ, lhs, rhs);
+    case COMPARE_NE:
+        return createNot(createVectorOp(*this, OPCODE_VCMP, comp | VECTOR_CMP_EQ, lhs, rhs));
+    case COMPARE_SGT:
+    case COMPARE_UGT:
+        return createVectorOp(*this, OPCODE_VCMP, comp | sign | VECTOR_CMP_GT, lhs, rhs);
+    case COMPARE_SGE:
+    case COMPARE_UGE:
+        return createVectorOp(*this, OPCODE_VCMP, comp | sign | VECTOR_CMP_GE, lhs, rhs);
+    case COMPARE_SLT:
+    case COMPARE_ULT:
+        return createVectorOp(*this, OPCODE_VCMP, comp | sign | VECTOR_CMP_GT, rhs, lhs);
+    case COMPARE_SLE:
+    case COMPARE_ULE:
+        return createVectorOp(*this, OPCODE_VCMP, comp | sign | VECTOR_CMP_GE, rhs, lhs);
+    default:
+        assert_always("Unimplemented case");
+        return nullptr;
+    }
 }
 
 Value* Builder::createVCmpEQ(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_EQ);
 }
 
 Value* Builder::createVCmpNE(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_NE);
 }
 
 Value* Builder::createVCmpFLT(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_SLT);
 }
 
 Value* Builder::createVCmpFLE(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_SLE);
 }
 
 Value* Builder::createVCmpFGT(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_SGT);
 }
 
 Value* Builder::createVCmpFGE(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_SGE);
 }
 
 Value* Builder::createVCmpSLT(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_SLT);
 }
 
 Value* Builder::createVCmpSLE(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_SLE);
 }
 
 Value* Builder::createVCmpSGT(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_SGT);
 }
 
 Value* Builder::createVCmpSGE(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_SGE);
 }
 
 Value* Builder::createVCmpULT(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_ULT);
 }
 
 Value* Builder::createVCmpULE(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_ULE);
 }
 
 Value* Builder::createVCmpUGT(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_UGT);
 }
 
 Value* Builder::createVCmpUGE(Value* lhs, Value* rhs, Type compType) {
-    return nullptr;
+    return createVCmp(lhs, rhs, compType, COMPARE_UGE);
+}
+
+// Vector shifting operations
+static Value* getConstantComponent(Builder& builder, U64 c, Type compType) {
+    switch (compType) {
+    case TYPE_I8:   return builder.getConstantI8(c);
+    case TYPE_I16:  return builder.getConstantI16(c);
+    case TYPE_I32:  return builder.getConstantI32(c);
+    case TYPE_I64:  return builder.getConstantI64(c);
+    default:
+        assert_always("Unimplemented case");
+        return nullptr;
+    }
+}
+
+Value* Builder::createVShl(Value* value, Value* amount, Type compType) {
+    return createVectorOp(*this, OPCODE_VSHL, getComponentFlags(compType), value, amount);
+}
+
+Value* Builder::createVShl(Value* value, U64 rhs, Type compType) {
+    return createVShl(value, createVSplat(getConstantComponent(*this, rhs, compType), value->type), compType);
+}
+
+Value* Builder::createVShr(Value* value, Value* amount, Type compType) {
+    return createVectorOp(*this, OPCODE_VSHR, getComponentFlags(compType), value, amount);
+}
+
+Value* Builder::createVShr(Value* value, U64 rhs, Type compType) {
+    return createVShr(value, createVSplat(getConstantComponent(*this, rhs, compType), value->type), compType);
+}
+
+Value* Builder::createVShrA(Value* value, Value* amount, Type compType) {
+    return createVectorOp(*this, OPCODE_VSHRA, getComponentFlags(compType), value, amount);
+}
+
+Value* Builder::createVShrA(Value* value, U64 rhs, Type compType) {
+    return createVShrA(value, createVSplat(getConstantComponent(*this, rhs, compType), value->type), compType);
+}
+
+// Vector permutation operations
+Value* Builder::createVSplat(Value* value, Type vecType) {
+    assert_true(vecType == TYPE_V128);
+
+    if (value->isConstant()) {
+        const U32 size = getTypeSize(value->type);
+        V128 c;
+        for (U32 offset = 0; offset < sizeof(V128); offset += size) {
+            std::memcpy(&c.u8[offset], &value->constant, size);
+        }
+        return getConstantV128(c);
+    }
+
+    Instruction* i = appendInstr(OPCODE_VSPLAT, getComponentFlags(value->type), allocValue(vecType));
+    i->src1.setValue(value);
+    return i->dest;
+}
+
+Value* Builder::createVExtract(Value* value, U32 index, Type compType) {
+    ASSERT_TYPE_VECTOR(value);
+    assert_true(index < getTypeSize(value->type) / getTypeSize(compType));
+
+    if (value->isConstant()) {
+        const U32 size = getTypeSize(compType);
+        Value::Constant c = {};
+        std::memcpy(&c, &value->constant.v128.u8[index * size], size);
+        switch (compType) {
+        case TYPE_F32:  return getConstantF32(c.f32);
+        case TYPE_F64:  return getConstantF64(c.f64);
+        default:        return getConstantComponent(*this, c.i64, compType);
+        }
+    }
+
+    Instruction* i = appendInstr(OPCODE_VEXTRACT, getComponentFlags(compType), allocValue(compType));
+    i->src1.setValue(value);
+    i->src2.immediate = index;
+    return i->dest;
+}
+
+Value* Builder::createVPerm(Value* lhs, Value* rhs, Value* control) {
+    ASSERT_TYPE_VECTOR(lhs);
+    ASSERT_TYPE_EQUAL(lhs, rhs);
+    ASSERT_TYPE_EQUAL(lhs, control);
+
+    Instruction* i = appendInstr(OPCODE_VPERM, COMPONENT_I8, allocValue(lhs->type));
+    i->src1.setValue(lhs);
+    i->src2.setValue(rhs);
+    i->src3.setValue(control);
+    return i->dest;
+}
+
+Value* Builder::createVMergeH(Value* lhs, Value* rhs, Type compType) {
+    return createVectorOp(*this, OPCODE_VMERGEH, getComponentFlags(compType), lhs, rhs);
+}
+
+Value* Builder::createVMergeL(Value* lhs, Value* rhs, Type compType) {
+    return createVectorOp(*this, OPCODE_VMERGEL, getComponentFlags(compType), lhs, rhs);
+}
+
+Value* Builder::createVPack(Value* lhs, Value* rhs, Type compType, VectorFlags flags) {
+    return createVectorOp(*this, OPCODE_VPACK, getComponentFlags(compType) | flags, lhs, rhs);
+}
+
+Value* Builder::createVUnpackH(Value* value, Type compType, ArithmeticFlags flags) {
+    return createVectorOp(*this, OPCODE_VUNPACKH, getComponentFlags(compType) | getSignFlags(flags), value);
+}
+
+Value* Builder::createVUnpackL(Value* value, Type compType, ArithmeticFlags flags) {
+    return createVectorOp(*this, OPCODE_VUNPACKL, getComponentFlags(compType) | getSignFlags(flags), value);
 }
 
 }  // namespace hir
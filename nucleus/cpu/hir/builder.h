@@ -10,7 +10,7 @@
 #include "nucleus/cpu/hir/type.h"
 #include "nucleus/cpu/hir/value.h"
 
-#include <list>
+#include <utility>
 #include <vector>
 
 namespace cpu {
@@ -21,15 +21,15 @@ class Block;
 class Value;
 
 class Builder {
-    Block* ib;
-    std::list<Instruction*>::iterator ip;
+    Block* ib = nullptr;
+    InstructionList::iterator ip;
 
 public:
     /**
      * HIR insertion
      */
     void setInsertPoint(Block* block);
-    void setInsertPoint(Block* block, std::list<Instruction*>::iterator ip);
+    void setInsertPoint(Block* block, InstructionList::iterator ip);
 
     // HIR values
     Value* allocValue(Type type);
@@ -86,12 +86,19 @@ public:
     Value* createShr(Value* value, U64 rhs);
     Value* createShrA(Value* value, Value* amount);
     Value* createShrA(Value* value, U64 rhs);
+    Value* createRol(Value* value, Value* amount);
+    Value* createRol(Value* value, U64 rhs);
+    Value* createRor(Value* value, Value* amount);
+    Value* createRor(Value* value, U64 rhs);
 
     // Memory access and context operations
     Value* createLoad(Value* address, Type type, MemoryFlags flags = ENDIAN_DEFAULT);
     void createStore(Value* address, Value* value, MemoryFlags flags = ENDIAN_DEFAULT);
+    Value* createCmpXchg(Value* address, Value* expected, Value* desired, MemoryFlags flags = ENDIAN_DEFAULT);
     Value* createCtxLoad(U32 offset, Type type);
     void createCtxStore(U32 offset, Value* value);
+    Value* createLocalLoad(U32 offset, Type type);
+    void createLocalStore(U32 offset, Value* value);
     void createMemFence();
 
     // Comparison operations
@@ -116,6 +123,9 @@ public:
     void createRet(Value* value);
     void createRet();
 
+    // Phi nodes (placed at the start of the current block, with one incoming value per predecessor)
+    Value* createPhi(const std::vector<std::pair<Value*, Block*>>& incoming);
+
     // Floating-point operations
     Value* createFAdd(Value* lhs, Value* rhs);
     Value* createFSub(Value* lhs, Value* rhs);
@@ -125,10 +135,21 @@ public:
 
     // Vector operations
     Value* createVAdd(Value* lhs, Value* rhs, Type compType);
+    Value* createVAddSat(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags = ARITHMETIC_SIGNED);
     Value* createVSub(Value* lhs, Value* rhs, Type compType);
+    Value* createVSubSat(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags = ARITHMETIC_SIGNED);
     Value* createVMul(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags = ARITHMETIC_SIGNED);
     Value* createVAvg(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags = ARITHMETIC_SIGNED);
+    Value* createVMin(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags = ARITHMETIC_SIGNED);
+    Value* createVMax(Value* lhs, Value* rhs, Type compType, ArithmeticFlags flags = ARITHMETIC_SIGNED);
     Value* createVAbs(Value* value, Type compType);
+    Value* createVRound(Value* value, Type compType, VectorFlags mode);
+    Value* createVRcp(Value* value, Type compType);
+    Value* createVRSqrt(Value* value, Type compType);
+    Value* createVConvert(Value* value, Type compTypeIn, Type compTypeOut, ArithmeticFlags flags = ARITHMETIC_SIGNED);
+
+    // Vector comparison operations (components are set to all ones if true, or zero if false)
+    Value* createVCmp(Value* lhs, Value* rhs, Type compType, CompareFlags flags);
     Value* createVCmpEQ(Value* lhs, Value* rhs, Type compType);
     Value* createVCmpNE(Value* lhs, Value* rhs, Type compType);
     Value* createVCmpFLT(Value* lhs, Value* rhs, Type compType);
@@ -143,6 +164,24 @@ public:
     Value* createVCmpULE(Value* lhs, Value* rhs, Type compType);
     Value* createVCmpUGT(Value* lhs, Value* rhs, Type compType);
     Value* createVCmpUGE(Value* lhs, Value* rhs, Type compType);
+
+    // Vector shifting operations (each component is shifted by the corresponding component of the amount, modulo its width)
+    Value* createVShl(Value* value, Value* amount, Type compType);
+    Value* createVShl(Value* value, U64 rhs, Type compType);
+    Value* createVShr(Value* value, Value* amount, Type compType);
+    Value* createVShr(Value* value, U64 rhs, Type compType);
+    Value* createVShrA(Value* value, Value* amount, Type compType);
+    Value* createVShrA(Value* value, U64 rhs, Type compType);
+
+    // Vector permutation operations
+    Value* createVSplat(Value* value, Type vecType = TYPE_V128);
+    Value* createVExtract(Value* value, U32 index, Type compType);
+    Value* createVPerm(Value* lhs, Value* rhs, Value* control);
+    Value* createVMergeH(Value* lhs, Value* rhs, Type compType);
+    Value* createVMergeL(Value* lhs, Value* rhs, Type compType);
+    Value* createVPack(Value* lhs, Value* rhs, Type compType, VectorFlags flags = VECTOR_SIGNED);
+    Value* createVUnpackH(Value* value, Type compType, ArithmeticFlags flags = ARITHMETIC_SIGNED);
+    Value* createVUnpackL(Value* value, Type compType, ArithmeticFlags flags = ARITHMETIC_SIGNED);
 };
 
 }  // namespace hir
@@ -5,19 +5,40 @@
 
 #include "function.h"
 #include "nucleus/cpu/hir/block.h"
+#include "nucleus/cpu/hir/instruction.h"
 #include "nucleus/cpu/hir/module.h"
 
 namespace cpu {
 namespace hir {
 
+static bool overlaps(const std::vector<ContextAccess::Range>& ranges, U32 offset, U32 size) {
+    for (const auto& range : ranges) {
+        if (range.offset < offset + size && offset < range.offset + range.size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ContextAccess::mayRead(U32 offset, U32 size) const {
+    return !known || overlaps(reads, offset, size);
+}
+
+bool ContextAccess::mayWrite(U32 offset, U32 size) const {
+    return !known || overlaps(writes, offset, size);
+}
+
 Function::Function(Module* parent, TypeOut tOut, TypeIn tIn)
-    : parent(parent), typeOut(tOut), typeIn(tIn), flags(0), nativeAddress(nullptr) {
+    : parent(parent), typeOut(tOut), typeIn(tIn), flags(0), nativeAddress(nullptr),
+      localsSize(0), spillCount(0), reloadCount(0), redundantCount(0) {
     // Set flags
     flags |= FUNCTION_IS_DECLARED;
 
     // Argument values
     for (auto type : tIn) {
         Value* value = new Value();
+        value->parent.function = this;
+        value->flags = VALUE_IS_ARGUMENT;
         value->type = type;
         args.push_back(value);
     }
@@ -26,12 +47,6 @@ Function::Function(Module* parent, TypeOut tOut, TypeIn tIn)
     parent->addFunction(this);
 }
 
-Function::~Function() {
-    for (auto block : blocks) {
-        delete block;
-    }
-}
-
 S32 Function::getId() {
     if (id < 0) {
         id = parent->functionIdCounter++;
@@ -39,9 +54,54 @@ S32 Function::getId() {
     return id;
 }
 
+std::vector<Block*> Function::getSuccessors(size_t index) const {
+    std::vector<Block*> successors;
+    Block* next = (index + 1 < blocks.size()) ? blocks[index + 1] : nullptr;
+
+    const auto& instructions = blocks[index]->instructions;
+    if (instructions.empty()) {
+        if (next) {
+            successors.push_back(next);
+        }
+        return successors;
+    }
+
+    const Instruction* last = instructions.back();
+    switch (last->opcode) {
+    case OPCODE_BR:
+        successors.push_back(last->src1.block);
+        break;
+    case OPCODE_BRCOND:
+        successors.push_back(last->src2.block);
+        if (next && next != last->src2.block) {
+            successors.push_back(next);
+        }
+        break;
+    case OPCODE_RET:
+        break;
+    default:
+        if (next) {
+            successors.push_back(next);
+        }
+    }
+    return successors;
+}
+
 void Function::reset() {
     flags = FUNCTION_IS_DECLARED;
     blocks.clear();
+    arena.release();
+    nativeImmediates.clear();
+    localsSize = 0;
+    spillCount = 0;
+    reloadCount = 0;
+    redundantCount = 0;
+}
+
+void Function::release() {
+    flags &= ~(FUNCTION_IS_DEFINING | FUNCTION_IS_DEFINED);
+    blocks.clear();
+    arena.release();
 }
 
 std::string Function::dump() {
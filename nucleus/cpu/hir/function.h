@@ -6,6 +6,7 @@
 #pragma once
 
 #include "nucleus/common.h"
+#include "nucleus/cpu/hir/arena.h"
 #include "nucleus/cpu/hir/type.h"
 #include "nucleus/cpu/hir/value.h"
 
@@ -16,6 +17,7 @@ namespace hir {
 
 // Forward declarations
 class Block;
+class Function;
 class Module;
 
 enum FunctionFlags {
@@ -29,6 +31,50 @@ enum FunctionFlags {
     FUNCTION_IS_CALLABLE    = (1 << 7),  // Function can be called
 };
 
+/**
+ * Call to another function in the native code of a function, which the backend can link
+ * directly to the native code of its target (see backend::Compiler::link).
+ */
+struct NativeCallSite {
+    const Function* target;  // Called function
+    U32 offset;              // Offset of the call instruction in the native code
+    U32 stub;                // Offset of the code calling the target through Function::nativeAddress
+};
+
+/**
+ * Context bytes that a function (including its callees) might access.
+ * Frontends fill this information, if available, so that optimization passes can
+ * keep context values cached in HIR values across calls.
+ */
+struct ContextAccess {
+    struct Range {
+        U32 offset;
+        U32 size;
+    };
+
+    // If false, the function might read or write any context byte
+    bool known = false;
+
+    std::vector<Range> reads;
+    std::vector<Range> writes;
+
+    /**
+     * Check whether the function might read any byte of the given context range
+     * @param[in]  offset  Offset of the range in the context
+     * @param[in]  size    Size of the range in bytes
+     * @return             True if any byte might be read
+     */
+    bool mayRead(U32 offset, U32 size) const;
+
+    /**
+     * Check whether the function might write any byte of the given context range
+     * @param[in]  offset  Offset of the range in the context
+     * @param[in]  size    Size of the range in bytes
+     * @return             True if any byte might be written
+     */
+    bool mayWrite(U32 offset, U32 size) const;
+};
+
 class Function {
     using TypeOut = Type;
     using TypeIn = std::vector<Type>;
@@ -49,16 +95,37 @@ public:
     // Blocks
     std::vector<Block*> blocks;
 
+    // Storage of the blocks, instructions and values of the definition
+    Arena arena;
+
     // Arguments
     std::vector<Value*> args;
 
+    // Context accesses, preserved after resetting the function
+    ContextAccess contextAccess;
+
     // Pointer to the compiled function
     void* nativeAddress;
     U64 nativeSize;
 
+    // Offsets of the 64-bit immediates in the compiled function, which might hold host addresses
+    std::vector<U32> nativeImmediates;
+
+    // Linkable calls in the compiled function (guarded by the compiler)
+    std::vector<NativeCallSite> nativeCallSites;
+
+    // Stack storage required by the values spilled during register allocation
+    U32 localsSize;
+
+    // Register allocation statistics
+    U32 spillCount;   // Number of values stored to the stack
+    U32 reloadCount;  // Number of loads of spilled values
+
+    // Value numbering statistics
+    U32 redundantCount;  // Number of redundant instructions removed
+
     // Constructor
     Function(Module* parent, TypeOut tOut, TypeIn tIn = {});
-    ~Function();
 
     // Get ID of this function (dumping related)
     S32 getId();
@@ -67,11 +134,25 @@ public:
     S32 blockIdCounter = 0;
     S32 valueIdCounter = 0;
 
+    /**
+     * Get the blocks that control can be transferred to after the given block,
+     * including the fall-through block of conditional branches
+     * @param[in]  index  Index of the block in Function::blocks
+     * @return            Successor blocks
+     */
+    std::vector<Block*> getSuccessors(size_t index) const;
+
     /**
      * Reset the function to its original declared state, removing its definition and compiled result
      */
     void reset();
 
+    /**
+     * Release the HIR definition of the function once its native code has been emitted,
+     * keeping the compiled result. The function has to be reset before defining it again.
+     */
+    void release();
+
     /**
      * Save a human-readable version of this HIR function
      * @return           String containing the readable version of this HIR function
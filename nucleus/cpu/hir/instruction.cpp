@@ -107,6 +107,7 @@ std::string Instruction::dump() const {
         // Memory flags
         case OPCODE_LOAD:
         case OPCODE_STORE:
+        case OPCODE_CMPXCHG:
             if (flags == ENDIAN_BIG) { output += "be"; }
             if (flags == ENDIAN_LITTLE) { output += "le"; }
             break;
@@ -147,5 +148,25 @@ std::string Instruction::dump() const {
     return output;
 }
 
+InstructionList::iterator InstructionList::insert(iterator pos, Instruction* instr) {
+    Instruction* next = pos.node;
+    Instruction* prev = next ? next->prev : tail;
+    instr->prev = prev;
+    instr->next = next;
+    (prev ? prev->next : head) = instr;
+    (next ? next->prev : tail) = instr;
+    return iterator(instr, this);
+}
+
+InstructionList::iterator InstructionList::erase(iterator pos) {
+    Instruction* instr = pos.node;
+    Instruction* next = instr->next;
+    (instr->prev ? instr->prev->next : head) = next;
+    (next ? next->prev : tail) = instr->prev;
+    instr->prev = nullptr;
+    instr->next = nullptr;
+    return iterator(next, this);
+}
+
 }  // namespace hir
 }  // namespace cpu
@@ -9,6 +9,7 @@
 #include "nucleus/cpu/hir/opcodes.h"
 #include "nucleus/cpu/hir/value.h"
 
+#include <iterator>
 #include <vector>
 #include <map>
 
@@ -24,6 +25,10 @@ class Instruction {
 public:
     Block* parent;
 
+    // Neighbouring instructions in the parent block (see InstructionList)
+    Instruction* prev;
+    Instruction* next;
+
     // Immediate operand type
     using Immediate = U64;
 
@@ -66,5 +71,97 @@ public:
     std::string dump() const;
 };
 
+/**
+ * Doubly-linked list of the instructions of a block, linked through the instructions themselves.
+ * Iterators point to the instructions, so they stay valid until the instruction is erased.
+ */
+class InstructionList {
+    Instruction* head = nullptr;
+    Instruction* tail = nullptr;
+
+public:
+    class iterator {
+        friend class InstructionList;
+
+        Instruction* node;
+        const InstructionList* list;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Instruction*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Instruction* const*;
+        using reference = Instruction*;
+
+        iterator() : node(nullptr), list(nullptr) {}
+        iterator(Instruction* node, const InstructionList* list) : node(node), list(list) {}
+
+        Instruction* operator*() const {
+            return node;
+        }
+        iterator& operator++() {
+            node = node->next;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator prev = *this;
+            node = node->next;
+            return prev;
+        }
+        iterator& operator--() {
+            node = node ? node->prev : list->tail;
+            return *this;
+        }
+        iterator operator--(int) {
+            iterator next = *this;
+            node = node ? node->prev : list->tail;
+            return next;
+        }
+        bool operator==(const iterator& other) const {
+            return node == other.node;
+        }
+        bool operator!=(const iterator& other) const {
+            return node != other.node;
+        }
+    };
+    using const_iterator = iterator;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    iterator begin() const { return iterator(head, this); }
+    iterator end() const { return iterator(nullptr, this); }
+    reverse_iterator rbegin() const { return reverse_iterator(end()); }
+    reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+    bool empty() const { return head == nullptr; }
+    Instruction* front() const { return head; }
+    Instruction* back() const { return tail; }
+
+    /**
+     * Insert an instruction before the given position
+     * @param[in]  pos    Position of the instruction following the inserted one
+     * @param[in]  instr  Instruction not linked to any list
+     * @return            Iterator to the inserted instruction
+     */
+    iterator insert(iterator pos, Instruction* instr);
+
+    /**
+     * Unlink an instruction from the list (the instruction is released along with its function)
+     * @param[in]  pos  Position of the instruction
+     * @return          Iterator to the instruction following the erased one
+     */
+    iterator erase(iterator pos);
+
+    /**
+     * Unlink all instructions satisfying a predicate
+     * @param[in]  pred  Predicate taking an instruction
+     */
+    template <typename Predicate>
+    void remove_if(Predicate pred) {
+        for (auto it = begin(); it != end();) {
+            it = pred(*it) ? erase(it) : std::next(it);
+        }
+    }
+};
+
 }  // namespace hir
 }  // namespace cpu
@@ -7,6 +7,7 @@
 
 #include "nucleus/common.h"
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -20,6 +21,9 @@ class Module {
 public:
     std::vector<Function*> functions;
 
+    // Guards the list of functions, since functions might be declared by several threads
+    std::mutex mutex;
+
     // Generate IDs for child blocks and values
     S32 functionIdCounter = 0;
 
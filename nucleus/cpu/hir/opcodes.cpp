@@ -9,7 +9,7 @@ namespace cpu {
 namespace hir {
 
 OpcodeInfo opcodeInfo[__OPCODE_COUNT + 1] = {
-#define OPCODE(id, name, signature)  { name, 0, signature },
+#define OPCODE(id, name, signature, flags)  { name, flags, signature },
 #include "opcodes.inl"
 #undef OPCODE
 };
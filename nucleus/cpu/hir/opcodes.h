@@ -41,6 +41,11 @@ enum MemoryFlags : OpcodeFlags {
     ENDIAN_LITTLE   = 1 << 1,  // Little Endian memory access
 };
 
+/**
+ * Vector instructions operate on the components of their operands, from the least significant
+ * one (component 0) onwards. The lower bits of their flags hold the type of these components
+ * (for packing, unpacking and conversions, the type of the source components).
+ */
 enum VectorFlags : OpcodeFlags {
     COMPONENT_I8,
     COMPONENT_I16,
@@ -48,6 +53,30 @@ enum VectorFlags : OpcodeFlags {
     COMPONENT_I64,
     COMPONENT_F32,
     COMPONENT_F64,
+    COMPONENT_MASK  = 0b111,
+
+    VECTOR_SIGNED             = 0 << 3,
+    VECTOR_UNSIGNED           = 1 << 3,  // Integer components are unsigned
+    VECTOR_SATURATE           = 1 << 4,  // Results saturate to the range of the destination components
+    VECTOR_SATURATE_UNSIGNED  = 1 << 5,  // Results saturate to the unsigned range (packing signed components)
+
+    // Comparisons (VCMP)
+    VECTOR_CMP_EQ    = 0 << 6,
+    VECTOR_CMP_GT    = 1 << 6,
+    VECTOR_CMP_GE    = 2 << 6,
+    VECTOR_CMP_MASK  = 3 << 6,
+
+    // Rounding modes (VROUND)
+    VECTOR_ROUND_NEAREST  = 0 << 6,
+    VECTOR_ROUND_ZERO     = 1 << 6,
+    VECTOR_ROUND_UP       = 2 << 6,
+    VECTOR_ROUND_DOWN     = 3 << 6,
+    VECTOR_ROUND_MASK     = 3 << 6,
+};
+
+enum OpcodeInfoFlags : OpcodeFlags {
+    OPCODE_FLAG_VOLATILE  = 1 << 0,  // Instruction has side effects besides defining its destination
+    OPCODE_FLAG_CLOBBER   = 1 << 1,  // Instruction overwrites the scratch registers of the target (see RegisterSet::scratchIndex)
 };
 
 enum Opcode {
@@ -83,6 +112,8 @@ enum OpcodeSignature {
     OPCODE_SIG_X_V_B   = (OPCODE_SIG_TYPE_X) | (OPCODE_SIG_TYPE_V << 3) | (OPCODE_SIG_TYPE_B << 6),
     OPCODE_SIG_M_V_F   = (OPCODE_SIG_TYPE_M) | (OPCODE_SIG_TYPE_V << 3) | (OPCODE_SIG_TYPE_F << 6),
     OPCODE_SIG_V_I_V   = (OPCODE_SIG_TYPE_V) | (OPCODE_SIG_TYPE_I << 3) | (OPCODE_SIG_TYPE_V << 6),
+    OPCODE_SIG_V_V_I   = (OPCODE_SIG_TYPE_V) | (OPCODE_SIG_TYPE_V << 3) | (OPCODE_SIG_TYPE_I << 6),
+    OPCODE_SIG_V_V_B   = (OPCODE_SIG_TYPE_V) | (OPCODE_SIG_TYPE_V << 3) | (OPCODE_SIG_TYPE_B << 6),
     OPCODE_SIG_V_V_V   = (OPCODE_SIG_TYPE_V) | (OPCODE_SIG_TYPE_V << 3) | (OPCODE_SIG_TYPE_V << 6),
     OPCODE_SIG_X_V_V_V = (OPCODE_SIG_TYPE_X) | (OPCODE_SIG_TYPE_V << 3) | (OPCODE_SIG_TYPE_V << 6) | (OPCODE_SIG_TYPE_V << 9),
     OPCODE_SIG_V_V_V_V = (OPCODE_SIG_TYPE_V) | (OPCODE_SIG_TYPE_V << 3) | (OPCODE_SIG_TYPE_V << 6) | (OPCODE_SIG_TYPE_V << 9),
@@ -3,49 +3,70 @@
  * Released under GPL v2 license. Read LICENSE for more details.
  */
 
-OPCODE(ADD,       "add",       OPCODE_SIG_V_V_V)   // Addition
-OPCODE(SUB,       "sub",       OPCODE_SIG_V_V_V)   // Subtraction
-OPCODE(MUL,       "mul",       OPCODE_SIG_V_V_V)   // Multiplication
-OPCODE(MULH,      "mulh",      OPCODE_SIG_V_V_V)   // Multiplication (high)
-OPCODE(DIV,       "div",       OPCODE_SIG_V_V_V)   // Division
-OPCODE(NEG,       "neg",       OPCODE_SIG_V_V)     // Negation
-OPCODE(ZEXT,      "zext",      OPCODE_SIG_V_V)     // Integer zero-extend 
-OPCODE(SEXT,      "sext",      OPCODE_SIG_V_V)     // Integer sign-extend
-OPCODE(TRUNC,     "trunc",     OPCODE_SIG_V_V)     // Integer truncation
-OPCODE(CAST,      "cast",      OPCODE_SIG_V_V)     // Cast
-OPCODE(CONVERT,   "convert",   OPCODE_SIG_V_V)     // Convert
-OPCODE(CTLZ,      "ctlz",      OPCODE_SIG_V_V)     // Count leading zeros
-OPCODE(NOT,       "not",       OPCODE_SIG_V_V)     // Bitwise Not
-OPCODE(AND,       "and",       OPCODE_SIG_V_V_V)   // Bitwise And
-OPCODE(OR,        "or",        OPCODE_SIG_V_V_V)   // Bitwise Or
-OPCODE(XOR,       "xor",       OPCODE_SIG_V_V_V)   // Bitwise Xor
-OPCODE(SHL,       "shl",       OPCODE_SIG_V_V_V)   // Shift to left
-OPCODE(SHR,       "shr",       OPCODE_SIG_V_V_V)   // Shift to right
-OPCODE(SHRA,      "shra",      OPCODE_SIG_V_V_V)   // Shift to right (algebraic)
-OPCODE(ROL,       "rol",       OPCODE_SIG_V_V_V)   // Rotate to left
-OPCODE(ROR,       "ror",       OPCODE_SIG_V_V_V)   // Rotate to right
-OPCODE(SQRT,      "sqrt",      OPCODE_SIG_V_V)     // Square root
-OPCODE(ABS,       "abs",       OPCODE_SIG_V_V)     // Absolute value
-OPCODE(LOAD,      "load",      OPCODE_SIG_V_V)     // Load from memory
-OPCODE(STORE,     "store",     OPCODE_SIG_X_V_V)   // Store to memory
-OPCODE(CTXLOAD,   "ctxload",   OPCODE_SIG_V_I)     // Context load
-OPCODE(CTXSTORE,  "ctxstore",  OPCODE_SIG_X_I_V)   // Context store
-OPCODE(MEMFENCE,  "memfence",  OPCODE_SIG_X)       // Memory fence
-OPCODE(SELECT,    "select",    OPCODE_SIG_V_V_V_V) // Select
-OPCODE(CMP,       "cmp",       OPCODE_SIG_V_V_V)   // Compare
-OPCODE(BR,        "br",        OPCODE_SIG_X_B)     // Branch
-OPCODE(ARG,       "arg",       OPCODE_SIG_V_I_V)   // Argument
-OPCODE(CALL,      "call",      OPCODE_SIG_M_F)     // Call
-OPCODE(BRCOND,    "brcond",    OPCODE_SIG_X_V_B)   // Conditional branch
-OPCODE(CALLCOND,  "callcond",  OPCODE_SIG_M_V_F)   // Conditional call
-OPCODE(RET,       "ret",       OPCODE_SIG_X_M)     // Return
-OPCODE(PHI,       "phi",       OPCODE_SIG_V_V_V)   // Phi node
-OPCODE(FADD,      "fadd",      OPCODE_SIG_V_V_V)   // Floating-point addition
-OPCODE(FSUB,      "fsub",      OPCODE_SIG_V_V_V)   // Floating-point subtraction
-OPCODE(FMUL,      "fmul",      OPCODE_SIG_V_V_V)   // Floating-point multiplication
-OPCODE(FDIV,      "fdiv",      OPCODE_SIG_V_V_V)   // Floating-point division
-OPCODE(FNEG,      "fneg",      OPCODE_SIG_V_V)     // Floating-point negation
-OPCODE(VADD,      "vadd",      OPCODE_SIG_V_V_V)   // Vector addition
-OPCODE(VSUB,      "vadd",      OPCODE_SIG_V_V_V)   // Vector subtraction
-OPCODE(VAVG,      "vavg",      OPCODE_SIG_V_V_V)   // Vector average
-OPCODE(VCMP,      "vcmp",      OPCODE_SIG_V_V_V)   // Vector compare
+OPCODE(ADD,        "add",        OPCODE_SIG_V_V_V,   0)                    // Addition
+OPCODE(SUB,        "sub",        OPCODE_SIG_V_V_V,   0)                    // Subtraction
+OPCODE(MUL,        "mul",        OPCODE_SIG_V_V_V,   0)                    // Multiplication
+OPCODE(MULH,       "mulh",       OPCODE_SIG_V_V_V,   0)                    // Multiplication (high)
+OPCODE(DIV,        "div",        OPCODE_SIG_V_V_V,   0)                    // Division
+OPCODE(NEG,        "neg",        OPCODE_SIG_V_V,     0)                    // Negation
+OPCODE(ZEXT,       "zext",       OPCODE_SIG_V_V,     0)                    // Integer zero-extend
+OPCODE(SEXT,       "sext",       OPCODE_SIG_V_V,     0)                    // Integer sign-extend
+OPCODE(TRUNC,      "trunc",      OPCODE_SIG_V_V,     0)                    // Integer truncation
+OPCODE(CAST,       "cast",       OPCODE_SIG_V_V,     0)                    // Cast
+OPCODE(CONVERT,    "convert",    OPCODE_SIG_V_V,     0)                    // Convert
+OPCODE(CTLZ,       "ctlz",       OPCODE_SIG_V_V,     0)                    // Count leading zeros
+OPCODE(NOT,        "not",        OPCODE_SIG_V_V,     0)                    // Bitwise Not
+OPCODE(AND,        "and",        OPCODE_SIG_V_V_V,   0)                    // Bitwise And
+OPCODE(OR,         "or",         OPCODE_SIG_V_V_V,   0)                    // Bitwise Or
+OPCODE(XOR,        "xor",        OPCODE_SIG_V_V_V,   0)                    // Bitwise Xor
+OPCODE(SHL,        "shl",        OPCODE_SIG_V_V_V,   0)                    // Shift to left
+OPCODE(SHR,        "shr",        OPCODE_SIG_V_V_V,   0)                    // Shift to right
+OPCODE(SHRA,       "shra",       OPCODE_SIG_V_V_V,   0)                    // Shift to right (algebraic)
+OPCODE(ROL,        "rol",        OPCODE_SIG_V_V_V,   0)                    // Rotate to left
+OPCODE(ROR,        "ror",        OPCODE_SIG_V_V_V,   0)                    // Rotate to right
+OPCODE(SQRT,       "sqrt",       OPCODE_SIG_V_V,     0)                    // Square root
+OPCODE(ABS,        "abs",        OPCODE_SIG_V_V,     0)                    // Absolute value
+OPCODE(LOAD,       "load",       OPCODE_SIG_V_V,     0)                    // Load from memory
+OPCODE(STORE,      "store",      OPCODE_SIG_X_V_V,   OPCODE_FLAG_VOLATILE) // Store to memory
+OPCODE(CMPXCHG,    "cmpxchg",    OPCODE_SIG_V_V_V_V, OPCODE_FLAG_VOLATILE | OPCODE_FLAG_CLOBBER) // Atomic compare and exchange in memory
+OPCODE(CTXLOAD,    "ctxload",    OPCODE_SIG_V_I,     0)                    // Context load
+OPCODE(CTXSTORE,   "ctxstore",   OPCODE_SIG_X_I_V,   OPCODE_FLAG_VOLATILE) // Context store
+OPCODE(LOCALLOAD,  "localload",  OPCODE_SIG_V_I,     0)                    // Local stack load
+OPCODE(LOCALSTORE, "localstore", OPCODE_SIG_X_I_V,   OPCODE_FLAG_VOLATILE) // Local stack store
+OPCODE(MEMFENCE,   "memfence",   OPCODE_SIG_X,       OPCODE_FLAG_VOLATILE) // Memory fence
+OPCODE(SELECT,     "select",     OPCODE_SIG_V_V_V_V, 0)                    // Select
+OPCODE(CMP,        "cmp",        OPCODE_SIG_V_V_V,   0)                    // Compare
+OPCODE(BR,         "br",         OPCODE_SIG_X_B,     OPCODE_FLAG_VOLATILE) // Branch
+OPCODE(ARG,        "arg",        OPCODE_SIG_V_I_V,   OPCODE_FLAG_VOLATILE) // Argument
+OPCODE(CALL,       "call",       OPCODE_SIG_M_F,     OPCODE_FLAG_VOLATILE) // Call
+OPCODE(BRCOND,     "brcond",     OPCODE_SIG_X_V_B,   OPCODE_FLAG_VOLATILE) // Conditional branch
+OPCODE(CALLCOND,   "callcond",   OPCODE_SIG_M_V_F,   OPCODE_FLAG_VOLATILE) // Conditional call
+OPCODE(RET,        "ret",        OPCODE_SIG_X_M,     OPCODE_FLAG_VOLATILE) // Return
+OPCODE(PHI,        "phi",        OPCODE_SIG_V_V_B,   0)                    // Phi node (value incoming from a predecessor)
+OPCODE(FADD,       "fadd",       OPCODE_SIG_V_V_V,   0)                    // Floating-point addition
+OPCODE(FSUB,       "fsub",       OPCODE_SIG_V_V_V,   0)                    // Floating-point subtraction
+OPCODE(FMUL,       "fmul",       OPCODE_SIG_V_V_V,   0)                    // Floating-point multiplication
+OPCODE(FDIV,       "fdiv",       OPCODE_SIG_V_V_V,   0)                    // Floating-point division
+OPCODE(FNEG,       "fneg",       OPCODE_SIG_V_V,     0)                    // Floating-point negation
+OPCODE(VADD,       "vadd",       OPCODE_SIG_V_V_V,   0)                    // Vector addition
+OPCODE(VSUB,       "vsub",       OPCODE_SIG_V_V_V,   0)                    // Vector subtraction
+OPCODE(VMUL,       "vmul",       OPCODE_SIG_V_V_V,   0)                    // Vector multiplication
+OPCODE(VAVG,       "vavg",       OPCODE_SIG_V_V_V,   0)                    // Vector average
+OPCODE(VMIN,       "vmin",       OPCODE_SIG_V_V_V,   0)                    // Vector minimum
+OPCODE(VMAX,       "vmax",       OPCODE_SIG_V_V_V,   0)                    // Vector maximum
+OPCODE(VCMP,       "vcmp",       OPCODE_SIG_V_V_V,   0)                    // Vector compare
+OPCODE(VSHL,       "vshl",       OPCODE_SIG_V_V_V,   0)                    // Vector shift to left
+OPCODE(VSHR,       "vshr",       OPCODE_SIG_V_V_V,   0)                    // Vector shift to right
+OPCODE(VSHRA,      "vshra",      OPCODE_SIG_V_V_V,   0)                    // Vector shift to right (algebraic)
+OPCODE(VROUND,     "vround",     OPCODE_SIG_V_V,     0)                    // Vector round to integer
+OPCODE(VRCP,       "vrcp",       OPCODE_SIG_V_V,     0)                    // Vector reciprocal estimate
+OPCODE(VRSQRT,     "vrsqrt",     OPCODE_SIG_V_V,     0)                    // Vector reciprocal square root estimate
+OPCODE(VCONVERT,   "vconvert",   OPCODE_SIG_V_V,     0)                    // Vector convert
+OPCODE(VSPLAT,     "vsplat",     OPCODE_SIG_V_V,     0)                    // Vector splat
+OPCODE(VEXTRACT,   "vextract",   OPCODE_SIG_V_V_I,   0)                    // Vector component extraction
+OPCODE(VPERM,      "vperm",      OPCODE_SIG_V_V_V_V, 0)                    // Vector byte permutation
+OPCODE(VMERGEH,    "vmergeh",    OPCODE_SIG_V_V_V,   0)                    // Vector merge (high components)
+OPCODE(VMERGEL,    "vmergel",    OPCODE_SIG_V_V_V,   0)                    // Vector merge (low components)
+OPCODE(VPACK,      "vpack",      OPCODE_SIG_V_V_V,   0)                    // Vector pack
+OPCODE(VUNPACKH,   "vunpackh",   OPCODE_SIG_V_V,     0)                    // Vector unpack (high components)
+OPCODE(VUNPACKL,   "vunpackl",   OPCODE_SIG_V_V,     0)                    // Vector unpack (low components)
@@ -8,6 +8,8 @@
 #include "nucleus/common.h"
 #include "nucleus/cpu/hir/function.h"
 
+#include <memory>
+
 namespace cpu {
 namespace hir {
 
@@ -25,6 +27,12 @@ public:
      * @return               True on success
      */
     virtual bool run(Function* function) = 0;
+
+    /**
+     * Create a copy of this pass, so that several threads can apply it at once
+     * @return               New pass with the same settings
+     */
+    virtual std::unique_ptr<Pass> clone() const = 0;
 };
 
 }  // namespace hir
@@ -6,7 +6,10 @@
 #pragma once
 
 // Optimization passes
+#include "nucleus/cpu/hir/passes/constant_propagation_pass.h"
+#include "nucleus/cpu/hir/passes/context_caching_pass.h"
 #include "nucleus/cpu/hir/passes/dead_code_elimination_pass.h"
+#include "nucleus/cpu/hir/passes/value_numbering_pass.h"
 
 // Mandatory passes
 #include "nucleus/cpu/hir/passes/register_allocation_pass.h"
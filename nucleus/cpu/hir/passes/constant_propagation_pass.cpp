@@ -0,0 +1,456 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "constant_propagation_pass.h"
+#include "nucleus/cpu/hir/block.h"
+#include "nucleus/cpu/hir/instruction.h"
+#include "nucleus/assert.h"
+
+#include <utility>
+
+namespace cpu {
+namespace hir {
+namespace passes {
+
+static bool isValueOperand(U8 sigType, const Value* value) {
+    return sigType == OPCODE_SIG_TYPE_V || (sigType == OPCODE_SIG_TYPE_M && value != nullptr);
+}
+
+// Opcodes without side effects whose result depends only on their sources
+static bool isFoldable(Opcode opcode) {
+    switch (opcode) {
+    case OPCODE_ADD:
+    case OPCODE_SUB:
+    case OPCODE_MUL:
+    case OPCODE_MULH:
+    case OPCODE_DIV:
+    case OPCODE_NEG:
+    case OPCODE_NOT:
+    case OPCODE_AND:
+    case OPCODE_OR:
+    case OPCODE_XOR:
+    case OPCODE_SHL:
+    case OPCODE_SHR:
+    case OPCODE_SHRA:
+    case OPCODE_ROL:
+    case OPCODE_ROR:
+    case OPCODE_ZEXT:
+    case OPCODE_SEXT:
+    case OPCODE_TRUNC:
+    case OPCODE_CAST:
+    case OPCODE_CONVERT:
+    case OPCODE_CMP:
+    case OPCODE_SELECT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static U64 getTypeMask(Type type) {
+    const U32 size = getTypeSize(type);
+    return (size >= 8) ? ~U64(0) : (U64(1) << (size * 8)) - 1;
+}
+
+// Get the zero-extended bits of an integer constant
+static U64 getConstantBits(const Value* value) {
+    switch (value->type) {
+    case TYPE_I8:   return U8(value->constant.i8);
+    case TYPE_I16:  return U16(value->constant.i16);
+    case TYPE_I32:  return U32(value->constant.i32);
+    case TYPE_I64:  return U64(value->constant.i64);
+    default:
+        assert_always("Unimplemented case");
+        return 0;
+    }
+}
+
+static bool isConstantOne(const Value* value) {
+    return value->isConstant() && getConstantBits(value) == 1;
+}
+
+static bool isConstantAllOnes(const Value* value) {
+    return value->isConstant() && getConstantBits(value) == getTypeMask(value->type);
+}
+
+static Value* createConstant(Arena& arena, Type type, U64 bits) {
+    Value* value = arena.create<Value>();
+    value->flags = 0;
+    value->usage = 0;
+    value->reg = 0;
+    switch (type) {
+    case TYPE_I8:   value->setConstantI8(bits);   break;
+    case TYPE_I16:  value->setConstantI16(bits);  break;
+    case TYPE_I32:  value->setConstantI32(bits);  break;
+    case TYPE_I64:  value->setConstantI64(bits);  break;
+    default:
+        assert_always("Unimplemented case");
+    }
+    return value;
+}
+
+static Value* cloneConstant(Arena& arena, const Value* source) {
+    Value* value = arena.create<Value>();
+    value->type = source->type;
+    value->flags = VALUE_IS_CONSTANT;
+    value->usage = 0;
+    value->reg = 0;
+    value->constant = source->constant;
+    return value;
+}
+
+void ConstantPropagationPass::replaceSources(Instruction* i) {
+    const auto& info = opcodeInfo[i->opcode];
+    const std::pair<U8, Instruction::Operand*> sources[] = {
+        { info.getSignatureSrc1(), &i->src1 },
+        { info.getSignatureSrc2(), &i->src2 },
+        { info.getSignatureSrc3(), &i->src3 },
+    };
+    for (const auto& source : sources) {
+        Instruction::Operand* operand = source.second;
+        if (!isValueOperand(source.first, operand->value)) {
+            continue;
+        }
+        Value* value = operand->value;
+        auto it = replacements.find(value);
+        if (it == replacements.end()) {
+            continue;
+        }
+        // Follow chains of replacements
+        while (it != replacements.end()) {
+            value = it->second;
+            it = replacements.find(value);
+        }
+        operand->value->usage -= 1;
+        operand->setValue(value);
+    }
+}
+
+Value* ConstantPropagationPass::foldConstants(Instruction* i) {
+    const auto& info = opcodeInfo[i->opcode];
+    const std::pair<U8, Value*> sources[] = {
+        { info.getSignatureSrc1(), i->src1.value },
+        { info.getSignatureSrc2(), i->src2.value },
+        { info.getSignatureSrc3(), i->src3.value },
+    };
+    for (const auto& source : sources) {
+        if (isValueOperand(source.first, source.second) && !source.second->isConstant()) {
+            return nullptr;
+        }
+    }
+
+    Value* lhs = i->src1.value;
+    Value* rhs = i->src2.value;
+    Value* result;
+
+    // Operations valid for any type
+    switch (i->opcode) {
+    case OPCODE_SELECT:
+        return lhs->isConstantTrue() ? rhs : i->src3.value;
+
+    case OPCODE_CMP:
+        // Floating-point comparisons are left to the target, which handles unordered operands
+        if (!lhs->isTypeInteger()) {
+            return nullptr;
+        }
+        result = cloneConstant(i->parent->parent->arena, lhs);
+        result->doCompare(rhs, static_cast<CompareFlags>(i->flags));
+        return result;
+
+    case OPCODE_CAST:
+        if (getTypeSize(lhs->type) != getTypeSize(i->dest->type)) {
+            return nullptr;
+        }
+        result = cloneConstant(i->parent->parent->arena, lhs);
+        result->doCast(i->dest->type);
+        return result;
+
+    default:
+        break;
+    }
+
+    // Remaining operations are only evaluated on integers
+    if (!lhs->isTypeInteger()) {
+        return nullptr;
+    }
+    const U32 bits = getTypeSize(lhs->type) * 8;
+
+    // Divisions by zero, overflowing divisions and oversized shifts are left to the target
+    switch (i->opcode) {
+    case OPCODE_DIV:
+        if (getConstantBits(rhs) == 0) {
+            return nullptr;
+        }
+        if (!(i->flags & ARITHMETIC_UNSIGNED) && isConstantAllOnes(rhs) &&
+            getConstantBits(lhs) == (U64(1) << (bits - 1))) {
+            return nullptr;
+        }
+        break;
+    case OPCODE_SHL:
+    case OPCODE_SHR:
+    case OPCODE_SHRA:
+        if (getConstantBits(rhs) >= bits) {
+            return nullptr;
+        }
+        break;
+    case OPCODE_CONVERT:
+        return nullptr;
+    default:
+        break;
+    }
+
+    result = cloneConstant(i->parent->parent->arena, lhs);
+    switch (i->opcode) {
+    case OPCODE_ADD:    result->doAdd(rhs);  break;
+    case OPCODE_SUB:    result->doSub(rhs);  break;
+    case OPCODE_MUL:    result->doMul(rhs, static_cast<ArithmeticFlags>(i->flags));   break;
+    case OPCODE_MULH:   result->doMulH(rhs, static_cast<ArithmeticFlags>(i->flags));  break;
+    case OPCODE_DIV:    result->doDiv(rhs, static_cast<ArithmeticFlags>(i->flags));   break;
+    case OPCODE_NEG:    result->doNeg();     break;
+    case OPCODE_NOT:    result->doNot();     break;
+    case OPCODE_AND:    result->doAnd(rhs);  break;
+    case OPCODE_OR:     result->doOr(rhs);   break;
+    case OPCODE_XOR:    result->doXor(rhs);  break;
+    case OPCODE_SHL:    result->doShl(rhs);  break;
+    case OPCODE_SHR:    result->doShr(rhs);  break;
+    case OPCODE_SHRA:   result->doShrA(rhs); break;
+    case OPCODE_ROL:    result->doRol(rhs);  break;
+    case OPCODE_ROR:    result->doRor(rhs);  break;
+    case OPCODE_ZEXT:   result->doZExt(i->dest->type);   break;
+    case OPCODE_SEXT:   result->doSExt(i->dest->type);   break;
+    case OPCODE_TRUNC:  result->doTrunc(i->dest->type);  break;
+    default:
+        return nullptr;
+    }
+    return result;
+}
+
+Value* ConstantPropagationPass::simplifyIdentities(Instruction* i) {
+    Value* lhs = i->src1.value;
+    Value* rhs = i->src2.value;
+
+    // Operations valid for any type
+    switch (i->opcode) {
+    case OPCODE_SELECT:
+        if (lhs->isConstant()) {
+            return lhs->isConstantTrue() ? rhs : i->src3.value;
+        }
+        if (rhs == i->src3.value) {
+            return rhs;
+        }
+        return nullptr;
+
+    case OPCODE_ZEXT:
+    case OPCODE_SEXT:
+    case OPCODE_TRUNC:
+    case OPCODE_CAST:
+    case OPCODE_CONVERT:
+        return (lhs->type == i->dest->type) ? lhs : nullptr;
+
+    default:
+        break;
+    }
+
+    // Identities below do not hold for floating-point values (NaNs, signed zeros)
+    if (!lhs->isTypeInteger()) {
+        return nullptr;
+    }
+
+    switch (i->opcode) {
+    case OPCODE_ADD:
+        if (lhs->isConstantZero()) { return rhs; }
+        if (rhs->isConstantZero()) { return lhs; }
+        break;
+
+    case OPCODE_SUB:
+        if (rhs->isConstantZero()) { return lhs; }
+        if (lhs == rhs) { return createConstant(i->parent->parent->arena, lhs->type, 0); }
+        break;
+
+    case OPCODE_MUL:
+        if (isConstantOne(lhs)) { return rhs; }
+        if (isConstantOne(rhs)) { return lhs; }
+        if (lhs->isConstantZero()) { return lhs; }
+        if (rhs->isConstantZero()) { return rhs; }
+        break;
+
+    case OPCODE_MULH:
+        if (lhs->isConstantZero()) { return lhs; }
+        if (rhs->isConstantZero()) { return rhs; }
+        break;
+
+    case OPCODE_DIV:
+        if (isConstantOne(rhs)) { return lhs; }
+        break;
+
+    case OPCODE_AND:
+        if (lhs->isConstantZero()) { return lhs; }
+        if (rhs->isConstantZero()) { return rhs; }
+        if (isConstantAllOnes(lhs)) { return rhs; }
+        if (isConstantAllOnes(rhs)) { return lhs; }
+        if (lhs == rhs) { return lhs; }
+        break;
+
+    case OPCODE_OR:
+        if (lhs->isConstantZero()) { return rhs; }
+        if (rhs->isConstantZero()) { return lhs; }
+        if (isConstantAllOnes(lhs)) { return lhs; }
+        if (isConstantAllOnes(rhs)) { return rhs; }
+        if (lhs == rhs) { return lhs; }
+        break;
+
+    case OPCODE_XOR:
+        if (lhs->isConstantZero()) { return rhs; }
+        if (rhs->isConstantZero()) { return lhs; }
+        if (lhs == rhs) { return createConstant(i->parent->parent->arena, lhs->type, 0); }
+        break;
+
+    case OPCODE_SHL:
+    case OPCODE_SHR:
+    case OPCODE_SHRA:
+    case OPCODE_ROL:
+    case OPCODE_ROR:
+        if (lhs->isConstantZero()) { return lhs; }
+        if (rhs->isConstantZero()) { return lhs; }
+        break;
+
+    case OPCODE_CMP:
+        // Floating-point values are unordered with themselves if NaN (e.g. `fcmpu crN, fX, fX`)
+        if (lhs == rhs && lhs->isTypeInteger()) {
+            switch (i->flags) {
+            case COMPARE_EQ:
+            case COMPARE_SLE:
+            case COMPARE_SGE:
+            case COMPARE_ULE:
+            case COMPARE_UGE:
+                return createConstant(i->parent->parent->arena, TYPE_I8, 1);
+            default:
+                return createConstant(i->parent->parent->arena, TYPE_I8, 0);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+    return nullptr;
+}
+
+Value* ConstantPropagationPass::forwardContextConstants(Instruction* i) {
+    switch (i->opcode) {
+    case OPCODE_CTXSTORE: {
+        const U64 offset = i->src1.immediate;
+        const U32 size = getTypeSize(i->src2.value->type);
+
+        // Forget any constant overlapping the stored bytes
+        for (auto it = contextConstants.begin(); it != contextConstants.end();) {
+            const U64 itOffset = it->first;
+            const U32 itSize = getTypeSize(it->second->type);
+            if (itOffset < offset + size && offset < itOffset + itSize) {
+                it = contextConstants.erase(it);
+            } else {
+                it++;
+            }
+        }
+        if (i->src2.value->isConstant()) {
+            contextConstants[offset] = i->src2.value;
+        }
+        return nullptr;
+    }
+    case OPCODE_CTXLOAD: {
+        auto it = contextConstants.find(i->src1.immediate);
+        if (it != contextConstants.end() && it->second->type == i->dest->type) {
+            return it->second;
+        }
+        return nullptr;
+    }
+    case OPCODE_CALL:
+    case OPCODE_CALLCOND:
+        contextConstants.clear();
+        return nullptr;
+
+    default:
+        return nullptr;
+    }
+}
+
+bool ConstantPropagationPass::run(Function* function) {
+    // Check function flags
+    if (!function || !(function->flags & FUNCTION_IS_DEFINED)) {
+        return false;
+    }
+
+    U32 folded = 0;
+    bool changed = true;
+    replacements.clear();
+
+    // Replacements might affect instructions visited earlier (e.g. in loops), so iterate until nothing changes
+    while (changed) {
+        changed = false;
+        for (auto& block : function->blocks) {
+            contextConstants.clear();
+
+            auto& instructions = block->instructions;
+            for (auto it = instructions.begin(); it != instructions.end();) {
+                Instruction* i = *it;
+                replaceSources(i);
+
+                // Turn conditional branches on constants into unconditional ones or fall-throughs
+                if (i->opcode == OPCODE_BRCOND && i->src1.value->isConstant()) {
+                    Value* cond = i->src1.value;
+                    cond->usage -= 1;
+                    if (cond->isConstantTrue()) {
+                        i->opcode = OPCODE_BR;
+                        i->src1.block = i->src2.block;
+                        i->src2.block = nullptr;
+                        it++;
+                    } else {
+                        it = instructions.erase(it);
+                    }
+                    folded += 1;
+                    changed = true;
+                    continue;
+                }
+
+                Value* result = forwardContextConstants(i);
+                if (!result && isFoldable(i->opcode)) {
+                    result = foldConstants(i);
+                    if (!result) {
+                        result = simplifyIdentities(i);
+                    }
+                }
+                if (!result) {
+                    it++;
+                    continue;
+                }
+
+                // Replace the destination and release the sources of the instruction
+                replacements[i->dest] = result;
+                const auto& info = opcodeInfo[i->opcode];
+                const std::pair<U8, Value*> sources[] = {
+                    { info.getSignatureSrc1(), i->src1.value },
+                    { info.getSignatureSrc2(), i->src2.value },
+                    { info.getSignatureSrc3(), i->src3.value },
+                };
+                for (const auto& source : sources) {
+                    if (isValueOperand(source.first, source.second)) {
+                        source.second->usage -= 1;
+                    }
+                }
+                it = instructions.erase(it);
+                folded += 1;
+                changed = true;
+            }
+        }
+    }
+
+    lastFoldedCount = folded;
+    totalFoldedCount += folded;
+    return true;
+}
+
+}  // namespace passes
+}  // namespace hir
+}  // namespace cpu
@@ -0,0 +1,93 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/hir/pass.h"
+
+#include <map>
+#include <unordered_map>
+
+namespace cpu {
+namespace hir {
+namespace passes {
+
+/**
+ * Constant Propagation Pass
+ * =========================
+ * Evaluates instructions whose sources are constant (arithmetic, shifts, conversions,
+ * comparisons and selects) and replaces every use of their results with the computed
+ * constants. Algebraic identities like `x+0`, `x*1`, `x&0` or `x^x` are simplified even
+ * if only some of the sources are known. Conditional branches on constant conditions
+ * become unconditional branches, or are removed if control falls through.
+ *
+ * Constants stored to the context are forwarded to later context loads of the same
+ * bytes in the same block, so that sequences like `lis r3, 0x1234; ori r3, r3, 0x5678`
+ * produce a single constant. The process repeats until no further changes happen.
+ *
+ * Notes:
+ * - Replaced instructions are removed, but their now unused sources are not.
+ *   Running the DeadCodeEliminationPass afterwards is recommended.
+ * - Calls are assumed to modify the whole context.
+ */
+class ConstantPropagationPass : public Pass {
+    // Values that replace the destination of removed instructions
+    std::unordered_map<Value*, Value*> replacements;
+
+    // Constants stored to the context in the current block, indexed by offset
+    std::map<U64, Value*> contextConstants;
+
+    /**
+     * Replace the sources of an instruction according to Value replacements
+     * @param[in]  i  Instruction whose sources will be updated
+     */
+    void replaceSources(Instruction* i);
+
+    /**
+     * Evaluate an instruction whose sources are constant
+     * @param[in]  i  Instruction to be evaluated
+     * @return        Constant result, or nullptr if the instruction cannot be evaluated
+     */
+    Value* foldConstants(Instruction* i);
+
+    /**
+     * Simplify an instruction whose result does not depend on all of its sources
+     * @param[in]  i  Instruction to be simplified
+     * @return        Value equivalent to the result, or nullptr if no simplification applies
+     */
+    Value* simplifyIdentities(Instruction* i);
+
+    /**
+     * Track context stores and forward stored constants to context loads
+     * @param[in]  i  Instruction to be processed
+     * @return        Constant read by a context load, or nullptr if unknown
+     */
+    Value* forwardContextConstants(Instruction* i);
+
+public:
+    // Number of instructions folded in the last function processed
+    U32 lastFoldedCount = 0;
+
+    // Number of instructions folded since the creation of this pass
+    U64 totalFoldedCount = 0;
+
+    // Get the name of this pass
+    const char* name() override {
+        return "Constant Propagation";
+    }
+
+    // Create a copy of this pass for another compilation thread
+    std::unique_ptr<Pass> clone() const override {
+        return std::make_unique<ConstantPropagationPass>(*this);
+    }
+
+    // Apply this pass on a function
+    bool run(Function* function) override;
+};
+
+}  // namespace passes
+}  // namespace hir
+}  // namespace cpu
@@ -0,0 +1,446 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "context_caching_pass.h"
+#include "nucleus/cpu/hir/block.h"
+#include "nucleus/cpu/hir/instruction.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace cpu {
+namespace hir {
+namespace passes {
+
+static bool isValueOperand(U8 sigType, const Value* value) {
+    return sigType == OPCODE_SIG_TYPE_V || (sigType == OPCODE_SIG_TYPE_M && value != nullptr);
+}
+
+static const Function* getCallee(const Instruction* i) {
+    return (i->opcode == OPCODE_CALL) ? i->src1.function : i->src2.function;
+}
+
+static size_t getEntryIndex(const Function* function) {
+    for (size_t index = 0; index < function->blocks.size(); index++) {
+        if (function->blocks[index]->flags & BLOCK_IS_ENTRY) {
+            return index;
+        }
+    }
+    return 0;
+}
+
+// Check whether two sets of known values cover the same context bytes with the same types
+static bool haveSameLayout(const std::map<U64, Value*>& lhs, const std::map<U64, Value*>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const auto& a, const auto& b) {
+        return a.first == b.first && a.second->type == b.second->type;
+    });
+}
+
+// Forget known values overlapping the given context bytes
+static void killValues(std::map<U64, Value*>& values, U64 offset, U32 size) {
+    for (auto it = values.begin(); it != values.end();) {
+        const U64 itOffset = it->first;
+        const U32 itSize = getTypeSize(it->second->type);
+        if (itOffset < offset + size && offset < itOffset + itSize) {
+            it = values.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+void ContextCachingPass::computeEdges(Function* function) {
+    const size_t count = function->blocks.size();
+    predecessors.assign(count, {});
+    successors.assign(count, {});
+
+    std::unordered_map<const Block*, size_t> indices;
+    for (size_t index = 0; index < count; index++) {
+        indices[function->blocks[index]] = index;
+    }
+    for (size_t index = 0; index < count; index++) {
+        for (const auto& block : function->getSuccessors(index)) {
+            const size_t succ = indices.at(block);
+            successors[index].push_back(succ);
+            predecessors[succ].push_back(index);
+        }
+    }
+}
+
+U32 ContextCachingPass::transferValues(Block* block, ContextValues& values, bool apply) {
+    U32 removed = 0;
+
+    auto& instructions = block->instructions;
+    for (auto it = instructions.begin(); it != instructions.end();) {
+        Instruction* i = *it;
+        switch (i->opcode) {
+        case OPCODE_CTXLOAD: {
+            const U64 offset = i->src1.immediate;
+            const auto known = values.find(offset);
+            if (known != values.end() && known->second->type == i->dest->type) {
+                if (apply) {
+                    replacements[i->dest] = known->second;
+                    it = instructions.erase(it);
+                    removed += 1;
+                    continue;
+                }
+            } else {
+                killValues(values, offset, getTypeSize(i->dest->type));
+                values[offset] = i->dest;
+            }
+            break;
+        }
+        case OPCODE_CTXSTORE: {
+            const U64 offset = i->src1.immediate;
+            killValues(values, offset, getTypeSize(i->src2.value->type));
+            values[offset] = i->src2.value;
+            break;
+        }
+        case OPCODE_CALL:
+        case OPCODE_CALLCOND: {
+            const auto& access = getCallee(i)->contextAccess;
+            for (auto value = values.begin(); value != values.end();) {
+                if (access.mayWrite(value->first, getTypeSize(value->second->type))) {
+                    value = values.erase(value);
+                } else {
+                    value++;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+        }
+        it++;
+    }
+    return removed;
+}
+
+U32 ContextCachingPass::transferBytes(Block* block, ContextBytes& bytes, bool apply) {
+    U32 removed = 0;
+
+    auto& instructions = block->instructions;
+    for (auto it = instructions.rbegin(); it != instructions.rend();) {
+        Instruction* i = *it;
+        switch (i->opcode) {
+        case OPCODE_CTXSTORE: {
+            const U64 offset = i->src1.immediate;
+            const U32 size = getTypeSize(i->src2.value->type);
+            bool isDead = true;
+            for (U32 byte = 0; byte < size; byte++) {
+                isDead &= bytes.count(offset + byte) != 0;
+                bytes.insert(offset + byte);
+            }
+            if (apply && isDead) {
+                i->src2.value->usage -= 1;
+                it = InstructionList::reverse_iterator(instructions.erase(std::next(it).base()));
+                removed += 1;
+                continue;
+            }
+            break;
+        }
+        case OPCODE_CTXLOAD: {
+            const U64 offset = i->src1.immediate;
+            const U32 size = getTypeSize(i->dest->type);
+            for (U32 byte = 0; byte < size; byte++) {
+                bytes.erase(offset + byte);
+            }
+            break;
+        }
+        case OPCODE_CALL:
+        case OPCODE_CALLCOND: {
+            const auto& access = getCallee(i)->contextAccess;
+            if (!access.known) {
+                bytes.clear();
+                break;
+            }
+            for (auto byte = bytes.begin(); byte != bytes.end();) {
+                if (access.mayRead(*byte, 1)) {
+                    byte = bytes.erase(byte);
+                } else {
+                    byte++;
+                }
+            }
+            break;
+        }
+        case OPCODE_RET:
+            bytes.clear();
+            break;
+        default:
+            break;
+        }
+        it++;
+    }
+    return removed;
+}
+
+U32 ContextCachingPass::forwardContextValues(Function* function) {
+    const size_t count = function->blocks.size();
+    const size_t entry = getEntryIndex(function);
+
+    // Values known at the end of each block, if the block has been visited. During the analysis,
+    // these values only tell which context bytes are known and with which type.
+    std::vector<ContextValues> valuesOut(count);
+    std::vector<bool> visited(count, false);
+
+    // Get the context bytes known at the start of a block, returns false if no predecessor has been visited
+    auto getValuesIn = [&](size_t index, ContextValues& values) -> bool {
+        values.clear();
+        if (index == entry || predecessors[index].empty()) {
+            return true;
+        }
+        bool first = true;
+        for (const auto& pred : predecessors[index]) {
+            if (!visited[pred]) {
+                continue;
+            }
+            if (first) {
+                values = valuesOut[pred];
+                first = false;
+                continue;
+            }
+            for (auto it = values.begin(); it != values.end();) {
+                const auto other = valuesOut[pred].find(it->first);
+                if (other == valuesOut[pred].end() || other->second->type != it->second->type) {
+                    it = values.erase(it);
+                } else {
+                    it++;
+                }
+            }
+        }
+        return !first;
+    };
+
+    // Iterate until the context bytes known at the end of each block stabilize
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t index = 0; index < count; index++) {
+            ContextValues values;
+            if (!getValuesIn(index, values)) {
+                continue;
+            }
+            transferValues(function->blocks[index], values, false);
+            if (!visited[index] || !haveSameLayout(values, valuesOut[index])) {
+                valuesOut[index] = std::move(values);
+                visited[index] = true;
+                changed = true;
+            }
+        }
+    }
+
+    // Remove loads of known values (blocks never visited are unreachable). Predecessors that disagree
+    // on a value, or that have not been processed yet (loops), get it merged by a phi node.
+    U32 removed = 0;
+    replacements.clear();
+    phis.clear();
+    std::vector<ContextValues> actualOut(count);
+    for (size_t index = 0; index < count; index++) {
+        ContextValues values;
+        getValuesIn(index, values);
+        for (auto& known : values) {
+            Value* value = nullptr;
+            bool isMerged = false;
+            for (const auto& pred : predecessors[index]) {
+                if (!visited[pred]) {
+                    continue;
+                }
+                Value* incoming = (pred < index) ? actualOut[pred].at(known.first) : nullptr;
+                if (!incoming || (value && value != incoming)) {
+                    isMerged = true;
+                    break;
+                }
+                value = incoming;
+            }
+            if (isMerged) {
+                value = function->arena.create<Value>();
+                value->type = known.second->type;
+                phis.push_back({ index, known.first, value });
+            }
+            known.second = value;
+        }
+        removed += transferValues(function->blocks[index], values, true);
+        if (visited[index]) {
+            actualOut[index] = std::move(values);
+        }
+    }
+    insertPhis(function, actualOut);
+    if (replacements.empty()) {
+        return removed;
+    }
+
+    // Replace the uses of the removed loads and placeholders
+    for (auto& block : function->blocks) {
+        for (auto* i : block->instructions) {
+            const auto& info = opcodeInfo[i->opcode];
+            const std::pair<U8, Instruction::Operand*> sources[] = {
+                { info.getSignatureSrc1(), &i->src1 },
+                { info.getSignatureSrc2(), &i->src2 },
+                { info.getSignatureSrc3(), &i->src3 },
+            };
+            for (const auto& source : sources) {
+                Instruction::Operand* operand = source.second;
+                if (!isValueOperand(source.first, operand->value)) {
+                    continue;
+                }
+                Value* value = resolve(operand->value);
+                if (value == operand->value) {
+                    continue;
+                }
+                operand->value->usage -= 1;
+                operand->setValue(value);
+            }
+        }
+    }
+    return removed;
+}
+
+void ContextCachingPass::insertPhis(Function* function, const std::vector<ContextValues>& valuesOut) {
+    auto getIncoming = [&](const PendingPhi& phi, size_t pred) -> Value* {
+        const auto it = valuesOut[pred].find(phi.offset);
+        return (it != valuesOut[pred].end()) ? resolve(it->second) : nullptr;
+    };
+
+    // Phi nodes merging a single value (besides themselves) are replaced by that value
+    std::vector<bool> isTrivial(phis.size(), false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t p = 0; p < phis.size(); p++) {
+            const PendingPhi& phi = phis[p];
+            if (isTrivial[p]) {
+                continue;
+            }
+            Value* same = nullptr;
+            bool isUnique = true;
+            for (const auto& pred : predecessors[phi.block]) {
+                Value* incoming = getIncoming(phi, pred);
+                if (!incoming || incoming == phi.placeholder || incoming == same) {
+                    continue;
+                }
+                if (same) {
+                    isUnique = false;
+                    break;
+                }
+                same = incoming;
+            }
+            if (isUnique && same) {
+                replacements[phi.placeholder] = same;
+                isTrivial[p] = true;
+                changed = true;
+            }
+        }
+    }
+
+    // Place the remaining ones at the start of their blocks
+    for (size_t p = 0; p < phis.size(); p++) {
+        const PendingPhi& phi = phis[p];
+        if (isTrivial[p]) {
+            continue;
+        }
+        std::vector<std::pair<Value*, Block*>> incoming;
+        for (const auto& pred : predecessors[phi.block]) {
+            Value* value = getIncoming(phi, pred);
+            if (value) {
+                incoming.push_back({ value, function->blocks[pred] });
+            }
+        }
+        builder.setInsertPoint(function->blocks[phi.block]);
+        replacements[phi.placeholder] = builder.createPhi(incoming);
+        lastPhisInserted += 1;
+    }
+}
+
+Value* ContextCachingPass::resolve(Value* value) const {
+    auto it = replacements.find(value);
+    while (it != replacements.end()) {
+        value = it->second;
+        it = replacements.find(value);
+    }
+    return value;
+}
+
+U32 ContextCachingPass::removeDeadContextStores(Function* function) {
+    const size_t count = function->blocks.size();
+
+    // Bytes overwritten at the start of each block, if the block has been visited
+    std::vector<ContextBytes> bytesIn(count);
+    std::vector<bool> visited(count, false);
+
+    // Get the bytes overwritten at the end of a block, returns false if no successor has been visited
+    auto getBytesOut = [&](size_t index, ContextBytes& bytes) -> bool {
+        bytes.clear();
+        if (successors[index].empty()) {
+            return true;
+        }
+        bool first = true;
+        for (const auto& succ : successors[index]) {
+            if (!visited[succ]) {
+                continue;
+            }
+            if (first) {
+                bytes = bytesIn[succ];
+                first = false;
+                continue;
+            }
+            for (auto it = bytes.begin(); it != bytes.end();) {
+                if (bytesIn[succ].count(*it) == 0) {
+                    it = bytes.erase(it);
+                } else {
+                    it++;
+                }
+            }
+        }
+        return !first;
+    };
+
+    // Iterate backwards until the bytes overwritten at the start of each block stabilize
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t index = count; index-- > 0;) {
+            ContextBytes bytes;
+            if (!getBytesOut(index, bytes)) {
+                continue;
+            }
+            transferBytes(function->blocks[index], bytes, false);
+            if (!visited[index] || bytes != bytesIn[index]) {
+                bytesIn[index] = std::move(bytes);
+                visited[index] = true;
+                changed = true;
+            }
+        }
+    }
+
+    // Remove dead stores (blocks never visited cannot reach any exit, so nothing is assumed about them)
+    U32 removed = 0;
+    for (size_t index = 0; index < count; index++) {
+        ContextBytes bytes;
+        if (getBytesOut(index, bytes)) {
+            removed += transferBytes(function->blocks[index], bytes, true);
+        }
+    }
+    return removed;
+}
+
+bool ContextCachingPass::run(Function* function) {
+    // Check function flags
+    if (!function || !(function->flags & FUNCTION_IS_DEFINED)) {
+        return false;
+    }
+
+    computeEdges(function);
+    lastPhisInserted = 0;
+    lastLoadsRemoved = forwardContextValues(function);
+    lastStoresRemoved = removeDeadContextStores(function);
+    totalLoadsRemoved += lastLoadsRemoved;
+    totalStoresRemoved += lastStoresRemoved;
+    totalPhisInserted += lastPhisInserted;
+    return true;
+}
+
+}  // namespace passes
+}  // namespace hir
+}  // namespace cpu
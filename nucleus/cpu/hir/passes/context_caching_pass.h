@@ -0,0 +1,144 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/hir/builder.h"
+#include "nucleus/cpu/hir/pass.h"
+
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace cpu {
+namespace hir {
+namespace passes {
+
+/**
+ * Context Caching Pass
+ * ====================
+ * Frontends access guest registers through context loads and stores. This pass keeps
+ * those registers in HIR values across the whole function:
+ *
+ * 1. Forwarding: Context loads are replaced with the value last stored to (or loaded
+ *    from) the same context bytes, if such a value is available in every path reaching
+ *    the load. At join points where predecessors hold different values, or where some
+ *    predecessor closes a loop, the values are merged with phi nodes. This builds the
+ *    SSA form of the guest registers accessed by the function, so that they can stay in
+ *    host registers across blocks.
+ *
+ * 2. Sinking: Context stores whose bytes are overwritten before being read in every
+ *    path are removed, so that a register written several times only gets stored at
+ *    the last write preceding a block exit, call or return.
+ *
+ * Calls are assumed to read and write the whole context, unless the callee provides
+ * its context accesses (see ContextAccess). Returns are assumed to read the whole context.
+ */
+class ContextCachingPass : public Pass {
+    // Value of the context bytes starting at each offset
+    using ContextValues = std::map<U64, Value*>;
+
+    // Context bytes overwritten before being read
+    using ContextBytes = std::set<U64>;
+
+    // Edges of the control flow graph of the current function
+    std::vector<std::vector<size_t>> predecessors;
+    std::vector<std::vector<size_t>> successors;
+
+    // Values that replace the destination of removed context loads
+    std::unordered_map<Value*, Value*> replacements;
+
+    // Phi nodes required at the start of a block, referenced by a placeholder until they are inserted
+    struct PendingPhi {
+        size_t block;
+        U64 offset;
+        Value* placeholder;
+    };
+    std::vector<PendingPhi> phis;
+
+    Builder builder;
+
+    /**
+     * Compute the predecessors and successors of every block
+     * @param[in]  function  Function to be analyzed
+     */
+    void computeEdges(Function* function);
+
+    /**
+     * Update the known context values after each instruction of a block
+     * @param[in]     block   Block to be processed
+     * @param[in,out] values  Context values known at the start/end of the block
+     * @param[in]     apply   Remove context loads whose value is known
+     * @return                Number of removed instructions
+     */
+    U32 transferValues(Block* block, ContextValues& values, bool apply);
+
+    /**
+     * Update the overwritten context bytes before each instruction of a block, in reverse order
+     * @param[in]     block  Block to be processed
+     * @param[in,out] bytes  Context bytes overwritten at the end/start of the block
+     * @param[in]     apply  Remove context stores whose bytes are overwritten
+     * @return               Number of removed instructions
+     */
+    U32 transferBytes(Block* block, ContextBytes& bytes, bool apply);
+
+    /**
+     * Replace context loads with known values
+     * @param[in]  function  Function to be processed
+     * @return               Number of removed instructions
+     */
+    U32 forwardContextValues(Function* function);
+
+    /**
+     * Insert the pending phi nodes, replacing those whose incoming values are all the same
+     * @param[in]  function   Function to be processed
+     * @param[in]  valuesOut  Context values known at the end of each block
+     */
+    void insertPhis(Function* function, const std::vector<ContextValues>& valuesOut);
+
+    /**
+     * Get the value replacing a removed context load or a phi node placeholder
+     * @param[in]  value  Value to be resolved
+     * @return            Replacement value, or the same value if it is not replaced
+     */
+    Value* resolve(Value* value) const;
+
+    /**
+     * Remove context stores overwritten before being read
+     * @param[in]  function  Function to be processed
+     * @return               Number of removed instructions
+     */
+    U32 removeDeadContextStores(Function* function);
+
+public:
+    // Number of context loads and stores removed, and phi nodes inserted, in the last function processed
+    U32 lastLoadsRemoved = 0;
+    U32 lastStoresRemoved = 0;
+    U32 lastPhisInserted = 0;
+
+    // Number of context loads and stores removed, and phi nodes inserted, since the creation of this pass
+    U64 totalLoadsRemoved = 0;
+    U64 totalStoresRemoved = 0;
+    U64 totalPhisInserted = 0;
+
+    // Get the name of this pass
+    const char* name() override {
+        return "Context Caching";
+    }
+
+    // Create a copy of this pass for another compilation thread
+    std::unique_ptr<Pass> clone() const override {
+        return std::make_unique<ContextCachingPass>(*this);
+    }
+
+    // Apply this pass on a function
+    bool run(Function* function) override;
+};
+
+}  // namespace passes
+}  // namespace hir
+}  // namespace cpu
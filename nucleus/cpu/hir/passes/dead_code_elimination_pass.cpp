@@ -4,17 +4,140 @@
  */
 
 #include "dead_code_elimination_pass.h"
+#include "nucleus/cpu/hir/block.h"
+#include "nucleus/cpu/hir/instruction.h"
+
+#include <unordered_set>
+#include <vector>
 
 namespace cpu {
 namespace hir {
 namespace passes {
 
+static bool isValueOperand(U8 sigType, const Value* value) {
+    return sigType == OPCODE_SIG_TYPE_V || (sigType == OPCODE_SIG_TYPE_M && value != nullptr);
+}
+
+static bool isRemovable(const Instruction* i) {
+    const auto& info = opcodeInfo[i->opcode];
+    if (info.flags & OPCODE_FLAG_VOLATILE) {
+        return false;
+    }
+    return isValueOperand(info.getSignatureDest(), i->dest) && i->dest->usage == 0;
+}
+
+U32 DeadCodeEliminationPass::removeDeadContextStores(Block* block) {
+    U32 removed = 0;
+
+    // Context bytes written later in the block without being read in between
+    std::unordered_set<U64> overwritten;
+
+    auto& instructions = block->instructions;
+    for (auto it = instructions.rbegin(); it != instructions.rend();) {
+        Instruction* i = *it;
+        if (i->opcode == OPCODE_CTXSTORE) {
+            const U64 offset = i->src1.immediate;
+            const U32 size = getTypeSize(i->src2.value->type);
+            bool isDead = true;
+            for (U32 byte = 0; byte < size; byte++) {
+                isDead &= overwritten.count(offset + byte) != 0;
+                overwritten.insert(offset + byte);
+            }
+            if (isDead) {
+                i->src2.value->usage -= 1;
+                it = InstructionList::reverse_iterator(instructions.erase(std::next(it).base()));
+                removed += 1;
+                continue;
+            }
+        } else if (i->opcode == OPCODE_CTXLOAD) {
+            const U64 offset = i->src1.immediate;
+            const U32 size = getTypeSize(i->dest->type);
+            for (U32 byte = 0; byte < size; byte++) {
+                overwritten.erase(offset + byte);
+            }
+        } else if (opcodeInfo[i->opcode].flags & OPCODE_FLAG_VOLATILE) {
+            // Calls, branches and memory accesses might read the context or leave the block
+            overwritten.clear();
+        }
+        it++;
+    }
+    return removed;
+}
+
+U32 DeadCodeEliminationPass::removeUnusedInstructions(Function* function) {
+    std::unordered_set<Instruction*> dead;
+    std::vector<Instruction*> worklist;
+
+    for (const auto& block : function->blocks) {
+        for (const auto& i : block->instructions) {
+            if (isRemovable(i)) {
+                dead.insert(i);
+                worklist.push_back(i);
+            }
+        }
+    }
+
+    // Release the sources of dead instructions, which might make their definitions dead as well
+    while (!worklist.empty()) {
+        Instruction* i = worklist.back();
+        worklist.pop_back();
+
+        const auto& info = opcodeInfo[i->opcode];
+        const std::pair<U8, Value*> sources[] = {
+            { info.getSignatureSrc1(), i->src1.value },
+            { info.getSignatureSrc2(), i->src2.value },
+            { info.getSignatureSrc3(), i->src3.value },
+        };
+        for (const auto& source : sources) {
+            Value* value = source.second;
+            if (!isValueOperand(source.first, value)) {
+                continue;
+            }
+            value->usage -= 1;
+            if (value->isConstant() || value->flags & VALUE_IS_ARGUMENT || value->usage != 0) {
+                continue;
+            }
+            Instruction* def = value->parent.instruction;
+            if (!def || dead.count(def) || !isRemovable(def)) {
+                continue;
+            }
+            dead.insert(def);
+            worklist.push_back(def);
+
+            // Phi nodes define their value once per incoming edge
+            if (def->opcode == OPCODE_PHI) {
+                for (const auto& phi : def->parent->instructions) {
+                    if (phi->opcode == OPCODE_PHI && phi->dest == value && !dead.count(phi)) {
+                        dead.insert(phi);
+                        worklist.push_back(phi);
+                    }
+                }
+            }
+        }
+    }
+
+    for (auto& block : function->blocks) {
+        block->instructions.remove_if([&](Instruction* i) {
+            return dead.count(i) != 0;
+        });
+    }
+    return dead.size();
+}
+
 bool DeadCodeEliminationPass::run(Function* function) {
     // Check function flags
     if (!function || !(function->flags & FUNCTION_IS_DEFINED)) {
         return false;
     }
 
+    U32 removed = 0;
+    for (auto& block : function->blocks) {
+        removed += removeDeadContextStores(block);
+    }
+    removed += removeUnusedInstructions(function);
+
+    lastRemovedCount = removed;
+    totalRemovedCount += removed;
     return true;
 }
 
@@ -12,16 +12,50 @@ namespace cpu {
 namespace hir {
 namespace passes {
 
+/**
+ * Dead Code Elimination Pass
+ * ==========================
+ * Removes instructions whose results are never used and have no side effects
+ * (see OPCODE_FLAG_VOLATILE), relying on Value::usage. Removing an instruction
+ * releases its sources, so whole chains of dead computations disappear at once.
+ *
+ * Additionally, context stores that are overwritten within the same block before
+ * being read (e.g. condition register and XER updates of consecutive record-form
+ * instructions) are removed. Other instructions with side effects, such as calls,
+ * are assumed to read the whole context.
+ */
 class DeadCodeEliminationPass : public Pass {
+    /**
+     * Remove context stores overwritten before being read in a block
+     * @param[in]  block  Block to be processed
+     * @return            Number of removed instructions
+     */
+    U32 removeDeadContextStores(Block* block);
+
+    /**
+     * Remove instructions without side effects whose destination is unused
+     * @param[in]  function  Function to be processed
+     * @return               Number of removed instructions
+     */
+    U32 removeUnusedInstructions(Function* function);
+
 public:
-    // Constructor
-    DeadCodeEliminationPass();
+    // Number of instructions removed from the last function processed
+    U32 lastRemovedCount = 0;
+
+    // Number of instructions removed since the creation of this pass
+    U64 totalRemovedCount = 0;
 
     // Get the name of this pass
     const char* name() override {
         return "Dead Code Elimination";
     }
 
+    // Create a copy of this pass for another compilation thread
+    std::unique_ptr<Pass> clone() const override {
+        return std::make_unique<DeadCodeEliminationPass>(*this);
+    }
+
     // Apply this pass on a function
     bool run(Function* function) override;
 };
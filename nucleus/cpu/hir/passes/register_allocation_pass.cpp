@@ -5,141 +5,565 @@
 
 #include "register_allocation_pass.h"
 #include "nucleus/cpu/hir/block.h"
+#include "nucleus/cpu/hir/builder.h"
 #include "nucleus/cpu/hir/instruction.h"
+#include "nucleus/logger/logger.h"
 #include "nucleus/assert.h"
 
+#include <algorithm>
+#include <bitset>
+
 namespace cpu {
 namespace hir {
 namespace passes {
 
-RegisterAllocationPass::RegisterAllocationPass(const backend::TargetInfo& targetInfo)
-    : targetInfo(targetInfo) {
-    for (const auto& regSet : targetInfo.regSets) {
-        RegSetUsage regUsage;
-        regUsage.regs.reset();
-        regUsage.count = regSet.valueIndex.size();
-        regUsage.types = regSet.types;
-        regUsages.push_back(regUsage);
+static bool isValueOperand(U8 sigType, const Value* value) {
+    return sigType == OPCODE_SIG_TYPE_V || (sigType == OPCODE_SIG_TYPE_M && value != nullptr);
+}
+
+static U32 getStackSlotSize(Type type) {
+    switch (type) {
+    case TYPE_V128:
+        return 16;
+    case TYPE_V256:
+        return 32;
+    default:
+        return 8;
+    }
+}
+
+RegisterAllocationPass::RegisterAllocationPass(const backend::TargetInfo& targetInfo, int maxRounds)
+    : targetInfo(targetInfo), maxRounds(maxRounds) {
+}
+
+int RegisterAllocationPass::getRegSetIndex(const Value* value) const {
+    for (size_t i = 0; i < targetInfo.regSets.size(); i++) {
+        const auto& regSet = targetInfo.regSets[i];
+        if (regSet.types & backend::RegisterSet::TYPE_INT && value->isTypeInteger() ||
+            regSet.types & backend::RegisterSet::TYPE_FLOAT && value->isTypeFloat() ||
+            regSet.types & backend::RegisterSet::TYPE_VECTOR && value->isTypeVector()) {
+            return i;
+        }
     }
+    return -1;
 }
 
 void RegisterAllocationPass::allocArgumentReg(int index, Value* arg) {
-    for (const auto& regSet : targetInfo.regSets) {
-        if (regSet.types & backend::RegisterSet::TYPE_INT && arg->isTypeInteger()) {
-            if (index < regSet.argIndex.size()) {
-                arg->reg = regSet.argIndex[index];
-                break;
+    // Arguments are counted per register set unless the target shares positions between them
+    if (index == 0) {
+        argCounts.assign(targetInfo.regSets.size(), 0);
+    }
+    const int setIndex = getRegSetIndex(arg);
+    if (setIndex < 0) {
+        assert_always("Unsupported argument type");
+        return;
+    }
+    const auto& regSet = targetInfo.regSets[setIndex];
+    const int slot = targetInfo.sharedArgSlots ? index : argCounts[setIndex]++;
+    if (slot >= regSet.argIndex.size()) {
+        assert_always("This pass does not support passing arguments in the stack yet");
+        return;
+    }
+    arg->reg = regSet.argIndex[slot];
+}
+
+void RegisterAllocationPass::numberInstructions(Function* function) {
+    positions.clear();
+    blockRanges.clear();
+    blockSuccessors.clear();
+    backEdges.clear();
+    callPositions.clear();
+    clobberPositions.clear();
+
+    U32 position = 0;
+    blockIndices.clear();
+    for (size_t b = 0; b < function->blocks.size(); b++) {
+        const Block* block = function->blocks[b];
+        blockIndices[block] = b;
+
+        Range range;
+        range.start = position;
+        for (const auto& i : block->instructions) {
+            if (i->opcode == OPCODE_CALL || i->opcode == OPCODE_CALLCOND) {
+                callPositions.push_back(position);
             }
+            if (opcodeInfo[i->opcode].flags & OPCODE_FLAG_CLOBBER) {
+                clobberPositions.push_back(position);
+            }
+            positions[i] = position++;
+        }
+        range.end = block->instructions.empty() ? range.start : position - 1;
+        blockRanges.push_back(range);
+    }
+
+    // Edges to blocks placed earlier in the function close loops
+    blockSuccessors.resize(function->blocks.size());
+    for (size_t b = 0; b < function->blocks.size(); b++) {
+        for (const auto& successor : function->getSuccessors(b)) {
+            const size_t s = blockIndices.at(successor);
+            blockSuccessors[b].push_back(s);
+            if (s <= b) {
+                backEdges.push_back({ blockRanges[s].start, blockRanges[b].end });
+            }
+        }
+    }
+}
+
+void RegisterAllocationPass::getDefUses(const Instruction* i, bool slots, Value*& def, std::vector<Value*>& uses) const {
+    def = nullptr;
+    uses.clear();
+
+    if (slots) {
+        if (i->opcode == OPCODE_LOCALSTORE) {
+            def = i->src2.value;
+        } else if (i->opcode == OPCODE_LOCALLOAD) {
+            uses.push_back(reloadSources.at(i->dest));
         }
-        // TODO: Float, vector
+        return;
+    }
+
+    // Argument values are placed in fixed registers
+    const auto& info = opcodeInfo[i->opcode];
+    if (i->opcode != OPCODE_ARG && isValueOperand(info.getSignatureDest(), i->dest)) {
+        def = i->dest;
+    }
+    if (isValueOperand(info.getSignatureSrc1(), i->src1.value) && !i->src1.value->isConstant()) {
+        uses.push_back(i->src1.value);
+    }
+    if (isValueOperand(info.getSignatureSrc2(), i->src2.value) && !i->src2.value->isConstant()) {
+        uses.push_back(i->src2.value);
+    }
+    if (isValueOperand(info.getSignatureSrc3(), i->src3.value) && !i->src3.value->isConstant()) {
+        uses.push_back(i->src3.value);
     }
 }
 
-bool RegisterAllocationPass::tryAllocValueReg(Value* value) {
-    // Nothing to alloc if value is unused
-    if (value->usage == 0) {
-        return true;
-    }
-    for (auto& regUsage : regUsages) {
-        if (regUsage.types & backend::RegisterSet::TYPE_INT && value->isTypeInteger() ||
-            regUsage.types & backend::RegisterSet::TYPE_FLOAT && value->isTypeFloat() ||
-            regUsage.types & backend::RegisterSet::TYPE_VECTOR && value->isTypeVector()) {
-            for (size_t i = 0; i < regUsage.count; i++) {
-                if (!regUsage.regs[i]) {
-                    regUsage.regs[i] = 1;
-                    value->reg = i;
-                    return true;
+void RegisterAllocationPass::computeLiveRanges(Function* function, bool slots, std::unordered_map<Value*, Range>& ranges) {
+    const size_t count = function->blocks.size();
+    std::vector<std::unordered_set<Value*>> gen(count);
+    std::vector<std::unordered_set<Value*>> kill(count);
+    std::vector<std::unordered_set<Value*>> liveIn(count);
+    std::vector<std::unordered_set<Value*>> liveOut(count);
+
+    ranges.clear();
+    auto extend = [&](Value* value, U32 position) {
+        auto it = ranges.find(value);
+        if (it == ranges.end()) {
+            ranges[value] = { position, position };
+        } else {
+            it->second.start = std::min(it->second.start, position);
+            it->second.end = std::max(it->second.end, position);
+        }
+    };
+
+    // Local definitions and uses
+    Value* def;
+    std::vector<Value*> uses;
+    std::unordered_set<Value*> defined;
+    std::vector<std::unordered_set<Value*>> phiUses(count);
+    for (size_t b = 0; b < count; b++) {
+        for (const auto& i : function->blocks[b]->instructions) {
+            const U32 position = positions.at(i);
+            getDefUses(i, slots, def, uses);
+
+            // Incoming values of phi nodes are copied at the end of their predecessor
+            if (i->opcode == OPCODE_PHI && !slots) {
+                const size_t pred = blockIndices.at(i->src2.block);
+                for (const auto& value : uses) {
+                    phiUses[pred].insert(value);
+                    extend(value, blockRanges[pred].end);
+                }
+                uses.clear();
+            }
+            for (const auto& value : uses) {
+                if (!kill[b].count(value)) {
+                    gen[b].insert(value);
                 }
+                extend(value, position);
+            }
+            if (def) {
+                kill[b].insert(def);
+                defined.insert(def);
+                extend(def, position);
             }
         }
     }
-    return false;
-}
 
-bool RegisterAllocationPass::tryFreeValueReg(Value* value) {
-    // Nothing to free if value is constant
-    if (value->isConstant()) {
-        return true;
+    // Propagate liveness backwards until reaching a fixed point
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t b = count; b-- > 0;) {
+            std::unordered_set<Value*> out = phiUses[b];
+            for (const auto& s : blockSuccessors[b]) {
+                out.insert(liveIn[s].begin(), liveIn[s].end());
+            }
+            std::unordered_set<Value*> in = gen[b];
+            for (const auto& value : out) {
+                if (!kill[b].count(value)) {
+                    in.insert(value);
+                }
+            }
+            if (in.size() != liveIn[b].size()) {
+                changed = true;
+            }
+            liveIn[b] = std::move(in);
+            liveOut[b] = std::move(out);
+        }
+    }
+
+    // Extend ranges over the blocks where the values are live
+    for (size_t b = 0; b < count; b++) {
+        for (const auto& value : liveIn[b]) {
+            extend(value, blockRanges[b].start);
+        }
+        for (const auto& value : liveOut[b]) {
+            extend(value, blockRanges[b].end);
+        }
     }
-    value->usage -= 1;
-    if (value->usage == 0) {
-        for (auto& regUsage : regUsages) {
-            if (regUsage.types & backend::RegisterSet::TYPE_INT && value->isTypeInteger() ||
-                regUsage.types & backend::RegisterSet::TYPE_FLOAT && value->isTypeFloat() ||
-                regUsage.types & backend::RegisterSet::TYPE_VECTOR && value->isTypeVector()) {
-                regUsage.regs[value->reg] = 0;
-                return true;
+
+    // Discard values not defined in this function (i.e. arguments)
+    if (!slots) {
+        argRanges.clear();
+    }
+    for (auto it = ranges.begin(); it != ranges.end();) {
+        if (!defined.count(it->first)) {
+            if (!slots) {
+                argRanges[it->first] = it->second;
             }
+            it = ranges.erase(it);
+        } else {
+            it++;
         }
     }
-    return false;
 }
 
-bool RegisterAllocationPass::run(Function* function) {
-    // Reset register usage
-    for (auto& regUsage : regUsages) {
-        regUsage.regs.reset();
+bool RegisterAllocationPass::canSplitAt(const Interval& interval, U32 position) const {
+    // A loop entered after the definition and closed after the split position could reach earlier uses
+    for (const auto& edge : backEdges) {
+        if (edge.start > interval.range.start && edge.start < position && edge.end >= position) {
+            return false;
+        }
     }
+    return true;
+}
 
-    // Arguments
-    for (int i = 0; i < function->args.size(); i++) {
-        auto& arg = function->args[i];
-        switch (arg->type) {
-        case TYPE_I8:
-        case TYPE_I16:
-        case TYPE_I32:
-        case TYPE_I64:
-            arg->reg = targetInfo.regSets[0].argIndex[i];
-            break;
+bool RegisterAllocationPass::allocateRegisters(std::vector<Interval>& intervals, std::vector<Spill>& spills) {
+    std::sort(intervals.begin(), intervals.end(), [](const Interval& lhs, const Interval& rhs) {
+        if (lhs.range.start != rhs.range.start) {
+            return lhs.range.start < rhs.range.start;
         }
-    }
+        return lhs.range.end < rhs.range.end;
+    });
 
-    // CFG values
-    for (auto& block : function->blocks) {
-        for (auto& i : block->instructions) {
-            // Handle call arguments
-            if (i->opcode == OPCODE_ARG) {
-                allocArgumentReg(i->src1.immediate, i->dest);
-                tryFreeValueReg(i->src2.value);
+    std::vector<std::bitset<32>> usedRegs(targetInfo.regSets.size());
+    std::vector<Interval*> active;
+
+    for (auto& current : intervals) {
+        // Free registers of intervals ending before the current one starts
+        for (auto it = active.begin(); it != active.end();) {
+            if ((*it)->range.end < current.range.start) {
+                usedRegs[(*it)->regSet][(*it)->value->reg] = 0;
+                it = active.erase(it);
+            } else {
+                it++;
+            }
+        }
+
+        const auto& regSet = targetInfo.regSets[current.regSet];
+        auto& used = usedRegs[current.regSet];
+
+        // Values live across calls need callee-saved registers, the rest prefer caller-saved ones
+        int reg = -1;
+        for (const auto& index : regSet.valueIndex) {
+            if (!used[index] && regSet.isCalleeSaved(index) == current.crossesCall) {
+                reg = index;
+                break;
+            }
+        }
+        if (reg < 0 && !current.crossesCall) {
+            for (const auto& index : regSet.valueIndex) {
+                if (!used[index]) {
+                    reg = index;
+                    break;
+                }
+            }
+        }
+        if (reg >= 0) {
+            current.value->reg = reg;
+            used[reg] = 1;
+            active.push_back(&current);
+            continue;
+        }
+
+        // Out of registers: find the spillable interval ending furthest away that holds a suitable register
+        Interval* victim = nullptr;
+        for (const auto& interval : active) {
+            if (interval->regSet != current.regSet || interval->isReload) {
                 continue;
             }
-            // Handle call returns
-            if (i->opcode == OPCODE_CALL || i->opcode == OPCODE_CALLCOND) {
+            if (current.crossesCall && !regSet.isCalleeSaved(interval->value->reg)) {
                 continue;
             }
-            // Handle everything else
-            auto opInfo = opcodeInfo[i->opcode];
-            if (opInfo.getSignatureDest() == OPCODE_SIG_TYPE_V) {
-                if (!tryAllocValueReg(i->dest)) {
-                    assert_always("This pass does not support placing values in the stack yet");
+            if (!victim || interval->range.end > victim->range.end) {
+                victim = interval;
+            }
+        }
+
+        if (victim && (victim->range.end > current.range.end || current.isReload)) {
+            // Split the victim, handing its register over to the current interval
+            const U32 position = current.range.start;
+            spills.push_back({ victim->value, canSplitAt(*victim, position) ? position : 0 });
+            current.value->reg = victim->value->reg;
+            active.erase(std::find(active.begin(), active.end(), victim));
+            active.push_back(&current);
+        } else if (!current.isReload) {
+            spills.push_back({ current.value, 0 });
+        } else {
+            logger.error(LOG_CPU, "Cannot find a register for a reloaded value");
+            return false;
+        }
+    }
+    return spills.empty();
+}
+
+void RegisterAllocationPass::spillClobberedArguments(Function* function, std::vector<Spill>& spills) const {
+    for (const auto& entry : argRanges) {
+        Value* arg = entry.first;
+        const int setIndex = getRegSetIndex(arg);
+        if (setIndex < 0 || spillSlots.count(arg)) {
+            continue;
+        }
+
+        // Arguments are live from the function entry until their last use
+        const auto& regSet = targetInfo.regSets[setIndex];
+        bool clobbered = false;
+        if (regSet.isScratch(arg->reg)) {
+            for (const auto& position : clobberPositions) {
+                clobbered |= (position <= entry.second.end);
+            }
+        }
+        if (!regSet.isCalleeSaved(arg->reg)) {
+            for (const auto& position : callPositions) {
+                clobbered |= (position < entry.second.end);
+            }
+        }
+        if (clobbered) {
+            spills.push_back({ arg, 0 });
+        }
+    }
+}
+
+void RegisterAllocationPass::insertSpillCode(Function* function, const std::vector<Spill>& spills) {
+    std::unordered_map<Value*, U32> splitPositions;
+    for (const auto& spill : spills) {
+        auto it = splitPositions.find(spill.value);
+        if (it == splitPositions.end() || spill.position < it->second) {
+            splitPositions[spill.value] = spill.position;
+        }
+    }
+
+    Builder builder;
+    for (auto& block : function->blocks) {
+        auto& instructions = block->instructions;
+        for (auto it = instructions.begin(); it != instructions.end(); it++) {
+            Instruction* i = *it;
+            auto found = positions.find(i);
+            if (found == positions.end()) {
+                continue; // Spill code inserted in this round
+            }
+            const U32 position = found->second;
+
+            // Phi nodes reload their incoming value at the end of the predecessor, before its terminator
+            Block* reloadBlock = block;
+            auto reloadPoint = it;
+            U32 usePosition = position;
+            if (i->opcode == OPCODE_PHI) {
+                reloadBlock = i->src2.block;
+                reloadPoint = reloadBlock->instructions.end();
+                if (!reloadBlock->instructions.empty()) {
+                    const auto last = std::prev(reloadPoint);
+                    if ((*last)->opcode == OPCODE_BR || (*last)->opcode == OPCODE_BRCOND || (*last)->opcode == OPCODE_RET) {
+                        reloadPoint = last;
+                    }
                 }
+                usePosition = blockRanges[blockIndices.at(reloadBlock)].end;
             }
-            if (opInfo.getSignatureSrc1() == OPCODE_SIG_TYPE_V) {
-                tryFreeValueReg(i->src1.value);
+
+            // Reload spilled sources
+            const auto& info = opcodeInfo[i->opcode];
+            std::pair<U8, Instruction::Operand*> operands[] = {
+                { info.getSignatureSrc1(), &i->src1 },
+                { info.getSignatureSrc2(), &i->src2 },
+                { info.getSignatureSrc3(), &i->src3 },
+            };
+            std::unordered_map<Value*, Value*> reloads;
+            for (auto& operand : operands) {
+                Value* value = operand.second->value;
+                if (!isValueOperand(operand.first, value)) {
+                    continue;
+                }
+                auto split = splitPositions.find(value);
+                if (split == splitPositions.end() || usePosition < split->second) {
+                    continue;
+                }
+                Value*& reload = reloads[value];
+                if (!reload) {
+                    builder.setInsertPoint(reloadBlock, reloadPoint);
+                    reload = builder.createLocalLoad(0, value->type);
+                    reloadSources[reload] = value;
+                    spillSlots[value].reloads.push_back(reload->parent.instruction);
+                    function->reloadCount += 1;
+                }
+                value->usage -= 1;
+                operand.second->setValue(reload);
             }
-            if (opInfo.getSignatureSrc2() == OPCODE_SIG_TYPE_V) {
-                tryFreeValueReg(i->src2.value);
+
+            // Store spilled destinations right after their definition (after all phi nodes of the block)
+            Value* dest = i->dest;
+            if (isValueOperand(info.getSignatureDest(), dest) && splitPositions.count(dest)) {
+                auto& slot = spillSlots[dest];
+                if (!slot.store) {
+                    auto storePoint = std::next(it);
+                    while (storePoint != instructions.end() && (*storePoint)->opcode == OPCODE_PHI) {
+                        storePoint++;
+                    }
+                    builder.setInsertPoint(block, storePoint);
+                    builder.createLocalStore(0, dest);
+                    slot.store = *std::prev(storePoint);
+                    function->spillCount += 1;
+                }
             }
-            if (opInfo.getSignatureSrc3() == OPCODE_SIG_TYPE_V) {
-                tryFreeValueReg(i->src3.value);
+        }
+    }
+
+    // Spilled arguments are stored before anything else in the entry block
+    Block* entry = function->blocks[0];
+    for (const auto& arg : function->args) {
+        if (splitPositions.count(arg) && !spillSlots[arg].store) {
+            builder.setInsertPoint(entry, entry->instructions.begin());
+            builder.createLocalStore(0, arg);
+            spillSlots[arg].store = entry->instructions.front();
+            function->spillCount += 1;
+        }
+    }
+}
+
+void RegisterAllocationPass::assignStackSlots(Function* function) {
+    struct StackSlot {
+        U32 offset;
+        U32 size;
+        U32 end;
+    };
+
+    std::unordered_map<Value*, Range> ranges;
+    computeLiveRanges(function, true, ranges);
+
+    std::vector<std::pair<Value*, Range>> lifetimes(ranges.begin(), ranges.end());
+    std::sort(lifetimes.begin(), lifetimes.end(), [](const std::pair<Value*, Range>& lhs, const std::pair<Value*, Range>& rhs) {
+        return lhs.second.start < rhs.second.start;
+    });
+
+    // Reuse slots of the same size whose previous owner is no longer live
+    U32 localsSize = 0;
+    std::vector<StackSlot> slots;
+    for (const auto& lifetime : lifetimes) {
+        const U32 size = getStackSlotSize(lifetime.first->type);
+        StackSlot* slot = nullptr;
+        for (auto& candidate : slots) {
+            if (candidate.size == size && candidate.end < lifetime.second.start) {
+                slot = &candidate;
+                break;
             }
         }
+        if (!slot) {
+            const U32 offset = (localsSize + size - 1) & ~(size - 1);
+            slots.push_back({ offset, size, 0 });
+            localsSize = offset + size;
+            slot = &slots.back();
+        }
+        slot->end = lifetime.second.end;
+
+        const auto& spillSlot = spillSlots.at(lifetime.first);
+        spillSlot.store->src1.immediate = slot->offset;
+        for (const auto& reload : spillSlot.reloads) {
+            reload->src1.immediate = slot->offset;
+        }
     }
+    function->localsSize = (localsSize + 15) & ~15;
+}
 
-    // Register remapping
+bool RegisterAllocationPass::run(Function* function) {
+    spillSlots.clear();
+    reloadSources.clear();
+    function->localsSize = 0;
+    function->spillCount = 0;
+    function->reloadCount = 0;
+
+    // Arguments
+    for (int i = 0; i < function->args.size(); i++) {
+        allocArgumentReg(i, function->args[i]);
+    }
+
+    // Call arguments
     for (auto& block : function->blocks) {
-        for (auto& i : block->instructions) {
-            auto opInfo = opcodeInfo[i->opcode];
-            if (i->opcode == OPCODE_ARG || opInfo.getSignatureDest() != OPCODE_SIG_TYPE_V) {
-                continue;
+        for (auto* i : block->instructions) {
+            if (i->opcode == OPCODE_ARG) {
+                allocArgumentReg(i->src1.immediate, i->dest);
             }
-            Value* value = i->dest;
-            for (const auto& regSet : targetInfo.regSets) {
-                if (regSet.types & backend::RegisterSet::TYPE_INT && value->isTypeInteger()) {
-                    value->reg = regSet.valueIndex[value->reg];
+        }
+    }
+
+    // Linear scan, inserting spill code until every interval fits in a register
+    std::vector<Interval> intervals;
+    std::vector<Spill> spills;
+    std::unordered_map<Value*, Range> ranges;
+    for (int round = 0;; round++) {
+        numberInstructions(function);
+        computeLiveRanges(function, false, ranges);
+
+        intervals.clear();
+        for (const auto& entry : ranges) {
+            Interval interval;
+            interval.value = entry.first;
+            interval.regSet = getRegSetIndex(entry.first);
+            interval.range = entry.second;
+            interval.isReload = reloadSources.count(entry.first) != 0;
+            interval.crossesCall = false;
+            for (const auto& call : callPositions) {
+                if (interval.range.start < call && call < interval.range.end) {
+                    interval.crossesCall = true;
+                    break;
                 }
             }
+            if (interval.regSet < 0) {
+                logger.error(LOG_CPU, "No register set available for value type %d", entry.first->type);
+                return false;
+            }
+            intervals.push_back(interval);
+        }
+
+        spills.clear();
+        const bool allocated = allocateRegisters(intervals, spills);
+        spillClobberedArguments(function, spills);
+        if (allocated && spills.empty()) {
+            break;
         }
+        if (spills.empty()) {
+            logger.error(LOG_CPU, "Register allocation failed");
+            return false;
+        }
+        if (round == maxRounds) {
+            logger.error(LOG_CPU, "Register allocation did not converge after %d rounds of spill code", maxRounds);
+            return false;
+        }
+        insertSpillCode(function, spills);
+    }
+
+    // Stack frame
+    if (!spillSlots.empty()) {
+        numberInstructions(function);
+        assignStackSlots(function);
     }
 
     function->flags |= FUNCTION_IS_COMPILABLE;
@@ -9,7 +9,9 @@
 #include "nucleus/cpu/backend/target.h"
 #include "nucleus/cpu/hir/pass.h"
 
-#include <bitset>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace cpu {
 namespace hir {
@@ -18,29 +20,77 @@ namespace passes {
 /**
  * Register Allocation Pass
  * ========================
- * This is a mandatory compiler pass that will assign, if possible, a hardware register
- * to the values of the target function. Should the pass fail to place a value in a register,
- * it will place it into the stack, wrapping any access to that variable with the
- * corresponding load/store instructions.
+ * This is a mandatory compiler pass that will assign a hardware register to the values
+ * of the target function using linear scan over live intervals. Should the pass run out
+ * of registers, the interval ending furthest away is split: it keeps its register until
+ * the split point, and any later use is wrapped with a reload from a stack slot. The
+ * value itself is stored to its slot right after being defined.
+ *
+ * Allocation is repeated after inserting spill code until every interval fits in a
+ * register, and the pass fails if that takes more than a given number of rounds.
+ * Finally, stack slots whose lifetimes do not overlap are shared, and the resulting
+ * storage size is saved in Function::localsSize for the backend to lay out the stack
+ * frame.
+ *
+ * Phi nodes define their value at the start of their block, while each incoming value
+ * is used at the end of the corresponding predecessor, where the backend copies it.
  *
  * Notes:
  * - This pass should be the last one to apply to a function.
- * - This pass uses Value::usage to determine when a value is no longer needed
- *   and the corresponding register can be. Value::usage will be modified.
+ * - Values live across calls are only placed in callee-saved registers.
+ * - Arguments live across a call or an instruction with OPCODE_FLAG_CLOBBER that overwrites
+ *   their register are stored at the function entry and reloaded before their uses.
+ * - Spill and reload counts are saved in Function::spillCount and Function::reloadCount.
  */
 class RegisterAllocationPass : public Pass {
 private:
-    struct RegSetUsage {
-        U32 types;
-        U32 count;
-        std::bitset<32> regs;
+    struct Range {
+        U32 start;
+        U32 end;
+    };
+
+    struct Interval {
+        Value* value;
+        int regSet;        // Index of the register set the value belongs to
+        Range range;       // Positions between the definition and the last use
+        bool crossesCall;  // Value is live across a call
+        bool isReload;     // Value holds a reload from the stack and cannot be spilled
+    };
+
+    struct Spill {
+        Value* value;      // Spilled value
+        U32 position;      // Uses at or after this position are reloaded from the stack
+    };
+
+    struct SpillSlot {
+        Instruction* store;
+        std::vector<Instruction*> reloads;
     };
 
     // Target information
     const backend::TargetInfo& targetInfo;
 
-    // Register usage
-    std::vector<RegSetUsage> regUsages;
+    // Maximum number of spill code insertion rounds before giving up
+    int maxRounds;
+
+    // Numbering of the current function
+    std::unordered_map<const Instruction*, U32> positions;
+    std::unordered_map<const Block*, size_t> blockIndices;
+    std::vector<Range> blockRanges;
+    std::vector<std::vector<size_t>> blockSuccessors;
+    std::vector<Range> backEdges;
+    std::vector<U32> callPositions;
+    std::vector<U32> clobberPositions;
+
+    // Live ranges of the function arguments, which are held in fixed registers
+    std::unordered_map<Value*, Range> argRanges;
+
+    // Spill code inserted in the current function
+    std::unordered_map<Value*, SpillSlot> spillSlots;
+    std::unordered_map<Value*, Value*> reloadSources;
+
+    // Number of arguments placed in each register set for the current call
+    std::vector<int> argCounts;
 
     /**
      * Handle call arguments
@@ -50,28 +100,88 @@ private:
     void allocArgumentReg(int index, Value* arg);
 
     /**
-     * Try to allocate a register for a value
-     * @param[in]  value  Value to allocate a register for
-     * @return            True if an available register was found
+     * Find the register set a value belongs to
+     * @param[in]  value  Value whose type will be checked
+     * @return            Index of the register set, or -1 if none matches
+     */
+    int getRegSetIndex(const Value* value) const;
+
+    /**
+     * Assign positions to instructions and blocks, and find calls and loops
+     * @param[in]  function  Function to be numbered
+     */
+    void numberInstructions(Function* function);
+
+    /**
+     * Get the values defined and read by an instruction
+     * @param[in]  i      Instruction to be inspected
+     * @param[in]  slots  If true, consider spill slots (defined by stores, read by reloads) rather than values
+     * @param[out] def    Value defined by the instruction, if any
+     * @param[out] uses   Values read by the instruction
      */
-    bool tryAllocValueReg(Value* value);
+    void getDefUses(const Instruction* i, bool slots, Value*& def, std::vector<Value*>& uses) const;
 
     /**
-     * Try to free a register from a value
-     * @param[in]  value  Value to allocate a register for
-     * @return            True if an available register was found
+     * Compute the positions where values are live, extending them across blocks
+     * @param[in]  function  Function to be analyzed
+     * @param[in]  slots     If true, compute lifetimes of spill slots rather than values
+     * @param[out] ranges    Live range for each value (or spilled value) defined in the function
      */
-    bool tryFreeValueReg(Value* value);
+    void computeLiveRanges(Function* function, bool slots, std::unordered_map<Value*, Range>& ranges);
+
+    /**
+     * Assign hardware registers to the live intervals
+     * @param[in]  intervals  Live intervals of the function
+     * @param[out] spills     Values that did not fit in a register
+     * @return                True if every interval was assigned a register
+     */
+    bool allocateRegisters(std::vector<Interval>& intervals, std::vector<Spill>& spills);
+
+    /**
+     * Find the arguments whose register is overwritten by a call or a clobbering instruction while they are live
+     * @param[in]  function  Function whose arguments will be checked
+     * @param[out] spills    Arguments to be reloaded from the stack
+     */
+    void spillClobberedArguments(Function* function, std::vector<Spill>& spills) const;
+
+    /**
+     * Check whether the uses of an interval can be reloaded only after a position,
+     * keeping the register for the earlier uses
+     * @param[in]  interval  Interval to be split
+     * @param[in]  position  Split position
+     * @return               True if no loop can take control back before the split position
+     */
+    bool canSplitAt(const Interval& interval, U32 position) const;
+
+    /**
+     * Insert stores after the definition of spilled values, and reloads before their uses
+     * @param[in]  function  Function to be modified
+     * @param[in]  spills    Values to be spilled
+     */
+    void insertSpillCode(Function* function, const std::vector<Spill>& spills);
+
+    /**
+     * Assign stack offsets to spilled values, sharing slots with disjoint lifetimes
+     * @param[in]  function  Function whose spill code has been inserted
+     */
+    void assignStackSlots(Function* function);
 
 public:
+    static constexpr int MAX_ALLOCATION_ROUNDS = 32;
+
     // Constructor
-    RegisterAllocationPass(const backend::TargetInfo& targetInfo);
+    RegisterAllocationPass(const backend::TargetInfo& targetInfo, int maxRounds = MAX_ALLOCATION_ROUNDS);
 
     // Get the name of this pass
     const char* name() override {
         return "Register Allocation";
     }
 
+    // Create a copy of this pass for another compilation thread
+    std::unique_ptr<Pass> clone() const override {
+        return std::make_unique<RegisterAllocationPass>(*this);
+    }
+
     // Apply this pass on a function
     bool run(Function* function) override;
 };
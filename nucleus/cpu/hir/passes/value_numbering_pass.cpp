@@ -0,0 +1,359 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "value_numbering_pass.h"
+#include "nucleus/cpu/hir/block.h"
+#include "nucleus/cpu/hir/instruction.h"
+
+#include <tuple>
+#include <utility>
+
+namespace cpu {
+namespace hir {
+namespace passes {
+
+// Kinds of expression sources
+enum {
+    SOURCE_NONE = 0,
+    SOURCE_VALUE,
+    SOURCE_IMMEDIATE,
+    SOURCE_CONSTANT,  // Followed by the type of the constant
+};
+
+static bool isValueOperand(U8 sigType, const Value* value) {
+    return sigType == OPCODE_SIG_TYPE_V || (sigType == OPCODE_SIG_TYPE_M && value != nullptr);
+}
+
+static bool isCommutative(Opcode opcode, OpcodeFlags flags) {
+    switch (opcode) {
+    case OPCODE_ADD:
+    case OPCODE_MUL:
+    case OPCODE_MULH:
+    case OPCODE_AND:
+    case OPCODE_OR:
+    case OPCODE_XOR:
+        return true;
+    case OPCODE_CMP:
+        return flags == COMPARE_EQ || flags == COMPARE_NE;
+    default:
+        return false;
+    }
+}
+
+bool ValueNumberingPass::Expression::operator<(const Expression& other) const {
+    return std::tie(opcode, flags, type, kinds[0], kinds[1], kinds[2], sources[0], sources[1], sources[2]) <
+        std::tie(other.opcode, other.flags, other.type, other.kinds[0], other.kinds[1], other.kinds[2],
+            other.sources[0], other.sources[1], other.sources[2]);
+}
+
+void ValueNumberingPass::computeDominators(Function* function, size_t entry) {
+    const size_t count = function->blocks.size();
+    const size_t undefined = count;
+
+    // Compute the edges of the control flow graph
+    std::unordered_map<const Block*, size_t> indices;
+    for (size_t index = 0; index < count; index++) {
+        indices[function->blocks[index]] = index;
+    }
+    std::vector<std::vector<size_t>> successors(count);
+    predecessors.assign(count, {});
+    for (size_t index = 0; index < count; index++) {
+        for (const auto& block : function->getSuccessors(index)) {
+            const size_t succ = indices.at(block);
+            successors[index].push_back(succ);
+            predecessors[succ].push_back(index);
+        }
+    }
+
+    // Compute the reverse postorder of the blocks reachable from the entry
+    std::vector<size_t> postorder;
+    std::vector<size_t> order(count, undefined);
+    std::vector<bool> visited(count, false);
+    std::vector<std::pair<size_t, size_t>> stack = {{ entry, 0 }};
+    visited[entry] = true;
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second < successors[top.first].size()) {
+            const size_t succ = successors[top.first][top.second++];
+            if (!visited[succ]) {
+                visited[succ] = true;
+                stack.push_back({ succ, 0 });
+            }
+        } else {
+            order[top.first] = postorder.size();
+            postorder.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+
+    // Iterate until the immediate dominators stabilize (Cooper, Harvey and Kennedy)
+    idoms.assign(count, undefined);
+    idoms[entry] = entry;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = postorder.rbegin(); it != postorder.rend(); it++) {
+            const size_t index = *it;
+            if (index == entry) {
+                continue;
+            }
+            size_t idom = undefined;
+            for (size_t pred : predecessors[index]) {
+                if (idoms[pred] == undefined) {
+                    continue;
+                }
+                if (idom == undefined) {
+                    idom = pred;
+                    continue;
+                }
+                size_t lhs = pred;
+                size_t rhs = idom;
+                while (lhs != rhs) {
+                    while (order[lhs] < order[rhs]) {
+                        lhs = idoms[lhs];
+                    }
+                    while (order[rhs] < order[lhs]) {
+                        rhs = idoms[rhs];
+                    }
+                }
+                idom = lhs;
+            }
+            if (idoms[index] != idom) {
+                idoms[index] = idom;
+                changed = true;
+            }
+        }
+    }
+
+    children.assign(count, {});
+    for (size_t index = 0; index < count; index++) {
+        if (index != entry && idoms[index] != undefined) {
+            children[idoms[index]].push_back(index);
+        }
+    }
+}
+
+void ValueNumberingPass::replaceSources(Instruction* i) {
+    const auto& info = opcodeInfo[i->opcode];
+    const std::pair<U8, Instruction::Operand*> sources[] = {
+        { info.getSignatureSrc1(), &i->src1 },
+        { info.getSignatureSrc2(), &i->src2 },
+        { info.getSignatureSrc3(), &i->src3 },
+    };
+    for (const auto& source : sources) {
+        Instruction::Operand* operand = source.second;
+        if (!isValueOperand(source.first, operand->value)) {
+            continue;
+        }
+        Value* value = operand->value;
+        auto it = replacements.find(value);
+        if (it == replacements.end()) {
+            continue;
+        }
+        while (it != replacements.end()) {
+            value = it->second;
+            it = replacements.find(value);
+        }
+        operand->value->usage -= 1;
+        operand->setValue(value);
+    }
+}
+
+bool ValueNumberingPass::getExpression(const Instruction* i, Expression& expression) const {
+    const auto& info = opcodeInfo[i->opcode];
+    if (info.flags & OPCODE_FLAG_VOLATILE || info.getSignatureDest() != OPCODE_SIG_TYPE_V) {
+        return false;
+    }
+    switch (i->opcode) {
+    case OPCODE_CTXLOAD:
+    case OPCODE_LOCALLOAD:
+    case OPCODE_PHI:
+        return false;
+    default:
+        break;
+    }
+
+    expression.opcode = static_cast<Opcode>(i->opcode);
+    expression.flags = i->flags;
+    expression.type = i->dest->type;
+
+    const std::pair<U8, const Instruction::Operand*> sources[] = {
+        { info.getSignatureSrc1(), &i->src1 },
+        { info.getSignatureSrc2(), &i->src2 },
+        { info.getSignatureSrc3(), &i->src3 },
+    };
+    for (int index = 0; index < 3; index++) {
+        const U8 sigType = sources[index].first;
+        const auto* operand = sources[index].second;
+        if (isValueOperand(sigType, operand->value)) {
+            const Value* value = operand->value;
+            if (!value->isConstant()) {
+                expression.kinds[index] = SOURCE_VALUE;
+                expression.sources[index] = reinterpret_cast<uintptr_t>(value);
+            } else if (value->isTypeVector()) {
+                return false;
+            } else {
+                const U32 size = getTypeSize(value->type);
+                const U64 mask = (size >= 8) ? ~U64(0) : (U64(1) << (size * 8)) - 1;
+                expression.kinds[index] = SOURCE_CONSTANT + value->type;
+                expression.sources[index] = U64(value->constant.i64) & mask;
+            }
+        } else if (sigType == OPCODE_SIG_TYPE_I) {
+            expression.kinds[index] = SOURCE_IMMEDIATE;
+            expression.sources[index] = operand->immediate;
+        } else {
+            expression.kinds[index] = SOURCE_NONE;
+            expression.sources[index] = 0;
+        }
+    }
+
+    // Sort the sources of commutative operations
+    if (isCommutative(expression.opcode, expression.flags) &&
+        std::tie(expression.kinds[1], expression.sources[1]) < std::tie(expression.kinds[0], expression.sources[0])) {
+        std::swap(expression.kinds[0], expression.kinds[1]);
+        std::swap(expression.sources[0], expression.sources[1]);
+    }
+    return true;
+}
+
+U32 ValueNumberingPass::numberBlock(Block* block, ExpressionTable& expressions, ExpressionTable& loads, std::vector<Expression>& undo) {
+    U32 removed = 0;
+
+    auto& instructions = block->instructions;
+    for (auto it = instructions.begin(); it != instructions.end();) {
+        Instruction* i = *it;
+        replaceSources(i);
+
+        // Memory side effects
+        switch (i->opcode) {
+        case OPCODE_STORE: {
+            loads.clear();
+            Expression load = {};
+            load.opcode = OPCODE_LOAD;
+            load.flags = i->flags;
+            load.type = i->src2.value->type;
+            load.kinds[0] = i->src1.value->isConstant() ? SOURCE_CONSTANT + i->src1.value->type : SOURCE_VALUE;
+            load.sources[0] = i->src1.value->isConstant() ? U64(i->src1.value->constant.i64) : reinterpret_cast<uintptr_t>(i->src1.value);
+            if (!i->src2.value->isConstant()) {
+                loads[load] = i->src2.value;
+            }
+            it++;
+            continue;
+        }
+        case OPCODE_CMPXCHG:
+        case OPCODE_CALL:
+        case OPCODE_CALLCOND:
+        case OPCODE_MEMFENCE:
+            loads.clear();
+            it++;
+            continue;
+        default:
+            break;
+        }
+
+        Expression expression;
+        if (!getExpression(i, expression)) {
+            it++;
+            continue;
+        }
+        ExpressionTable& table = (i->opcode == OPCODE_LOAD) ? loads : expressions;
+        const auto known = table.find(expression);
+        if (known == table.end()) {
+            table[expression] = i->dest;
+            if (&table == &expressions) {
+                undo.push_back(expression);
+            }
+            it++;
+            continue;
+        }
+
+        // Replace the destination and release the sources of the redundant instruction
+        replacements[i->dest] = known->second;
+        const auto& info = opcodeInfo[i->opcode];
+        const std::pair<U8, Value*> sources[] = {
+            { info.getSignatureSrc1(), i->src1.value },
+            { info.getSignatureSrc2(), i->src2.value },
+            { info.getSignatureSrc3(), i->src3.value },
+        };
+        for (const auto& source : sources) {
+            if (isValueOperand(source.first, source.second)) {
+                source.second->usage -= 1;
+            }
+        }
+        it = instructions.erase(it);
+        removed += 1;
+    }
+    return removed;
+}
+
+bool ValueNumberingPass::run(Function* function) {
+    // Check function flags
+    if (!function || !(function->flags & FUNCTION_IS_DEFINED) || function->blocks.empty()) {
+        return false;
+    }
+
+    size_t entry = 0;
+    for (size_t index = 0; index < function->blocks.size(); index++) {
+        if (function->blocks[index]->flags & BLOCK_IS_ENTRY) {
+            entry = index;
+            break;
+        }
+    }
+    computeDominators(function, entry);
+    replacements.clear();
+
+    // Depth-first traversal of the dominator tree
+    struct Scope {
+        size_t index;
+        size_t child;
+        size_t undoSize;
+        ExpressionTable loads;  // Memory loads available at the end of the block
+    };
+    ExpressionTable expressions;
+    std::vector<Expression> undo;
+    std::vector<Scope> scopes;
+    U32 removed = 0;
+
+    scopes.push_back({ entry, 0, 0, {} });
+    removed += numberBlock(function->blocks[entry], expressions, scopes.back().loads, undo);
+    while (!scopes.empty()) {
+        Scope& scope = scopes.back();
+        if (scope.child < children[scope.index].size()) {
+            const size_t child = children[scope.index][scope.child++];
+            ExpressionTable loads;
+            if (predecessors[child].size() == 1 && predecessors[child][0] == scope.index) {
+                loads = scope.loads;
+            }
+            const size_t undoSize = undo.size();
+            removed += numberBlock(function->blocks[child], expressions, loads, undo);
+            scopes.push_back({ child, 0, undoSize, std::move(loads) });
+            continue;
+        }
+        // Forget the expressions of the block when leaving its scope
+        while (undo.size() > scope.undoSize) {
+            expressions.erase(undo.back());
+            undo.pop_back();
+        }
+        scopes.pop_back();
+    }
+
+    // Replace the remaining uses in blocks unreachable from the entry
+    if (!replacements.empty()) {
+        for (auto& block : function->blocks) {
+            for (auto* i : block->instructions) {
+                replaceSources(i);
+            }
+        }
+    }
+
+    function->redundantCount = removed;
+    lastRemovedCount = removed;
+    totalRemovedCount += removed;
+    return true;
+}
+
+}  // namespace passes
+}  // namespace hir
+}  // namespace cpu
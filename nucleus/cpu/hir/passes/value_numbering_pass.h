@@ -0,0 +1,112 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/hir/pass.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace cpu {
+namespace hir {
+namespace passes {
+
+/**
+ * Value Numbering Pass
+ * ====================
+ * Removes instructions computing the same result as an earlier instruction that
+ * dominates them. Blocks are visited in a depth-first traversal of the dominator tree,
+ * keeping a scoped table of the expressions computed along the current path. Sources of
+ * commutative operations are sorted, and constants are compared by value.
+ *
+ * Memory loads are only reused if no instruction with memory side effects (stores, atomics,
+ * calls, fences) can execute in between: their table is cleared after any such instruction,
+ * and only inherited by dominated blocks whose single predecessor is the dominator. Values
+ * written by a store are forwarded to later loads of the same address and type.
+ *
+ * Notes:
+ * - Context loads are handled by the ContextCachingPass.
+ * - The number of removed instructions is saved in Function::redundantCount.
+ */
+class ValueNumberingPass : public Pass {
+    // Expression computed by an instruction
+    struct Expression {
+        Opcode opcode;
+        OpcodeFlags flags;
+        Type type;
+        U8 kinds[3];      // Kind of each source: none, value, constant (and its type) or immediate
+        U64 sources[3];   // Value pointer, constant bits or immediate of each source
+
+        bool operator<(const Expression& other) const;
+    };
+
+    using ExpressionTable = std::map<Expression, Value*>;
+
+    // Dominator tree of the current function
+    std::vector<size_t> idoms;
+    std::vector<std::vector<size_t>> children;
+    std::vector<std::vector<size_t>> predecessors;
+
+    // Values that replace the destination of removed instructions
+    std::unordered_map<Value*, Value*> replacements;
+
+    /**
+     * Compute the immediate dominator of every block reachable from the entry
+     * @param[in]  function  Function to be analyzed
+     * @param[in]  entry     Index of the entry block
+     */
+    void computeDominators(Function* function, size_t entry);
+
+    /**
+     * Replace the sources of an instruction according to Value replacements
+     * @param[in]  i  Instruction whose sources will be updated
+     */
+    void replaceSources(Instruction* i);
+
+    /**
+     * Get the expression computed by an instruction
+     * @param[in]  i           Instruction whose sources have already been replaced
+     * @param[out] expression  Expression computed by the instruction
+     * @return                 True if the instruction can be numbered
+     */
+    bool getExpression(const Instruction* i, Expression& expression) const;
+
+    /**
+     * Number the instructions of a block, removing the redundant ones
+     * @param[in]     block        Block to be processed
+     * @param[in,out] expressions  Expressions available, new ones are added and logged in the undo list
+     * @param[in,out] loads        Memory loads available at the start/end of the block
+     * @param[out]    undo         Expressions added to the table by this block
+     * @return                     Number of removed instructions
+     */
+    U32 numberBlock(Block* block, ExpressionTable& expressions, ExpressionTable& loads, std::vector<Expression>& undo);
+
+public:
+    // Number of instructions removed from the last function processed
+    U32 lastRemovedCount = 0;
+
+    // Number of instructions removed since the creation of this pass
+    U64 totalRemovedCount = 0;
+
+    // Get the name of this pass
+    const char* name() override {
+        return "Value Numbering";
+    }
+
+    // Create a copy of this pass for another compilation thread
+    std::unique_ptr<Pass> clone() const override {
+        return std::make_unique<ValueNumberingPass>(*this);
+    }
+
+    // Apply this pass on a function
+    bool run(Function* function) override;
+};
+
+}  // namespace passes
+}  // namespace hir
+}  // namespace cpu
@@ -8,5 +8,20 @@
 namespace cpu {
 namespace hir {
 
+U32 getTypeSize(Type type) {
+    switch (type) {
+    case TYPE_I8:   return 1;
+    case TYPE_I16:  return 2;
+    case TYPE_I32:  return 4;
+    case TYPE_I64:  return 8;
+    case TYPE_F32:  return 4;
+    case TYPE_F64:  return 8;
+    case TYPE_V128: return 16;
+    case TYPE_V256: return 32;
+    default:
+        return 0;
+    }
+}
+
 }  // namespace hir
 }  // namespace cpu
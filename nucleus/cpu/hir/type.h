@@ -24,5 +24,12 @@ enum Type {
     TYPE_PTR = TYPE_I64
 };
 
+/**
+ * Get the size in bytes of a value of the given type
+ * @param[in]  type  HIR type
+ * @return           Size in bytes, or 0 for void
+ */
+U32 getTypeSize(Type type);
+
 }  // namespace hir
 }  // namespace cpu
@@ -12,6 +12,48 @@
 namespace cpu {
 namespace hir {
 
+// High 64 bits of the 128-bit product of two unsigned 64-bit integers
+static U64 mulhu64(U64 lhs, U64 rhs) {
+    const U64 lhsLo = lhs & 0xFFFFFFFF, lhsHi = lhs >> 32;
+    const U64 rhsLo = rhs & 0xFFFFFFFF, rhsHi = rhs >> 32;
+    const U64 lo = lhsLo * rhsLo;
+    const U64 mid1 = lhsHi * rhsLo + (lo >> 32);
+    const U64 mid2 = lhsLo * rhsHi + (mid1 & 0xFFFFFFFF);
+    return lhsHi * rhsHi + (mid1 >> 32) + (mid2 >> 32);
+}
+
+// High 64 bits of the 128-bit product of two signed 64-bit integers
+static S64 mulhs64(S64 lhs, S64 rhs) {
+    U64 result = mulhu64(U64(lhs), U64(rhs));
+    if (lhs < 0) {
+        result -= U64(rhs);
+    }
+    if (rhs < 0) {
+        result -= U64(lhs);
+    }
+    return S64(result);
+}
+
+// Evaluate a comparison, using the unsigned type for COMPARE_U* conditions
+template <typename TS, typename TU>
+static bool compareConstants(TS lhs, TS rhs, CompareFlags flags) {
+    switch (flags) {
+    case COMPARE_EQ:   return lhs == rhs;
+    case COMPARE_NE:   return lhs != rhs;
+    case COMPARE_SLT:  return lhs < rhs;
+    case COMPARE_SLE:  return lhs <= rhs;
+    case COMPARE_SGE:  return lhs >= rhs;
+    case COMPARE_SGT:  return lhs > rhs;
+    case COMPARE_ULT:  return TU(lhs) < TU(rhs);
+    case COMPARE_ULE:  return TU(lhs) <= TU(rhs);
+    case COMPARE_UGE:  return TU(lhs) >= TU(rhs);
+    case COMPARE_UGT:  return TU(lhs) > TU(rhs);
+    default:
+        assert_always("Unimplemented case");
+        return false;
+    }
+}
+
 S32 Value::getId() {
     if (id < 0) {
         Function* parFunction;
@@ -94,8 +136,9 @@ bool Value::isConstantZero() const {
     case TYPE_I64:  return (constant.i64 == 0);
     case TYPE_F32:  return (constant.f32 == 0);
     case TYPE_F64:  return (constant.f64 == 0);
-    case TYPE_V128: assert_always("Unimplemented Value::isConstantZero for TYPE_V128"); return false;
-    case TYPE_V256: assert_always("Unimplemented Value::isConstantZero for TYPE_V256"); return false;
+    case TYPE_V128: return (constant.v128.u64[0] == 0 && constant.v128.u64[1] == 0);
+    case TYPE_V256: return (constant.v256.u64[0] == 0 && constant.v256.u64[1] == 0 &&
+                            constant.v256.u64[2] == 0 && constant.v256.u64[3] == 0);
 
     default:
         assert_always("Wrong type");
@@ -169,7 +212,7 @@ void Value::doSub(Value* rhs) {
 }
 
 void Value::doMul(Value* rhs, ArithmeticFlags flags) {
-    if (flags & ARITHMETIC_SIGNED) {
+    if (!(flags & ARITHMETIC_UNSIGNED)) {
         switch (type) {
         case TYPE_I8:   constant.i8  *= rhs->constant.i8;   break;
         case TYPE_I16:  constant.i16 *= rhs->constant.i16;  break;
@@ -191,10 +234,29 @@ void Value::doMul(Value* rhs, ArithmeticFlags flags) {
 }
 
 void Value::doMulH(Value* rhs, ArithmeticFlags flags) {
+    if (!(flags & ARITHMETIC_UNSIGNED)) {
+        switch (type) {
+        case TYPE_I8:   constant.i8  = (S16(constant.i8)  * S16(rhs->constant.i8))  >> 8;   break;
+        case TYPE_I16:  constant.i16 = (S32(constant.i16) * S32(rhs->constant.i16)) >> 16;  break;
+        case TYPE_I32:  constant.i32 = (S64(constant.i32) * S64(rhs->constant.i32)) >> 32;  break;
+        case TYPE_I64:  constant.i64 = mulhs64(constant.i64, rhs->constant.i64);            break;
+        default:
+            assert_always("Unimplemented case");
+        }
+    } else {
+        switch (type) {
+        case TYPE_I8:   constant.i8  = (U16(U8(constant.i8))   * U16(U8(rhs->constant.i8)))   >> 8;   break;
+        case TYPE_I16:  constant.i16 = (U32(U16(constant.i16)) * U32(U16(rhs->constant.i16))) >> 16;  break;
+        case TYPE_I32:  constant.i32 = (U64(U32(constant.i32)) * U64(U32(rhs->constant.i32))) >> 32;  break;
+        case TYPE_I64:  constant.i64 = mulhu64(constant.i64, rhs->constant.i64);                      break;
+        default:
+            assert_always("Unimplemented case");
+        }
+    }
 }
 
 void Value::doDiv(Value* rhs, ArithmeticFlags flags) {
-    if (flags & ARITHMETIC_SIGNED) {
+    if (!(flags & ARITHMETIC_UNSIGNED)) {
         switch (type) {
         case TYPE_I8:   constant.i8  /= rhs->constant.i8;   break;
         case TYPE_I16:  constant.i16 /= rhs->constant.i16;  break;
@@ -205,10 +267,10 @@ void Value::doDiv(Value* rhs, ArithmeticFlags flags) {
         }
     } else {
         switch (type) {
-        case TYPE_I8:   constant.i8  /= U8(rhs->constant.i8);    break;
-        case TYPE_I16:  constant.i16 /= U16(rhs->constant.i16);  break;
-        case TYPE_I32:  constant.i32 /= U32(rhs->constant.i32);  break;
-        case TYPE_I64:  constant.i64 /= U64(rhs->constant.i64);  break;
+        case TYPE_I8:   constant.i8  = U8(constant.i8)   / U8(rhs->constant.i8);    break;
+        case TYPE_I16:  constant.i16 = U16(constant.i16) / U16(rhs->constant.i16);  break;
+        case TYPE_I32:  constant.i32 = U32(constant.i32) / U32(rhs->constant.i32);  break;
+        case TYPE_I64:  constant.i64 = U64(constant.i64) / U64(rhs->constant.i64);  break;
         default:
             assert_always("Unimplemented case");
         }
@@ -232,6 +294,10 @@ void Value::doAnd(Value* rhs) {
     case TYPE_I16:  constant.i16 &= rhs->constant.i16;  break;
     case TYPE_I32:  constant.i32 &= rhs->constant.i32;  break;
     case TYPE_I64:  constant.i64 &= rhs->constant.i64;  break;
+    case TYPE_V128:
+        constant.v128.u64[0] &= rhs->constant.v128.u64[0];
+        constant.v128.u64[1] &= rhs->constant.v128.u64[1];
+        break;
     default:
         assert_always("Unimplemented case");
     }
@@ -243,6 +309,10 @@ void Value::doOr(Value* rhs) {
     case TYPE_I16:  constant.i16 |= rhs->constant.i16;  break;
     case TYPE_I32:  constant.i32 |= rhs->constant.i32;  break;
     case TYPE_I64:  constant.i64 |= rhs->constant.i64;  break;
+    case TYPE_V128:
+        constant.v128.u64[0] |= rhs->constant.v128.u64[0];
+        constant.v128.u64[1] |= rhs->constant.v128.u64[1];
+        break;
     default:
         assert_always("Unimplemented case");
     }
@@ -254,6 +324,10 @@ void Value::doXor(Value* rhs) {
     case TYPE_I16:  constant.i16 ^= rhs->constant.i16;  break;
     case TYPE_I32:  constant.i32 ^= rhs->constant.i32;  break;
     case TYPE_I64:  constant.i64 ^= rhs->constant.i64;  break;
+    case TYPE_V128:
+        constant.v128.u64[0] ^= rhs->constant.v128.u64[0];
+        constant.v128.u64[1] ^= rhs->constant.v128.u64[1];
+        break;
     default:
         assert_always("Unimplemented case");
     }
@@ -265,6 +339,10 @@ void Value::doNot() {
     case TYPE_I16:  constant.i16 = ~constant.i16;  break;
     case TYPE_I32:  constant.i32 = ~constant.i32;  break;
     case TYPE_I64:  constant.i64 = ~constant.i64;  break;
+    case TYPE_V128:
+        constant.v128.u64[0] = ~constant.v128.u64[0];
+        constant.v128.u64[1] = ~constant.v128.u64[1];
+        break;
     default:
         assert_always("Unimplemented case");
     }
@@ -303,6 +381,30 @@ void Value::doShrA(Value* amount) {
     }
 }
 
+void Value::doRol(Value* amount) {
+    const U32 n = U8(amount->constant.i8);
+    switch (type) {
+    case TYPE_I8:   constant.i8  = (U8(constant.i8)   << (n & 7))  | (U8(constant.i8)   >> ((8 - n) & 7));   break;
+    case TYPE_I16:  constant.i16 = (U16(constant.i16) << (n & 15)) | (U16(constant.i16) >> ((16 - n) & 15)); break;
+    case TYPE_I32:  constant.i32 = (U32(constant.i32) << (n & 31)) | (U32(constant.i32) >> ((32 - n) & 31)); break;
+    case TYPE_I64:  constant.i64 = (U64(constant.i64) << (n & 63)) | (U64(constant.i64) >> ((64 - n) & 63)); break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
+void Value::doRor(Value* amount) {
+    const U32 n = U8(amount->constant.i8);
+    switch (type) {
+    case TYPE_I8:   constant.i8  = (U8(constant.i8)   >> (n & 7))  | (U8(constant.i8)   << ((8 - n) & 7));   break;
+    case TYPE_I16:  constant.i16 = (U16(constant.i16) >> (n & 15)) | (U16(constant.i16) << ((16 - n) & 15)); break;
+    case TYPE_I32:  constant.i32 = (U32(constant.i32) >> (n & 31)) | (U32(constant.i32) << ((32 - n) & 31)); break;
+    case TYPE_I64:  constant.i64 = (U64(constant.i64) >> (n & 63)) | (U64(constant.i64) << ((64 - n) & 63)); break;
+    default:
+        assert_always("Unimplemented case");
+    }
+}
+
 void Value::doZExt(Type newType) {
     switch (type) {
     case TYPE_I8:   type = newType; constant.i64 &= 0xFF;        break;
@@ -446,70 +548,17 @@ void Value::doConvert(Type newType) {
 }
 
 void Value::doCompare(Value* rhs, CompareFlags flags) {
+    bool result;
     switch (type) {
-    case TYPE_I8:
-        switch (flags) {
-        case COMPARE_EQ:  constant.i8 = (constant.i8 == rhs->constant.i8) ? 1 : 0;  break;
-        case COMPARE_NE:  constant.i8 = (constant.i8 != rhs->constant.i8) ? 1 : 0;  break;
-        case COMPARE_SLT: constant.i8 = (constant.i8 <  rhs->constant.i8) ? 1 : 0;  break;
-        case COMPARE_SLE: constant.i8 = (constant.i8 <= rhs->constant.i8) ? 1 : 0;  break;
-        case COMPARE_SGE: constant.i8 = (constant.i8 >= rhs->constant.i8) ? 1 : 0;  break;
-        case COMPARE_SGT: constant.i8 = (constant.i8 >  rhs->constant.i8) ? 1 : 0;  break;
-        case COMPARE_ULT: constant.i8 = (U8(constant.i8) <  U8(rhs->constant.i8)) ? 1 : 0;  break;
-        case COMPARE_ULE: constant.i8 = (U8(constant.i8) <= U8(rhs->constant.i8)) ? 1 : 0;  break;
-        case COMPARE_UGE: constant.i8 = (U8(constant.i8) >= U8(rhs->constant.i8)) ? 1 : 0;  break;
-        case COMPARE_UGT: constant.i8 = (U8(constant.i8) >  U8(rhs->constant.i8)) ? 1 : 0;  break;
-        }
-        break;
-
-    case TYPE_I16:
-        switch (flags) {
-        case COMPARE_EQ:  constant.i8 = (constant.i16 == rhs->constant.i16) ? 1 : 0;  break;
-        case COMPARE_NE:  constant.i8 = (constant.i16 != rhs->constant.i16) ? 1 : 0;  break;
-        case COMPARE_SLT: constant.i8 = (constant.i16 <  rhs->constant.i16) ? 1 : 0;  break;
-        case COMPARE_SLE: constant.i8 = (constant.i16 <= rhs->constant.i16) ? 1 : 0;  break;
-        case COMPARE_SGE: constant.i8 = (constant.i16 >= rhs->constant.i16) ? 1 : 0;  break;
-        case COMPARE_SGT: constant.i8 = (constant.i16 >  rhs->constant.i16) ? 1 : 0;  break;
-        case COMPARE_ULT: constant.i8 = (U16(constant.i16) <  U16(rhs->constant.i16)) ? 1 : 0;  break;
-        case COMPARE_ULE: constant.i8 = (U16(constant.i16) <= U16(rhs->constant.i16)) ? 1 : 0;  break;
-        case COMPARE_UGE: constant.i8 = (U16(constant.i16) >= U16(rhs->constant.i16)) ? 1 : 0;  break;
-        case COMPARE_UGT: constant.i8 = (U16(constant.i16) >  U16(rhs->constant.i16)) ? 1 : 0;  break;
-        }
-        break;
-
-    case TYPE_I32:
-        switch (flags) {
-        case COMPARE_EQ:  constant.i8 = (constant.i32 == rhs->constant.i32) ? 1 : 0;  break;
-        case COMPARE_NE:  constant.i8 = (constant.i32 != rhs->constant.i32) ? 1 : 0;  break;
-        case COMPARE_SLT: constant.i8 = (constant.i32 <  rhs->constant.i32) ? 1 : 0;  break;
-        case COMPARE_SLE: constant.i8 = (constant.i32 <= rhs->constant.i32) ? 1 : 0;  break;
-        case COMPARE_SGE: constant.i8 = (constant.i32 >= rhs->constant.i32) ? 1 : 0;  break;
-        case COMPARE_SGT: constant.i8 = (constant.i32 >  rhs->constant.i32) ? 1 : 0;  break;
-        case COMPARE_ULT: constant.i8 = (U32(constant.i32) <  U32(rhs->constant.i32)) ? 1 : 0;  break;
-        case COMPARE_ULE: constant.i8 = (U32(constant.i32) <= U32(rhs->constant.i32)) ? 1 : 0;  break;
-        case COMPARE_UGE: constant.i8 = (U32(constant.i32) >= U32(rhs->constant.i32)) ? 1 : 0;  break;
-        case COMPARE_UGT: constant.i8 = (U32(constant.i32) >  U32(rhs->constant.i32)) ? 1 : 0;  break;
-        }
-        break;
-
-    case TYPE_I64:
-        switch (flags) {
-        case COMPARE_EQ:  constant.i8 = (constant.i64 == rhs->constant.i64) ? 1 : 0;  break;
-        case COMPARE_NE:  constant.i8 = (constant.i64 != rhs->constant.i64) ? 1 : 0;  break;
-        case COMPARE_SLT: constant.i8 = (constant.i64 <  rhs->constant.i64) ? 1 : 0;  break;
-        case COMPARE_SLE: constant.i8 = (constant.i64 <= rhs->constant.i64) ? 1 : 0;  break;
-        case COMPARE_SGE: constant.i8 = (constant.i64 >= rhs->constant.i64) ? 1 : 0;  break;
-        case COMPARE_SGT: constant.i8 = (constant.i64 >  rhs->constant.i64) ? 1 : 0;  break;
-        case COMPARE_ULT: constant.i8 = (U64(constant.i64) <  U64(rhs->constant.i64)) ? 1 : 0;  break;
-        case COMPARE_ULE: constant.i8 = (U64(constant.i64) <= U64(rhs->constant.i64)) ? 1 : 0;  break;
-        case COMPARE_UGE: constant.i8 = (U64(constant.i64) >= U64(rhs->constant.i64)) ? 1 : 0;  break;
-        case COMPARE_UGT: constant.i8 = (U64(constant.i64) >  U64(rhs->constant.i64)) ? 1 : 0;  break;
-        }
-        break;
-
+    case TYPE_I8:   result = compareConstants<S8, U8>(constant.i8, rhs->constant.i8, flags);      break;
+    case TYPE_I16:  result = compareConstants<S16, U16>(constant.i16, rhs->constant.i16, flags);  break;
+    case TYPE_I32:  result = compareConstants<S32, U32>(constant.i32, rhs->constant.i32, flags);  break;
+    case TYPE_I64:  result = compareConstants<S64, U64>(constant.i64, rhs->constant.i64, flags);  break;
     default:
         assert_always("Unimplemented case");
+        return;
     }
+    constant.i8 = result ? 1 : 0;
     type = TYPE_I8;
 }
 
@@ -19,6 +19,7 @@ class Instruction;
 enum ValueFlags {
     VALUE_IS_CONSTANT  = (1 << 0),
     VALUE_IS_ARGUMENT  = (1 << 1),
+    VALUE_IS_POINTER   = (1 << 2),  // Constant holding a host address
 };
 
 /**
@@ -96,6 +97,8 @@ public:
     void doShl(Value* amount);
     void doShr(Value* amount);
     void doShrA(Value* amount);
+    void doRol(Value* amount);
+    void doRor(Value* amount);
     void doZExt(Type newType);
     void doSExt(Type newType);
     void doTrunc(Type newType);
@@ -6,39 +6,84 @@
 #include "util.h"
 #include "nucleus/emulator.h"
 #include "nucleus/system/lv2.h"
+#include "nucleus/cpu/cell.h"
 #include "nucleus/cpu/cpu.h"
 #include "nucleus/cpu/hir/function.h"
 #include "nucleus/cpu/frontend/ppu/ppu_decoder.h"
 #include "nucleus/cpu/frontend/ppu/ppu_state.h"
 #include "nucleus/cpu/frontend/ppu/ppu_tables.h"
 #include "nucleus/cpu/frontend/ppu/ppu_thread.h"
+#include "nucleus/cpu/frontend/ppu/ppu_translator.h"
+#include "nucleus/logger/logger.h"
 
 #ifdef NUCLEUS_PLATFORM_WINDOWS
 #include <Windows.h>
 #endif
 
+#include <algorithm>
+
 namespace cpu {
 
 void nucleusTranslate(void* guestFunc, U64 guestAddr) {
     auto* function = static_cast<frontend::ppu::Function*>(guestFunc);
-    function->analyze_cfg();
-    function->recompile();
-
     auto* hirFunction = function->hirFunction;
-    auto* cpu = CPU::getCurrentThread()->parent;
+    auto* cpu = static_cast<Cell*>(CPU::getCurrentThread()->parent);
     auto* state = static_cast<frontend::ppu::PPUThread*>(CPU::getCurrentThread())->state.get();
-    cpu->compiler->compile(hirFunction);
-    cpu->compiler->call(hirFunction, state);
+
+    // Wait for the function to be translated, unless no translator thread got to it yet
+    if (!cpu->ppu_translator->require(function)) {
+        logger.error(LOG_CPU, "Could not translate function at 0x%llX", guestAddr);
+        return;
+    }
+    if (!cpu->compiler->call(hirFunction, state)) {
+        logger.error(LOG_CPU, "Could not call function at 0x%llX", guestAddr);
+    }
 }
 
 void nucleusCall(U64 guestAddr) {
     auto* thread = static_cast<frontend::ppu::PPUThread*>(CPU::getCurrentThread());
     auto* state = thread->state.get();
+    auto* cpu = static_cast<Cell*>(thread->parent);
 
+    // Call the function directly if it was discovered and compiled already
     state->pc = guestAddr;
+    if (auto* function = cpu->ppu_dispatch.find(U32(guestAddr))) {
+        if (cpu->compiler->call(function, state)) {
+            return;
+        }
+    }
     thread->task();
 }
 
+void nucleusDispatch(void* inlineCache, U64 guestAddr) {
+    auto* cache = static_cast<backend::InlineCache*>(inlineCache);
+    auto* thread = static_cast<frontend::ppu::PPUThread*>(CPU::getCurrentThread());
+    auto* state = thread->state.get();
+    auto* cpu = static_cast<Cell*>(thread->parent);
+    cache->misses++;
+
+    // Functions not discovered or compiled yet are handled by the thread, and cached once they miss again
+    state->pc = guestAddr;
+    auto* function = cpu->ppu_dispatch.find(U32(guestAddr));
+    if (!function || !(function->flags & hir::FUNCTION_IS_COMPILED)) {
+        thread->task();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        U32* end = cache->targets + cache->count;
+        if (cache->count < backend::INLINE_CACHE_SIZE && std::find(cache->targets, end, U32(guestAddr)) == end) {
+            cache->targets[cache->count] = U32(guestAddr);
+            cache->functions[cache->count] = function;
+            cache->count += 1;
+            cpu->compiler->compileInlineCache(*cache);
+        }
+    }
+    if (!cpu->compiler->call(function, state)) {
+        thread->task();
+    }
+}
+
 void nucleusSysCall() {
     auto* state = static_cast<frontend::ppu::PPUThread*>(CPU::getCurrentThread())->state.get();
     static_cast<sys::LV2*>(nucleus.sys.get())->call(*state);
@@ -50,10 +95,12 @@ void nucleusHook(U32 fnid) {
 }
 
 void nucleusLog(U64 guestAddr) {
-    auto* state = static_cast<frontend::ppu::PPUThread*>(CPU::getCurrentThread())->state.get();
-    //printf("> [%08X] %s\n", U32(guestAddr), frontend::ppu::get_entry(guestAddr).name);
-    int a = 0;
-    a += 1;
+    auto* thread = CPU::getCurrentThread();
+    frontend::ppu::Instruction code;
+    code.value = thread->parent->memory->read32(U32(guestAddr));
+
+    const auto& entry = frontend::ppu::get_entry(code);
+    logger.notice(LOG_CPU, "> [%08X] %s", U32(guestAddr), entry.type == frontend::ppu::ENTRY_INSTRUCTION ? entry.name : "(invalid)");
 }
 
 U64 nucleusTime() {
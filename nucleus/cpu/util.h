@@ -28,6 +28,15 @@ void nucleusTranslate(void* guestFunc, U64 guestAddr);
  */
 void nucleusCall(U64 guestAddr);
 
+/**
+ * Indirect calls in JIT-translated code go through inline caches, whose stubs handle the
+ * targets observed so far. Other targets are handled through this function, which adds
+ * them to the cache, if not full, and calls them.
+ * @param[in]  inlineCache  Host address to the backend::InlineCache of the call site
+ * @param[in]  guestAddr    Guest address where the function to be executed begins
+ */
+void nucleusDispatch(void* inlineCache, U64 guestAddr);
+
 /**
  * Guest code may contain syscalls. Note that all potential argument values that
  * may have been modified and are allocated in registers should be copied back to the
@@ -6,10 +6,12 @@
 #include "utils.h"
 
 #include <algorithm>
+#include <cerrno>
 
 #if defined(NUCLEUS_PLATFORM_WINDOWS)
 #include <Windows.h>
 #elif defined(NUCLEUS_PLATFORM_LINUX)
+#include <sys/stat.h>
 #include <unistd.h>
 #endif
 
@@ -17,9 +19,11 @@ namespace fs {
 
 Path getEmulatorPath()
 {
-    char buffer[4096];
-#ifdef NUCLEUS_PLATFORM_WINDOWS
+    char buffer[4096] = {};
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
     GetModuleFileName(NULL, buffer, sizeof(buffer));
+#elif defined(NUCLEUS_PLATFORM_LINUX)
+    readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
 #endif
 
     Path exePath = buffer;
@@ -65,4 +69,15 @@ Path getProcessPath(const Path& elfPath)
     return procPath.substr(0, pos+1);
 }
 
+bool createDirectory(const Path& path)
+{
+#if defined(NUCLEUS_PLATFORM_WINDOWS)
+    return CreateDirectory(path.c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+#elif defined(NUCLEUS_PLATFORM_LINUX)
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#else
+    return false;
+#endif
+}
+
 }  // namespace fs
@@ -15,4 +15,7 @@ Path getEmulatorPath();
 // Get the path to the folder that contains the emulated ELF binary
 Path getProcessPath(const Path& elfPath);
 
+// Create a folder in the host filesystem, returns true if it exists afterwards
+bool createDirectory(const Path& path);
+
 }  // namespace fs
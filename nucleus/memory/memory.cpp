@@ -103,6 +103,15 @@ void Memory::readRight(U8* dst, U32 src, U32 size)
     }
 }
 
+void Memory::readBlock32(U32* dst, U32 src, U32 count)
+{
+    // Simple loop over contiguous words, so that compilers can vectorize the byteswaps
+    const U32* words = (const U32*)((U64)m_base + src);
+    for (U32 i = 0; i < count; i++) {
+        dst[i] = SE32(words[i]);
+    }
+}
+
 /**
  * Write memory reversing endianness if necessary
  */
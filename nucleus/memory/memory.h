@@ -42,6 +42,7 @@ public:
     U128 read128(U32 addr);
     void readLeft(U8* dst, U32 src, U32 size);
     void readRight(U8* dst, U32 src, U32 size);
+    void readBlock32(U32* dst, U32 src, U32 count);
 
     void write8(U32 addr, U8 value);
     void write16(U32 addr, U16 value);
@@ -81,7 +81,7 @@ S32 sys_prx_start_module(S32 id, U64 flags, sys_prx_start_module_option_t* pOpt)
 
                 // Try to link to a native implementation (HLE)
                 if (lv2.modules.find(lib.name, fnid)) {
-                    if (config.ppuTranslator == CPU_TRANSLATOR_INSTRUCTION) {
+                    if (!(config.ppuTranslator & CPU_TRANSLATOR_IS_CACHED)) {
                         U32 hookAddr = nucleus.memory->alloc(20, 8);
                         nucleus.memory->write32(hookAddr + 0, 0x3D600000 | ((fnid >> 16) & 0xFFFF));  // lis  r11, fnid:hi
                         nucleus.memory->write32(hookAddr + 4, 0x616B0000 | (fnid & 0xFFFF));          // ori  r11, r11, fnid:lo
@@ -91,7 +91,7 @@ S32 sys_prx_start_module(S32 id, U64 flags, sys_prx_start_module_option_t* pOpt)
                         nucleus.memory->write32(hookAddr + 20, 0);                                    // OPD: Function RTOC
                         nucleus.memory->write32(importedLibrary.fstub_addr + 4*i, hookAddr + 16);
                     }
-                    if (config.ppuTranslator == CPU_TRANSLATOR_FUNCTION) {
+                    if (config.ppuTranslator & CPU_TRANSLATOR_IS_CACHED) {
                         const U32 addr = lib.exports.at(fnid);
                         const U32 func_addr = nucleus.memory->read32(addr + 0);
                         const U32 func_rtoc = nucleus.memory->read32(addr + 4);
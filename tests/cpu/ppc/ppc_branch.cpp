@@ -93,6 +93,29 @@ void PPCTestRunner::crorc() {
 }
 
 void PPCTestRunner::crxor() {
+    // Condition Register XOR
+    TEST_INSTRUCTION(test_crxor, CR, BD, BA, BB, newCR, {
+        state.setCR(CR);
+        run({ a.crxor(BD, BA, BB); });
+        expect(state.getCR() == newCR);
+    });
+
+    test_crxor(0x80000000, 1, 0, 2, 0xC0000000);
+    test_crxor(0xA0000000, 0, 0, 2, 0x20000000);
+    test_crxor(0x00000001, 31, 31, 31, 0x00000000);
+
+    // Writing single bits of CR0 while its comparison is still pending
+    TEST_INSTRUCTION(test_crxor_pending, RA, RB, BD, BA, BB, newCR, {
+        state.r[1] = RA;
+        state.r[2] = RB;
+        run({ a.add_(r3, r1, r2); a.crxor(BD, BA, BB); });
+        expect(state.getCR() == newCR);
+    });
+
+    test_crxor_pending(0x0000000000000001ULL, 0x0000000000000002ULL, 3, 1, 3, 0x50000000);
+    test_crxor_pending(0x0000000000000001ULL, 0x0000000000000002ULL, 0, 0, 0, 0x40000000);
+    test_crxor_pending(0x0000000000000001ULL, 0x0000000000000002ULL, 4, 1, 0, 0x48000000);
+    test_crxor_pending(0x0000000000000001ULL, 0xFFFFFFFFFFFFFFFFULL, 2, 2, 2, 0x00000000);
 }
 
 void PPCTestRunner::mcrf() {
@@ -42,6 +42,20 @@ void PPCTestRunner::mfocrf() {
 
     test_mfcr(0x0000000000000000ULL, 0x12481248, 0x0000000012481248ULL);
     test_mfcr(0xFFFFFFFFFFFFFFFFULL, 0x12481248, 0x0000000012481248ULL);
+
+    // Move from Condition Register while the comparison of CR0 is still pending
+    TEST_INSTRUCTION(test_mfcr_pending, RA, RB, CR, newRD, {
+        state.r[1] = RA;
+        state.r[2] = RB;
+        state.setCR(CR);
+        run({ a.add_(r3, r1, r2); a.mfcr(r4); });
+        expect(state.r[4] == newRD);
+        expect(state.getCR() == newRD);
+    });
+
+    test_mfcr_pending(0x0000000000000001ULL, 0x0000000000000002ULL, 0x12481248, 0x0000000042481248ULL);
+    test_mfcr_pending(0x0000000000000001ULL, 0xFFFFFFFFFFFFFFFEULL, 0x02481248, 0x0000000082481248ULL);
+    test_mfcr_pending(0x0000000000000001ULL, 0xFFFFFFFFFFFFFFFFULL, 0xF2481248, 0x0000000022481248ULL);
 }
 
 void PPCTestRunner::mfspr() {
@@ -17,10 +17,10 @@ void PPCTestRunner::addx() {
         state.r[2] = R2;
         run({ a.add(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -35,10 +35,10 @@ void PPCTestRunner::addx() {
         state.r[2] = R2;
         run({ a.add_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -57,10 +57,10 @@ void PPCTestRunner::addcx() {
         state.xer.ca = oldCA;
         run({ a.addc(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -78,10 +78,10 @@ void PPCTestRunner::addcx() {
         state.xer.ca = oldCA;
         run({ a.addc_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -101,10 +101,10 @@ void PPCTestRunner::addex() {
         state.xer.ca = oldCA;
         run({ a.adde(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -122,10 +122,10 @@ void PPCTestRunner::addex() {
         state.xer.ca = oldCA;
         run({ a.adde_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -143,10 +143,10 @@ void PPCTestRunner::addi() {
         state.r[RAIndex] = RA;
         run({ a.addi(r2, RAIndex, SIMM); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -167,10 +167,10 @@ void PPCTestRunner::addic() {
         state.r[1] = R1;
         run({ a.addic(r2, r1, SIMM); });
         expect(state.r[2] == R2);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == CA);
@@ -188,10 +188,10 @@ void PPCTestRunner::addic_() {
         state.r[1] = R1;
         run({ a.addic_(r2, r1, SIMM); });
         expect(state.r[2] == R2);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == CA);
@@ -210,10 +210,10 @@ void PPCTestRunner::addis() {
         state.r[RAIndex] = RA;
         run({ a.addis(r2, RAIndex, SIMM); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -238,10 +238,10 @@ void PPCTestRunner::addzex() {
         state.xer.ca = oldCA;
         run({ a.addze(r2, r1); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -260,10 +260,10 @@ void PPCTestRunner::addzex() {
         state.xer.ca = oldCA;
         run({ a.addze_(r2, r1); });
         expect(state.r[2] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -284,10 +284,10 @@ void PPCTestRunner::andx() {
         state.r[2] = R2;
         run({ a.and_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -302,10 +302,10 @@ void PPCTestRunner::andx() {
         state.r[2] = R2;
         run({ a.and__(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -323,10 +323,10 @@ void PPCTestRunner::andcx() {
         state.r[2] = R2;
         run({ a.andc(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -341,10 +341,10 @@ void PPCTestRunner::andcx() {
         state.r[2] = R2;
         run({ a.andc_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -361,10 +361,10 @@ void PPCTestRunner::andi_() {
         state.r[1] = R1;
         run({ a.andi_(r2, r1, UIMM); });
         expect(state.r[2] == R2);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -380,10 +380,10 @@ void PPCTestRunner::andis_() {
         state.r[1] = R1;
         run({ a.andis_(r2, r1, UIMM); });
         expect(state.r[2] == R2);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -411,10 +411,10 @@ void PPCTestRunner::cntlzdx() {
         state.r[1] = RS;
         run({ a.cntlzd(r2, r1); });
         expect(state.r[2] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -430,10 +430,10 @@ void PPCTestRunner::cntlzdx() {
         state.r[1] = RS;
         run({ a.cntlzd_(r2, r1); });
         expect(state.r[2] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -451,10 +451,10 @@ void PPCTestRunner::cntlzwx() {
         state.r[1] = RS;
         run({ a.cntlzw(r2, r1); });
         expect(state.r[2] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -472,10 +472,10 @@ void PPCTestRunner::cntlzwx() {
         state.r[1] = RS;
         run({ a.cntlzw_(r2, r1); });
         expect(state.r[2] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -496,10 +496,10 @@ void PPCTestRunner::divdx() {
         state.r[2] = RB;
         run({ a.divd(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -518,10 +518,10 @@ void PPCTestRunner::divdx() {
         state.r[2] = RB;
         run({ a.divd_(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -542,10 +542,10 @@ void PPCTestRunner::divdux() {
         state.r[2] = RB;
         run({ a.divdu(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -564,10 +564,10 @@ void PPCTestRunner::divdux() {
         state.r[2] = RB;
         run({ a.divdu_(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -589,10 +589,10 @@ void PPCTestRunner::divwx() {
         state.r[2] = RB;
         run({ a.divw(r3, r1, r2); });
         expect((state.r[3] & mask) == (RD & mask));
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -612,10 +612,10 @@ void PPCTestRunner::divwx() {
         state.r[2] = RB;
         run({ a.divw_(r3, r1, r2); });
         expect((state.r[3] & mask) == (RD & mask));
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -638,10 +638,10 @@ void PPCTestRunner::divwux() {
         state.r[2] = RB;
         run({ a.divwu(r3, r1, r2); });
         expect((state.r[3] & mask) == (RD & mask));
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -661,10 +661,10 @@ void PPCTestRunner::divwux() {
         state.r[2] = RB;
         run({ a.divwu_(r3, r1, r2); });
         expect((state.r[3] & mask) == (RD & mask));
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -685,10 +685,10 @@ void PPCTestRunner::eqvx() {
         state.r[2] = R2;
         run({ a.eqv(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -704,10 +704,10 @@ void PPCTestRunner::eqvx() {
         state.r[2] = R2;
         run({ a.eqv_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -724,10 +724,10 @@ void PPCTestRunner::extsbx() {
         state.r[1] = RS;
         run({ a.extsb(r2, r1); });
         expect(state.r[2] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -741,10 +741,10 @@ void PPCTestRunner::extsbx() {
         state.r[1] = RS;
         run({ a.extsb_(r2, r1); });
         expect(state.r[2] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -761,10 +761,10 @@ void PPCTestRunner::extshx() {
         state.r[1] = RS;
         run({ a.extsh(r2, r1); });
         expect(state.r[2] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -778,10 +778,10 @@ void PPCTestRunner::extshx() {
         state.r[1] = RS;
         run({ a.extsh_(r2, r1); });
         expect(state.r[2] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -798,10 +798,10 @@ void PPCTestRunner::extswx() {
         state.r[1] = RS;
         run({ a.extsw(r2, r1); });
         expect(state.r[2] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -815,10 +815,10 @@ void PPCTestRunner::extswx() {
         state.r[1] = RS;
         run({ a.extsw_(r2, r1); });
         expect(state.r[2] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -836,10 +836,10 @@ void PPCTestRunner::mulhdx() {
         state.r[2] = RB;
         run({ a.mulhd(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -859,10 +859,10 @@ void PPCTestRunner::mulhdx() {
         state.r[2] = RB;
         run({ a.mulhd_(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -884,10 +884,10 @@ void PPCTestRunner::mulhdux() {
         state.r[2] = RB;
         run({ a.mulhdu(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -907,10 +907,10 @@ void PPCTestRunner::mulhdux() {
         state.r[2] = RB;
         run({ a.mulhdu_(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -933,10 +933,10 @@ void PPCTestRunner::mulhwx() {
         state.r[2] = RB;
         run({ a.mulhw(r3, r1, r2); });
         expect((state.r[3] & mask) == (RD & mask));
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -958,10 +958,10 @@ void PPCTestRunner::mulhwx() {
         state.r[2] = RB;
         run({ a.mulhw_(r3, r1, r2); });
         expect((state.r[3] & mask) == (RD & mask));
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -986,10 +986,10 @@ void PPCTestRunner::mulhwux() {
         state.r[2] = RB;
         run({ a.mulhwu(r3, r1, r2); });
         expect((state.r[3] & mask) == (RD & mask));
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1011,10 +1011,10 @@ void PPCTestRunner::mulhwux() {
         state.r[2] = RB;
         run({ a.mulhwu_(r3, r1, r2); });
         expect((state.r[3] & mask) == (RD & mask));
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1038,10 +1038,10 @@ void PPCTestRunner::mulldx() {
         state.r[2] = RB;
         run({ a.mulld(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1061,10 +1061,10 @@ void PPCTestRunner::mulldx() {
         state.r[2] = RB;
         run({ a.mulld_(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1085,10 +1085,10 @@ void PPCTestRunner::mulli() {
         state.r[1] = RA;
         run({ a.mulli(r2, r1, SIMM); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1110,10 +1110,10 @@ void PPCTestRunner::mullwx() {
         state.r[2] = RB;
         run({ a.mullw(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1133,10 +1133,10 @@ void PPCTestRunner::mullwx() {
         state.r[2] = RB;
         run({ a.mullw_(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1158,10 +1158,10 @@ void PPCTestRunner::nandx() {
         state.r[2] = RB;
         run({ a.nand(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1177,10 +1177,10 @@ void PPCTestRunner::nandx() {
         state.r[2] = RB;
         run({ a.nand_(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1197,10 +1197,10 @@ void PPCTestRunner::negx() {
         state.r[1] = RA;
         run({ a.neg(r2, r1); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1215,10 +1215,10 @@ void PPCTestRunner::negx() {
         state.r[1] = RA;
         run({ a.neg_(r2, r1); });
         expect(state.r[2] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1236,10 +1236,10 @@ void PPCTestRunner::norx() {
         state.r[2] = RB;
         run({ a.nor(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1255,10 +1255,10 @@ void PPCTestRunner::norx() {
         state.r[2] = RB;
         run({ a.nor_(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1276,10 +1276,10 @@ void PPCTestRunner::orx() {
         state.r[2] = R2;
         run({ a.or_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1294,10 +1294,10 @@ void PPCTestRunner::orx() {
         state.r[2] = R2;
         run({ a.or__(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1315,10 +1315,10 @@ void PPCTestRunner::orcx() {
         state.r[2] = R2;
         run({ a.orc(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1333,10 +1333,10 @@ void PPCTestRunner::orcx() {
         state.r[2] = R2;
         run({ a.orc_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1353,10 +1353,10 @@ void PPCTestRunner::ori() {
         state.r[1] = R1;
         run({ a.ori(r2, r1, UIMM); });
         expect(state.r[2] == R2);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1372,10 +1372,10 @@ void PPCTestRunner::oris() {
         state.r[1] = R1;
         run({ a.oris(r2, r1, UIMM); });
         expect(state.r[2] == R2);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1413,10 +1413,10 @@ void PPCTestRunner::rlwnmx() {
         state.r[2] = RB;
         run({ a.rlwnm(r3, r1, r2, MB, ME); });
         expect(state.r[3] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1435,10 +1435,10 @@ void PPCTestRunner::slwx() {
         state.r[2] = RB;
         run({ a.slw(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1461,10 +1461,10 @@ void PPCTestRunner::slwx() {
         state.r[2] = RB;
         run({ a.slw_(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1495,10 +1495,10 @@ void PPCTestRunner::srawx() {
         state.r[2] = RB;
         run({ a.sraw(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == CA);
@@ -1524,10 +1524,10 @@ void PPCTestRunner::srawx() {
         state.r[2] = RB;
         run({ a.sraw_(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == CA);
@@ -1554,10 +1554,10 @@ void PPCTestRunner::srawix() {
         state.r[1] = RS;
         run({ a.srawi(r2, r1, SH); });
         expect(state.r[2] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == CA);
@@ -1580,10 +1580,10 @@ void PPCTestRunner::srawix() {
         state.r[1] = RS;
         run({ a.srawi_(r2, r1, SH); });
         expect(state.r[2] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == CA);
@@ -1609,10 +1609,10 @@ void PPCTestRunner::srdx() {
         state.r[2] = RB;
         run({ a.srd(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1635,10 +1635,10 @@ void PPCTestRunner::srdx() {
         state.r[2] = RB;
         run({ a.srd_(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1663,10 +1663,10 @@ void PPCTestRunner::srwx() {
         state.r[2] = RB;
         run({ a.srw(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1689,10 +1689,10 @@ void PPCTestRunner::srwx() {
         state.r[2] = RB;
         run({ a.srw_(r3, r1, r2); });
         expect(state.r[3] == RA);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1717,10 +1717,10 @@ void PPCTestRunner::subfx() {
         state.r[2] = R2;
         run({ a.subf(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1735,10 +1735,10 @@ void PPCTestRunner::subfx() {
         state.r[2] = R2;
         run({ a.subf_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1757,10 +1757,10 @@ void PPCTestRunner::subfcx() {
         state.xer.ca = oldCA;
         run({ a.subfc(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -1778,10 +1778,10 @@ void PPCTestRunner::subfcx() {
         state.xer.ca = oldCA;
         run({ a.subfc_(r3, r1, r2); });
         expect(state.r[3] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -1801,10 +1801,10 @@ void PPCTestRunner::subfex() {
         state.xer.ca = oldCA;
         run({ a.adde(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -1822,10 +1822,10 @@ void PPCTestRunner::subfex() {
         state.xer.ca = oldCA;
         run({ a.subfe_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -1843,10 +1843,10 @@ void PPCTestRunner::subfic() {
         state.r[1] = R1;
         run({ a.subfic(r2, r1, SIMM); });
         expect(state.r[2] == R2);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == CA);
@@ -1868,10 +1868,10 @@ void PPCTestRunner::subfzex() {
         state.xer.ca = oldCA;
         run({ a.addze(r2, r1); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -1890,10 +1890,10 @@ void PPCTestRunner::subfzex() {
         state.xer.ca = oldCA;
         run({ a.addze_(r2, r1); });
         expect(state.r[2] == RD);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(state.xer.ca == newCA);
@@ -1914,10 +1914,10 @@ void PPCTestRunner::xorx() {
         state.r[2] = R2;
         run({ a.xor_(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1932,10 +1932,10 @@ void PPCTestRunner::xorx() {
         state.r[2] = R2;
         run({ a.xor__(r3, r1, r2); });
         expect(state.r[3] == R3);
-        expect(state.cr.field[0].lt == LT);
-        expect(state.cr.field[0].gt == GT);
-        expect(state.cr.field[0].eq == EQ);
-        expect(state.cr.field[0].so == SO);
+        expect(!!(state.getCRField(0) & PPUState::CR_LT) == LT);
+        expect(!!(state.getCRField(0) & PPUState::CR_GT) == GT);
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!!(state.getCRField(0) & PPUState::CR_SO) == SO);
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1952,10 +1952,10 @@ void PPCTestRunner::xori() {
         state.r[1] = R1;
         run({ a.xori(r2, r1, UIMM); });
         expect(state.r[2] == R2);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1971,10 +1971,10 @@ void PPCTestRunner::xoris() {
         state.r[1] = R1;
         run({ a.xoris(r2, r1, UIMM); });
         expect(state.r[2] == R2);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
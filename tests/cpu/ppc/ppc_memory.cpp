@@ -19,10 +19,10 @@ void PPCTestRunner::lbz() {
         state.r[2] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lbz(r2, RAIndex, D); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -50,10 +50,10 @@ void PPCTestRunner::lbzu() {
         run({ a.lbzu(r2, RAIndex, D); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -82,10 +82,10 @@ void PPCTestRunner::lbzux() {
         run({ a.lbzux(r3, RAIndex, r2); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -113,10 +113,10 @@ void PPCTestRunner::lbzx() {
         state.r[3] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lbzx(r3, RAIndex, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -146,10 +146,10 @@ void PPCTestRunner::ld() {
         state.r[RAIndex] = RA;
         run({ a.ld(r2, RAIndex, D); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -179,10 +179,10 @@ void PPCTestRunner::ldu() {
         run({ a.ldu(r2, RAIndex, D); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -210,10 +210,10 @@ void PPCTestRunner::ldux() {
         run({ a.ldux(r3, RAIndex, r2); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -240,10 +240,10 @@ void PPCTestRunner::ldx() {
         state.r[2] = RB;
         run({ a.ldx(r3, RAIndex, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -273,10 +273,10 @@ void PPCTestRunner::lfd() {
         state.r[RAIndex] = RA;
         run({ a.lfd(f0, RAIndex, D); });
         expect(reinterpret_cast<U64&>(state.f[0]) == FRD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -303,10 +303,10 @@ void PPCTestRunner::lfdu() {
         run({ a.lfdu(f0, RAIndex, D); });
         expect(state.r[RAIndex] == newRA);
         expect(reinterpret_cast<U64&>(state.f[0]) == FRD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -334,10 +334,10 @@ void PPCTestRunner::lfdux() {
         run({ a.lfdux(f0, RAIndex, r2); });
         expect(state.r[RAIndex] == newRA);
         expect(reinterpret_cast<U64&>(state.f[0]) == FRD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -364,10 +364,10 @@ void PPCTestRunner::lfdx() {
         state.r[2] = RB;
         run({ a.lfdx(f0, RAIndex, r2); });
         expect(reinterpret_cast<U64&>(state.f[0]) == FRD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -410,10 +410,10 @@ void PPCTestRunner::lha() {
         state.r[2] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lha(r2, RAIndex, D); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -441,10 +441,10 @@ void PPCTestRunner::lhau() {
         run({ a.lhau(r2, RAIndex, D); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -473,10 +473,10 @@ void PPCTestRunner::lhaux() {
         run({ a.lhaux(r3, RAIndex, r2); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -504,10 +504,10 @@ void PPCTestRunner::lhax() {
         state.r[3] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lhax(r3, RAIndex, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -541,10 +541,10 @@ void PPCTestRunner::lhz() {
         state.r[2] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lhz(r2, RAIndex, D); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -572,10 +572,10 @@ void PPCTestRunner::lhzu() {
         run({ a.lhzu(r2, RAIndex, D); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -604,10 +604,10 @@ void PPCTestRunner::lhzux() {
         run({ a.lhzux(r3, RAIndex, r2); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -635,10 +635,10 @@ void PPCTestRunner::lhzx() {
         state.r[3] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lhzx(r3, RAIndex, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -678,10 +678,10 @@ void PPCTestRunner::lwa() {
         state.r[2] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lwa(r2, RAIndex, D); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -710,10 +710,10 @@ void PPCTestRunner::lwaux() {
         run({ a.lwaux(r3, RAIndex, r2); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -741,10 +741,10 @@ void PPCTestRunner::lwax() {
         state.r[3] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lwax(r3, RAIndex, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -778,10 +778,10 @@ void PPCTestRunner::lwz() {
         state.r[2] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lwz(r2, RAIndex, D); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -809,10 +809,10 @@ void PPCTestRunner::lwzu() {
         run({ a.lwzu(r2, RAIndex, D); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -841,10 +841,10 @@ void PPCTestRunner::lwzux() {
         run({ a.lwzux(r3, RAIndex, r2); });
         expect(state.r[RAIndex] == newRA);
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -872,10 +872,10 @@ void PPCTestRunner::lwzx() {
         state.r[3] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lwzx(r3, RAIndex, r2); });
         expect(state.r[3] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -906,10 +906,10 @@ void PPCTestRunner::stb() {
         state.r[2] = 0xFFFFFFFFFFFFFFFFULL;
         run({ a.lbz(r2, RAIndex, D); });
         expect(state.r[2] == RD);
-        expect(!state.cr.field[0].lt);
-        expect(!state.cr.field[0].gt);
-        expect(!state.cr.field[0].eq);
-        expect(!state.cr.field[0].so);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!(state.getCRField(0) & PPUState::CR_EQ));
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
         expect(!state.xer.so);
         expect(!state.xer.ov);
         expect(!state.xer.ca);
@@ -1026,6 +1026,52 @@ void PPCTestRunner::stdcx_() {
 }
 
 void PPCTestRunner::stwcx_() {
+    // Store Word Conditional Indexed, after Load Word and Reserve Indexed.
+    // The reservation might be lost in between because of another thread or its own thread:
+    //  0: Nothing happens in between
+    //  1: Another thread stores conditionally to the same reservation granule
+    //  2: Another thread overwrites the reserved word with a plain store
+    //  3: A previous conditional store of this thread already consumed the reservation
+    const U32 addr = memory->alloc(0x1000);
+    TEST_INSTRUCTION(test_stwcx_, Interference, RS, EQ, Value, {
+        memory->write32(addr + 0x10, 0x12345678);
+        state.r[1] = addr;
+        state.r[2] = 0x10;
+        state.r[3] = RS;
+        run({ a.lwarx(r4, r1, r2); });
+        expect(state.r[4] == 0x12345678);
+
+        PPUState current = state;
+        if (Interference == 1) {
+            state.r[5] = 0x14;
+            state.r[6] = 0xCAFEBABE;
+            run({ a.lwarx(r7, r1, r5); a.stwcx_(r6, r1, r5); });
+            expect(state.getCRField(0) & PPUState::CR_EQ);
+            state = current;
+        }
+        if (Interference == 2) {
+            state.r[6] = 0xCAFEBABE;
+            run({ a.stw(r6, r1, 0x10); });
+            state = current;
+        }
+        if (Interference == 3) {
+            run({ a.stwcx_(r3, r1, r2); });
+            expect(state.getCRField(0) & PPUState::CR_EQ);
+        }
+
+        run({ a.stwcx_(r3, r1, r2); });
+        expect(memory->read32(addr + 0x10) == Value);
+        expect(!(state.getCRField(0) & PPUState::CR_LT));
+        expect(!(state.getCRField(0) & PPUState::CR_GT));
+        expect(!!(state.getCRField(0) & PPUState::CR_EQ) == EQ);
+        expect(!(state.getCRField(0) & PPUState::CR_SO));
+    });
+
+    test_stwcx_(0, 0x00000000AAAAAAAAULL, 1, 0xAAAAAAAA);
+    test_stwcx_(1, 0x00000000AAAAAAAAULL, 0, 0x12345678);
+    test_stwcx_(2, 0x00000000AAAAAAAAULL, 0, 0xCAFEBABE);
+    test_stwcx_(3, 0x00000000AAAAAAAAULL, 0, 0xAAAAAAAA);
+    memory->free(addr);
 }
 
 void PPCTestRunner::sync() {
@@ -14,6 +14,10 @@
 #include "nucleus/cpu/hir/passes.h"
 #include "nucleus/cpu/backend/x86/x86_compiler.h"
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 // Target
@@ -26,7 +30,8 @@ public:
     TEST_METHOD(CPU_BackendTests) {
         Module* module = new Module();
         Function* function = new Function(module, TYPE_I64, {TYPE_I64, TYPE_I64});
-        Block* block = new Block(function);
+        Block* block = Block::create(function);
+        block->flags |= BLOCK_IS_ENTRY;
 
         Builder builder;
         builder.setInsertPoint(block);
@@ -37,8 +42,358 @@ public:
 
         Compiler* compiler = new x86::X86Compiler();
         compiler->addPass(std::make_unique<passes::RegisterAllocationPass>(compiler->targetInfo));
-        compiler->compile(module);
-        //auto result = function->call(3,4);
-        //Assert::IsTrue(result == 28);
+        Assert::IsTrue(compiler->compile(module));
+
+        V128 result = {};
+        Assert::IsTrue(compiler->call(function, nullptr, { builder.getConstantI64(3), builder.getConstantI64(4) }, &result));
+        Assert::IsTrue(result.u64[0] == 28);
+    }
+
+    TEST_METHOD(CPU_InstructionListTests) {
+        Module* module = new Module();
+        Function* function = new Function(module, TYPE_VOID);
+        Block* block = Block::create(function);
+        auto& instructions = block->instructions;
+        Assert::IsTrue(instructions.empty());
+
+        Builder builder;
+        builder.setInsertPoint(block);
+        Instruction* i0 = builder.appendInstr(OPCODE_MEMFENCE, 0);
+        Instruction* i2 = builder.appendInstr(OPCODE_MEMFENCE, 0);
+        Instruction* i3 = builder.appendInstr(OPCODE_RET, 0);
+
+        // Insert before an existing instruction
+        auto it2 = std::next(instructions.begin());
+        builder.setInsertPoint(block, it2);
+        Instruction* i1 = builder.appendInstr(OPCODE_MEMFENCE, 0);
+        Assert::IsTrue(*it2 == i2);
+
+        const std::vector<Instruction*> forward(instructions.begin(), instructions.end());
+        const std::vector<Instruction*> backward(instructions.rbegin(), instructions.rend());
+        Assert::IsTrue(forward == std::vector<Instruction*>({ i0, i1, i2, i3 }));
+        Assert::IsTrue(backward == std::vector<Instruction*>({ i3, i2, i1, i0 }));
+        Assert::IsTrue(instructions.front() == i0);
+        Assert::IsTrue(instructions.back() == i3);
+        Assert::IsTrue(*std::prev(instructions.end()) == i3);
+
+        // Erasing keeps the iterators to other instructions valid
+        auto next = instructions.erase(std::next(instructions.begin()));
+        Assert::IsTrue(next == it2);
+        Assert::IsTrue(*it2 == i2);
+        Assert::IsTrue(i2->prev == i0);
+        Assert::IsTrue(i1->prev == nullptr && i1->next == nullptr);
+
+        // Erase while iterating backwards
+        for (auto rit = instructions.rbegin(); rit != instructions.rend();) {
+            if ((*rit)->opcode == OPCODE_RET) {
+                rit = InstructionList::reverse_iterator(instructions.erase(std::next(rit).base()));
+            } else {
+                rit++;
+            }
+        }
+        Assert::IsTrue(instructions.back() == i2);
+        Assert::IsTrue(std::vector<Instruction*>(instructions.rbegin(), instructions.rend()) ==
+            std::vector<Instruction*>({ i2, i0 }));
+
+        // Erased instructions can be inserted again
+        instructions.insert(instructions.begin(), i3);
+        Assert::IsTrue(instructions.front() == i3);
+        instructions.remove_if([](Instruction* i) { return i->opcode == OPCODE_MEMFENCE; });
+        Assert::IsTrue(instructions.front() == i3 && instructions.back() == i3);
+        instructions.erase(instructions.begin());
+        Assert::IsTrue(instructions.empty());
+        Assert::IsTrue(instructions.begin() == instructions.end());
+    }
+
+    TEST_METHOD(CPU_FunctionResetTests) {
+        Module* module = new Module();
+        Function* function = new Function(module, TYPE_I64, {TYPE_I64, TYPE_I64});
+        Compiler* compiler = new x86::X86Compiler();
+        compiler->addPass(std::make_unique<passes::RegisterAllocationPass>(compiler->targetInfo));
+
+        // Define, compile and release the function several times, reusing its arena
+        for (int round = 0; round < 3; round++) {
+            function->reset();
+            Assert::IsTrue(function->blocks.empty());
+
+            Block* block = Block::create(function);
+            block->flags |= BLOCK_IS_ENTRY;
+            Builder builder;
+            builder.setInsertPoint(block);
+            auto sum = builder.createAdd(function->args[0], function->args[1]);
+            builder.createRet(builder.createMul(sum, builder.getConstantI64(round + 1)));
+            function->flags |= FUNCTION_IS_DEFINED;
+            Assert::IsTrue(function->blocks.size() == 1);
+            Assert::IsTrue(compiler->compile(function));
+            Assert::IsTrue(function->nativeAddress != nullptr);
+
+            // Releasing the definition keeps the compiled result
+            function->release();
+            Assert::IsTrue(function->blocks.empty());
+            Assert::IsTrue((function->flags & FUNCTION_IS_DEFINED) == 0);
+            Assert::IsTrue((function->flags & FUNCTION_IS_COMPILED) != 0);
+            Assert::IsFalse(compiler->compile(function));
+        }
+    }
+
+    TEST_METHOD(CPU_RegisterClobberTests) {
+        Module* module = new Module();
+        Function* function = new Function(module, TYPE_I64, {TYPE_I64, TYPE_I64, TYPE_I64, TYPE_I64});
+        Block* block = Block::create(function);
+        block->flags |= BLOCK_IS_ENTRY;
+
+        // Every argument is read by or after an instruction overwriting the scratch registers
+        Builder builder;
+        builder.setInsertPoint(block);
+        const auto& args = function->args;
+        auto claimed = builder.createZExt(builder.createCmpXchg(args[0], args[1], args[2]), TYPE_I64);
+        auto sum = builder.createAdd(builder.createAdd(args[0], args[1]), builder.createAdd(args[2], args[3]));
+        builder.createRet(builder.createAdd(sum, claimed));
+        function->flags |= FUNCTION_IS_DEFINED;
+
+        Compiler* compiler = new x86::X86Compiler();
+        compiler->addPass(std::make_unique<passes::RegisterAllocationPass>(compiler->targetInfo));
+        Assert::IsTrue(compiler->compile(function));
+
+        // Arguments held in scratch registers are reloaded from the stack instead
+        const auto& regSet = compiler->targetInfo.regSets[0];
+        bool clobbered = false;
+        for (const auto& i : block->instructions) {
+            clobbered |= (i->opcode == OPCODE_CMPXCHG);
+            if (!clobbered) {
+                continue;
+            }
+            for (const auto* operand : { &i->src1, &i->src2, &i->src3 }) {
+                const bool isArg = std::find(args.begin(), args.end(), operand->value) != args.end();
+                Assert::IsFalse(isArg && regSet.isScratch(operand->value->reg));
+            }
+        }
+        Assert::IsTrue(function->spillCount > 0);
+        Assert::IsTrue(block->instructions.front()->opcode == OPCODE_LOCALSTORE);
+
+        // The arguments keep their values after the exchange
+        U64 word = 5;
+        V128 result = {};
+        const U64 addr = reinterpret_cast<U64>(&word);
+        Assert::IsTrue(compiler->call(function, nullptr, { builder.getConstantI64(addr),
+            builder.getConstantI64(5), builder.getConstantI64(7), builder.getConstantI64(11) }, &result));
+        Assert::IsTrue(word == 7);
+        Assert::IsTrue(result.u64[0] == addr + 5 + 7 + 11 + 1);
+    }
+
+    static void pressureCallee() {
+    }
+
+    // Define a function keeping more values alive at once than there are registers
+    static Function* createPressureFunction(Module* module, int count, bool call) {
+        Function* function = new Function(module, TYPE_I64, {TYPE_I64});
+        Block* block = Block::create(function);
+        block->flags |= BLOCK_IS_ENTRY;
+
+        Builder builder;
+        builder.setInsertPoint(block);
+        std::vector<Value*> values;
+        for (int i = 0; i < count; i++) {
+            values.push_back(builder.createMul(function->args[0], builder.getConstantI64(i + 2)));
+        }
+        if (call) {
+            Function* callee = new Function(module, TYPE_VOID);
+            callee->flags |= FUNCTION_IS_EXTERN;
+            callee->nativeAddress = reinterpret_cast<void*>(&pressureCallee);
+            builder.createCall(callee, {}, CALL_EXTERN);
+        }
+        Value* sum = values[0];
+        for (int i = 1; i < count; i++) {
+            sum = builder.createAdd(sum, values[i]);
+        }
+        builder.createRet(sum);
+        function->flags |= FUNCTION_IS_DEFINED;
+        return function;
+    }
+
+    // Call a compiled function taking and returning an integer
+    static U64 callPressureFunction(Compiler* compiler, Function* function, U64 arg) {
+        Builder builder;
+        builder.setInsertPoint(function->blocks[0]);
+        V128 result = {};
+        Assert::IsTrue(compiler->call(function, nullptr, { builder.getConstantI64(arg) }, &result));
+        return result.u64[0];
+    }
+
+    static int countOpcode(const Block* block, Opcode opcode) {
+        int count = 0;
+        for (const auto& i : block->instructions) {
+            count += (i->opcode == opcode) ? 1 : 0;
+        }
+        return count;
+    }
+
+    TEST_METHOD(CPU_DeadContextStoreTests) {
+        Module* module = new Module();
+        Function* function = new Function(module, TYPE_I64, {TYPE_I64, TYPE_I64});
+        Block* block = Block::create(function);
+        block->flags |= BLOCK_IS_ENTRY;
+
+        // The first store is overwritten before anything reads it
+        Builder builder;
+        builder.setInsertPoint(block);
+        builder.createCtxStore(0x10, function->args[0]);
+        builder.createCtxStore(0x10, function->args[1]);
+        builder.createRet(function->args[0]);
+        function->flags |= FUNCTION_IS_DEFINED;
+
+        passes::DeadCodeEliminationPass pass;
+        Assert::IsTrue(pass.run(function));
+        Assert::IsTrue(pass.lastRemovedCount == 1);
+        Assert::IsTrue(countOpcode(block, OPCODE_CTXSTORE) == 1);
+        Assert::IsTrue(block->instructions.front()->src2.value == function->args[1]);
+
+        // Stores read by a load, or by an instruction with side effects, are kept
+        function->reset();
+        block = Block::create(function);
+        block->flags |= BLOCK_IS_ENTRY;
+        builder.setInsertPoint(block);
+        builder.createCtxStore(0x10, function->args[0]);
+        Value* value = builder.createCtxLoad(0x14, TYPE_I32);
+        builder.createCtxStore(0x10, function->args[1]);
+        builder.createCtxStore(0x20, function->args[0]);
+        builder.appendInstr(OPCODE_MEMFENCE, 0);
+        builder.createCtxStore(0x20, function->args[1]);
+        builder.createRet(builder.createZExt(value, TYPE_I64));
+        function->flags |= FUNCTION_IS_DEFINED;
+
+        Assert::IsTrue(pass.run(function));
+        Assert::IsTrue(pass.lastRemovedCount == 0);
+        Assert::IsTrue(countOpcode(block, OPCODE_CTXSTORE) == 4);
+    }
+
+    TEST_METHOD(CPU_ConstantCompareTests) {
+        Module* module = new Module();
+        Function* function = new Function(module, TYPE_VOID, {TYPE_I64, TYPE_F64});
+        Block* block = Block::create(function);
+        block->flags |= BLOCK_IS_ENTRY;
+
+        // Integer comparisons of constants, or of a value with itself, are folded
+        Builder builder;
+        builder.setInsertPoint(block);
+        builder.createCtxStore(0x10, builder.createCmpEQ(function->args[0], function->args[0]));
+        builder.createCtxStore(0x11, builder.createCmpSLT(function->args[0], function->args[0]));
+
+        // Floating-point ones are left to the target, since NaN operands compare unordered
+        builder.createCtxStore(0x12, builder.createCmpEQ(function->args[1], function->args[1]));
+        builder.createCtxStore(0x13, builder.createCmpSLT(builder.getConstantF64(1.0), builder.getConstantF64(2.0)));
+        builder.createRet();
+        function->flags |= FUNCTION_IS_DEFINED;
+
+        passes::ConstantPropagationPass pass;
+        Assert::IsTrue(pass.run(function));
+        Assert::IsTrue(pass.lastFoldedCount == 2);
+        Assert::IsTrue(countOpcode(block, OPCODE_CMP) == 2);
+        for (const auto& i : block->instructions) {
+            if (i->opcode == OPCODE_CMP) {
+                Assert::IsTrue(i->src1.value->type == TYPE_F64);
+            }
+        }
+    }
+
+    TEST_METHOD(CPU_DeadCodeTests) {
+        Module* module = new Module();
+        Function* function = new Function(module, TYPE_I64, {TYPE_I64});
+        Block* entry = Block::create(function);
+        Block* other = Block::create(function);
+        Block* merge = Block::create(function);
+        entry->flags |= BLOCK_IS_ENTRY;
+
+        // Values only used by an unused phi node form a dead chain across blocks
+        Builder builder;
+        builder.setInsertPoint(entry);
+        Value* lhs = builder.createMul(function->args[0], builder.getConstantI64(2));
+        builder.createBrCond(builder.createCmpEQ(function->args[0], builder.getConstantI64(0)), merge, other);
+        builder.setInsertPoint(other);
+        Value* rhs = builder.createAdd(function->args[0], builder.getConstantI64(3));
+        builder.createBr(merge);
+        builder.setInsertPoint(merge);
+        Value* phi = builder.createPhi({ { lhs, entry }, { rhs, other } });
+        builder.createAdd(phi, builder.getConstantI64(1));
+        builder.createRet(function->args[0]);
+        function->flags |= FUNCTION_IS_DEFINED;
+
+        passes::DeadCodeEliminationPass pass;
+        Assert::IsTrue(pass.run(function));
+        Assert::IsTrue(pass.lastRemovedCount == 5);
+        Assert::IsTrue(countOpcode(entry, OPCODE_MUL) == 0);
+        Assert::IsTrue(countOpcode(entry, OPCODE_CMP) == 1);
+        Assert::IsTrue(countOpcode(other, OPCODE_ADD) == 0);
+        Assert::IsTrue(countOpcode(merge, OPCODE_PHI) == 0);
+        Assert::IsTrue(merge->instructions.front() == merge->instructions.back());
+    }
+
+    TEST_METHOD(CPU_RegisterSpillTests) {
+        Module* module = new Module();
+        Compiler* compiler = new x86::X86Compiler();
+        compiler->addPass(std::make_unique<passes::RegisterAllocationPass>(compiler->targetInfo));
+
+        // Few values fit in registers
+        Function* function = createPressureFunction(module, 4, false);
+        Assert::IsTrue(compiler->compile(function));
+        Assert::IsTrue(function->spillCount == 0);
+        Assert::IsTrue(function->localsSize == 0);
+        Assert::IsTrue(callPressureFunction(compiler, function, 3) == 3 * (2 + 3 + 4 + 5));
+
+        // Values that do not fit are stored once and reloaded before their uses
+        function = createPressureFunction(module, 16, false);
+        Assert::IsTrue(compiler->compile(function));
+        Assert::IsTrue(function->spillCount > 0);
+        Assert::IsTrue(function->reloadCount >= function->spillCount);
+        Assert::IsTrue(function->localsSize >= 8);
+        Assert::IsTrue(function->localsSize % 16 == 0);
+        Assert::IsTrue(callPressureFunction(compiler, function, 3) == 3 * (16 * 17 / 2 + 16));
+    }
+
+    TEST_METHOD(CPU_RegisterCallTests) {
+        Module* module = new Module();
+        Compiler* compiler = new x86::X86Compiler();
+        compiler->addPass(std::make_unique<passes::RegisterAllocationPass>(compiler->targetInfo));
+        const auto& regSet = compiler->targetInfo.regSets[0];
+
+        // Values live across the call are read from callee-saved registers, or reloaded after it
+        Function* function = createPressureFunction(module, 8, true);
+        Assert::IsTrue(compiler->compile(function));
+        Assert::IsTrue(function->spillCount > 0);
+
+        std::vector<Value*> definedBefore;
+        bool called = false;
+        for (const auto& i : function->blocks[0]->instructions) {
+            if (i->opcode == OPCODE_CALL) {
+                called = true;
+            } else if (!called && i->dest) {
+                definedBefore.push_back(i->dest);
+            } else if (called && i->opcode != OPCODE_LOCALLOAD) {
+                for (const auto* operand : { &i->src1, &i->src2 }) {
+                    if (std::find(definedBefore.begin(), definedBefore.end(), operand->value) != definedBefore.end()) {
+                        Assert::IsTrue(regSet.isCalleeSaved(operand->value->reg));
+                    }
+                }
+            }
+        }
+        Assert::IsTrue(called);
+        Assert::IsTrue(callPressureFunction(compiler, function, 3) == 3 * (8 * 9 / 2 + 8));
+    }
+
+    TEST_METHOD(CPU_RegisterRoundsTests) {
+        Module* module = new Module();
+        Compiler* compiler = new x86::X86Compiler();
+        compiler->addPass(std::make_unique<passes::RegisterAllocationPass>(compiler->targetInfo, 0));
+
+        // Without spill code rounds, allocation succeeds only if no value needs to be spilled
+        Function* function = createPressureFunction(module, 4, false);
+        Assert::IsTrue(compiler->compile(function));
+        Assert::IsTrue((function->flags & FUNCTION_IS_COMPILED) != 0);
+
+        // Running out of rounds fails the compilation instead of emitting unallocated values
+        function = createPressureFunction(module, 16, false);
+        Assert::IsFalse(compiler->compile(function));
+        Assert::IsTrue((function->flags & FUNCTION_IS_COMPILED) == 0);
+        Assert::IsTrue((function->flags & FUNCTION_IS_COMPILING) == 0);
     }
 };
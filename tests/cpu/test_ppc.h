@@ -75,7 +75,7 @@ public:
 protected:
     void execute(std::function<void(PPCAssembler&)> ppcFunc) {
         function->reset();
-        block = new hir::Block(function);
+        block = hir::Block::create(function);
 
         Recompiler recompiler(cpu.get(), nullptr);
         recompiler.builder.setInsertPoint(block);
@@ -87,12 +87,17 @@ protected:
         for (size_t i = 0; (i * sizeof(U32)) < a.curSize; i++) {
             Instruction instr;
             instr.value = static_cast<U32*>(a.codeAddr)[i];
-            auto method = get_entry(instr).recompile;
-            (recompiler.*method)(instr);
+            recompiler.recompileInstruction(instr);
         }
+        // Comparisons still pending in the lazy CR state have to reach PPUState before returning
+        recompiler.flushCR();
 
         compiler->compile(function);
         compiler->call(function, &state);
+
+        // Drop the blocks of this run before the arena is reused by the next one
+        block = nullptr;
+        function->release();
     }
 
 public:
@@ -0,0 +1,135 @@
+/**
+ * (c) 2015 Alexandro Sanchez Bach. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+// Visual Studio testing dependencies
+#include "CppUnitTest.h"
+
+// Target
+#include "nucleus/cpu/hir/function.h"
+#include "nucleus/cpu/hir/module.h"
+#include "nucleus/cpu/frontend/ppu/ppu_dispatch.h"
+#include "nucleus/cpu/frontend/ppu/ppu_tables.h"
+#include "nucleus/cpu/frontend/ppu/analyzer/ppu_analyzer.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// Target
+using namespace cpu;
+using namespace cpu::frontend::ppu;
+
+TEST_CLASS(PPUTests) {
+
+public:
+    TEST_METHOD(PPU_DispatchTableTests) {
+        hir::Module* module = new hir::Module();
+        hir::Function* function1 = new hir::Function(module, hir::TYPE_VOID);
+        hir::Function* function2 = new hir::Function(module, hir::TYPE_VOID);
+        DispatchTable table;
+
+        // Lookups in pages that were never allocated miss
+        Assert::IsTrue(table.find(0x00000000) == nullptr);
+        Assert::IsTrue(table.find(0x12340010) == nullptr);
+
+        // Both levels are indexed by the address: neighbouring entries and pages stay empty
+        table.install(0x12340010, function1);
+        Assert::IsTrue(table.find(0x12340010) == function1);
+        Assert::IsTrue(table.find(0x1234000C) == nullptr);
+        Assert::IsTrue(table.find(0x12340014) == nullptr);
+        Assert::IsTrue(table.find(0x12350010) == nullptr);
+        Assert::IsTrue(table.find(0x12330010) == nullptr);
+
+        // First and last entries of the address space
+        table.install(0x00000000, function1);
+        table.install(0xFFFFFFFC, function2);
+        Assert::IsTrue(table.find(0x00000000) == function1);
+        Assert::IsTrue(table.find(0xFFFFFFFC) == function2);
+        Assert::IsTrue(table.find(0xFFFFFFF8) == nullptr);
+
+        // Installing again replaces the previous function
+        table.install(0x12340010, function2);
+        Assert::IsTrue(table.find(0x12340010) == function2);
+
+        // Invalidation removes the functions of the range only
+        table.install(0x12340020, function1);
+        table.invalidate(0x12340000, 0x20);
+        Assert::IsTrue(table.find(0x12340010) == nullptr);
+        Assert::IsTrue(table.find(0x12340020) == function1);
+        Assert::IsTrue(table.find(0x00000000) == function1);
+    }
+
+    TEST_METHOD(PPU_AnalyzerReservationTests) {
+        auto analyze = [](Analyzer& status, U32 value) {
+            Instruction code;
+            code.value = value;
+            (status.*get_entry(code).analyze)(code);
+        };
+
+        // lwarx r3, 0, r4
+        Analyzer load;
+        analyze(load, 0x7C602028);
+        Assert::IsTrue(load.reserve == REG_WRITE);
+
+        // stwcx. r3, 0, r4
+        Analyzer store;
+        analyze(store, 0x7C60212D);
+        Assert::IsTrue((store.reserve & REG_READ) != 0);
+        Assert::IsTrue((store.reserve & REG_WRITE) != 0);
+    }
+
+    TEST_METHOD(PPU_AnalyzerSummaryOverflowTests) {
+        auto analyze = [](U32 value) {
+            Analyzer status;
+            Instruction code;
+            code.value = value;
+            (status.*get_entry(code).analyze)(code);
+            return status.xer;
+        };
+
+        // Fields written by integer comparisons and record forms copy XER.SO
+        Assert::IsTrue(analyze(0x7C642A14) == REG_NONE);        // add r3, r4, r5
+        Assert::IsTrue((analyze(0x7C642A15) & REG_READ) != 0);  // add. r3, r4, r5
+        Assert::IsTrue((analyze(0x7C032000) & REG_READ) != 0);  // cmpw cr0, r3, r4
+        Assert::IsTrue((analyze(0x7C60212D) & REG_READ) != 0);  // stwcx. r3, 0, r4
+    }
+
+    TEST_METHOD(PPU_DecoderTableTests) {
+        // Operand bits are varied too, since they must not affect the decoded entry
+        const U32 fills[] = { 0x00000000, 0x03FFF800, 0x02A95000, 0x01556800 };
+
+        for (U32 primary = 0; primary < 0x40; primary++) {
+            for (U32 ext = 0; ext < 0x800; ext++) {
+                for (U32 fill : fills) {
+                    Instruction code;
+                    code.value = (primary << 26) | fill | ext;
+
+                    const Entry& nested = resolve_entry(code);
+                    const Entry& flat = get_entry(code);
+                    if (nested.type != ENTRY_INSTRUCTION) {
+                        Assert::IsTrue(flat.type == ENTRY_INVALID);
+                        continue;
+                    }
+                    Assert::IsTrue(flat.type == ENTRY_INSTRUCTION);
+                    Assert::IsTrue(flat.name == nested.name);
+                    Assert::IsTrue(flat.analyze == nested.analyze);
+                    Assert::IsTrue(flat.recompile == nested.recompile);
+                    Assert::IsTrue(flat.interpret == nested.interpret);
+                }
+            }
+        }
+
+        // Batched lookups return the same entries as single lookups
+        Instruction codes[0x800];
+        const Entry* entries[0x800];
+        for (U32 primary = 0; primary < 0x40; primary++) {
+            for (U32 ext = 0; ext < 0x800; ext++) {
+                codes[ext].value = (primary << 26) | ext;
+            }
+            get_entries(codes, 0x800, entries);
+            for (U32 ext = 0; ext < 0x800; ext++) {
+                Assert::IsTrue(entries[ext] == &get_entry(codes[ext]));
+            }
+        }
+    }
+};